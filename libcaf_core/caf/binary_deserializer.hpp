@@ -12,6 +12,7 @@
 
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/squashed_int.hpp"
+#include "caf/detail/type_traits.hpp"
 #include "caf/error_code.hpp"
 #include "caf/fwd.hpp"
 #include "caf/load_inspector_base.hpp"
@@ -74,6 +75,33 @@ public:
     return context_;
   }
 
+  /// Returns the object that owns the input bytes or `nullptr` if the input
+  /// has no shared owner.
+  ref_counted* input_owner() const noexcept {
+    return input_owner_;
+  }
+
+  /// Sets the object that owns the input bytes. Types such as
+  /// ::shared_byte_span or ::shared_string_view keep a reference to the owner
+  /// instead of copying bytes from the input.
+  /// @pre `ptr` keeps the input bytes alive and never modifies them
+  void input_owner(ref_counted* ptr) noexcept {
+    input_owner_ = ptr;
+  }
+
+  /// Returns whether the deserializer reads integers with more than 8 bits in
+  /// compact form.
+  /// @see binary_serializer::compact_integers
+  bool compact_integers() const noexcept {
+    return compact_integers_;
+  }
+
+  /// Enables or disables compact integers.
+  /// @see binary_serializer::compact_integers
+  void compact_integers(bool value) noexcept {
+    compact_integers_ = value;
+  }
+
   /// Jumps `num_bytes` forward.
   /// @pre `num_bytes <= remaining()`
   void skip(size_t num_bytes);
@@ -200,6 +228,76 @@ public:
 
   bool value(std::vector<bool>& x);
 
+  // -- bulk access to contiguous sequences ------------------------------------
+
+  using super::list;
+
+  /// Reads `xs` in bulk instead of reading each element individually.
+  template <class T>
+  std::enable_if_t<detail::is_bulk_binary_value_v<T>, bool>
+  list(std::vector<T>& xs) {
+    xs.clear();
+    auto size = size_t{0};
+    if (!begin_sequence(size))
+      return false;
+    // Check the size before allocating any memory. Compact integers occupy
+    // at least one byte.
+    auto min_size = size_t{sizeof(T)};
+    if (compact_integers_ && std::is_integral<T>::value)
+      min_size = 1;
+    if (size > remaining() / min_size) {
+      emplace_error(sec::end_of_stream);
+      return false;
+    }
+    xs.resize(size);
+    return value(make_span(xs)) && end_sequence();
+  }
+
+  /// Reads `xs` in bulk instead of reading each element individually.
+  bool list(byte_buffer& xs);
+
+  /// Fills `xs` with values from the input. Reads the same input as calling
+  /// `value` for each element but checks the bounds only once unless reading
+  /// compact integers.
+  bool value(span<int8_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<uint8_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<int16_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<uint16_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<int32_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<uint32_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<int64_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<uint64_t> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<float> xs) noexcept;
+
+  /// @copydoc value(span<int8_t>)
+  bool value(span<double> xs) noexcept;
+
+  template <class T>
+  std::enable_if_t<std::is_integral<T>::value
+                     && detail::is_bulk_binary_value_v<T>,
+                   bool>
+  value(span<T> xs) noexcept {
+    using squashed_type = detail::squashed_int_t<T>;
+    auto ptr = reinterpret_cast<squashed_type*>(xs.data());
+    return value(make_span(ptr, xs.size()));
+  }
+
 private:
   explicit binary_deserializer(actor_system& sys) noexcept;
 
@@ -216,6 +314,12 @@ private:
 
   /// Provides access to the ::proxy_registry and to the ::actor_system.
   execution_unit* context_;
+
+  /// Optionally keeps the input alive for types that share it.
+  ref_counted* input_owner_ = nullptr;
+
+  /// Configures whether integers use varint and zigzag encoding.
+  bool compact_integers_ = false;
 };
 
 } // namespace caf
@@ -13,6 +13,7 @@
 #include "caf/byte_buffer.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/squashed_int.hpp"
+#include "caf/detail/type_traits.hpp"
 #include "caf/fwd.hpp"
 #include "caf/save_inspector_base.hpp"
 #include "caf/span.hpp"
@@ -66,6 +67,35 @@ public:
     return write_pos_;
   }
 
+  /// Returns whether type-erased values such as ::message compute their
+  /// serialized size first in order to reserve memory for their entire
+  /// content at once.
+  bool presize() const noexcept {
+    return presize_;
+  }
+
+  /// Enables or disables pre-sizing of type-erased values.
+  /// @see presize
+  void presize(bool value) noexcept {
+    presize_ = value;
+  }
+
+  /// Returns whether the serializer writes integers with more than 8 bits in
+  /// compact form, i.e., with varint encoding for unsigned and zigzag plus
+  /// varint encoding for signed integers. Small values then occupy a single
+  /// byte. Readers must enable the same mode on their ::binary_deserializer.
+  /// @note does not apply to sequence sizes (always varint encoded) and to
+  ///       floating point numbers (always fixed width).
+  bool compact_integers() const noexcept {
+    return compact_integers_;
+  }
+
+  /// Enables or disables compact integers.
+  /// @see compact_integers
+  void compact_integers(bool value) noexcept {
+    compact_integers_ = value;
+  }
+
   static constexpr bool has_human_readable_format() noexcept {
     return false;
   }
@@ -82,6 +112,10 @@ public:
   /// when skipping past the end.
   void skip(size_t num_bytes);
 
+  /// Makes sure that the buffer can store at least `num_bytes` past the write
+  /// position without re-allocating.
+  void reserve(size_t num_bytes);
+
   // -- interface functions ----------------------------------------------------
 
   constexpr bool begin_object(type_id_t, string_view) noexcept {
@@ -178,6 +212,64 @@ public:
 
   bool value(const std::vector<bool>& x);
 
+  // -- bulk access to contiguous sequences ------------------------------------
+
+  using super::list;
+
+  /// Writes `xs` in bulk instead of writing each element individually.
+  template <class T>
+  std::enable_if_t<detail::is_bulk_binary_value_v<T>, bool>
+  list(const std::vector<T>& xs) {
+    return begin_sequence(xs.size()) && value(make_span(xs)) && end_sequence();
+  }
+
+  /// Writes `xs` in bulk instead of writing each element individually.
+  bool list(const byte_buffer& xs) {
+    return begin_sequence(xs.size()) && value(make_span(xs)) && end_sequence();
+  }
+
+  /// Writes all values in `xs` without any size prefix. Produces the same
+  /// output as calling `value` for each element but grows the buffer at most
+  /// once unless writing compact integers.
+  bool value(span<const int8_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const uint8_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const int16_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const uint16_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const int32_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const uint32_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const int64_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const uint64_t> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const float> xs);
+
+  /// @copydoc value(span<const int8_t>)
+  bool value(span<const double> xs);
+
+  template <class T>
+  std::enable_if_t<std::is_integral<T>::value
+                     && detail::is_bulk_binary_value_v<T>,
+                   bool>
+  value(span<const T> xs) {
+    using squashed_type = detail::squashed_int_t<T>;
+    auto ptr = reinterpret_cast<const squashed_type*>(xs.data());
+    return value(make_span(ptr, xs.size()));
+  }
+
 private:
   /// Stores the serialized output.
   byte_buffer& buf_;
@@ -187,6 +279,12 @@ private:
 
   /// Provides access to the ::proxy_registry and to the ::actor_system.
   execution_unit* context_;
+
+  /// Configures whether type-erased values compute their size up front.
+  bool presize_ = false;
+
+  /// Configures whether integers use varint and zigzag encoding.
+  bool compact_integers_ = false;
 };
 
 } // namespace caf
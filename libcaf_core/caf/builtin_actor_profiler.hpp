@@ -0,0 +1,196 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "caf/actor_profiler.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/thread_local_registry.hpp"
+#include "caf/fwd.hpp"
+#include "caf/timespan.hpp"
+
+namespace caf {
+
+/// An @ref actor_profiler that records how long each actor type takes for
+/// processing each message type, how many messages a handler sends and which
+/// message caused which. The profiler exports its data as collapsed stacks for
+/// flame graph tools and as JSON in the Chrome trace event format.
+///
+/// Each thread records into its own buffers. Hence, the hooks only contend on
+/// a lock when a thread sees an actor or message type for the first time or
+/// while another thread exports the data.
+///
+/// To install the profiler, pass it to the actor system via
+/// `actor_system_config::profiler`. CAF only calls the hooks when building
+/// with `CAF_ENABLE_ACTOR_PROFILER`.
+/// @experimental
+class CAF_CORE_EXPORT builtin_actor_profiler : public actor_profiler {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Number of buckets in the processing time histograms. Bucket `i` counts
+  /// processing times below `2^i` nanoseconds and the last bucket counts all
+  /// remaining values.
+  static constexpr size_t num_buckets = 32;
+
+  /// Limits how many causing messages the profiler tracks for a single
+  /// message. Longer chains start over at the root.
+  static constexpr uint32_t max_stack_depth = 16;
+
+  // -- member types -----------------------------------------------------------
+
+  /// Summarizes how an actor type processed a message type.
+  struct entry {
+    /// Name of the actor type, as reported by `local_actor::name`.
+    std::string actor_type;
+
+    /// Types of the message content, e.g., `[int32_t, std::string]`.
+    std::string message_type;
+
+    /// Number of processed messages.
+    size_t count = 0;
+
+    /// Sum of all processing times.
+    timespan total_time{0};
+
+    /// Longest processing time.
+    timespan max_time{0};
+
+    /// Number of messages with a known send time, i.e., messages from actors.
+    size_t latency_count = 0;
+
+    /// Sum of the times between sending and processing these messages.
+    timespan total_latency{0};
+
+    /// Number of messages the actors sent while processing the messages.
+    size_t sends = 0;
+
+    /// Histogram for the processing times.
+    std::array<size_t, num_buckets> buckets{};
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// @param trace_capacity Maximum number of trace events per thread for
+  ///                       `write_chrome_trace`. Threads overwrite their
+  ///                       oldest event when exceeding this limit.
+  explicit builtin_actor_profiler(size_t trace_capacity = 16384);
+
+  ~builtin_actor_profiler() override;
+
+  // -- overrides --------------------------------------------------------------
+
+  void add_actor(const local_actor& self, const local_actor* parent) override;
+
+  void remove_actor(const local_actor& self) override;
+
+  void before_processing(const local_actor& self,
+                         const mailbox_element& element) override;
+
+  void after_processing(const local_actor& self,
+                        invoke_message_result result) override;
+
+  void before_sending(const local_actor& self,
+                      mailbox_element& element) override;
+
+  void before_sending_scheduled(const local_actor& self,
+                                actor_clock::time_point timeout,
+                                mailbox_element& element) override;
+
+  // -- exporting --------------------------------------------------------------
+
+  /// Returns the statistics for each pair of actor type and message type,
+  /// sorted by total processing time in descending order.
+  /// @thread-safe
+  std::vector<entry> entries() const;
+
+  /// Writes the processing times in the collapsed stacks format. Each line
+  /// consists of the causal chain of a message, i.e., `actor:[types]` frames
+  /// separated by `;`, followed by the total processing time in nanoseconds.
+  /// Tools such as `flamegraph.pl` render this format as flame graph.
+  /// @thread-safe
+  void write_collapsed_stacks(std::ostream& out) const;
+
+  /// Writes the most recent processing events in the Chrome trace event format.
+  /// Flow events connect each message to the handler that sent it. Tools such
+  /// as `chrome://tracing` or Perfetto render this format as timeline.
+  /// @thread-safe
+  void write_chrome_trace(std::ostream& out) const;
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  using clock_type = std::chrono::steady_clock;
+
+  struct thread_data;
+
+  struct shard;
+
+  struct frame_info {
+    std::string actor_type;
+    std::string message_type;
+  };
+
+  struct stack_node {
+    uint32_t parent;
+    uint32_t frame;
+    uint32_t depth;
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  thread_data& local_data();
+
+  uint32_t frame_id(thread_data& td, const local_actor& self,
+                    const mailbox_element& element);
+
+  uint32_t stack_id(thread_data& td, uint32_t parent, uint32_t frame);
+
+  void record_send(const local_actor& self, const mailbox_element& element);
+
+  /// @pre `intern_mtx_` is locked.
+  std::string render_stack(uint32_t id) const;
+
+  // -- member variables -------------------------------------------------------
+
+  /// Configures the size of the trace event ring buffers.
+  size_t trace_capacity_;
+
+  /// Start time for the trace timestamps.
+  clock_type::time_point t0_;
+
+  /// Stores the data of all threads that processed at least one message.
+  detail::thread_local_registry<thread_data> threads_;
+
+  /// Guards all members for interning frames and stacks.
+  mutable std::mutex intern_mtx_;
+
+  /// Maps pointers to actor names and type lists to frame IDs.
+  std::map<std::pair<const char*, const void*>, uint32_t> frame_ids_;
+
+  /// Stores the names for each frame ID.
+  std::vector<frame_info> frames_;
+
+  /// Maps pairs of parent stack ID and frame ID to stack IDs.
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> stack_ids_;
+
+  /// Stores the nodes for each stack ID. The ID 0 denotes the empty stack.
+  std::vector<stack_node> stacks_;
+
+  /// Maps outgoing mailbox elements to the handler that sent them.
+  std::unique_ptr<shard[]> shards_;
+};
+
+} // namespace caf
@@ -0,0 +1,194 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "caf/actor_profiler.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/thread_local_registry.hpp"
+#include "caf/fwd.hpp"
+#include "caf/tracing_data.hpp"
+#include "caf/tracing_data_factory.hpp"
+#include "caf/type_id_list.hpp"
+
+namespace caf {
+
+/// Implements distributed tracing for actor messages. The tracer attaches a
+/// @ref context to each outgoing message and records a *span* for each message
+/// an actor processes. A span knows its trace and the span of the handler that
+/// sent the message, i.e., the spans of a trace form a tree that spans all
+/// actors (and nodes) that took part in handling the initial message.
+///
+/// Messages from outside of a message handler start a new trace. The tracer
+/// decides once per trace whether it records the spans, based on the sampling
+/// rate. The context carries this decision to all subsequent messages.
+///
+/// The tracer keeps the most recent spans of each thread in memory and exports
+/// them as OTLP/JSON, i.e., in the JSON encoding of the OpenTelemetry protocol
+/// that collectors such as the OpenTelemetry Collector or Jaeger accept.
+///
+/// To install the tracer, pass it to the actor system via both
+/// `actor_system_config::profiler` and `actor_system_config::tracing_context`.
+/// The latter enables the middleman to send and receive the context as part of
+/// BASP messages. CAF only calls the hooks when building with
+/// `CAF_ENABLE_ACTOR_PROFILER`.
+/// @experimental
+class CAF_CORE_EXPORT builtin_tracer : public actor_profiler,
+                                       public tracing_data_factory {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// The tracing data that the tracer attaches to messages.
+  class CAF_CORE_EXPORT context : public tracing_data {
+  public:
+    context(uint64_t trace_id_high, uint64_t trace_id_low, uint64_t parent_id,
+            bool sampled) noexcept;
+
+    ~context() override;
+
+    bool serialize(serializer& sink) const override;
+
+    bool serialize(binary_serializer& sink) const override;
+
+    /// Upper half of the 128-bit trace ID.
+    uint64_t trace_id_high;
+
+    /// Lower half of the 128-bit trace ID.
+    uint64_t trace_id_low;
+
+    /// ID of the span that sent the message or 0 if the message started the
+    /// trace.
+    uint64_t parent_id;
+
+    /// Stores whether the tracer records the spans of this trace.
+    bool sampled;
+  };
+
+  /// An actor processing a single message.
+  struct span {
+    /// Upper half of the 128-bit trace ID.
+    uint64_t trace_id_high = 0;
+
+    /// Lower half of the 128-bit trace ID.
+    uint64_t trace_id_low = 0;
+
+    /// Unique ID of this span.
+    uint64_t span_id = 0;
+
+    /// ID of the span that sent the message or 0 for root spans.
+    uint64_t parent_id = 0;
+
+    /// Name of the actor type, as reported by `local_actor::name`.
+    std::string actor_name;
+
+    /// ID of the actor that processed the message.
+    actor_id aid = 0;
+
+    /// Types of the message content.
+    type_id_list message_types = make_type_id_list();
+
+    /// Nanoseconds since the UNIX epoch when the actor started processing.
+    int64_t start = 0;
+
+    /// Nanoseconds since the UNIX epoch when the actor finished processing.
+    int64_t end = 0;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// @param sample_rate Fraction of traces that the tracer records, where `1`
+  ///                    records all traces and `0` disables recording.
+  /// @param capacity Maximum number of spans per thread. Threads overwrite
+  ///                 their oldest span when exceeding this limit.
+  explicit builtin_tracer(double sample_rate = 1.0, size_t capacity = 16384);
+
+  ~builtin_tracer() override;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the fraction of traces that the tracer records.
+  double sample_rate() const noexcept {
+    return sample_rate_;
+  }
+
+  // -- actor_profiler overrides -----------------------------------------------
+
+  void add_actor(const local_actor& self, const local_actor* parent) override;
+
+  void remove_actor(const local_actor& self) override;
+
+  void before_processing(const local_actor& self,
+                         const mailbox_element& element) override;
+
+  void after_processing(const local_actor& self,
+                        invoke_message_result result) override;
+
+  void before_sending(const local_actor& self,
+                      mailbox_element& element) override;
+
+  void before_sending_scheduled(const local_actor& self,
+                                actor_clock::time_point timeout,
+                                mailbox_element& element) override;
+
+  // -- tracing_data_factory overrides -----------------------------------------
+
+  bool deserialize(deserializer& source,
+                   std::unique_ptr<tracing_data>& dst) const override;
+
+  bool deserialize(binary_deserializer& source,
+                   std::unique_ptr<tracing_data>& dst) const override;
+
+  // -- exporting --------------------------------------------------------------
+
+  /// Returns the recorded spans of all threads, sorted by start time.
+  /// @thread-safe
+  std::vector<span> spans() const;
+
+  /// Writes all recorded spans as OTLP/JSON, i.e., as a single
+  /// `ExportTraceServiceRequest` in the JSON encoding of the OpenTelemetry
+  /// protocol.
+  /// @thread-safe
+  void write_otlp_json(std::ostream& out) const;
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  struct thread_data;
+
+  // -- utility functions ------------------------------------------------------
+
+  thread_data& local_data();
+
+  std::unique_ptr<context> make_context(thread_data& td);
+
+  // -- member variables -------------------------------------------------------
+
+  /// Fraction of traces that the tracer records.
+  double sample_rate_;
+
+  /// Random numbers below this threshold select a new trace for recording.
+  uint64_t sample_threshold_;
+
+  /// Configures the size of the ring buffers.
+  size_t capacity_;
+
+  /// Guards `node_`.
+  mutable std::mutex node_mtx_;
+
+  /// ID of the node that runs the traced actors.
+  std::string node_;
+
+  /// Stores the data of all threads that used the tracer.
+  detail::thread_local_registry<thread_data> threads_;
+};
+
+} // namespace caf
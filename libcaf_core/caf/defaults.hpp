@@ -79,6 +79,8 @@ constexpr auto policy = string_view{"stealing"};
 constexpr auto profiling_output_file = string_view{""};
 constexpr auto max_throughput = std::numeric_limits<size_t>::max();
 constexpr auto profiling_resolution = timespan(100'000'000);
+constexpr auto trace_file = string_view{""};
+constexpr auto trace_buffer_size = size_t{65536};
 
 } // namespace caf::defaults::scheduler
 
@@ -94,6 +96,12 @@ constexpr auto relaxed_sleep_duration = timespan{10'000'000};
 
 } // namespace caf::defaults::work_stealing
 
+namespace caf::defaults::logger {
+
+constexpr auto per_thread_buffer_size = size_t{65536};
+
+} // namespace caf::defaults::logger
+
 namespace caf::defaults::logger::file {
 
 constexpr auto format = string_view{"%r %c %p %a %t %C %M %F:%L %m%n"};
@@ -117,5 +125,12 @@ constexpr auto heartbeat_interval = timespan{10'000'000'000};
 constexpr auto connection_timeout = timespan{30'000'000'000};
 constexpr auto cached_udp_buffers = size_t{10};
 constexpr auto max_pending_msgs = size_t{10};
+constexpr auto compression_threshold = size_t{1024};
+constexpr auto output_batch_size = size_t{0};
+constexpr auto output_batch_delay = timespan{100'000};
+constexpr auto presize_payloads = false;
+constexpr auto streaming_threshold = size_t{1024 * 1024};
+constexpr auto streaming_buffer_size = size_t{16 * 1024 * 1024};
+constexpr auto max_payload_size = size_t{256 * 1024 * 1024};
 
 } // namespace caf::defaults::middleman
@@ -0,0 +1,136 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/logger.hpp"
+#include "caf/string_view.hpp"
+#include "caf/timestamp.hpp"
+
+namespace caf::detail {
+
+/// Writes log events in a compact binary format. The writer stores each
+/// distinct string (category, function, file and thread names) only once and
+/// afterwards refers to it by ID. Events only carry numbers, string IDs and
+/// the message. Rendering the events into text happens offline, e.g., via
+/// `render_binary_log`.
+///
+/// The format starts with a header (the magic string `CAFLOG`, a 16-bit
+/// version and the start time in nanoseconds since epoch), followed by a
+/// sequence of records. All integers use little-endian byte order.
+class CAF_CORE_EXPORT binary_log_writer {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Identifies the current version of the binary format.
+  static constexpr uint16_t version = 1;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Writes the header with the start time `t0` to `out`.
+  binary_log_writer(std::ostream& out, timestamp t0);
+
+  binary_log_writer(const binary_log_writer&) = delete;
+
+  binary_log_writer& operator=(const binary_log_writer&) = delete;
+
+  // -- writing ----------------------------------------------------------------
+
+  /// Appends `x` to the output.
+  void write(const logger::event& x);
+
+private:
+  uint32_t string_id(string_view str);
+
+  uint32_t thread_id(std::thread::id tid);
+
+  uint32_t add_string(string_view str);
+
+  std::ostream& out_;
+
+  /// Stores the current record before writing it to `out_`.
+  std::vector<char> buf_;
+
+  /// Maps static strings to their ID. The logger only passes pointers to
+  /// string literals in the fields of an event (except for the message).
+  /// Hence, the writer does not need to compare the strings themselves.
+  std::map<std::pair<const char*, size_t>, uint32_t> strings_;
+
+  /// Maps thread IDs to the string ID for their rendered representation.
+  std::unordered_map<std::thread::id, uint32_t> threads_;
+
+  uint32_t next_id_ = 0;
+};
+
+/// Reads log events from the binary format written by ::binary_log_writer.
+class CAF_CORE_EXPORT binary_log_reader {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Reads the header from `in`.
+  explicit binary_log_reader(std::istream& in);
+
+  binary_log_reader(const binary_log_reader&) = delete;
+
+  binary_log_reader& operator=(const binary_log_reader&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns whether the input starts with a valid header.
+  bool valid() const noexcept {
+    return valid_;
+  }
+
+  /// Returns the start time of the log.
+  timestamp t0() const noexcept {
+    return t0_;
+  }
+
+  // -- reading ----------------------------------------------------------------
+
+  /// Reads the next event from the input. On success, all string views in `x`
+  /// remain valid for the lifetime of the reader. Since `std::thread::id` has
+  /// no portable representation, the reader sets `thread_name` instead of
+  /// `tid`.
+  /// @returns `false` at the end of the input or on a malformed record, `true`
+  ///          otherwise.
+  bool next(logger::event& x);
+
+private:
+  bool read_bytes(void* dst, size_t n);
+
+  template <class T>
+  bool read_int(T& x);
+
+  bool read_string_ref(string_view& x);
+
+  std::istream& in_;
+
+  bool valid_ = false;
+
+  timestamp t0_;
+
+  /// Stores all strings by ID. A deque never moves its elements when growing.
+  std::deque<std::string> strings_;
+};
+
+/// Renders all events in the binary log `in` to `out`, using the line format
+/// `lf`.
+/// @returns `false` if `in` is not a binary log or contains a malformed
+///          record, `true` otherwise.
+CAF_CORE_EXPORT bool render_binary_log(std::istream& in, std::ostream& out,
+                                       const logger::line_format& lf);
+
+} // namespace caf::detail
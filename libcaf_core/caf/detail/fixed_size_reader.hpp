@@ -0,0 +1,227 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "caf/byte.hpp"
+#include "caf/detail/ieee_754.hpp"
+#include "caf/detail/network_order.hpp"
+#include "caf/detail/squashed_int.hpp"
+#include "caf/fwd.hpp"
+#include "caf/load_inspector_base.hpp"
+#include "caf/sec.hpp"
+#include "caf/span.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::detail {
+
+/// Reads the output of ::binary_serializer for objects with a fixed binary
+/// size. Counterpart to ::fixed_size_writer.
+/// @see fixed_size_codec
+class fixed_size_reader : public load_inspector_base<fixed_size_reader> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = load_inspector_base<fixed_size_reader>;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  fixed_size_reader(execution_unit* ctx, const byte* first,
+                    const byte* last) noexcept
+    : pos_(first), end_(last), context_(ctx) {
+    // nop
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the current execution unit.
+  execution_unit* context() const noexcept {
+    return context_;
+  }
+
+  /// Returns the current read position.
+  const byte* position() const noexcept {
+    return pos_;
+  }
+
+  static constexpr bool has_human_readable_format() noexcept {
+    return false;
+  }
+
+  // -- interface functions ----------------------------------------------------
+
+  bool fetch_next_object_type(type_id_t&) {
+    return variable_size();
+  }
+
+  constexpr bool begin_object(type_id_t, string_view) noexcept {
+    return true;
+  }
+
+  constexpr bool end_object() noexcept {
+    return true;
+  }
+
+  constexpr bool begin_field(string_view) noexcept {
+    return true;
+  }
+
+  bool begin_field(string_view, bool&) {
+    return variable_size();
+  }
+
+  bool begin_field(string_view, span<const type_id_t>, size_t&) {
+    return variable_size();
+  }
+
+  bool begin_field(string_view, bool&, span<const type_id_t>, size_t&) {
+    return variable_size();
+  }
+
+  constexpr bool end_field() noexcept {
+    return true;
+  }
+
+  constexpr bool begin_tuple(size_t) noexcept {
+    return true;
+  }
+
+  constexpr bool end_tuple() noexcept {
+    return true;
+  }
+
+  constexpr bool begin_key_value_pair() noexcept {
+    return true;
+  }
+
+  constexpr bool end_key_value_pair() noexcept {
+    return true;
+  }
+
+  bool begin_sequence(size_t&) {
+    return variable_size();
+  }
+
+  constexpr bool end_sequence() noexcept {
+    return true;
+  }
+
+  bool begin_associative_array(size_t&) {
+    return variable_size();
+  }
+
+  constexpr bool end_associative_array() noexcept {
+    return true;
+  }
+
+  bool value(byte& x) {
+    if (pos_ == end_)
+      return out_of_input();
+    x = *pos_++;
+    return true;
+  }
+
+  bool value(bool& x) {
+    auto tmp = byte{0};
+    if (!value(tmp))
+      return false;
+    x = tmp != byte{0};
+    return true;
+  }
+
+  template <class T>
+  std::enable_if_t<std::is_integral<T>::value, bool> value(T& x) {
+    using unsigned_type = squashed_int_t<std::make_unsigned_t<T>>;
+    if constexpr (sizeof(T) == 1) {
+      auto tmp = byte{0};
+      if (!value(tmp))
+        return false;
+      x = static_cast<T>(tmp);
+      return true;
+    } else {
+      auto tmp = unsigned_type{0};
+      if (!load(tmp))
+        return false;
+      x = static_cast<T>(from_network_order(tmp));
+      return true;
+    }
+  }
+
+  bool value(float& x) {
+    auto tmp = uint32_t{0};
+    if (!load(tmp))
+      return false;
+    x = unpack754(from_network_order(tmp));
+    return true;
+  }
+
+  bool value(double& x) {
+    auto tmp = uint64_t{0};
+    if (!load(tmp))
+      return false;
+    x = unpack754(from_network_order(tmp));
+    return true;
+  }
+
+  bool value(long double&) {
+    return variable_size();
+  }
+
+  bool value(std::string&) {
+    return variable_size();
+  }
+
+  bool value(std::u16string&) {
+    return variable_size();
+  }
+
+  bool value(std::u32string&) {
+    return variable_size();
+  }
+
+  bool value(span<byte> x) {
+    if (static_cast<size_t>(end_ - pos_) < x.size())
+      return out_of_input();
+    if (!x.empty()) // Calling memcpy with nullptr is undefined behavior.
+      memcpy(x.data(), pos_, x.size());
+    pos_ += x.size();
+    return true;
+  }
+
+  bool value(std::vector<bool>&) {
+    return variable_size();
+  }
+
+private:
+  template <class T>
+  bool load(T& x) {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(T))
+      return out_of_input();
+    memcpy(&x, pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool variable_size() {
+    emplace_error(sec::unsupported_operation,
+                  "value has no fixed size in the binary format");
+    return false;
+  }
+
+  bool out_of_input() {
+    emplace_error(sec::end_of_stream);
+    return false;
+  }
+
+  const byte* pos_;
+  const byte* end_;
+  execution_unit* context_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,204 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "caf/byte.hpp"
+#include "caf/detail/ieee_754.hpp"
+#include "caf/detail/network_order.hpp"
+#include "caf/detail/squashed_int.hpp"
+#include "caf/fwd.hpp"
+#include "caf/save_inspector_base.hpp"
+#include "caf/sec.hpp"
+#include "caf/span.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::detail {
+
+/// Writes the same output as ::binary_serializer for objects with a fixed
+/// binary size into a pre-allocated memory region. All member functions are
+/// inline, which allows the compiler to turn the inspection of an object into
+/// a sequence of stores. Values without fixed size make the writer fail.
+/// @see fixed_size_codec
+class fixed_size_writer : public save_inspector_base<fixed_size_writer> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = save_inspector_base<fixed_size_writer>;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  fixed_size_writer(execution_unit* ctx, byte* first, byte* last) noexcept
+    : pos_(first), end_(last), context_(ctx) {
+    // nop
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the current execution unit.
+  execution_unit* context() const noexcept {
+    return context_;
+  }
+
+  /// Returns the current write position.
+  byte* position() const noexcept {
+    return pos_;
+  }
+
+  static constexpr bool has_human_readable_format() noexcept {
+    return false;
+  }
+
+  // -- interface functions ----------------------------------------------------
+
+  constexpr bool begin_object(type_id_t, string_view) noexcept {
+    return true;
+  }
+
+  constexpr bool end_object() noexcept {
+    return true;
+  }
+
+  constexpr bool begin_field(string_view) noexcept {
+    return true;
+  }
+
+  bool begin_field(string_view, bool) {
+    return variable_size();
+  }
+
+  bool begin_field(string_view, span<const type_id_t>, size_t) {
+    return variable_size();
+  }
+
+  bool begin_field(string_view, bool, span<const type_id_t>, size_t) {
+    return variable_size();
+  }
+
+  constexpr bool end_field() noexcept {
+    return true;
+  }
+
+  constexpr bool begin_tuple(size_t) noexcept {
+    return true;
+  }
+
+  constexpr bool end_tuple() noexcept {
+    return true;
+  }
+
+  constexpr bool begin_key_value_pair() noexcept {
+    return true;
+  }
+
+  constexpr bool end_key_value_pair() noexcept {
+    return true;
+  }
+
+  bool begin_sequence(size_t) {
+    return variable_size();
+  }
+
+  constexpr bool end_sequence() noexcept {
+    return true;
+  }
+
+  bool begin_associative_array(size_t) {
+    return variable_size();
+  }
+
+  constexpr bool end_associative_array() noexcept {
+    return true;
+  }
+
+  bool value(byte x) {
+    if (pos_ == end_)
+      return out_of_space();
+    *pos_++ = x;
+    return true;
+  }
+
+  bool value(bool x) {
+    return value(static_cast<byte>(x ? 1 : 0));
+  }
+
+  template <class T>
+  std::enable_if_t<std::is_integral<T>::value, bool> value(T x) {
+    using unsigned_type = squashed_int_t<std::make_unsigned_t<T>>;
+    if constexpr (sizeof(T) == 1)
+      return value(static_cast<byte>(x));
+    else
+      return store(to_network_order(static_cast<unsigned_type>(x)));
+  }
+
+  bool value(float x) {
+    return store(to_network_order(pack754(x)));
+  }
+
+  bool value(double x) {
+    return store(to_network_order(pack754(x)));
+  }
+
+  bool value(long double) {
+    return variable_size();
+  }
+
+  bool value(string_view) {
+    return variable_size();
+  }
+
+  bool value(const std::u16string&) {
+    return variable_size();
+  }
+
+  bool value(const std::u32string&) {
+    return variable_size();
+  }
+
+  bool value(span<const byte> x) {
+    if (static_cast<size_t>(end_ - pos_) < x.size())
+      return out_of_space();
+    if (!x.empty()) // Calling memcpy with nullptr is undefined behavior.
+      memcpy(pos_, x.data(), x.size());
+    pos_ += x.size();
+    return true;
+  }
+
+  bool value(const std::vector<bool>&) {
+    return variable_size();
+  }
+
+private:
+  template <class T>
+  bool store(T x) {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(T))
+      return out_of_space();
+    memcpy(pos_, &x, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool variable_size() {
+    emplace_error(sec::unsupported_operation,
+                  "value has no fixed size in the binary format");
+    return false;
+  }
+
+  bool out_of_space() {
+    emplace_error(sec::runtime_error,
+                  "object exceeds the size of its type schema");
+    return false;
+  }
+
+  byte* pos_;
+  byte* end_;
+  execution_unit* context_;
+};
+
+} // namespace caf::detail
@@ -71,4 +71,15 @@ object* make_object(monotonic_buffer_resource* storage);
 
 value* parse(string_parser_state& ps, monotonic_buffer_resource* storage);
 
+/// Parses `str` in two stages. The first stage finds all structural
+/// characters, i.e., brackets, braces, colons, commas and the quotes around
+/// strings, checking 16 characters at once when compiling with SSE2. The
+/// second stage walks this index to build the tree and runs the first stage
+/// on the next chunk of the input whenever it reaches the end of the index.
+/// Produces the same tree as `parse` but returns `nullptr` instead of
+/// reporting errors. Hence, callers may re-run `parse` on the same input to
+/// get a precise error.
+/// @note strings in the resulting tree point into `str`.
+value* parse_indexed(string_view str, monotonic_buffer_resource* storage);
+
 } // namespace caf::detail::json
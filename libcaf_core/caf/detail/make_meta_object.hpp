@@ -13,9 +13,11 @@
 #include "caf/deserializer.hpp"
 #include "caf/detail/meta_object.hpp"
 #include "caf/detail/padded_size.hpp"
+#include "caf/detail/serialized_size.hpp"
 #include "caf/detail/stringification_inspector.hpp"
 #include "caf/inspector_access.hpp"
 #include "caf/serializer.hpp"
+#include "caf/use_fixed_size_codec.hpp"
 
 namespace caf::detail::default_function {
 
@@ -36,12 +38,18 @@ void copy_construct(void* ptr, const void* src) {
 
 template <class T>
 bool save_binary(binary_serializer& sink, const void* ptr) {
-  return sink.apply(*static_cast<const T*>(ptr));
+  if constexpr (use_fixed_size_codec_v<T>)
+    return fixed_size_codec<T>::save(sink, *static_cast<const T*>(ptr));
+  else
+    return sink.apply(*static_cast<const T*>(ptr));
 }
 
 template <class T>
 bool load_binary(binary_deserializer& source, void* ptr) {
-  return source.apply(*static_cast<T*>(ptr));
+  if constexpr (use_fixed_size_codec_v<T>)
+    return fixed_size_codec<T>::load(source, *static_cast<T*>(ptr));
+  else
+    return source.apply(*static_cast<T*>(ptr));
 }
 
 template <class T>
@@ -61,6 +69,11 @@ void stringify(std::string& buf, const void* ptr) {
   static_cast<void>(unused);
 }
 
+template <class T>
+bool save_size(serialized_size_inspector& sink, const void* ptr) {
+  return sink.apply(*static_cast<const T*>(ptr));
+}
+
 } // namespace caf::detail::default_function
 
 namespace caf::detail {
@@ -78,6 +91,7 @@ meta_object make_meta_object(string_view type_name) {
     default_function::save<T>,
     default_function::load<T>,
     default_function::stringify<T>,
+    default_function::save_size<T>,
   };
 }
 
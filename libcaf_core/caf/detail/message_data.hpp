@@ -12,6 +12,7 @@
 #include "caf/config.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/implicit_conversions.hpp"
+#include "caf/detail/message_layout.hpp"
 #include "caf/detail/padded_size.hpp"
 #include "caf/fwd.hpp"
 #include "caf/type_id_list.hpp"
@@ -41,7 +42,9 @@ public:
   message_data& operator=(const message_data&) = delete;
 
   /// Constructs the message data object *without* constructing any element.
-  explicit message_data(type_id_list types) noexcept;
+  /// @pre `layout` is the storage layout for `types` and remains valid for the
+  ///      lifetime of the message data.
+  message_data(type_id_list types, const message_layout& layout) noexcept;
 
   ~message_data() noexcept;
 
@@ -97,6 +100,11 @@ public:
     return types_.size();
   }
 
+  /// Returns the storage layout of the message elements.
+  const message_layout& layout() const noexcept {
+    return *layout_;
+  }
+
   /// Returns the memory location for the object at given index.
   /// @pre `index < size()`
   byte* at(size_t index) noexcept;
@@ -182,6 +190,7 @@ private:
 
   mutable std::atomic<size_t> rc_;
   type_id_list types_;
+  const message_layout* layout_;
   size_t constructed_elements_;
   byte storage_[];
 };
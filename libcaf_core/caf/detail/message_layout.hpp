@@ -0,0 +1,52 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/padded_size.hpp"
+#include "caf/type_id_list.hpp"
+
+namespace caf::detail {
+
+/// Pre-computed storage layout for the elements of a message.
+struct message_layout {
+  /// Sum of the padded sizes of all elements.
+  size_t storage_size = 0;
+
+  /// Offset of each element relative to the storage of the message.
+  std::vector<size_t> offsets;
+
+  /// Stores whether all types in the list have a meta object.
+  bool valid = true;
+};
+
+/// Returns the storage layout for messages with `types`. Computes the layout
+/// once per type list and caches the result globally as well as in a small
+/// thread-local cache.
+/// @pre `types` points to an interned list, i.e., a list that remains valid
+///      for the lifetime of the program such as lists created by
+///      `make_type_id_list` or `type_id_list_builder`.
+CAF_CORE_EXPORT const message_layout& layout_of(type_id_list types);
+
+/// Returns the storage layout for messages with elements of type `Ts`. Unlike
+/// `layout_of`, this function computes the layout from the static types and
+/// thus never accesses the global cache.
+template <class... Ts>
+const message_layout& static_layout_of() {
+  static const message_layout result = [] {
+    message_layout x;
+    x.offsets.reserve(sizeof...(Ts));
+    ((x.offsets.emplace_back(x.storage_size),
+      x.storage_size += padded_size_v<Ts>),
+     ...);
+    return x;
+  }();
+  return result;
+}
+
+} // namespace caf::detail
@@ -49,6 +49,11 @@ struct meta_object {
 
   /// Appends a string representation of an object to a buffer.
   void (*stringify)(std::string&, const void*);
+
+  /// Adds the serialized size of an object to a size inspector. Unlike `save`,
+  /// this function calls the member functions of the inspector directly
+  /// instead of dispatching each field and value through a virtual interface.
+  bool (*save_size)(serialized_size_inspector&, const void*);
 };
 
 /// An opaque type for shared object lifetime management of the global meta
@@ -9,8 +9,10 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <ctime>
 #include <limits>
+#include <string>
 #include <type_traits>
 
 namespace caf::detail {
@@ -124,66 +126,105 @@ void print(Buffer& buf, bool x) {
   buf.insert(buf.end(), str.begin(), str.end());
 }
 
+/// Lists the decimal representation of all numbers from 00 to 99.
+constexpr const char decimal_digit_pairs[] = "00010203040506070809"
+                                             "10111213141516171819"
+                                             "20212223242526272829"
+                                             "30313233343536373839"
+                                             "40414243444546474849"
+                                             "50515253545556575859"
+                                             "60616263646566676869"
+                                             "70717273747576777879"
+                                             "80818283848586878889"
+                                             "90919293949596979899";
+
 template <class Buffer, class T>
 std::enable_if_t<std::is_integral<T>::value> print(Buffer& buf, T x) {
-  // An integer can at most have 20 digits (UINT64_MAX).
+  // An integer can at most have 20 digits (UINT64_MAX) plus the sign.
   char stack_buffer[24];
-  char* p = stack_buffer;
-  // Convert negative values into positives as necessary.
+  auto last = stack_buffer + sizeof(stack_buffer);
+  auto p = last;
+  // Convert negative values into positives as necessary. Casting to the
+  // unsigned type first also covers the smallest value, which has no positive
+  // counterpart in T.
+  using unsigned_type = std::make_unsigned_t<T>;
+  auto y = static_cast<unsigned_type>(x);
+  bool negative = false;
   if constexpr (std::is_signed<T>::value) {
-    if (x == std::numeric_limits<T>::min()) {
-      using namespace caf::literals;
-      // The code below would fail for the smallest value, because this value
-      // has no positive counterpart. For example, an int8_t ranges from -128 to
-      // 127. Hence, an int8_t cannot represent `abs(-128)`.
-      string_view result;
-      if constexpr (sizeof(T) == 1) {
-        result = "-128"_sv;
-      } else if constexpr (sizeof(T) == 2) {
-        result = "-32768"_sv;
-      } else if constexpr (sizeof(T) == 4) {
-        result = "-2147483648"_sv;
-      } else {
-        static_assert(sizeof(T) == 8);
-        result = "-9223372036854775808"_sv;
-      }
-      buf.insert(buf.end(), result.begin(), result.end());
-      return;
-    }
     if (x < 0) {
-      buf.push_back('-');
-      x = -x;
+      negative = true;
+      y = static_cast<unsigned_type>(unsigned_type{0} - y);
     }
   }
-  // Fill the buffer.
-  *p++ = static_cast<char>((x % 10) + '0');
-  x /= 10;
-  while (x != 0) {
-    *p++ = static_cast<char>((x % 10) + '0');
-    x /= 10;
+  // Fill the buffer from the back, producing two digits per division.
+  while (y >= 100) {
+    auto index = static_cast<size_t>(y % 100) * 2;
+    y /= 100;
+    *--p = decimal_digit_pairs[index + 1];
+    *--p = decimal_digit_pairs[index];
+  }
+  if (y >= 10) {
+    auto index = static_cast<size_t>(y) * 2;
+    *--p = decimal_digit_pairs[index + 1];
+    *--p = decimal_digit_pairs[index];
+  } else {
+    *--p = static_cast<char>('0' + y);
   }
-  // Now, the buffer holds the string representation in reverse order.
-  do {
-    buf.push_back(*--p);
-  } while (p != stack_buffer);
+  if (negative)
+    *--p = '-';
+  buf.insert(buf.end(), p, last);
 }
 
 template <class Buffer, class T>
 std::enable_if_t<std::is_floating_point<T>::value> print(Buffer& buf, T x) {
-  // TODO: Check whether to_chars is available on supported compilers and
-  //       re-implement using the new API as soon as possible.
-  auto str = std::to_string(x);
-  if (str.find('.') != std::string::npos) {
+  // Produces the same output as std::to_string, i.e., printf with "%f", but
+  // avoids allocating a string for all values that fit into the stack buffer.
+  char stack_buffer[64];
+  std::string heap_buffer;
+  string_view str;
+  int size;
+  if constexpr (std::is_same<T, long double>::value)
+    size = snprintf(stack_buffer, sizeof(stack_buffer), "%Lf", x);
+  else
+    size = snprintf(stack_buffer, sizeof(stack_buffer), "%f",
+                    static_cast<double>(x));
+  if (size < 0) {
+    return;
+  } else if (static_cast<size_t>(size) < sizeof(stack_buffer)) {
+    str = string_view{stack_buffer, static_cast<size_t>(size)};
+  } else {
+    heap_buffer = std::to_string(x);
+    str = heap_buffer;
+  }
+  if (str.find('.') != string_view::npos) {
     // Drop trailing zeros.
     while (str.back() == '0')
-      str.pop_back();
+      str.remove_suffix(1);
     // Drop trailing dot as well if we've removed all decimal places.
     if (str.back() == '.')
-      str.pop_back();
+      str.remove_suffix(1);
   }
   buf.insert(buf.end(), str.begin(), str.end());
 }
 
+/// Prints `ns` nanoseconds as microseconds with exactly three decimal places,
+/// e.g., `-1.005` for -1005 nanoseconds.
+template <class Buffer>
+void print_us(Buffer& buf, int64_t ns) {
+  // Casting to the unsigned type first also covers the smallest value.
+  auto abs_ns = static_cast<uint64_t>(ns);
+  if (ns < 0) {
+    buf.push_back('-');
+    abs_ns = uint64_t{0} - abs_ns;
+  }
+  print(buf, abs_ns / 1000);
+  auto frac = static_cast<size_t>(abs_ns % 1000);
+  buf.push_back('.');
+  buf.push_back(static_cast<char>('0' + frac / 100));
+  buf.push_back(decimal_digit_pairs[(frac % 100) * 2]);
+  buf.push_back(decimal_digit_pairs[(frac % 100) * 2 + 1]);
+}
+
 template <class Buffer, class Rep, class Period>
 void print(Buffer& buf, std::chrono::duration<Rep, Period> x) {
   using namespace caf::literals;
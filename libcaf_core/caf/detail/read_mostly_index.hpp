@@ -0,0 +1,133 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace caf::detail {
+
+/// An insert-only hash index that maps precomputed hash values to pointers.
+/// Readers never block: they probe a table of atomic slots. Writers must
+/// serialize calls to `insert` and `clear`, e.g., by holding a mutex. When the
+/// table becomes half full, the writer copies all entries to a table with
+/// twice the capacity and publishes the new table. Previous tables stay alive
+/// until destroying the index, because readers may still access them.
+/// @note The index never owns the objects it points to.
+template <class T>
+class read_mostly_index {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  read_mostly_index() noexcept : table_(nullptr), size_(0) {
+    // nop
+  }
+
+  read_mostly_index(const read_mostly_index&) = delete;
+
+  read_mostly_index& operator=(const read_mostly_index&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of entries.
+  /// @pre The caller serializes this call with `insert` and `clear`.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  // -- lookup -----------------------------------------------------------------
+
+  /// Returns the first entry with the hash value `hash` that satisfies `pred`
+  /// or `nullptr` if no such entry exists. Safe to call concurrently with
+  /// other readers and with a writer.
+  template <class Predicate>
+  T* find(size_t hash, Predicate&& pred) const {
+    auto tbl = table_.load(std::memory_order_acquire);
+    if (tbl == nullptr)
+      return nullptr;
+    // The table always has at least one empty slot, so the loop terminates.
+    for (auto index = hash & tbl->mask;; index = (index + 1) & tbl->mask) {
+      auto& entry = tbl->slots[index];
+      auto ptr = entry.value.load(std::memory_order_acquire);
+      if (ptr == nullptr)
+        return nullptr;
+      if (entry.hash.load(std::memory_order_relaxed) == hash && pred(*ptr))
+        return ptr;
+    }
+  }
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Adds `ptr` with the hash value `hash` to the index.
+  /// @pre `ptr != nullptr`
+  void insert(size_t hash, T* ptr) {
+    auto tbl = table_.load(std::memory_order_relaxed);
+    if (tbl == nullptr || (size_ + 1) * 2 > tbl->mask + 1)
+      tbl = grow(tbl);
+    place(*tbl, hash, ptr);
+    ++size_;
+  }
+
+  /// Removes all entries from the index.
+  void clear() {
+    table_.store(nullptr, std::memory_order_release);
+    size_ = 0;
+  }
+
+private:
+  struct slot {
+    std::atomic<size_t> hash{0};
+    std::atomic<T*> value{nullptr};
+  };
+
+  struct table {
+    explicit table(size_t capacity)
+      : mask(capacity - 1), slots(new slot[capacity]) {
+      // nop
+    }
+
+    size_t mask;
+    std::unique_ptr<slot[]> slots;
+  };
+
+  static void place(table& tbl, size_t hash, T* ptr) {
+    auto index = hash & tbl.mask;
+    while (tbl.slots[index].value.load(std::memory_order_relaxed) != nullptr)
+      index = (index + 1) & tbl.mask;
+    auto& entry = tbl.slots[index];
+    entry.hash.store(hash, std::memory_order_relaxed);
+    // Publishes the hash value as well.
+    entry.value.store(ptr, std::memory_order_release);
+  }
+
+  table* grow(table* old_tbl) {
+    auto capacity = old_tbl == nullptr ? size_t{8} : (old_tbl->mask + 1) * 2;
+    auto new_tbl = std::make_unique<table>(capacity);
+    if (old_tbl != nullptr) {
+      for (size_t index = 0; index <= old_tbl->mask; ++index) {
+        auto& entry = old_tbl->slots[index];
+        if (auto ptr = entry.value.load(std::memory_order_relaxed))
+          place(*new_tbl, entry.hash.load(std::memory_order_relaxed), ptr);
+      }
+    }
+    auto result = new_tbl.get();
+    tables_.emplace_back(std::move(new_tbl));
+    table_.store(result, std::memory_order_release);
+    return result;
+  }
+
+  /// Points to the current table.
+  std::atomic<table*> table_;
+
+  /// Stores the number of entries in the current table.
+  size_t size_;
+
+  /// Owns the current table and all previous tables.
+  std::vector<std::unique_ptr<table>> tables_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,163 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "caf/config.hpp"
+#include "caf/detail/core_export.hpp"
+
+namespace caf::detail {
+
+/// Returns a small number that identifies the calling thread. Threads receive
+/// consecutive numbers in the order of their first call.
+CAF_CORE_EXPORT size_t this_thread_shard() noexcept;
+
+/// Stores one block of 64-bit counters per shard. Each block starts at a cache
+/// line boundary and occupies whole cache lines. Hence, threads that update
+/// the cells of different shards never write to the same cache line. Readers
+/// sum up a cell across all blocks.
+class CAF_CORE_EXPORT sharded_cells {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using cell_type = std::atomic<int64_t>;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Limits the number of shards.
+  static constexpr size_t max_shards = 256;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a zero-initialized block of `cells_per_shard` cells for each
+  /// shard. Rounds `num_shards` up to the next power of two.
+  sharded_cells(size_t num_shards, size_t cells_per_shard);
+
+  sharded_cells(const sharded_cells&) = delete;
+
+  sharded_cells& operator=(const sharded_cells&) = delete;
+
+  ~sharded_cells();
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of blocks.
+  size_t num_shards() const noexcept {
+    return mask_ + 1;
+  }
+
+  /// Returns the block for the calling thread.
+  cell_type* local_block() noexcept {
+    return cells_ + (this_thread_shard() & mask_) * stride_;
+  }
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Adds `amount` to `cell`. Stores floating point numbers as bit patterns.
+  template <class T>
+  static void add(cell_type& cell, T amount) noexcept {
+    if constexpr (std::is_integral<T>::value) {
+      cell.fetch_add(static_cast<int64_t>(amount), std::memory_order_relaxed);
+    } else {
+      static_assert(sizeof(T) == sizeof(int64_t));
+      // Usually, only one thread writes to the cell. Hence, the loop almost
+      // never repeats.
+      auto bits = cell.load(std::memory_order_relaxed);
+      auto new_bits = to_bits(from_bits<T>(bits) + amount);
+      while (!cell.compare_exchange_weak(bits, new_bits,
+                                         std::memory_order_relaxed))
+        new_bits = to_bits(from_bits<T>(bits) + amount);
+    }
+  }
+
+  /// Adds `amount` to the cell at `offset` in the block of the calling thread.
+  template <class T>
+  void add(size_t offset, T amount) noexcept {
+    add(local_block()[offset], amount);
+  }
+
+  // -- observers --------------------------------------------------------------
+
+  /// Returns the sum of the cell at `offset` across all blocks.
+  template <class T>
+  T sum(size_t offset) const noexcept {
+    auto result = T{0};
+    for (size_t shard = 0; shard <= mask_; ++shard) {
+      auto bits = cells_[shard * stride_ + offset].load(
+        std::memory_order_relaxed);
+      if constexpr (std::is_integral<T>::value)
+        result += static_cast<T>(bits);
+      else
+        result += from_bits<T>(bits);
+    }
+    return result;
+  }
+
+private:
+  template <class T>
+  static int64_t to_bits(T x) noexcept {
+    int64_t result;
+    memcpy(&result, &x, sizeof(int64_t));
+    return result;
+  }
+
+  template <class T>
+  static T from_bits(int64_t x) noexcept {
+    T result;
+    memcpy(&result, &x, sizeof(int64_t));
+    return result;
+  }
+
+  /// Selects a block, i.e., `num_shards - 1`.
+  size_t mask_;
+
+  /// Number of cells per block, including padding.
+  size_t stride_;
+
+  /// Points to the first cell of the first block.
+  cell_type* cells_;
+};
+
+/// Refers to a single cell in all blocks of a ::sharded_cells object.
+template <class T>
+class sharded_value {
+public:
+  constexpr sharded_value() noexcept : cells_(nullptr), offset_(0) {
+    // nop
+  }
+
+  sharded_value(sharded_cells* cells, size_t offset) noexcept
+    : cells_(cells), offset_(offset) {
+    // nop
+  }
+
+  /// Returns whether this object refers to a cell.
+  explicit operator bool() const noexcept {
+    return cells_ != nullptr;
+  }
+
+  /// Adds `amount` to the cell in the block of the calling thread.
+  /// @pre `static_cast<bool>(*this)`
+  void add(T amount) noexcept {
+    cells_->add(offset_, amount);
+  }
+
+  /// Returns the sum of the cell across all blocks.
+  /// @pre `static_cast<bool>(*this)`
+  T sum() const noexcept {
+    return cells_->template sum<T>(offset_);
+  }
+
+private:
+  sharded_cells* cells_;
+  size_t offset_;
+};
+
+} // namespace caf::detail
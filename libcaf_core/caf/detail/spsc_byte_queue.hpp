@@ -0,0 +1,77 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "caf/config.hpp"
+#include "caf/detail/core_export.hpp"
+
+namespace caf::detail {
+
+/// A bounded, lock-free queue for variable-sized records with exactly one
+/// producer and exactly one consumer. The producer never blocks: `try_push`
+/// simply fails if the queue has not enough free space left.
+class CAF_CORE_EXPORT spsc_byte_queue {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a queue that stores up to `capacity` bytes, rounded up to the next
+  /// power of two. Each record occupies its size plus four bytes.
+  explicit spsc_byte_queue(size_t capacity);
+
+  spsc_byte_queue(const spsc_byte_queue&) = delete;
+
+  spsc_byte_queue& operator=(const spsc_byte_queue&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the maximum number of bytes in the queue.
+  size_t capacity() const noexcept {
+    return mask_ + 1;
+  }
+
+  /// Returns whether the queue contains no records.
+  /// @note Only accurate when called by the consumer.
+  bool empty() const noexcept {
+    return rd_pos_.load(std::memory_order_relaxed)
+           == wr_pos_.load(std::memory_order_acquire);
+  }
+
+  // -- producer interface -----------------------------------------------------
+
+  /// Appends a record consisting of `header` followed by `payload`.
+  /// @returns `false` if the queue has not enough free space, `true`
+  ///          otherwise.
+  bool try_push(const void* header, size_t header_size, const void* payload,
+                size_t payload_size) noexcept;
+
+  // -- consumer interface -----------------------------------------------------
+
+  /// Copies the next record into `buf`, replacing its previous content.
+  /// @returns `false` if the queue is empty, `true` otherwise.
+  bool try_pop(std::vector<char>& buf);
+
+private:
+  void write(size_t pos, const void* src, size_t n) noexcept;
+
+  void read(size_t pos, void* dst, size_t n) const noexcept;
+
+  size_t mask_;
+
+  std::unique_ptr<char[]> buf_;
+
+  /// Read position of the consumer.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> rd_pos_;
+
+  /// Write position of the producer.
+  alignas(CAF_CACHE_LINE_SIZE) std::atomic<size_t> wr_pos_;
+};
+
+} // namespace caf::detail
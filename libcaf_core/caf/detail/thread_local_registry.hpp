@@ -0,0 +1,142 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+
+namespace caf::detail {
+
+/// Returns a process-wide unique ID for a ::thread_local_registry.
+CAF_CORE_EXPORT uint64_t next_thread_local_registry_id() noexcept;
+
+/// Gives each thread its own object of type `T` and keeps a list of all
+/// objects, e.g., for collecting data that threads record without
+/// synchronizing with each other. Threads keep one object per registry and
+/// keep it alive after the registry goes out of scope, i.e., an object
+/// outlives the registry until its thread terminates or accesses a new
+/// registry for `T`.
+template <class T>
+class thread_local_registry {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using pointer = std::shared_ptr<T>;
+
+  using entries_type = std::vector<pointer>;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  thread_local_registry()
+    : id_(next_thread_local_registry_id()), alive_(std::make_shared<char>()) {
+    // nop
+  }
+
+  thread_local_registry(const thread_local_registry&) = delete;
+
+  thread_local_registry& operator=(const thread_local_registry&) = delete;
+
+  // -- access -----------------------------------------------------------------
+
+  /// Returns the object of the calling thread. On the first access from a
+  /// thread, creates the object by calling `make(n)`, where `n` is the number
+  /// of objects in the registry, i.e., the position of the new object.
+  template <class Factory>
+  T& local(Factory&& make) {
+    // Threads usually access a single registry, e.g., the logger of their
+    // actor system. Hence, we check the most recent registry first.
+    auto& st = state();
+    if (st.last_owner != id_)
+      select(st, make);
+    return *st.last;
+  }
+
+  /// Calls `f` with the list of all objects while holding the lock.
+  /// @thread-safe
+  template <class F>
+  decltype(auto) with_entries(F&& f) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    return f(entries_);
+  }
+
+  /// Calls `f` with the list of all objects while holding the lock.
+  /// @thread-safe
+  template <class F>
+  decltype(auto) with_entries(F&& f) const {
+    std::unique_lock<std::mutex> guard{mtx_};
+    return f(std::as_const(entries_));
+  }
+
+private:
+  /// Stores the object of a thread for a single registry.
+  struct local_entry {
+    /// ID of the registry.
+    uint64_t owner;
+
+    /// Expires when the registry goes out of scope.
+    std::weak_ptr<char> alive;
+
+    /// Points to the object of the thread.
+    pointer ptr;
+  };
+
+  /// Stores the objects of a thread for all registries of type `T`.
+  struct local_state {
+    /// ID of the most recently accessed registry.
+    uint64_t last_owner = 0;
+
+    /// Object of the thread for the most recently accessed registry.
+    T* last = nullptr;
+
+    /// Objects of the thread for each registry it accessed.
+    std::vector<local_entry> entries;
+  };
+
+  static local_state& state() {
+    thread_local local_state result;
+    return result;
+  }
+
+  /// Makes the object for this registry the most recent object of the thread
+  /// and creates it if necessary.
+  template <class Factory>
+  void select(local_state& st, Factory& make) {
+    auto& xs = st.entries;
+    auto has_id = [this](const local_entry& x) { return x.owner == id_; };
+    auto i = std::find_if(xs.begin(), xs.end(), has_id);
+    if (i == xs.end()) {
+      // Drop the objects of all registries that no longer exist, e.g., in
+      // unit tests that start multiple actor systems from the same thread.
+      auto is_expired = [](const local_entry& x) { return x.alive.expired(); };
+      xs.erase(std::remove_if(xs.begin(), xs.end(), is_expired), xs.end());
+      pointer ptr;
+      { // Lifetime scope of guard.
+        std::unique_lock<std::mutex> guard{mtx_};
+        ptr = make(entries_.size());
+        entries_.emplace_back(ptr);
+      }
+      xs.emplace_back(local_entry{id_, alive_, std::move(ptr)});
+      i = xs.end() - 1;
+    }
+    st.last_owner = id_;
+    st.last = i->ptr.get();
+  }
+
+  uint64_t id_;
+
+  std::shared_ptr<char> alive_;
+
+  mutable std::mutex mtx_;
+
+  entries_type entries_;
+};
+
+} // namespace caf::detail
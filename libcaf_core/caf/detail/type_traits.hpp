@@ -785,6 +785,14 @@ struct is_list_like {
 template <class T>
 constexpr bool is_list_like_v = is_list_like<T>::value;
 
+/// Checks whether the binary serializers can write and read contiguous
+/// sequences of `T` in bulk, i.e., whether `T` is an arithmetic type with a
+/// fixed-size binary representation.
+template <class T>
+constexpr bool is_bulk_binary_value_v
+  = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value
+    && !std::is_same<T, long double>::value;
+
 template <class F, class... Ts>
 struct is_invocable {
 private:
@@ -0,0 +1,89 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/detail/fixed_size_reader.hpp"
+#include "caf/detail/fixed_size_writer.hpp"
+#include "caf/schema_inspector.hpp"
+#include "caf/type_schema.hpp"
+#include "caf/use_fixed_size_codec.hpp"
+
+namespace caf {
+
+/// Saves and loads objects of type `T` in the format of ::binary_serializer
+/// and ::binary_deserializer, but bypasses their per-value bounds checks and
+/// function calls if `T` has a fixed binary size. Since the codec computes the
+/// size from the ::type_schema of `T`, saving reserves the memory for an
+/// object at once and loading checks the input size only once. The codec
+/// falls back to the generic path for all other types, for compact integers
+/// and for objects that do not match the schema.
+///
+/// Using the codec for hot types with many fields, e.g., nested structs of
+/// numbers, replaces one out-of-line call per value with inline stores.
+/// Messages use the codec for all types that opt in via
+/// ::CAF_USE_FIXED_SIZE_CODEC.
+template <class T>
+class fixed_size_codec {
+public:
+  /// Returns the schema of `T`.
+  static const type_schema& schema() {
+    static const type_schema result = make_type_schema<T>();
+    return result;
+  }
+
+  /// Returns whether the codec bypasses the generic path for `T`.
+  static bool enabled() {
+    return schema().fixed_size();
+  }
+
+  /// Writes `x` to `sink`.
+  static bool save(binary_serializer& sink, const T& x) {
+    auto& xs = schema();
+    if (!xs.fixed_size() || sink.compact_integers())
+      return sink.apply(x);
+    auto& buf = sink.buf();
+    auto old_size = buf.size();
+    auto first = sink.write_pos();
+    sink.skip(xs.size());
+    detail::fixed_size_writer f{sink.context(), buf.data() + first,
+                                buf.data() + first + xs.size()};
+    if (f.apply(x) && f.position() == buf.data() + first + xs.size())
+      return true;
+    // Fall back to the generic path if `x` deviates from the schema, e.g.,
+    // due to an `inspect` overload that writes different fields per value.
+    buf.resize(old_size);
+    sink.seek(first);
+    return sink.apply(x);
+  }
+
+  /// Reads `x` from `source`.
+  static bool load(binary_deserializer& source, T& x) {
+    auto& xs = schema();
+    if (!xs.fixed_size() || source.compact_integers()
+        || source.remaining() < xs.size())
+      return source.apply(x);
+    auto first = source.current();
+    detail::fixed_size_reader f{source.context(), first, first + xs.size()};
+    if (f.apply(x) && f.position() == first + xs.size()) {
+      source.skip(xs.size());
+      return true;
+    }
+    // Let the generic path produce the error or handle the mismatch.
+    return source.apply(x);
+  }
+};
+
+} // namespace caf
+
+/// Enables ::fixed_size_codec for `type_name` when serializing messages.
+/// Requires that the specialization is visible when calling
+/// `init_global_meta_objects` for the type.
+#define CAF_USE_FIXED_SIZE_CODEC(type_name)                                    \
+  namespace caf {                                                              \
+  template <>                                                                  \
+  struct use_fixed_size_codec<type_name> : std::true_type {};                  \
+  }
@@ -30,7 +30,8 @@ public:
 
 private:
   void forward_msg(strong_actor_ptr sender, message_id mid, message msg,
-                   const forwarding_stack* fwd = nullptr);
+                   const forwarding_stack* fwd = nullptr,
+                   tracing_data_ptr tracing = nullptr);
 
   mutable detail::shared_spinlock broker_mtx_;
   actor broker_;
@@ -22,6 +22,7 @@ template <class> class callback;
 template <class> class dictionary;
 template <class> class downstream;
 template <class> class expected;
+template <class> class fixed_size_codec;
 template <class> class inbound_stream_slot;
 template <class> class intrusive_cow_ptr;
 template <class> class intrusive_ptr;
@@ -127,6 +128,9 @@ class resumable;
 class scheduled_actor;
 class scoped_actor;
 class serializer;
+class shared_byte_buffer;
+class shared_byte_span;
+class shared_string_view;
 class skip_t;
 class stream_manager;
 class string_view;
@@ -236,6 +240,7 @@ namespace telemetry {
 
 class component;
 class dbl_gauge;
+class hdr_layout;
 class int_gauge;
 class label;
 class label_view;
@@ -249,6 +254,9 @@ enum class metric_type : uint8_t;
 template <class ValueType>
 class counter;
 
+template <class ValueType>
+class hdr_histogram;
+
 template <class ValueType>
 class histogram;
 
@@ -259,14 +267,18 @@ template <class Type>
 class metric_impl;
 
 using dbl_counter = counter<double>;
+using dbl_hdr_histogram = hdr_histogram<double>;
 using dbl_histogram = histogram<double>;
 using int_counter = counter<int64_t>;
+using int_hdr_histogram = hdr_histogram<int64_t>;
 using int_histogram = histogram<int64_t>;
 
 using dbl_counter_family = metric_family_impl<dbl_counter>;
+using dbl_hdr_histogram_family = metric_family_impl<dbl_hdr_histogram>;
 using dbl_histogram_family = metric_family_impl<dbl_histogram>;
 using dbl_gauge_family = metric_family_impl<dbl_gauge>;
 using int_counter_family = metric_family_impl<int_counter>;
+using int_hdr_histogram_family = metric_family_impl<int_hdr_histogram>;
 using int_histogram_family = metric_family_impl<int_histogram>;
 using int_gauge_family = metric_family_impl<int_gauge>;
 
@@ -327,6 +339,7 @@ namespace scheduler {
 class abstract_worker;
 class test_coordinator;
 class abstract_coordinator;
+class event_tracer;
 
 } // namespace scheduler
 
@@ -347,11 +360,13 @@ class stream_distribution_tree;
 
 class abstract_worker;
 class abstract_worker_hub;
+class binary_log_writer;
 class disposer;
 class dynamic_message_data;
 class group_manager;
 class message_data;
 class private_thread;
+class serialized_size_inspector;
 
 struct meta_object;
 
@@ -0,0 +1,226 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/message_data.hpp"
+#include "caf/error.hpp"
+#include "caf/fwd.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/type_id_list.hpp"
+
+namespace caf {
+
+/// Deserializes a sequence of objects from binary input that arrives in
+/// chunks. The deserializer buffers input until it contains the next object
+/// and drops the bytes of each object after loading it. Loading a ::message
+/// resumes at the granularity of individual elements, i.e., the deserializer
+/// only needs to buffer the bytes of one element at a time. Elements of type
+/// `std::string`, ::byte_buffer, ::shared_byte_span and ::shared_string_view
+/// never get buffered: the deserializer appends their bytes to the element as
+/// they arrive.
+///
+/// Each load either succeeds, fails, or reports that the deserializer needs
+/// more input. In the latter case, the deserializer restarts the object from
+/// scratch once enough input arrived. To keep the total work linear in the
+/// input size, the deserializer waits until its buffer has doubled before
+/// trying to load the same object again.
+class CAF_CORE_EXPORT incremental_binary_deserializer {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Denotes the outcome of a load operation.
+  enum class load_result {
+    /// The deserializer loaded the object and dropped its bytes.
+    done,
+    /// The deserializer needs more input before it can load the object.
+    incomplete,
+    /// The input is malformed. The error is available via `get_error()`.
+    failed,
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a deserializer that fails to load objects that require more than
+  /// `max_buffer_size` bytes. A `max_buffer_size` of 0 disables the limit. The
+  /// limit does not apply to message elements that the deserializer loads
+  /// while receiving their bytes, e.g., strings.
+  explicit incremental_binary_deserializer(execution_unit* ctx,
+                                           size_t max_buffer_size
+                                           = 0) noexcept;
+
+  incremental_binary_deserializer(const incremental_binary_deserializer&)
+    = delete;
+
+  incremental_binary_deserializer&
+  operator=(const incremental_binary_deserializer&) = delete;
+
+  ~incremental_binary_deserializer();
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the current execution unit.
+  execution_unit* context() const noexcept {
+    return context_;
+  }
+
+  /// Returns how many bytes the deserializer currently buffers.
+  size_t buffered() const noexcept {
+    return buf_.size() - pos_;
+  }
+
+  /// Returns how many bytes the deserializer consumed in total.
+  size_t consumed() const noexcept {
+    return consumed_;
+  }
+
+  /// Returns the maximum number of buffered bytes or 0 for no limit.
+  size_t max_buffer_size() const noexcept {
+    return max_buffer_size_;
+  }
+
+  /// Returns whether the input has no more data.
+  bool closed() const noexcept {
+    return closed_;
+  }
+
+  /// Returns the last error.
+  const error& get_error() const noexcept {
+    return err_;
+  }
+
+  /// Returns whether the deserializer reads integers in compact form.
+  /// @see binary_serializer::compact_integers
+  bool compact_integers() const noexcept {
+    return compact_integers_;
+  }
+
+  /// Enables or disables compact integers.
+  /// @see binary_serializer::compact_integers
+  void compact_integers(bool value) noexcept {
+    compact_integers_ = value;
+  }
+
+  // -- input management -------------------------------------------------------
+
+  /// Appends `bytes` to the buffered input.
+  void append(const_byte_span bytes);
+
+  /// Signals that no more input follows. Loads that run out of input fail
+  /// after calling this function.
+  void close() noexcept;
+
+  /// Drops all buffered input and any partially loaded message.
+  void reset() noexcept;
+
+  // -- loading ----------------------------------------------------------------
+
+  /// Calls `fn` with a ::binary_deserializer for the buffered input and drops
+  /// the bytes that `fn` consumed on success. When running out of input,
+  /// `fn` may get called again with the same input plus more bytes.
+  /// @note types such as ::shared_byte_span always receive copies, because the
+  ///       deserializer re-uses its buffer.
+  template <class F>
+  load_result apply_fn(F&& fn) {
+    if (!ready())
+      return load_result::incomplete;
+    binary_deserializer source{context_, buf_.data() + pos_, buffered()};
+    source.compact_integers(compact_integers_);
+    auto ok = fn(source);
+    return finalize(source, ok);
+  }
+
+  /// Loads `x` from the buffered input.
+  template <class T>
+  load_result load(T& x) {
+    return apply_fn([&x](binary_deserializer& source) { //
+      return source.apply(x);
+    });
+  }
+
+  /// Loads `x` from the buffered input one element at a time.
+  /// @note the result is undefined when interleaving this function with other
+  ///       loads before it returns `done` or `failed`.
+  load_result load(message& x);
+
+  /// Loads `x` from the output of `message::save_values` one element at a
+  /// time.
+  /// @pre `types` remains valid for the lifetime of the program.
+  /// @note the result is undefined when interleaving this function with other
+  ///       loads before it returns `done` or `failed`.
+  load_result load_values(message& x, type_id_list types);
+
+private:
+  /// Checks whether enough input arrived since the last attempt.
+  bool ready() const noexcept {
+    return closed_ || buffered() >= next_attempt_;
+  }
+
+  /// Drops the consumed bytes on success or computes when to try again.
+  load_result finalize(binary_deserializer& source, bool ok);
+
+  /// Loads the remaining elements of the current message.
+  load_result load_elements(message& x);
+
+  /// Appends the available bytes to the string or byte buffer at `ptr`.
+  load_result load_blob(type_id_t type, void* ptr);
+
+  /// Drops the current message.
+  void reset_message() noexcept;
+
+  /// Provides access to the ::proxy_registry and to the ::actor_system.
+  execution_unit* context_;
+
+  /// Stores the input. Only bytes starting at `pos_` are valid.
+  byte_buffer buf_;
+
+  /// Points to the first byte of the next object in `buf_`.
+  size_t pos_ = 0;
+
+  /// Counts how many bytes the deserializer consumed in total.
+  size_t consumed_ = 0;
+
+  /// Restricts how many bytes a single object may occupy in the buffer.
+  size_t max_buffer_size_;
+
+  /// Minimum number of buffered bytes before trying to load again.
+  size_t next_attempt_ = 0;
+
+  /// Stores whether the input has no more data.
+  bool closed_ = false;
+
+  /// Configures whether integers use varint and zigzag encoding.
+  bool compact_integers_ = false;
+
+  /// Stores the last error.
+  error err_;
+
+  /// Stores the elements of a partially loaded message.
+  intrusive_ptr<detail::message_data> msg_data_;
+
+  /// Stores how many elements of `msg_data_` are complete.
+  size_t msg_loaded_ = 0;
+
+  /// Stores whether the element at `msg_loaded_` holds a constructed object.
+  bool element_constructed_ = false;
+
+  /// Stores whether the deserializer has read the size of the string or byte
+  /// buffer at `msg_loaded_`.
+  bool blob_started_ = false;
+
+  /// Stores how many bytes of the string or byte buffer at `msg_loaded_` are
+  /// still missing.
+  size_t blob_pending_ = 0;
+
+  /// Collects the bytes for shared strings and byte spans.
+  byte_buffer blob_;
+};
+
+} // namespace caf
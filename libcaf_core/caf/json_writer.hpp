@@ -105,10 +105,16 @@ public:
   // -- modifiers --------------------------------------------------------------
 
   /// Removes all characters from the buffer and restores the writer to its
-  /// initial state.
+  /// initial state. Keeps the allocated memory of the buffer.
   /// @warning Invalidates all string views into the buffer.
   void reset();
 
+  /// Reserves memory for at least `num_bytes` more characters in the buffer.
+  /// Allows users to size the buffer once when writing large objects
+  /// repeatedly or when knowing the approximate output size in advance.
+  /// @warning Invalidates all string views into the buffer.
+  void reserve(size_t num_bytes);
+
   // -- overrides --------------------------------------------------------------
 
   bool begin_object(type_id_t type, string_view name) override;
@@ -233,6 +239,9 @@ private:
     buf_.insert(buf_.end(), str.begin(), str.end());
   }
 
+  // Adds `str` as quoted and escaped JSON string to the output buffer.
+  void add_escaped(string_view str);
+
   // Adds a separator to the output buffer unless the current entry is empty.
   // The separator is just a comma when in compact mode and otherwise a comma
   // followed by a newline.
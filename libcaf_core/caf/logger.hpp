@@ -4,14 +4,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
+#include <vector>
 
 #include "caf/abstract_actor.hpp"
 #include "caf/config.hpp"
@@ -23,6 +28,7 @@
 #include "caf/detail/ringbuffer.hpp"
 #include "caf/detail/scope_guard.hpp"
 #include "caf/detail/shared_spinlock.hpp"
+#include "caf/detail/thread_local_registry.hpp"
 #include "caf/fwd.hpp"
 #include "caf/intrusive/drr_queue.hpp"
 #include "caf/intrusive/fifo_inbox.hpp"
@@ -82,6 +88,16 @@ public:
     /// Configures whether the logger generates colored output.
     bool console_coloring : 1;
 
+    /// Configures whether each thread writes its events to a lock-free buffer
+    /// instead of the shared event queue. The logger thread collects the
+    /// events from all buffers. Threads drop events when their buffer is full
+    /// instead of blocking.
+    bool per_thread_buffers : 1;
+
+    /// Configures whether the logger writes the log file in a compact binary
+    /// format instead of rendering each event with the file format.
+    bool binary_file : 1;
+
     config();
   };
 
@@ -129,6 +145,10 @@ public:
     /// Thread ID of the caller.
     std::thread::id tid;
 
+    /// Optional representation of the thread ID. Only set for events read
+    /// from a binary log, since `tid` has no portable representation.
+    string_view thread_name;
+
     /// Actor ID of the caller.
     actor_id aid;
 
@@ -260,6 +280,11 @@ public:
   /// Renders `x` using the line format `lf` to `out`.
   void render(std::ostream& out, const line_format& lf, const event& x) const;
 
+  /// Renders `x` using the line format `lf` to `out`, computing the runtime
+  /// field relative to `t0`.
+  static void render_event(std::ostream& out, const line_format& lf,
+                           const event& x, timestamp t0);
+
   /// Returns a string representation of the joined groups of `x` if `x` is an
   /// actor with the `subscriber` mixin.
   template <class T>
@@ -313,10 +338,21 @@ private:
 
   void log_last_line();
 
+  // -- per-thread buffers -----------------------------------------------------
+
+  struct thread_buffer;
+
+  void push_to_thread_buffer(const event& x);
+
+  size_t flush_thread_buffers(std::vector<event>& events,
+                              std::vector<char>& record);
+
   // -- thread management ------------------------------------------------------
 
   void run();
 
+  void run_buffered();
+
   void start();
 
   void stop();
@@ -362,6 +398,24 @@ private:
 
   // Executes `logger::run`.
   std::thread thread_;
+
+  // Writes the log file if `cfg_.binary_file` is set.
+  std::unique_ptr<detail::binary_log_writer> binary_writer_;
+
+  // Configures the capacity of each per-thread buffer in bytes.
+  size_t thread_buffer_size_;
+
+  // Stores the buffers of all threads that logged at least one event.
+  detail::thread_local_registry<thread_buffer> thread_buffers_;
+
+  // Guards `stopping_` for waiting on `stopping_cv_`.
+  std::mutex stopping_mtx_;
+
+  // Wakes up the logger thread when stopping.
+  std::condition_variable stopping_cv_;
+
+  // Signals the logger thread to process remaining events and stop.
+  std::atomic<bool> stopping_;
 };
 
 CAF_CORE_EXPORT std::string to_string(logger::field_type x);
@@ -125,10 +125,22 @@ public:
 
   bool save(binary_serializer& sink) const;
 
+  bool save(detail::serialized_size_inspector& sink) const;
+
   bool load(deserializer& source);
 
   bool load(binary_deserializer& source);
 
+  /// Saves the elements of this message without type information. Hence,
+  /// readers must know the types of the message ahead of time.
+  /// @see load_values
+  bool save_values(binary_serializer& sink) const;
+
+  /// Restores a message from the output of `save_values`.
+  /// @pre `types` remains valid for the lifetime of the program, e.g., because
+  ///      it was created by `make_type_id_list` or `type_id_list_builder`.
+  bool load_values(binary_deserializer& source, type_id_list types);
+
   // -- element access ---------------------------------------------------------
 
   /// Returns the type ID of the element at `index`.
@@ -214,7 +226,8 @@ message make_message(Ts&&... xs) {
   auto vptr = malloc(data_size);
   if (vptr == nullptr)
     CAF_RAISE_ERROR(std::bad_alloc, "bad_alloc");
-  auto raw_ptr = new (vptr) message_data(types);
+  auto& layout = static_layout_of<strip_and_convert_t<Ts>...>();
+  auto raw_ptr = new (vptr) message_data(types, layout);
   intrusive_cow_ptr<message_data> ptr{raw_ptr, false};
   raw_ptr->init(std::forward<Ts>(xs)...);
   return message{std::move(ptr)};
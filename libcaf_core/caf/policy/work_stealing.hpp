@@ -18,6 +18,9 @@
 #include "caf/detail/double_ended_queue.hpp"
 #include "caf/policy/unprofiled.hpp"
 #include "caf/resumable.hpp"
+#include "caf/scheduler/event_tracer.hpp"
+#include "caf/telemetry/counter.hpp"
+#include "caf/telemetry/gauge.hpp"
 #include "caf/timespan.hpp"
 
 namespace caf::policy {
@@ -84,7 +87,20 @@ public:
     if (victim == self->id())
       victim = p->num_workers() - 1;
     // steal oldest element from the victim's queue
-    return d(p->worker_by_id(victim)).queue.take_tail();
+    auto victim_ptr = p->worker_by_id(victim);
+    auto job = d(victim_ptr).queue.take_tail();
+    if (auto tracer = p->tracer(); tracer && job)
+      tracer->record(scheduler::event_tracer::event_type::steal,
+                     self->id_of(job), victim);
+    if (auto& m = self->metrics(); m.steals != nullptr) {
+      if (job) {
+        m.steals->inc();
+        victim_ptr->metrics().queue_size->dec();
+      } else {
+        m.failed_steals->inc();
+      }
+    }
+    return job;
   }
 
   template <class Coordinator>
@@ -96,6 +112,7 @@ public:
   template <class Worker>
   void external_enqueue(Worker* self, resumable* job) {
     d(self).queue.append(job);
+    inc_queue_size(self);
     auto& lock = d(self).waitdata.lock;
     auto& cv = d(self).waitdata.cv;
     { // guard scope
@@ -109,6 +126,7 @@ public:
   template <class Worker>
   void internal_enqueue(Worker* self, resumable* job) {
     d(self).queue.prepend(job);
+    inc_queue_size(self);
   }
 
   template <class Worker>
@@ -116,6 +134,7 @@ public:
     // job has voluntarily released the CPU to let others run instead
     // this means we are going to put this job to the very end of our queue
     d(self).queue.append(job);
+    inc_queue_size(self);
   }
 
   template <class Worker>
@@ -125,18 +144,24 @@ public:
     // polling, then we relax our polling a bit and wait 50 us between
     // dequeue attempts
     auto& strategies = d(self).strategies;
+    auto& metrics = self->metrics();
     resumable* job = nullptr;
     for (size_t k = 0; k < 2; ++k) { // iterate over the first two strategies
+      auto t0 = poll_start(metrics);
       for (size_t i = 0; i < strategies[k].attempts;
            i += strategies[k].step_size) {
-        job = d(self).queue.take_head();
-        if (job)
+        job = take_head(self);
+        if (job) {
+          add_poll_time(metrics, k, t0);
           return job;
+        }
         // try to steal every X poll attempts
         if ((i % strategies[k].steal_interval) == 0) {
           job = try_steal(self);
-          if (job)
+          if (job) {
+            add_poll_time(metrics, k, t0);
             return job;
+          }
         }
         if (strategies[k].sleep_duration.count() > 0) {
 #ifdef CAF_MSVC
@@ -152,6 +177,7 @@ public:
 #endif
         }
       }
+      add_poll_time(metrics, k, t0);
     }
     // we assume pretty much nothing is going on so we can relax polling
     // and falling to sleep on a condition variable whose timeout is the one
@@ -162,7 +188,10 @@ public:
     auto& cv = d(self).waitdata.cv;
     bool notimeout = true;
     size_t i = 1;
+    auto t0 = poll_start(metrics);
     do {
+      if (metrics.parks != nullptr)
+        metrics.parks->inc();
       { // guard scope
         std::unique_lock<std::mutex> guard(lock);
         sleeping = true;
@@ -172,7 +201,9 @@ public:
         sleeping = false;
       }
       if (notimeout) {
-        job = d(self).queue.take_head();
+        if (metrics.unparks != nullptr)
+          metrics.unparks->inc();
+        job = take_head(self);
       } else {
         notimeout = true;
         if ((i % relaxed.steal_interval) == 0)
@@ -180,12 +211,13 @@ public:
       }
       ++i;
     } while (job == nullptr);
+    add_poll_time(metrics, 2, t0);
     return job;
   }
 
   template <class Worker, class UnaryFunction>
   void foreach_resumable(Worker* self, UnaryFunction f) {
-    auto next = [&] { return d(self).queue.take_head(); };
+    auto next = [&] { return take_head(self); };
     for (auto job = next(); job != nullptr; job = next()) {
       f(job);
     }
@@ -195,6 +227,43 @@ public:
   void foreach_central_resumable(Coordinator*, UnaryFunction) {
     // nop
   }
+
+private:
+  // -- metrics ----------------------------------------------------------------
+
+  using clock_type = std::chrono::steady_clock;
+
+  template <class Worker>
+  static void inc_queue_size(Worker* self) {
+    if (auto gauge = self->metrics().queue_size)
+      gauge->inc();
+  }
+
+  template <class Worker>
+  static resumable* take_head(Worker* self) {
+    auto job = d(self).queue.take_head();
+    if (auto gauge = self->metrics().queue_size; gauge && job)
+      gauge->dec();
+    return job;
+  }
+
+  template <class Metrics>
+  static clock_type::time_point poll_start(const Metrics& metrics) {
+    if (metrics.poll_time[0] != nullptr)
+      return clock_type::now();
+    return {};
+  }
+
+  template <class Metrics>
+  static void add_poll_time(const Metrics& metrics, size_t strategy,
+                            clock_type::time_point t0) {
+    if (auto counter = metrics.poll_time[strategy]) {
+      using fractional_seconds = std::chrono::duration<double>;
+      auto dt = std::chrono::duration_cast<fractional_seconds>(clock_type::now()
+                                                               - t0);
+      counter->inc(dt.count());
+    }
+  }
 };
 
 } // namespace caf::policy
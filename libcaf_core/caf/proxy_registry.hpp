@@ -4,9 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
-#include <map>
-#include <mutex>
 #include <unordered_map>
 #include <utility>
 
@@ -14,6 +15,7 @@
 #include "caf/actor_cast.hpp"
 #include "caf/actor_proxy.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/shared_spinlock.hpp"
 #include "caf/exit_reason.hpp"
 #include "caf/fwd.hpp"
 #include "caf/node_id.hpp"
@@ -36,6 +38,41 @@ public:
     virtual void set_last_hop(node_id* ptr) = 0;
   };
 
+  /// Caches recently used proxies for a single thread of execution, e.g., a
+  /// BASP worker. Looking up a cached proxy neither locks the registry nor
+  /// searches its maps. The cache drops all entries whenever the registry
+  /// erases proxies.
+  class CAF_CORE_EXPORT local_cache {
+  public:
+    /// Number of cache slots. Must be a power of two.
+    static constexpr size_t num_slots = 16;
+
+    /// Returns the cached proxy for `nid` and `aid` or `nullptr`.
+    strong_actor_ptr get(const proxy_registry& owner, const node_id& nid,
+                         actor_id aid);
+
+    /// Stores `ptr` as proxy for `nid` and `aid`.
+    void put(const node_id& nid, actor_id aid, const strong_actor_ptr& ptr);
+
+    /// Drops all entries.
+    void clear();
+
+  private:
+    struct entry {
+      node_id nid;
+      actor_id aid = invalid_actor_id;
+      weak_actor_ptr ptr;
+    };
+
+    static constexpr size_t slot(actor_id aid) noexcept {
+      return static_cast<size_t>(aid & (num_slots - 1));
+    }
+
+    const proxy_registry* owner_ = nullptr;
+    uint64_t epoch_ = 0;
+    std::array<entry, num_slots> entries_;
+  };
+
   proxy_registry(actor_system& sys, backend& be);
 
   proxy_registry(const proxy_registry&) = delete;
@@ -56,7 +93,7 @@ public:
   actor_addr read(deserializer* source);
 
   /// A map that stores all proxies for known remote actors.
-  using proxy_map = std::map<actor_id, strong_actor_ptr>;
+  using proxy_map = std::unordered_map<actor_id, strong_actor_ptr>;
 
   /// Returns the number of proxies for `node`.
   size_t count_proxies(const node_id& node) const;
@@ -99,14 +136,24 @@ public:
     backend_.set_last_hop(ptr);
   }
 
+  /// Sets the thread-local cache for `get_or_put` or disables caching if
+  /// `ptr == nullptr`.
+  static void set_local_cache(local_cache* ptr) noexcept;
+
+  /// Returns a counter that changes whenever the registry erases proxies.
+  uint64_t epoch() const noexcept {
+    return epoch_.load(std::memory_order_acquire);
+  }
+
 private:
   /// @pre mtx_ is locked
   void kill_proxy(strong_actor_ptr&, error);
 
   actor_system& system_;
   backend& backend_;
-  mutable std::mutex mtx_;
+  mutable detail::shared_spinlock mtx_;
   std::unordered_map<node_id, proxy_map> proxies_;
+  std::atomic<uint64_t> epoch_;
 };
 
 } // namespace caf
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <memory>
+#include <string>
 
 #include "caf/actor.hpp"
 #include "caf/actor_addr.hpp"
@@ -16,6 +19,7 @@
 #include "caf/detail/core_export.hpp"
 #include "caf/fwd.hpp"
 #include "caf/message.hpp"
+#include "caf/scheduler/event_tracer.hpp"
 
 namespace caf::scheduler {
 
@@ -27,6 +31,32 @@ class CAF_CORE_EXPORT abstract_coordinator : public actor_system::module {
 public:
   enum utility_actor_id : size_t { printer_id, max_id };
 
+  /// Optional metrics collected by individual workers when configured to do
+  /// so. Policies only update the metrics that apply to them.
+  struct worker_metrics_t {
+    /// Counts how many jobs are currently waiting in the queue of the worker.
+    telemetry::int_gauge* queue_size = nullptr;
+
+    /// Counts how many jobs the worker stole from others.
+    telemetry::int_counter* steals = nullptr;
+
+    /// Counts how many steal attempts of the worker found no job.
+    telemetry::int_counter* failed_steals = nullptr;
+
+    /// Accumulates the time the worker spent polling for jobs with the
+    /// aggressive, moderate and relaxed strategy.
+    std::array<telemetry::dbl_counter*, 3> poll_time{};
+
+    /// Counts how often the worker went to sleep while waiting for jobs.
+    telemetry::int_counter* parks = nullptr;
+
+    /// Counts how often new jobs woke up the sleeping worker.
+    telemetry::int_counter* unparks = nullptr;
+
+    /// Samples how long the worker runs a job before the job returns.
+    telemetry::dbl_histogram* resume_duration = nullptr;
+  };
+
   explicit abstract_coordinator(actor_system& sys);
 
   /// Returns a handle to the central printing actor.
@@ -73,9 +103,23 @@ public:
 
   static size_t default_thread_count() noexcept;
 
+  /// Returns the metrics for the worker with ID `worker_id`. All pointers are
+  /// `nullptr` unless `caf.scheduler.enable-metrics` is set.
+  worker_metrics_t make_worker_metrics(size_t worker_id);
+
+  /// Returns the tracer for scheduling events or `nullptr` if tracing is
+  /// disabled.
+  event_tracer* tracer() const noexcept {
+    return tracer_.get();
+  }
+
 protected:
   void stop_actors();
 
+  /// Writes the recorded scheduling events to the configured trace file.
+  /// Does nothing if tracing is disabled.
+  void write_trace_file();
+
   /// ID of the worker receiving the next enqueue (round-robin dispatch).
   std::atomic<size_t> next_worker_;
 
@@ -90,6 +134,15 @@ protected:
 
   /// Reference to the host system.
   actor_system& system_;
+
+  /// Stores whether workers collect metrics.
+  bool collect_metrics_;
+
+  /// Records scheduling events if `caf.scheduler.trace-file` is set.
+  std::unique_ptr<event_tracer> tracer_;
+
+  /// Output path for the recorded scheduling events.
+  std::string trace_file_;
 };
 
 } // namespace caf::scheduler
@@ -60,8 +60,11 @@ protected:
       w->start();
     // Launch an additional background thread for dispatching timeouts and
     // delayed messages.
-    timer_ = system().launch_thread("caf.clock",
-                                    [this] { clock_.run_dispatch_loop(); });
+    timer_ = system().launch_thread("caf.clock", [this] {
+      if (auto tracer = this->tracer())
+        tracer->set_thread_name("caf.clock");
+      clock_.run_dispatch_loop();
+    });
     // Run remaining startup code.
     super::start();
   }
@@ -124,6 +127,8 @@ protected:
     // stop timer thread
     clock_.cancel_dispatch_loop();
     timer_.join();
+    // All threads of the scheduler are done, i.e., the trace is complete.
+    write_trace_file();
   }
 
   void enqueue(resumable* ptr) override {
@@ -0,0 +1,127 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/thread_local_registry.hpp"
+
+namespace caf::scheduler {
+
+/// Records scheduling activity of an actor system into per-thread ring buffers
+/// of fixed-size binary records and exports them in the Chrome trace event
+/// format. Tools such as `chrome://tracing` or Perfetto render this format as
+/// timeline, showing when each worker ran which actor, how long actors waited
+/// for a worker after receiving a message, and which worker stole from which.
+///
+/// The scheduler creates a tracer if `caf.scheduler.trace-file` is set. All
+/// hooks check for a tracer first, i.e., tracing has no overhead beyond a
+/// branch when disabled.
+/// @experimental
+class CAF_CORE_EXPORT event_tracer {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Identifies the kind of a recorded event.
+  enum class event_type : uint8_t {
+    /// A thread starts running an actor. The argument is unused.
+    resume_begin,
+    /// A thread stops running an actor. The argument is the
+    /// `resumable::resume_result`.
+    resume_end,
+    /// A worker stole an actor. The argument is the ID of the victim.
+    steal,
+    /// A message arrived in the mailbox of an actor. The argument is 1 if the
+    /// message caused the actor to get scheduled, 0 otherwise.
+    mailbox_enqueue,
+    /// An actor tries to process a message from its mailbox. The argument is
+    /// the message ID. Skipped messages appear again on the next attempt.
+    mailbox_dequeue,
+    /// The multiplexer starts handling an I/O event. The actor ID is the
+    /// socket and the argument is the `io::network::operation`.
+    io_begin,
+    /// The multiplexer stops handling an I/O event. The actor ID is the socket
+    /// and the argument is the `io::network::operation`.
+    io_end,
+  };
+
+  /// A single entry in the ring buffer of a thread.
+  struct entry {
+    /// Nanoseconds since the tracer started.
+    int64_t time;
+
+    /// ID of the actor or socket this event refers to.
+    uint64_t id;
+
+    /// Event-specific argument.
+    uint64_t arg;
+
+    /// Kind of the event.
+    event_type type;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// @param capacity Maximum number of entries per thread. Threads overwrite
+  ///                 their oldest entry when exceeding this limit.
+  explicit event_tracer(size_t capacity);
+
+  ~event_tracer();
+
+  event_tracer(const event_tracer&) = delete;
+
+  event_tracer& operator=(const event_tracer&) = delete;
+
+  // -- recording --------------------------------------------------------------
+
+  /// Adds an event to the ring buffer of the calling thread. Only the calling
+  /// thread writes to its ring buffer, i.e., recording never blocks.
+  void record(event_type type, uint64_t id, uint64_t arg);
+
+  /// Assigns a name to the calling thread for the exported trace. Unnamed
+  /// threads appear as `thread <n>`.
+  void set_thread_name(std::string name);
+
+  // -- exporting --------------------------------------------------------------
+
+  /// Returns the recorded events of all threads with the name of the
+  /// recording thread, sorted by time.
+  /// @thread-safe
+  std::vector<std::pair<std::string, entry>> entries() const;
+
+  /// Writes all recorded events in the Chrome trace event format.
+  /// @thread-safe
+  void write_chrome_trace(std::ostream& out) const;
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  using clock_type = std::chrono::steady_clock;
+
+  struct thread_data;
+
+  // -- utility functions ------------------------------------------------------
+
+  thread_data& local_data();
+
+  // -- member variables -------------------------------------------------------
+
+  /// Configures the size of the ring buffers.
+  size_t capacity_;
+
+  /// Start time for the trace timestamps.
+  clock_type::time_point t0_;
+
+  /// Stores the data of all threads that recorded at least one event.
+  detail::thread_local_registry<thread_data> threads_;
+};
+
+} // namespace caf::scheduler
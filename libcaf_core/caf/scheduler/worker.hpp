@@ -5,12 +5,16 @@
 #pragma once
 
 #include <cstddef>
+#include <string>
 
 #include "caf/detail/double_ended_queue.hpp"
 #include "caf/detail/set_thread_name.hpp"
 #include "caf/execution_unit.hpp"
 #include "caf/logger.hpp"
 #include "caf/resumable.hpp"
+#include "caf/scheduler/abstract_coordinator.hpp"
+#include "caf/scheduler/event_tracer.hpp"
+#include "caf/telemetry/timer.hpp"
 
 namespace caf::scheduler {
 
@@ -24,6 +28,7 @@ public:
   using job_ptr = resumable*;
   using coordinator_ptr = coordinator<Policy>*;
   using policy_data = typename Policy::worker_data;
+  using metrics_t = abstract_coordinator::worker_metrics_t;
 
   worker(size_t worker_id, coordinator_ptr worker_parent,
          const policy_data& init, size_t throughput)
@@ -31,7 +36,8 @@ public:
       max_throughput_(throughput),
       id_(worker_id),
       parent_(worker_parent),
-      data_(init) {
+      data_(init),
+      metrics_(worker_parent->make_worker_metrics(worker_id)) {
     // nop
   }
 
@@ -84,16 +90,38 @@ public:
     return max_throughput_;
   }
 
+  /// Returns the metrics of this worker. All pointers are `nullptr` unless
+  /// the scheduler collects metrics.
+  const metrics_t& metrics() const noexcept {
+    return metrics_;
+  }
+
 private:
   void run() {
     CAF_SET_LOGGER_SYS(&system());
+    using event_type = event_tracer::event_type;
+    auto tracer = parent_->tracer();
+    if (tracer)
+      tracer->set_thread_name("caf.worker." + std::to_string(id_));
     // scheduling loop
     for (;;) {
       auto job = policy_.dequeue(this);
       CAF_ASSERT(job != nullptr);
       CAF_ASSERT(job->subtype() != resumable::io_actor);
       policy_.before_resume(this, job);
+      actor_id aid = 0;
+      if (tracer) {
+        aid = id_of(job);
+        tracer->record(event_type::resume_begin, aid, 0);
+      }
+      auto t0 = metrics_.resume_duration != nullptr
+                  ? telemetry::timer::clock_type::now()
+                  : telemetry::timer::clock_type::time_point{};
       auto res = job->resume(this, max_throughput_);
+      if (metrics_.resume_duration != nullptr)
+        telemetry::timer::observe(metrics_.resume_duration, t0);
+      if (tracer)
+        tracer->record(event_type::resume_end, aid, res);
       policy_.after_resume(this, job);
       switch (res) {
         case resumable::resume_later: {
@@ -131,6 +159,8 @@ private:
   policy_data data_;
   // instance of our policy object
   Policy policy_;
+  // optional metrics, see caf.scheduler.enable-metrics
+  metrics_t metrics_;
 };
 
 } // namespace caf::scheduler
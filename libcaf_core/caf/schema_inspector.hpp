@@ -0,0 +1,164 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "caf/byte.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/squashed_int.hpp"
+#include "caf/fwd.hpp"
+#include "caf/save_inspector_base.hpp"
+#include "caf/span.hpp"
+#include "caf/string_view.hpp"
+#include "caf/type_schema.hpp"
+
+namespace caf {
+
+/// Records the binary representation of inspected objects as ::type_schema.
+/// The inspector mirrors ::binary_serializer but writes no output.
+class CAF_CORE_EXPORT schema_inspector
+  : public save_inspector_base<schema_inspector> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = save_inspector_base<schema_inspector>;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit schema_inspector(type_schema& result) noexcept : result_(result) {
+    // nop
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns `nullptr`, since the inspector has no execution context.
+  execution_unit* context() const noexcept {
+    return nullptr;
+  }
+
+  static constexpr bool has_human_readable_format() noexcept {
+    return false;
+  }
+
+  // -- interface functions ----------------------------------------------------
+
+  bool begin_object(type_id_t type, string_view name);
+
+  bool end_object();
+
+  bool begin_field(string_view name);
+
+  bool begin_field(string_view name, bool is_present);
+
+  bool begin_field(string_view name, span<const type_id_t> types,
+                   size_t index);
+
+  bool begin_field(string_view name, bool is_present,
+                   span<const type_id_t> types, size_t index);
+
+  bool end_field();
+
+  bool begin_tuple(size_t size);
+
+  bool end_tuple();
+
+  bool begin_key_value_pair();
+
+  bool end_key_value_pair();
+
+  bool begin_sequence(size_t size);
+
+  bool end_sequence();
+
+  bool begin_associative_array(size_t size);
+
+  bool end_associative_array();
+
+  bool value(byte x);
+
+  bool value(bool x);
+
+  bool value(int8_t x);
+
+  bool value(uint8_t x);
+
+  bool value(int16_t x);
+
+  bool value(uint16_t x);
+
+  bool value(int32_t x);
+
+  bool value(uint32_t x);
+
+  bool value(int64_t x);
+
+  bool value(uint64_t x);
+
+  template <class T>
+  std::enable_if_t<std::is_integral<T>::value, bool> value(T x) {
+    return value(static_cast<detail::squashed_int_t<T>>(x));
+  }
+
+  bool value(float x);
+
+  bool value(double x);
+
+  bool value(long double x);
+
+  bool value(string_view x);
+
+  bool value(const std::u16string& x);
+
+  bool value(const std::u32string& x);
+
+  bool value(span<const byte> x);
+
+  bool value(const std::vector<bool>& x);
+
+private:
+  /// Returns the current field path.
+  std::string path() const;
+
+  /// Records a value with fixed size unless inside a variable-size value.
+  bool add_fixed(type_id_t type, size_t size);
+
+  /// Records a value with variable size unless inside a variable-size value.
+  bool add_variable(type_id_t type);
+
+  /// Receives the recorded fields.
+  type_schema& result_;
+
+  /// Stores the names of all open fields.
+  std::vector<string_view> names_;
+
+  /// Stores for each open field whether it has a variable size.
+  std::vector<bool> variable_fields_;
+
+  /// Counts the currently open objects.
+  size_t objects_ = 0;
+
+  /// Counts the currently open values with variable size. The inspector
+  /// ignores their content.
+  size_t variable_ = 0;
+};
+
+/// Derives the ::type_schema of `T` by inspecting a default-constructed
+/// instance of `T` with a ::schema_inspector.
+/// @relates type_schema
+template <class T>
+type_schema make_type_schema() {
+  type_schema result;
+  schema_inspector f{result};
+  T x{};
+  auto unused = f.apply(x);
+  static_cast<void>(unused); // Always true.
+  return result;
+}
+
+} // namespace caf
@@ -0,0 +1,150 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "caf/byte.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
+#include "caf/detail/comparable.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/ref_counted.hpp"
+
+namespace caf {
+
+/// A reference-counted ::byte_buffer. Allows ::shared_byte_span and
+/// ::shared_string_view objects to point into received data instead of copying
+/// it.
+class CAF_CORE_EXPORT shared_byte_buffer : public ref_counted {
+public:
+  shared_byte_buffer() = default;
+
+  explicit shared_byte_buffer(byte_buffer bytes) : bytes(std::move(bytes)) {
+    // nop
+  }
+
+  ~shared_byte_buffer() override;
+
+  /// The shared content.
+  byte_buffer bytes;
+};
+
+/// @relates shared_byte_buffer
+using shared_byte_buffer_ptr = intrusive_ptr<shared_byte_buffer>;
+
+/// An immutable sequence of bytes that keeps its storage alive through a
+/// reference count. When loading from a ::binary_deserializer with an input
+/// owner, the span points into the input instead of copying its bytes.
+class CAF_CORE_EXPORT shared_byte_span
+  : detail::comparable<shared_byte_span> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using value_type = byte;
+
+  using const_iterator = const byte*;
+
+  using iterator = const_iterator;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  shared_byte_span() noexcept = default;
+
+  shared_byte_span(const shared_byte_span&) = default;
+
+  shared_byte_span(shared_byte_span&&) noexcept = default;
+
+  /// Creates a span that owns `bytes`.
+  explicit shared_byte_span(byte_buffer bytes);
+
+  /// Creates a span that points to `bytes` and keeps `owner` alive.
+  /// @pre `owner` stores `bytes`
+  shared_byte_span(intrusive_ptr<ref_counted> owner,
+                   const_byte_span bytes) noexcept
+    : owner_(std::move(owner)), data_(bytes.data()), size_(bytes.size()) {
+    // nop
+  }
+
+  shared_byte_span& operator=(const shared_byte_span&) = default;
+
+  shared_byte_span& operator=(shared_byte_span&&) noexcept = default;
+
+  // -- properties -------------------------------------------------------------
+
+  const byte* data() const noexcept {
+    return data_;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  const_iterator begin() const noexcept {
+    return data_;
+  }
+
+  const_iterator end() const noexcept {
+    return data_ + size_;
+  }
+
+  const_byte_span bytes() const noexcept {
+    return {data_, size_};
+  }
+
+  /// Returns the object that owns the memory of this span.
+  ref_counted* owner() const noexcept {
+    return owner_.get();
+  }
+
+  // -- comparison -------------------------------------------------------------
+
+  int compare(const shared_byte_span& other) const noexcept;
+
+  // -- serialization ----------------------------------------------------------
+
+  /// Loads the span from `source`, sharing the input buffer of `source` if it
+  /// has an input owner.
+  bool load(binary_deserializer& source);
+
+  template <class Inspector>
+  friend bool inspect(Inspector& f, shared_byte_span& x) {
+    if constexpr (Inspector::is_loading) {
+      if constexpr (std::is_same<Inspector, binary_deserializer>::value) {
+        return x.load(f);
+      } else {
+        byte_buffer buf;
+        if (!f.apply(buf))
+          return false;
+        x = shared_byte_span{std::move(buf)};
+        return true;
+      }
+    } else if constexpr (std::is_same<Inspector, binary_serializer>::value) {
+      return f.begin_sequence(x.size()) && f.value(x.bytes())
+             && f.end_sequence();
+    } else {
+      if (!f.begin_sequence(x.size()))
+        return false;
+      for (auto b : x)
+        if (!f.value(b))
+          return false;
+      return f.end_sequence();
+    }
+  }
+
+private:
+  intrusive_ptr<ref_counted> owner_;
+  const byte* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace caf
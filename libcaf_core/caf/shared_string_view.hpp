@@ -0,0 +1,123 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include "caf/detail/comparable.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/ref_counted.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf {
+
+/// An immutable string that keeps its storage alive through a reference
+/// count. When loading from a ::binary_deserializer with an input owner, the
+/// view points into the input instead of copying its characters.
+class CAF_CORE_EXPORT shared_string_view
+  : detail::comparable<shared_string_view>,
+    detail::comparable<shared_string_view, string_view> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using value_type = char;
+
+  using const_iterator = const char*;
+
+  using iterator = const_iterator;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  shared_string_view() noexcept = default;
+
+  shared_string_view(const shared_string_view&) = default;
+
+  shared_string_view(shared_string_view&&) noexcept = default;
+
+  /// Creates a view that owns `str`.
+  explicit shared_string_view(std::string str);
+
+  /// Creates a view that points to `str` and keeps `owner` alive.
+  /// @pre `owner` stores `str`
+  shared_string_view(intrusive_ptr<ref_counted> owner, string_view str) noexcept
+    : owner_(std::move(owner)), data_(str.data()), size_(str.size()) {
+    // nop
+  }
+
+  shared_string_view& operator=(const shared_string_view&) = default;
+
+  shared_string_view& operator=(shared_string_view&&) noexcept = default;
+
+  // -- properties -------------------------------------------------------------
+
+  const char* data() const noexcept {
+    return data_;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  const_iterator begin() const noexcept {
+    return data_;
+  }
+
+  const_iterator end() const noexcept {
+    return data_ + size_;
+  }
+
+  string_view str() const noexcept {
+    return {data_, size_};
+  }
+
+  /// Returns the object that owns the memory of this view.
+  ref_counted* owner() const noexcept {
+    return owner_.get();
+  }
+
+  // -- comparison -------------------------------------------------------------
+
+  int compare(const shared_string_view& other) const noexcept;
+
+  int compare(string_view other) const noexcept;
+
+  // -- serialization ----------------------------------------------------------
+
+  /// Loads the view from `source`, sharing the input buffer of `source` if it
+  /// has an input owner.
+  bool load(binary_deserializer& source);
+
+  template <class Inspector>
+  friend bool inspect(Inspector& f, shared_string_view& x) {
+    if constexpr (Inspector::is_loading) {
+      if constexpr (std::is_same<Inspector, binary_deserializer>::value) {
+        return x.load(f);
+      } else {
+        std::string str;
+        if (!f.apply(str))
+          return false;
+        x = shared_string_view{std::move(str)};
+        return true;
+      }
+    } else {
+      return f.value(x.str());
+    }
+  }
+
+private:
+  intrusive_ptr<ref_counted> owner_;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace caf
@@ -13,6 +13,7 @@
 #include "caf/string_view.hpp"
 #include "caf/telemetry/counter.hpp"
 #include "caf/telemetry/gauge.hpp"
+#include "caf/telemetry/hdr_histogram.hpp"
 #include "caf/telemetry/histogram.hpp"
 #include "caf/timespan.hpp"
 #include "caf/timestamp.hpp"
@@ -21,6 +22,11 @@ namespace caf::telemetry::collector {
 
 /// Collects system metrics and exports them to the text-based Prometheus
 /// format. For a documentation of the format, see: https://git.io/fjgDD.
+/// Optionally, the collector renders the OpenMetrics text format instead.
+///
+/// The collector renders the name and the labels of each metric only once and
+/// caches the result. Subsequent scrapes only format the current values into
+/// the (re-used) internal buffer.
 class CAF_CORE_EXPORT prometheus {
 public:
   // -- member types -----------------------------------------------------------
@@ -30,8 +36,28 @@ public:
   /// have to maintain a null-terminator.
   using char_buffer = std::vector<char>;
 
+  /// Selects the text format for exporting the metrics.
+  enum class output_format {
+    /// The text-based exposition format of Prometheus (version 0.0.4).
+    text,
+    /// The OpenMetrics text format (version 1.0.0), which terminates the
+    /// output with `# EOF` and renders timestamps in seconds.
+    open_metrics,
+  };
+
   // -- properties -------------------------------------------------------------
 
+  /// Returns the format for rendering the metrics.
+  [[nodiscard]] output_format format() const noexcept {
+    return format_;
+  }
+
+  /// Sets the format for rendering the metrics. Changing the format discards
+  /// the result of the last scrape, i.e., `str()` returns an empty string until
+  /// the next call to `collect_from`, which renders again even if
+  /// `min_scrape_interval()` has not passed yet.
+  void format(output_format value);
+
   /// Returns the minimum scrape interval, i.e., the minimum time that needs to
   /// pass before `collect_from` iterates the registry to re-fill the buffer.
   [[nodiscard]] timespan min_scrape_interval() const noexcept {
@@ -92,6 +118,15 @@ public:
                         span<const dbl_histogram::bucket_type> buckets,
                         double sum);
 
+  /// Appends the quantiles 0.5, 0.9, 0.99 and 0.999 of `snapshot` as well as
+  /// its sum and count as Prometheus summary.
+  void append_summary(const metric_family* family, const metric* instance,
+                      const int_hdr_histogram::snapshot_type& snapshot);
+
+  /// @copydoc append_summary
+  void append_summary(const metric_family* family, const metric* instance,
+                      const dbl_hdr_histogram::snapshot_type& snapshot);
+
   // -- collect API ------------------------------------------------------------
 
   /// Applies this collector to the registry, filling the character buffer while
@@ -135,6 +170,16 @@ public:
     append_histogram(family, instance, val->buckets(), val->sum());
   }
 
+  void operator()(const metric_family* family, const metric* instance,
+                  const dbl_hdr_histogram* val) {
+    append_summary(family, instance, val->snapshot());
+  }
+
+  void operator()(const metric_family* family, const metric* instance,
+                  const int_hdr_histogram* val) {
+    append_summary(family, instance, val->snapshot());
+  }
+
 private:
   // -- implementation details -------------------------------------------------
 
@@ -143,6 +188,10 @@ private:
   void set_current_family(const metric_family* family,
                           string_view prometheus_type);
 
+  /// Returns the cached name and labels of `instance`.
+  const char_buffer& instance_prefix(const metric_family* family,
+                                     const metric* instance);
+
   void append_impl(const metric_family* family, string_view prometheus_type,
                    const metric* instance, int64_t value);
 
@@ -154,6 +203,10 @@ private:
                              const metric* instance,
                              span<const BucketType> buckets, ValueType sum);
 
+  template <class ValueType>
+  void append_summary_impl(const metric_family* family, const metric* instance,
+                           const hdr_snapshot<ValueType>& snapshot);
+
   // -- member variables -------------------------------------------------------
 
   /// Stores the generated text output.
@@ -165,13 +218,23 @@ private:
   /// Caches type information and help text for a metric.
   std::unordered_map<const metric_family*, char_buffer> family_info_;
 
-  /// Caches variable names for each bucket of a histogram as well as for the
-  /// implicit sum and count fields.
+  /// Caches the variable name with all labels for counters and gauges.
+  std::unordered_map<const metric*, char_buffer> metric_info_;
+
+  /// Caches variable names for each bucket of a histogram (each quantile of a
+  /// summary) as well as for the implicit sum and count fields.
   std::unordered_map<const metric*, std::vector<char_buffer>> histogram_info_;
 
   /// Caches which metric family is currently collected.
   const metric_family* current_family_ = nullptr;
 
+  /// Stores the timestamp of the current scrape, preceded by a whitespace and
+  /// followed by a newline, i.e., the end of each line in the output.
+  char_buffer line_suffix_;
+
+  /// Selects the text format.
+  output_format format_ = output_format::text;
+
   /// Minimum time between re-iterating the registry.
   timespan min_scrape_interval_ = timespan{0};
 };
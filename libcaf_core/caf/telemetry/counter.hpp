@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <memory>
 #include <type_traits>
 
 #include "caf/config.hpp"
+#include "caf/detail/sharded_cells.hpp"
 #include "caf/fwd.hpp"
 #include "caf/span.hpp"
 #include "caf/telemetry/gauge.hpp"
@@ -15,6 +17,10 @@
 namespace caf::telemetry {
 
 /// A metric that represents a single value that can only go up.
+///
+/// Counters that many threads update concurrently may use one cell per thread
+/// (shard) instead of a single atomic value. Each thread then increments its
+/// own cell without contention, while reading the value sums up all cells.
 template <class ValueType>
 class counter {
 public:
@@ -42,36 +48,73 @@ public:
     // nop
   }
 
+  /// Creates a counter with `num_shards` cells if `num_shards > 1`.
+  counter(span<const label>, size_t num_shards) {
+    if (num_shards > 1) {
+      cells_ = std::make_unique<detail::sharded_cells>(num_shards, 1);
+      shards_ = detail::sharded_value<value_type>{cells_.get(), 0};
+    }
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns whether the counter uses one cell per shard.
+  bool sharded() const noexcept {
+    return static_cast<bool>(shards_);
+  }
+
+  /// Reads the value of the counter from the cell at `offset` in `cells`
+  /// instead of from its own storage. Other metrics such as histograms use
+  /// this to aggregate their sharded state on demand.
+  /// @private
+  void read_from(detail::sharded_cells* cells, size_t offset) noexcept {
+    shards_ = detail::sharded_value<value_type>{cells, offset};
+  }
+
   // -- modifiers --------------------------------------------------------------
 
   /// Increments the counter by 1.
   void inc() noexcept {
-    gauge_.inc();
+    if (shards_)
+      shards_.add(value_type{1});
+    else
+      gauge_.inc();
   }
 
   /// Increments the counter by `amount`.
   /// @pre `amount > 0`
   void inc(value_type amount) noexcept {
     CAF_ASSERT(amount > 0);
-    gauge_.inc(amount);
+    if (shards_)
+      shards_.add(amount);
+    else
+      gauge_.inc(amount);
   }
 
   /// Increments the counter by 1.
   /// @returns The new value of the counter.
+  /// @note sharded counters need to sum up all cells to compute the result.
   template <class T = ValueType>
   std::enable_if_t<std::is_same<T, int64_t>::value, T> operator++() noexcept {
-    return ++gauge_;
+    if (!shards_)
+      return ++gauge_;
+    shards_.add(1);
+    return value();
   }
 
   // -- observers --------------------------------------------------------------
 
   /// Returns the current value of the counter.
   value_type value() const noexcept {
+    if (shards_)
+      return gauge_.value() + shards_.sum();
     return gauge_.value();
   }
 
 private:
   gauge<value_type> gauge_;
+  detail::sharded_value<value_type> shards_;
+  std::unique_ptr<detail::sharded_cells> cells_;
 };
 
 /// Convenience alias for a counter with value type `double`.
@@ -0,0 +1,255 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "caf/detail/sharded_cells.hpp"
+#include "caf/fwd.hpp"
+#include "caf/settings.hpp"
+#include "caf/span.hpp"
+#include "caf/telemetry/hdr_layout.hpp"
+#include "caf/telemetry/label.hpp"
+#include "caf/telemetry/metric_type.hpp"
+
+namespace caf::telemetry {
+
+/// A point-in-time copy of the buckets of an ::hdr_histogram. Snapshots with
+/// the same layout are mergeable. Threads may also record values into a
+/// thread-local snapshot and periodically merge it into a histogram.
+template <class ValueType>
+class hdr_snapshot {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using value_type = ValueType;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit hdr_snapshot(const hdr_layout& layout)
+    : layout_(layout), counts_(layout.size()) {
+    // nop
+  }
+
+  hdr_snapshot(const hdr_snapshot&) = default;
+
+  hdr_snapshot(hdr_snapshot&&) = default;
+
+  hdr_snapshot& operator=(const hdr_snapshot&) = default;
+
+  hdr_snapshot& operator=(hdr_snapshot&&) = default;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the layout of the buckets.
+  const hdr_layout& layout() const noexcept {
+    return layout_;
+  }
+
+  /// Returns the number of observations per bucket.
+  span<const int64_t> counts() const noexcept {
+    return {counts_.data(), counts_.size()};
+  }
+
+  /// Returns the sum of all observed values.
+  value_type sum() const noexcept {
+    return sum_;
+  }
+
+  /// Returns the number of observed values.
+  int64_t count() const noexcept {
+    return count_;
+  }
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Increments the bucket where the observed value falls into.
+  void observe(value_type value) noexcept {
+    ++counts_[layout_.index_of(static_cast<double>(value))];
+    sum_ += value;
+    ++count_;
+  }
+
+  /// Adds the observations of `other` to this snapshot.
+  /// @returns `false` if `other` has a different layout, `true` otherwise.
+  bool merge(const hdr_snapshot& other) noexcept {
+    if (layout_ != other.layout_)
+      return false;
+    for (size_t index = 0; index < counts_.size(); ++index)
+      counts_[index] += other.counts_[index];
+    sum_ += other.sum_;
+    count_ += other.count_;
+    return true;
+  }
+
+  /// Drops all observations.
+  void reset() noexcept {
+    std::fill(counts_.begin(), counts_.end(), int64_t{0});
+    sum_ = value_type{0};
+    count_ = 0;
+  }
+
+  // -- observers --------------------------------------------------------------
+
+  /// Returns the value at quantile `q`, e.g., `0.99` for the 99th percentile.
+  /// The result has a relative error of at most `2^-(precision + 1)` for
+  /// values within the bounds of the layout.
+  /// @returns the (approximated) value at `q` or 0 if the snapshot is empty.
+  value_type quantile(double q) const noexcept {
+    if (count_ == 0)
+      return value_type{0};
+    q = std::clamp(q, 0.0, 1.0);
+    auto rank = std::max(static_cast<int64_t>(std::ceil(q * count_)),
+                         int64_t{1});
+    int64_t acc = 0;
+    size_t index = 0;
+    for (; index < counts_.size() - 1; ++index) {
+      acc += counts_[index];
+      if (acc >= rank)
+        break;
+    }
+    auto result = layout_.value_at(index);
+    if constexpr (std::is_integral<value_type>::value)
+      return static_cast<value_type>(std::llround(result));
+    else
+      return static_cast<value_type>(result);
+  }
+
+private:
+  template <class>
+  friend class hdr_histogram;
+
+  hdr_layout layout_;
+  std::vector<int64_t> counts_;
+  value_type sum_ = value_type{0};
+  int64_t count_ = 0;
+};
+
+/// Represents distributions of events with a high dynamic range, e.g.,
+/// latencies ranging from microseconds to seconds. Unlike ::histogram, this
+/// metric type uses a fixed log-linear layout with (usually) hundreds of small
+/// buckets. This allows computing quantiles such as the 99.9th percentile with
+/// a bounded relative error.
+///
+/// Observing a value computes the bucket in constant time. Each thread
+/// increments the counters in its own block of cells (see
+/// ::detail::sharded_cells) when creating the histogram with more than one
+/// shard. Reading the histogram sums up all blocks into a ::hdr_snapshot.
+template <class ValueType>
+class hdr_histogram {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using value_type = ValueType;
+
+  using snapshot_type = hdr_snapshot<value_type>;
+
+  using family_setting = hdr_layout;
+
+  // -- constants --------------------------------------------------------------
+
+  static constexpr metric_type runtime_type
+    = std::is_same<value_type, double>::value ? metric_type::dbl_hdr_histogram
+                                              : metric_type::int_hdr_histogram;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a histogram with `num_shards` blocks of counters. The settings
+  /// for the first label in `labels` that has an entry in `cfg` (if any)
+  /// override the fields of `layout`.
+  hdr_histogram(span<const label> labels, const settings* cfg,
+                const hdr_layout& layout, size_t num_shards = 1)
+    : layout_(layout_from(labels, cfg, layout)),
+      cells_(num_shards, layout_.size() + 1) {
+    // nop
+  }
+
+  explicit hdr_histogram(const hdr_layout& layout)
+    : hdr_histogram({}, nullptr, layout) {
+    // nop
+  }
+
+  hdr_histogram(const hdr_histogram&) = delete;
+
+  hdr_histogram& operator=(const hdr_histogram&) = delete;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Increments the bucket where the observed value falls into and increments
+  /// the sum of all observed values.
+  void observe(value_type value) noexcept {
+    // The cell after the last bucket stores the sum.
+    auto block = cells_.local_block();
+    auto index = layout_.index_of(static_cast<double>(value));
+    detail::sharded_cells::add(block[index], int64_t{1});
+    detail::sharded_cells::add(block[layout_.size()], value);
+  }
+
+  /// Adds all observations in `x` to this histogram.
+  /// @returns `false` if `x` has a different layout, `true` otherwise.
+  bool merge(const snapshot_type& x) noexcept {
+    if (layout_ != x.layout())
+      return false;
+    auto block = cells_.local_block();
+    for (size_t index = 0; index < x.counts_.size(); ++index)
+      if (auto n = x.counts_[index]; n != 0)
+        detail::sharded_cells::add(block[index], n);
+    detail::sharded_cells::add(block[layout_.size()], x.sum_);
+    return true;
+  }
+
+  // -- observers --------------------------------------------------------------
+
+  /// Returns the layout of the buckets.
+  const hdr_layout& layout() const noexcept {
+    return layout_;
+  }
+
+  /// Returns the sum of all observed values.
+  value_type sum() const noexcept {
+    return cells_.template sum<value_type>(layout_.size());
+  }
+
+  /// Returns whether the histogram uses one block of counters per shard.
+  bool sharded() const noexcept {
+    return cells_.num_shards() > 1;
+  }
+
+  /// Returns the current state of all buckets.
+  snapshot_type snapshot() const {
+    snapshot_type result{layout_};
+    for (size_t index = 0; index < result.counts_.size(); ++index) {
+      auto n = cells_.template sum<int64_t>(index);
+      result.counts_[index] = n;
+      result.count_ += n;
+    }
+    result.sum_ = sum();
+    return result;
+  }
+
+private:
+  static hdr_layout layout_from(span<const label> labels, const settings* cfg,
+                                const hdr_layout& fallback) {
+    if (cfg != nullptr)
+      for (const auto& lbl : labels)
+        if (auto ptr = get_if<settings>(cfg, lbl.str()))
+          return hdr_layout::from(*ptr, fallback);
+    return fallback;
+  }
+
+  hdr_layout layout_;
+  detail::sharded_cells cells_;
+};
+
+/// Convenience alias for an HDR histogram with value type `double`.
+using dbl_hdr_histogram = hdr_histogram<double>;
+
+/// Convenience alias for an HDR histogram with value type `int64_t`.
+using int_hdr_histogram = hdr_histogram<int64_t>;
+
+} // namespace caf::telemetry
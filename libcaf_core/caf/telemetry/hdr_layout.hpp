@@ -0,0 +1,131 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/fwd.hpp"
+
+namespace caf::telemetry {
+
+/// Describes the buckets of a high dynamic range (HDR) histogram. The layout
+/// covers all powers of two between a minimum and a maximum value and splits
+/// each range `[2^e, 2^(e+1))` into `2^precision` buckets of equal width.
+/// Hence, the width of each bucket is at most `2^-precision` of its lower
+/// bound and locating the bucket for a value only requires looking at the
+/// exponent and the most significant bits of its floating point
+/// representation.
+class CAF_CORE_EXPORT hdr_layout {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Limits the number of buckets per power of two to `2^max_precision`.
+  static constexpr int max_precision = 10;
+
+  /// Number of sub-buckets per power of two for layouts created from settings
+  /// without a `precision` field.
+  static constexpr int default_precision = 5;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a layout for values between `min_value` and `max_value` with
+  /// `2^precision` buckets per power of two. Smaller values (including zero
+  /// and negative values) fall into the first bucket, larger values fall into
+  /// the last bucket.
+  hdr_layout(double min_value, double max_value,
+             int precision = default_precision);
+
+  hdr_layout(const hdr_layout&) = default;
+
+  hdr_layout& operator=(const hdr_layout&) = default;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the lower bound of the first bucket, i.e., the largest power of
+  /// two that is less than or equal to the configured minimum.
+  double min_value() const noexcept {
+    return lower_bound(0);
+  }
+
+  /// Returns the upper bound of the last bucket.
+  double max_value() const noexcept {
+    return upper_bound(size() - 1);
+  }
+
+  /// Returns the number of buckets per power of two as a power of two.
+  int precision() const noexcept {
+    return precision_;
+  }
+
+  /// Returns the number of buckets.
+  size_t size() const noexcept {
+    return static_cast<size_t>(max_exponent_ - min_exponent_ + 1)
+           << precision_;
+  }
+
+  /// Returns the bucket for `value`.
+  size_t index_of(double value) const noexcept {
+    // Also catches NaN.
+    if (!(value >= lowest_))
+      return 0;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    auto exponent = static_cast<int>((bits >> 52) & 0x7FF) - 1023;
+    if (exponent > max_exponent_)
+      return size() - 1;
+    auto mask = (uint64_t{1} << precision_) - 1;
+    auto sub_bucket = (bits >> (52 - precision_)) & mask;
+    return (static_cast<size_t>(exponent - min_exponent_) << precision_)
+           + static_cast<size_t>(sub_bucket);
+  }
+
+  /// Returns the smallest value that falls into the bucket at `index`.
+  double lower_bound(size_t index) const noexcept;
+
+  /// Returns the smallest value that falls into the bucket after `index`.
+  double upper_bound(size_t index) const noexcept;
+
+  /// Returns the value that represents all values in the bucket at `index`,
+  /// i.e., the center of the bucket.
+  double value_at(size_t index) const noexcept {
+    return (lower_bound(index) + upper_bound(index)) / 2;
+  }
+
+  // -- factories --------------------------------------------------------------
+
+  /// Reads the fields `min`, `max` and `precision` from `cfg`, using the
+  /// values of `fallback` for missing fields.
+  static hdr_layout from(const settings& cfg, const hdr_layout& fallback);
+
+  // -- comparison -------------------------------------------------------------
+
+  friend bool operator==(const hdr_layout& x, const hdr_layout& y) noexcept {
+    return x.min_exponent_ == y.min_exponent_
+           && x.max_exponent_ == y.max_exponent_
+           && x.precision_ == y.precision_;
+  }
+
+  friend bool operator!=(const hdr_layout& x, const hdr_layout& y) noexcept {
+    return !(x == y);
+  }
+
+private:
+  /// Exponent of the first bucket.
+  int min_exponent_;
+
+  /// Exponent of the last bucket.
+  int max_exponent_;
+
+  /// Number of sub-buckets per exponent as a power of two.
+  int precision_;
+
+  /// Caches `2^min_exponent_`.
+  double lowest_;
+};
+
+} // namespace caf::telemetry
@@ -8,7 +8,10 @@
 #include <initializer_list>
 #include <memory>
 #include <mutex>
+#include <type_traits>
 
+#include "caf/detail/read_mostly_index.hpp"
+#include "caf/hash/fnv.hpp"
 #include "caf/span.hpp"
 #include "caf/string_view.hpp"
 #include "caf/telemetry/label.hpp"
@@ -54,24 +57,38 @@ public:
   }
 
   Type* get_or_add(span<const label_view> labels) {
-    auto has_label_values = [labels](const auto& metric_ptr) {
-      const auto& metric_labels = metric_ptr->labels();
+    auto has_label_values = [labels](const impl_type& instance) {
+      const auto& metric_labels = instance.labels();
       return std::is_permutation(metric_labels.begin(), metric_labels.end(),
                                  labels.begin(), labels.end());
     };
+    // Existing metrics never go away, so looking them up needs no lock.
+    auto hash = hash_of(labels);
+    if (auto ptr = index_.find(hash, has_label_values))
+      return std::addressof(ptr->impl());
     std::unique_lock<std::mutex> guard{mx_};
-    auto m = std::find_if(metrics_.begin(), metrics_.end(), has_label_values);
-    if (m == metrics_.end()) {
-      std::vector<label> cpy{labels.begin(), labels.end()};
-      std::sort(cpy.begin(), cpy.end());
-      std::unique_ptr<impl_type> ptr;
-      if constexpr (std::is_same<extra_setting_type, unit_t>::value)
+    // Check again, since another thread may have added the metric meanwhile.
+    if (auto ptr = index_.find(hash, has_label_values))
+      return std::addressof(ptr->impl());
+    std::vector<label> cpy{labels.begin(), labels.end()};
+    std::sort(cpy.begin(), cpy.end());
+    std::unique_ptr<impl_type> ptr;
+    if constexpr (std::is_same<extra_setting_type, unit_t>::value) {
+      if constexpr (is_shardable)
+        ptr.reset(new impl_type(std::move(cpy), shards_));
+      else
         ptr.reset(new impl_type(std::move(cpy)));
+    } else {
+      if constexpr (is_shardable)
+        ptr.reset(new impl_type(std::move(cpy), config_, extra_setting_,
+                                shards_));
       else
         ptr.reset(new impl_type(std::move(cpy), config_, extra_setting_));
-      m = metrics_.emplace(m, std::move(ptr));
     }
-    return std::addressof(m->get()->impl());
+    auto result = ptr.get();
+    metrics_.emplace_back(std::move(ptr));
+    index_.insert(hash, result);
+    return std::addressof(result->impl());
   }
 
   Type* get_or_add(std::initializer_list<label_view> labels) {
@@ -88,6 +105,17 @@ public:
     return config_;
   }
 
+  /// Returns how many shards new metrics of this family use.
+  size_t shards() const noexcept {
+    return shards_;
+  }
+
+  /// Sets how many shards new metrics of this family use. Metric types that
+  /// have no sharded representation ignore this setting.
+  void shards(size_t value) noexcept {
+    shards_ = value;
+  }
+
   template <class Collector>
   void collect(Collector& collector) const {
     std::unique_lock<std::mutex> guard{mx_};
@@ -96,10 +124,26 @@ public:
   }
 
 private:
+  /// Computes a hash value for `labels` that does not depend on their order.
+  static size_t hash_of(span<const label_view> labels) noexcept {
+    size_t result = 0;
+    for (const auto& lbl : labels)
+      result += hash::fnv<size_t>::compute(lbl.name(), lbl.value());
+    return result;
+  }
+
+  static constexpr bool is_shardable
+    = std::is_same<extra_setting_type, unit_t>::value
+        ? std::is_constructible<Type, span<const label>, size_t>::value
+        : std::is_constructible<Type, span<const label>, const settings*,
+                                const extra_setting_type&, size_t>::value;
+
   const settings* config_;
   extra_setting_type extra_setting_;
+  size_t shards_ = 1;
   mutable std::mutex mx_;
   std::vector<std::unique_ptr<impl_type>> metrics_;
+  detail::read_mostly_index<impl_type> index_;
 };
 
 } // namespace caf::telemetry
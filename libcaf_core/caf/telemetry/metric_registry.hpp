@@ -11,12 +11,14 @@
 #include <mutex>
 
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/read_mostly_index.hpp"
 #include "caf/fwd.hpp"
 #include "caf/raise_error.hpp"
 #include "caf/settings.hpp"
 #include "caf/string_view.hpp"
 #include "caf/telemetry/counter.hpp"
 #include "caf/telemetry/gauge.hpp"
+#include "caf/telemetry/hdr_histogram.hpp"
 #include "caf/telemetry/histogram.hpp"
 #include "caf/telemetry/metric_family_impl.hpp"
 
@@ -70,8 +72,8 @@ public:
                bool is_sum = false) {
     using gauge_type = gauge<ValueType>;
     using family_type = metric_family_impl<gauge_type>;
-    std::unique_lock<std::mutex> guard{families_mx_};
-    if (auto ptr = fetch(prefix, name)) {
+    std::unique_lock<std::mutex> guard{families_mx_, std::defer_lock};
+    if (auto ptr = fetch(prefix, name, guard)) {
       assert_properties(ptr, gauge_type::runtime_type, labels, unit, is_sum);
       return static_cast<family_type*>(ptr);
     }
@@ -80,7 +82,7 @@ public:
                                              to_string(helptext),
                                              to_string(unit), is_sum);
     auto result = ptr.get();
-    families_.emplace_back(std::move(ptr));
+    add(std::move(ptr));
     return result;
   }
 
@@ -103,8 +105,8 @@ public:
                bool is_sum = false) {
     using gauge_type = gauge<ValueType>;
     using family_type = metric_family_impl<gauge_type>;
-    std::unique_lock<std::mutex> guard{families_mx_};
-    if (auto ptr = fetch(prefix, name)) {
+    std::unique_lock<std::mutex> guard{families_mx_, std::defer_lock};
+    if (auto ptr = fetch(prefix, name, guard)) {
       assert_properties(ptr, gauge_type::runtime_type, labels, unit, is_sum);
       return static_cast<family_type*>(ptr);
     }
@@ -113,7 +115,7 @@ public:
                                              to_string(helptext),
                                              to_string(unit), is_sum);
     auto result = ptr.get();
-    families_.emplace_back(std::move(ptr));
+    add(std::move(ptr));
     return result;
   }
 
@@ -200,8 +202,8 @@ public:
                  string_view unit = "1", bool is_sum = false) {
     using counter_type = counter<ValueType>;
     using family_type = metric_family_impl<counter_type>;
-    std::unique_lock<std::mutex> guard{families_mx_};
-    if (auto ptr = fetch(prefix, name)) {
+    std::unique_lock<std::mutex> guard{families_mx_, std::defer_lock};
+    if (auto ptr = fetch(prefix, name, guard)) {
       assert_properties(ptr, counter_type::runtime_type, labels, unit, is_sum);
       return static_cast<family_type*>(ptr);
     }
@@ -209,8 +211,9 @@ public:
                                              to_sorted_vec(labels),
                                              to_string(helptext),
                                              to_string(unit), is_sum);
+    ptr->shards(shards_);
     auto result = ptr.get();
-    families_.emplace_back(std::move(ptr));
+    add(std::move(ptr));
     return result;
   }
 
@@ -234,8 +237,8 @@ public:
                  string_view unit = "1", bool is_sum = false) {
     using counter_type = counter<ValueType>;
     using family_type = metric_family_impl<counter_type>;
-    std::unique_lock<std::mutex> guard{families_mx_};
-    if (auto ptr = fetch(prefix, name)) {
+    std::unique_lock<std::mutex> guard{families_mx_, std::defer_lock};
+    if (auto ptr = fetch(prefix, name, guard)) {
       assert_properties(ptr, counter_type::runtime_type, labels, unit, is_sum);
       return static_cast<family_type*>(ptr);
     }
@@ -243,8 +246,9 @@ public:
                                              to_sorted_vec(labels),
                                              to_string(helptext),
                                              to_string(unit), is_sum);
+    ptr->shards(shards_);
     auto result = ptr.get();
-    families_.emplace_back(std::move(ptr));
+    add(std::move(ptr));
     return result;
   }
 
@@ -341,8 +345,8 @@ public:
     using upper_bounds_list = std::vector<ValueType>;
     if (default_upper_bounds.empty())
       CAF_RAISE_ERROR("at least one bucket must exist in the default settings");
-    std::unique_lock<std::mutex> guard{families_mx_};
-    if (auto ptr = fetch(prefix, name)) {
+    std::unique_lock<std::mutex> guard{families_mx_, std::defer_lock};
+    if (auto ptr = fetch(prefix, name, guard)) {
       assert_properties(ptr, histogram_type::runtime_type, label_names, unit,
                         is_sum);
       return static_cast<family_type*>(ptr);
@@ -353,12 +357,7 @@ public:
       if (auto grp = get_if<settings>(config_, prefix)) {
         if (sub_settings = get_if<settings>(grp, name);
             sub_settings != nullptr) {
-          if (auto lst = get_as<upper_bounds_list>(*sub_settings, "buckets")) {
-            std::sort(lst->begin(), lst->end());
-            lst->erase(std::unique(lst->begin(), lst->end()), lst->end());
-            if (!lst->empty())
-              upper_bounds = std::move(*lst);
-          }
+          upper_bounds = histogram_type::upper_bounds_from(*sub_settings);
         }
       }
     }
@@ -369,8 +368,9 @@ public:
       sub_settings, to_string(prefix), to_string(name),
       to_sorted_vec(label_names), to_string(helptext), to_string(unit), is_sum,
       std::move(upper_bounds));
+    ptr->shards(shards_);
     auto result = ptr.get();
-    families_.emplace_back(std::move(ptr));
+    add(std::move(ptr));
     return result;
   }
 
@@ -456,11 +456,173 @@ public:
     return fptr->get_or_add({});
   }
 
+  /// Returns an HDR histogram metric family. Creates the family lazily if
+  /// necessary, but fails if the full name already belongs to a different
+  /// family.
+  /// @param prefix The prefix (namespace) this family belongs to. Usually the
+  ///               application or protocol name, e.g., `http`. The prefix `caf`
+  ///               as well as prefixes starting with an underscore are
+  ///               reserved.
+  /// @param name The human-readable name of the metric, e.g., `requests`.
+  /// @param label_names Names for all label dimensions of the metric.
+  /// @param default_layout Layout of the metric buckets.
+  /// @param helptext Short explanation of the metric.
+  /// @param unit Unit of measurement. Please use base units such as `bytes` or
+  ///             `seconds` (prefer lowercase). The pseudo-unit `1` identifies
+  ///             dimensionless counts.
+  /// @param is_sum Setting this to `true` indicates that this metric adds
+  ///               something up to a total, where only the total value is of
+  ///               interest. For example, the total number of HTTP requests.
+  /// @note The first call wins when calling this function multiple times with
+  ///       different layouts.
+  /// @note The actor system config may override the fields of
+  ///       `default_layout`.
+  template <class ValueType = int64_t>
+  metric_family_impl<hdr_histogram<ValueType>>*
+  hdr_histogram_family(string_view prefix, string_view name,
+                       span_t<string_view> label_names,
+                       const hdr_layout& default_layout, string_view helptext,
+                       string_view unit = "1", bool is_sum = false) {
+    using histogram_type = hdr_histogram<ValueType>;
+    using family_type = metric_family_impl<histogram_type>;
+    std::unique_lock<std::mutex> guard{families_mx_, std::defer_lock};
+    if (auto ptr = fetch(prefix, name, guard)) {
+      assert_properties(ptr, histogram_type::runtime_type, label_names, unit,
+                        is_sum);
+      return static_cast<family_type*>(ptr);
+    }
+    const settings* sub_settings = nullptr;
+    auto layout = default_layout;
+    if (config_ != nullptr) {
+      if (auto grp = get_if<settings>(config_, prefix)) {
+        if (sub_settings = get_if<settings>(grp, name);
+            sub_settings != nullptr)
+          layout = hdr_layout::from(*sub_settings, default_layout);
+      }
+    }
+    auto ptr = std::make_unique<family_type>(
+      sub_settings, to_string(prefix), to_string(name),
+      to_sorted_vec(label_names), to_string(helptext), to_string(unit), is_sum,
+      layout);
+    ptr->shards(shards_);
+    auto result = ptr.get();
+    add(std::move(ptr));
+    return result;
+  }
+
+  /// @copydoc hdr_histogram_family
+  template <class ValueType = int64_t>
+  metric_family_impl<hdr_histogram<ValueType>>*
+  hdr_histogram_family(string_view prefix, string_view name,
+                       std::initializer_list<string_view> label_names,
+                       const hdr_layout& default_layout, string_view helptext,
+                       string_view unit = "1", bool is_sum = false) {
+    auto lbl_span = make_span(label_names.begin(), label_names.size());
+    return hdr_histogram_family<ValueType>(prefix, name, lbl_span,
+                                           default_layout, helptext, unit,
+                                           is_sum);
+  }
+
+  /// Returns an HDR histogram. Creates the family lazily if necessary, but
+  /// fails if the full name already belongs to a different family.
+  /// @param prefix The prefix (namespace) this family belongs to. Usually the
+  ///               application or protocol name, e.g., `http`. The prefix `caf`
+  ///               as well as prefixes starting with an underscore are
+  ///               reserved.
+  /// @param name The human-readable name of the metric, e.g., `requests`.
+  /// @param labels Names for all label dimensions of the metric.
+  /// @param default_layout Layout of the metric buckets.
+  /// @param helptext Short explanation of the metric.
+  /// @param unit Unit of measurement. Please use base units such as `bytes` or
+  ///             `seconds` (prefer lowercase). The pseudo-unit `1` identifies
+  ///             dimensionless counts.
+  /// @param is_sum Setting this to `true` indicates that this metric adds
+  ///               something up to a total, where only the total value is of
+  ///               interest. For example, the total number of HTTP requests.
+  /// @note The actor system config may override the fields of
+  ///       `default_layout`.
+  template <class ValueType = int64_t>
+  hdr_histogram<ValueType>*
+  hdr_histogram_instance(string_view prefix, string_view name,
+                         span_t<label_view> labels,
+                         const hdr_layout& default_layout,
+                         string_view helptext, string_view unit = "1",
+                         bool is_sum = false) {
+    std::vector<string_view> label_names;
+    label_names.reserve(labels.size());
+    for (auto& lbl : labels)
+      label_names.emplace_back(lbl.name());
+    span_t<string_view> names{label_names.data(), label_names.size()};
+    auto fptr = hdr_histogram_family<ValueType>(prefix, name, names,
+                                                default_layout, helptext, unit,
+                                                is_sum);
+    return fptr->get_or_add(labels);
+  }
+
+  /// @copydoc hdr_histogram_instance
+  template <class ValueType = int64_t>
+  hdr_histogram<ValueType>*
+  hdr_histogram_instance(string_view prefix, string_view name,
+                         std::initializer_list<label_view> labels,
+                         const hdr_layout& default_layout,
+                         string_view helptext, string_view unit = "1",
+                         bool is_sum = false) {
+    span_t<label_view> lbls{labels.begin(), labels.size()};
+    return hdr_histogram_instance<ValueType>(prefix, name, lbls, default_layout,
+                                             helptext, unit, is_sum);
+  }
+
+  /// Returns an HDR histogram metric singleton, i.e., the single instance of a
+  /// family without label dimensions. Creates all objects lazily if necessary,
+  /// but fails if the full name already belongs to a different family.
+  /// @param prefix The prefix (namespace) this family belongs to. Usually the
+  ///               application or protocol name, e.g., `http`. The prefix `caf`
+  ///               as well as prefixes starting with an underscore are
+  ///               reserved.
+  /// @param name The human-readable name of the metric, e.g., `requests`.
+  /// @param default_layout Layout of the metric buckets.
+  /// @param helptext Short explanation of the metric.
+  /// @param unit Unit of measurement. Please use base units such as `bytes` or
+  ///             `seconds` (prefer lowercase). The pseudo-unit `1` identifies
+  ///             dimensionless counts.
+  /// @param is_sum Setting this to `true` indicates that this metric adds
+  ///               something up to a total, where only the total value is of
+  ///               interest. For example, the total number of HTTP requests.
+  /// @note The actor system config may override the fields of
+  ///       `default_layout`.
+  template <class ValueType = int64_t>
+  hdr_histogram<ValueType>*
+  hdr_histogram_singleton(string_view prefix, string_view name,
+                          const hdr_layout& default_layout,
+                          string_view helptext, string_view unit = "1",
+                          bool is_sum = false) {
+    span_t<string_view> lbls;
+    auto fptr = hdr_histogram_family<ValueType>(prefix, name, lbls,
+                                                default_layout, helptext, unit,
+                                                is_sum);
+    return fptr->get_or_add({});
+  }
+
   /// @internal
-  void config(const settings* ptr) {
-    config_ = ptr;
+  void config(const settings* ptr);
+
+  /// Returns how many shards new counters and histograms use. A value of 1
+  /// disables sharding.
+  /// @see shards(size_t)
+  size_t shards() const noexcept {
+    return shards_;
   }
 
+  /// Configures how many shards counters and histograms of families created
+  /// afterwards use. With more than one shard, each metric keeps one cell
+  /// (block of cells for histograms) per thread on its own cache line. Threads
+  /// then update their cells without contention, while collectors sum up all
+  /// cells. This trades memory and scrape time for cheaper updates on hot
+  /// paths. A value of 0 selects one shard per hardware thread.
+  /// @note gauges never use shards, because setting a gauge or reading the
+  ///       result of `operator++` would require touching all cells.
+  void shards(size_t value) noexcept;
+
   // -- observers --------------------------------------------------------------
 
   template <class Collector>
@@ -478,9 +640,23 @@ public:
   void merge(metric_registry& other);
 
 private:
-  /// @pre `families_mx_` is locked.
+  /// Returns the family with given prefix and name or `nullptr`. Safe to call
+  /// without holding `families_mx_`.
   metric_family* fetch(const string_view& prefix, const string_view& name);
 
+  /// Returns the family with given prefix and name without locking if it
+  /// exists. Otherwise, locks `guard` and looks up the family again.
+  /// @post `guard` owns a lock on `families_mx_` if the result is `nullptr`.
+  metric_family* fetch(const string_view& prefix, const string_view& name,
+                       std::unique_lock<std::mutex>& guard);
+
+  /// Adds `ptr` to the families and to the index.
+  /// @pre `families_mx_` is locked.
+  void add(std::unique_ptr<metric_family> ptr);
+
+  /// Computes the hash value for the index.
+  static size_t hash_of(string_view prefix, string_view name) noexcept;
+
   static std::vector<std::string> to_sorted_vec(span_t<string_view> xs);
 
   static std::vector<std::string> to_sorted_vec(span_t<label_view> xs);
@@ -498,9 +674,15 @@ private:
         return f(static_cast<const metric_family_impl<int_gauge>*>(ptr));
       case metric_type::dbl_histogram:
         return f(static_cast<const metric_family_impl<dbl_histogram>*>(ptr));
-      default:
-        CAF_ASSERT(ptr->type() == metric_type::int_histogram);
+      case metric_type::int_histogram:
         return f(static_cast<const metric_family_impl<int_histogram>*>(ptr));
+      case metric_type::dbl_hdr_histogram:
+        return f(
+          static_cast<const metric_family_impl<dbl_hdr_histogram>*>(ptr));
+      default:
+        CAF_ASSERT(ptr->type() == metric_type::int_hdr_histogram);
+        return f(
+          static_cast<const metric_family_impl<int_hdr_histogram>*>(ptr));
     }
   }
 
@@ -514,7 +696,9 @@ private:
 
   mutable std::mutex families_mx_;
   std::vector<std::unique_ptr<metric_family>> families_;
+  detail::read_mostly_index<metric_family> index_;
   const caf::settings* config_;
+  size_t shards_ = 1;
 };
 
 } // namespace caf::telemetry
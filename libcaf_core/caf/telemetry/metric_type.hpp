@@ -13,6 +13,8 @@ enum class metric_type : uint8_t {
   int_gauge,
   dbl_histogram,
   int_histogram,
+  dbl_hdr_histogram,
+  int_hdr_histogram,
 };
 
 } // namespace caf::telemetry
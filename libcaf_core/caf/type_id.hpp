@@ -411,6 +411,8 @@ CAF_BEGIN_TYPE_ID_BLOCK(core_module, 0)
   CAF_ADD_TYPE_ID(core_module, (caf::open_stream_msg))
   CAF_ADD_TYPE_ID(core_module, (caf::pec))
   CAF_ADD_TYPE_ID(core_module, (caf::sec))
+  CAF_ADD_TYPE_ID(core_module, (caf::shared_byte_span))
+  CAF_ADD_TYPE_ID(core_module, (caf::shared_string_view))
   CAF_ADD_TYPE_ID(core_module, (caf::stream_slots))
   CAF_ADD_TYPE_ID(core_module, (caf::strong_actor_ptr))
   CAF_ADD_TYPE_ID(core_module, (caf::timeout_msg))
@@ -0,0 +1,123 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/string_view.hpp"
+#include "caf/type_id.hpp"
+
+namespace caf {
+
+/// Describes the binary representation of a type as a flat list of values, in
+/// the order in which ::binary_serializer writes them. Nested objects and
+/// tuples dissolve into their values. Values that have no fixed size, i.e.,
+/// strings, sequences, maps, optional fields and variant fields, appear as a
+/// single field without their content.
+/// @see make_type_schema
+class CAF_CORE_EXPORT type_schema {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Describes a single value in the binary representation.
+  struct field {
+    /// Joins the field names leading to this value with dots. Empty for the
+    /// value of a type without fields, e.g., an integer. Elements of a tuple
+    /// share the path of the tuple.
+    std::string path;
+
+    /// Identifies the type of this value, e.g., `type_id_v<int32_t>`. Raw
+    /// bytes use `type_id_v<uint8_t>`, while sequences, maps, optional fields
+    /// and variant fields use `invalid_type_id`.
+    type_id_t type;
+
+    /// Stores the position of this value in the binary representation or
+    /// `npos` if a value with variable size precedes it.
+    size_t offset;
+
+    /// Stores how many bytes this value occupies or 0 if the size depends on
+    /// the value.
+    size_t size;
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  /// Denotes an unknown offset.
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  type_schema() = default;
+
+  type_schema(type_schema&&) = default;
+
+  type_schema(const type_schema&) = default;
+
+  type_schema& operator=(type_schema&&) = default;
+
+  type_schema& operator=(const type_schema&) = default;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the type ID of the described type or `invalid_type_id` if the
+  /// type has no ID.
+  type_id_t type() const noexcept {
+    return type_;
+  }
+
+  /// Returns the name of the described type.
+  const std::string& name() const noexcept {
+    return name_;
+  }
+
+  /// Returns all values in the order of the binary representation.
+  const std::vector<field>& fields() const noexcept {
+    return fields_;
+  }
+
+  /// Returns whether all values of the type have the same binary size.
+  bool fixed_size() const noexcept {
+    return fixed_size_;
+  }
+
+  /// Returns the size of the binary representation or `npos` if the size
+  /// depends on the value.
+  size_t size() const noexcept {
+    return fixed_size_ ? size_ : npos;
+  }
+
+  /// Returns the field at `path` or `nullptr` if no such field exists.
+  const field* find(string_view path) const noexcept;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Sets the type ID and the name of the described type.
+  void set_type(type_id_t type, std::string name);
+
+  /// Appends a value with a fixed size.
+  void add_fixed(std::string path, type_id_t type, size_t size);
+
+  /// Appends a value that has no fixed size.
+  void add_variable(std::string path, type_id_t type);
+
+  /// Removes all fields.
+  void clear() noexcept;
+
+private:
+  type_id_t type_ = invalid_type_id;
+  std::string name_;
+  std::vector<field> fields_;
+  size_t size_ = 0;
+  bool fixed_size_ = true;
+};
+
+/// @relates type_schema
+CAF_CORE_EXPORT std::string to_string(const type_schema& x);
+
+} // namespace caf
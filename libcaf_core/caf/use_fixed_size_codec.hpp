@@ -0,0 +1,20 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <type_traits>
+
+namespace caf {
+
+/// Template specializations can enable ::fixed_size_codec for individual
+/// types when serializing them as part of a message.
+/// @see CAF_USE_FIXED_SIZE_CODEC
+template <class T>
+struct use_fixed_size_codec : std::false_type {};
+
+template <class T>
+constexpr bool use_fixed_size_codec_v = use_fixed_size_codec<T>::value;
+
+} // namespace caf
@@ -74,7 +74,10 @@ actor_system_config::actor_system_config()
     .add<size_t>("max-throughput", "nr. of messages actors can consume per run")
     .add<bool>("enable-profiling", "enables profiler output")
     .add<timespan>("profiling-resolution", "data collection rate")
-    .add<string>("profiling-output-file", "output file for the profiler");
+    .add<string>("profiling-output-file", "output file for the profiler")
+    .add<bool>("enable-metrics", "collects metrics for each worker")
+    .add<string>("trace-file", "writes scheduling events to this file")
+    .add<size_t>("trace-buffer-size", "max. number of trace events per thread");
   opt_group(custom_options_, "caf.work-stealing")
     .add<size_t>("aggressive-poll-attempts", "nr. of aggressive steal attempts")
     .add<size_t>("aggressive-steal-interval",
@@ -89,8 +92,11 @@ actor_system_config::actor_system_config()
     .add<timespan>("relaxed-sleep-duration",
                    "sleep duration between relaxed steal attempts");
   opt_group{custom_options_, "caf.logger"} //
-    .add<bool>("inline-output", "disable logger thread (for testing only!)");
+    .add<bool>("inline-output", "disable logger thread (for testing only!)")
+    .add<bool>("per-thread-buffers", "buffer events per thread without locks")
+    .add<size_t>("per-thread-buffer-size", "size of each buffer in bytes");
   opt_group{custom_options_, "caf.logger.file"}
+    .add<bool>("binary", "write the log file in the binary format")
     .add<string>("path", "filesystem path for the log file")
     .add<string>("format", "format for individual log file entries")
     .add<string>("verbosity", "minimum severity level for file output")
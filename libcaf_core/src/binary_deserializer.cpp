@@ -5,6 +5,7 @@
 #include "caf/binary_deserializer.hpp"
 
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <type_traits>
 
@@ -40,6 +41,105 @@ bool float_value(binary_deserializer& source, T& x) {
   }
 }
 
+// Decodes an unsigned LEB128 value. Rejects encodings that exceed `T`.
+template <class T>
+bool varint_value(binary_deserializer& source, T& x) {
+  static constexpr int max_bits = std::numeric_limits<T>::digits;
+  auto result = uint64_t{0};
+  auto shift = 0;
+  uint8_t low7 = 0;
+  do {
+    if (shift >= max_bits) {
+      source.emplace_error(sec::invalid_argument, "varint too long");
+      return false;
+    }
+    if (!source.value(low7))
+      return false;
+    auto bits = static_cast<uint64_t>(low7 & 0x7f);
+    if (shift > 0 && (bits >> (64 - shift)) != 0) {
+      source.emplace_error(sec::invalid_argument, "varint out of range");
+      return false;
+    }
+    result |= bits << shift;
+    shift += 7;
+  } while (low7 & 0x80);
+  if constexpr (max_bits < 64) {
+    if ((result >> max_bits) != 0) {
+      source.emplace_error(sec::invalid_argument, "varint out of range");
+      return false;
+    }
+  }
+  x = static_cast<T>(result);
+  return true;
+}
+
+// Reverses the zigzag mapping of the binary_serializer.
+template <class T>
+bool compact_int_value(binary_deserializer& source, T& x) {
+  if constexpr (std::is_signed<T>::value) {
+    auto tmp = std::make_unsigned_t<T>{0};
+    if (!varint_value(source, tmp))
+      return false;
+    auto y = static_cast<T>(tmp >> 1);
+    x = (tmp & 1) != 0 ? static_cast<T>(~y) : y;
+    return true;
+  } else {
+    return varint_value(source, x);
+  }
+}
+
+template <class T>
+bool compact_int_values(binary_deserializer& source, span<T> xs) {
+  for (auto& x : xs)
+    if (!compact_int_value(source, x))
+      return false;
+  return true;
+}
+
+// Reads all values with a single range check. The loop body only copies and
+// converts, which allows the compiler to vectorize it.
+template <class T, class Converter>
+bool bulk_value(binary_deserializer& source, span<T> xs, Converter convert) {
+  using packed_type = decltype(convert.pack(std::declval<T>()));
+  static_assert(sizeof(packed_type) == sizeof(T));
+  auto num_bytes = xs.size() * sizeof(T);
+  if (num_bytes > source.remaining()) {
+    source.emplace_error(sec::end_of_stream);
+    return false;
+  }
+  auto in = source.current();
+  for (auto& x : xs) {
+    packed_type tmp;
+    memcpy(&tmp, in, sizeof(T));
+    x = convert(tmp);
+    in += sizeof(T);
+  }
+  source.skip(num_bytes);
+  return true;
+}
+
+template <class T>
+struct int_converter {
+  using unsigned_type = std::make_unsigned_t<T>;
+
+  static unsigned_type pack(T);
+
+  T operator()(unsigned_type x) const noexcept {
+    return static_cast<T>(detail::from_network_order(x));
+  }
+};
+
+template <class T>
+struct float_converter {
+  using packed_type = typename detail::ieee_754_trait<T>::packed_type;
+
+  static packed_type pack(T);
+
+  T operator()(packed_type x) const noexcept {
+    return detail::unpack754(detail::from_network_order(x));
+  }
+};
+
 // Does not perform any range checks.
 template <class T>
 void unsafe_int_value(binary_deserializer& source, T& x) {
@@ -194,26 +294,38 @@ bool binary_deserializer::value(uint8_t& x) noexcept {
 }
 
 bool binary_deserializer::value(int16_t& x) noexcept {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_deserializer::value(uint16_t& x) noexcept {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_deserializer::value(int32_t& x) noexcept {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_deserializer::value(uint32_t& x) noexcept {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_deserializer::value(int64_t& x) noexcept {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_deserializer::value(uint64_t& x) noexcept {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
@@ -250,6 +362,71 @@ bool binary_deserializer::value(span<byte> x) noexcept {
   return true;
 }
 
+bool binary_deserializer::value(span<int8_t> xs) noexcept {
+  return value(as_writable_bytes(xs));
+}
+
+bool binary_deserializer::value(span<uint8_t> xs) noexcept {
+  return value(as_writable_bytes(xs));
+}
+
+bool binary_deserializer::value(span<int16_t> xs) noexcept {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_value(*this, xs, int_converter<int16_t>{});
+}
+
+bool binary_deserializer::value(span<uint16_t> xs) noexcept {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_value(*this, xs, int_converter<uint16_t>{});
+}
+
+bool binary_deserializer::value(span<int32_t> xs) noexcept {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_value(*this, xs, int_converter<int32_t>{});
+}
+
+bool binary_deserializer::value(span<uint32_t> xs) noexcept {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_value(*this, xs, int_converter<uint32_t>{});
+}
+
+bool binary_deserializer::value(span<int64_t> xs) noexcept {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_value(*this, xs, int_converter<int64_t>{});
+}
+
+bool binary_deserializer::value(span<uint64_t> xs) noexcept {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_value(*this, xs, int_converter<uint64_t>{});
+}
+
+bool binary_deserializer::value(span<float> xs) noexcept {
+  return bulk_value(*this, xs, float_converter<float>{});
+}
+
+bool binary_deserializer::value(span<double> xs) noexcept {
+  return bulk_value(*this, xs, float_converter<double>{});
+}
+
+bool binary_deserializer::list(byte_buffer& xs) {
+  xs.clear();
+  auto size = size_t{0};
+  if (!begin_sequence(size))
+    return false;
+  if (!range_check(size)) {
+    emplace_error(sec::end_of_stream);
+    return false;
+  }
+  xs.resize(size);
+  return value(make_span(xs)) && end_sequence();
+}
+
 bool binary_deserializer::value(std::string& x) {
   x.clear();
   size_t str_size = 0;
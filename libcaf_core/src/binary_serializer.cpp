@@ -22,6 +22,78 @@ auto int_value(binary_serializer& sink, T x) {
   return sink.value(as_bytes(make_span(&y, 1)));
 }
 
+// Encodes `x` as unsigned LEB128, i.e., writes 7 bits per byte and sets the
+// high bit on all bytes but the last.
+bool varint_value(binary_serializer& sink, uint64_t x) {
+  uint8_t buf[10];
+  auto i = buf;
+  while (x > 0x7f) {
+    *i++ = (static_cast<uint8_t>(x) & 0x7f) | 0x80;
+    x >>= 7;
+  }
+  *i++ = static_cast<uint8_t>(x);
+  return sink.value(as_bytes(make_span(buf, static_cast<size_t>(i - buf))));
+}
+
+// Maps signed integers to unsigned integers such that values with a small
+// magnitude have a short varint encoding: 0, -1, 1, -2, ... map to 0, 1, 2, ...
+template <class T>
+uint64_t zigzag(T x) {
+  auto y = static_cast<uint64_t>(static_cast<int64_t>(x));
+  return x < 0 ? ~(y << 1) : y << 1;
+}
+
+template <class T>
+bool compact_int_value(binary_serializer& sink, T x) {
+  if constexpr (std::is_signed<T>::value)
+    return varint_value(sink, zigzag(x));
+  else
+    return varint_value(sink, x);
+}
+
+template <class T>
+bool compact_int_values(binary_serializer& sink, span<const T> xs) {
+  for (auto x : xs)
+    compact_int_value(sink, x);
+  return true;
+}
+
+// Writes all values with a single resize of the buffer. The loop body only
+// converts and copies, which allows the compiler to vectorize it.
+template <class T, class Converter>
+bool bulk_value(binary_serializer& sink, span<const T> xs, Converter convert) {
+  using converted_type = decltype(convert(std::declval<T>()));
+  static_assert(sizeof(converted_type) == sizeof(T));
+  auto& buf = sink.buf();
+  auto pos = sink.write_pos();
+  auto num_bytes = xs.size() * sizeof(T);
+  if (buf.size() < pos + num_bytes)
+    buf.resize(pos + num_bytes);
+  auto out = buf.data() + pos;
+  for (auto x : xs) {
+    auto y = convert(x);
+    memcpy(out, &y, sizeof(T));
+    out += sizeof(T);
+  }
+  sink.seek(pos + num_bytes);
+  return true;
+}
+
+template <class T>
+bool bulk_int_value(binary_serializer& sink, span<const T> xs) {
+  using unsigned_type = std::make_unsigned_t<T>;
+  return bulk_value(sink, xs, [](T x) {
+    return detail::to_network_order(static_cast<unsigned_type>(x));
+  });
+}
+
+template <class T>
+bool bulk_float_value(binary_serializer& sink, span<const T> xs) {
+  return bulk_value(sink, xs, [](T x) {
+    return detail::to_network_order(detail::pack754(x));
+  });
+}
+
 } // namespace
 
 binary_serializer::binary_serializer(actor_system& sys,
@@ -37,6 +109,12 @@ void binary_serializer::skip(size_t num_bytes) {
   write_pos_ += num_bytes;
 }
 
+void binary_serializer::reserve(size_t num_bytes) {
+  auto required = write_pos_ + num_bytes;
+  if (buf_.capacity() < required)
+    buf_.reserve(required);
+}
+
 bool binary_serializer::begin_sequence(size_t list_size) {
   // Use varbyte encoding to compress sequence size on the wire.
   // For 64-bit values, the encoded representation cannot get larger than 10
@@ -124,6 +202,58 @@ bool binary_serializer::value(span<const byte> x) {
   return true;
 }
 
+bool binary_serializer::value(span<const int8_t> xs) {
+  return value(as_bytes(xs));
+}
+
+bool binary_serializer::value(span<const uint8_t> xs) {
+  return value(as_bytes(xs));
+}
+
+bool binary_serializer::value(span<const int16_t> xs) {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_int_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const uint16_t> xs) {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_int_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const int32_t> xs) {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_int_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const uint32_t> xs) {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_int_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const int64_t> xs) {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_int_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const uint64_t> xs) {
+  if (compact_integers_)
+    return compact_int_values(*this, xs);
+  return bulk_int_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const float> xs) {
+  return bulk_float_value(*this, xs);
+}
+
+bool binary_serializer::value(span<const double> xs) {
+  return bulk_float_value(*this, xs);
+}
+
 bool binary_serializer::value(byte x) {
   if (write_pos_ == buf_.size())
     buf_.emplace_back(x);
@@ -146,26 +276,38 @@ bool binary_serializer::value(uint8_t x) {
 }
 
 bool binary_serializer::value(int16_t x) {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_serializer::value(uint16_t x) {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_serializer::value(int32_t x) {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_serializer::value(uint32_t x) {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_serializer::value(int64_t x) {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
 bool binary_serializer::value(uint64_t x) {
+  if (compact_integers_)
+    return compact_int_value(*this, x);
   return int_value(*this, x);
 }
 
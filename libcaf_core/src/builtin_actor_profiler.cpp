@@ -0,0 +1,445 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/builtin_actor_profiler.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <unordered_map>
+
+#include "caf/detail/print.hpp"
+#include "caf/invoke_message_result.hpp"
+#include "caf/local_actor.hpp"
+#include "caf/mailbox_element.hpp"
+
+namespace caf {
+
+namespace {
+
+// Configures how many shards the profiler uses for tracking sent messages.
+constexpr size_t num_shards = 64;
+
+// Configures how many sent messages a shard tracks at most. Messages that
+// never reach a local actor, e.g., messages to remote actors, would otherwise
+// accumulate indefinitely.
+constexpr size_t max_pending_per_shard = 4096;
+
+// Event IDs consist of the thread index and a thread-local counter.
+constexpr int event_id_shift = 40;
+
+int64_t to_ns(std::chrono::steady_clock::duration x) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(x).count();
+}
+
+size_t bucket_of(int64_t ns) {
+  size_t result = 0;
+  while (result + 1 < builtin_actor_profiler::num_buckets
+         && (int64_t{1} << result) <= ns)
+    ++result;
+  return result;
+}
+
+struct pair_hash {
+  template <class T, class U>
+  size_t operator()(const std::pair<T, U>& x) const noexcept {
+    auto h1 = std::hash<T>{}(x.first);
+    auto h2 = std::hash<U>{}(x.second);
+    return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+  }
+};
+
+// Tracks a handler that is currently running on this thread.
+struct active_frame {
+  const local_actor* self;
+  uint32_t stack;
+  uint64_t event;
+  uint64_t parent_event;
+  std::chrono::steady_clock::time_point start;
+  int64_t latency_ns;
+  size_t sends;
+};
+
+struct stack_stats {
+  size_t count = 0;
+  int64_t total_ns = 0;
+  int64_t max_ns = 0;
+  size_t latency_count = 0;
+  int64_t latency_ns = 0;
+  size_t sends = 0;
+  std::array<size_t, builtin_actor_profiler::num_buckets> buckets{};
+};
+
+struct trace_event {
+  uint32_t stack;
+  uint64_t id;
+  uint64_t parent;
+  actor_id aid;
+  int64_t start_ns;
+  int64_t duration_ns;
+  size_t sends;
+};
+
+// Identifies the handler that sent a message.
+struct origin {
+  const void* sender;
+  uint64_t event;
+  uint32_t stack;
+  std::chrono::steady_clock::time_point sent;
+};
+
+} // namespace
+
+struct builtin_actor_profiler::thread_data {
+  /// Position of this thread in `threads_`.
+  size_t index = 0;
+
+  /// Counts processed messages for generating event IDs.
+  uint64_t events = 0;
+
+  /// Stores the running handlers. Only accessed by the owning thread.
+  std::vector<active_frame> active;
+
+  /// Caches frame IDs. Only accessed by the owning thread.
+  std::unordered_map<std::pair<const char*, const void*>, uint32_t, pair_hash>
+    frame_cache;
+
+  /// Caches stack IDs. Only accessed by the owning thread.
+  std::unordered_map<std::pair<uint32_t, uint32_t>, uint32_t, pair_hash>
+    stack_cache;
+
+  /// Guards `stats` and `trace`.
+  std::mutex mtx;
+
+  /// Aggregates processing times by stack ID.
+  std::unordered_map<uint32_t, stack_stats> stats;
+
+  /// Stores the most recent trace events.
+  std::vector<trace_event> trace;
+
+  /// Points to the oldest trace event once `trace` reached its capacity.
+  size_t trace_pos = 0;
+};
+
+struct builtin_actor_profiler::shard {
+  std::mutex mtx;
+  std::unordered_map<const mailbox_element*, origin> pending;
+};
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+builtin_actor_profiler::builtin_actor_profiler(size_t trace_capacity)
+  : trace_capacity_(std::max(trace_capacity, size_t{1})),
+    t0_(clock_type::now()),
+    shards_(new shard[num_shards]) {
+  stacks_.emplace_back(stack_node{0, 0, 0});
+}
+
+builtin_actor_profiler::~builtin_actor_profiler() {
+  // nop
+}
+
+// -- overrides ----------------------------------------------------------------
+
+void builtin_actor_profiler::add_actor(const local_actor&,
+                                       const local_actor*) {
+  // nop
+}
+
+void builtin_actor_profiler::remove_actor(const local_actor&) {
+  // nop
+}
+
+void builtin_actor_profiler::before_processing(const local_actor& self,
+                                               const mailbox_element& element) {
+  auto& td = local_data();
+  auto now = clock_type::now();
+  // Find out which handler sent this message, if any.
+  origin src{nullptr, 0, 0, now};
+  auto found = false;
+  {
+    auto key = &element;
+    auto& sh = shards_[std::hash<const void*>{}(key) % num_shards];
+    std::unique_lock<std::mutex> guard{sh.mtx};
+    if (auto i = sh.pending.find(key); i != sh.pending.end()) {
+      if (i->second.sender == element.sender.get()) {
+        src = i->second;
+        found = true;
+      }
+      sh.pending.erase(i);
+    }
+  }
+  auto stack = stack_id(td, src.stack, frame_id(td, self, element));
+  auto event = (static_cast<uint64_t>(td.index) << event_id_shift)
+               | ++td.events;
+  td.active.emplace_back(active_frame{&self, stack, event, src.event, now,
+                                      found ? to_ns(now - src.sent) : -1, 0});
+}
+
+void builtin_actor_profiler::after_processing(const local_actor& self,
+                                              invoke_message_result result) {
+  auto& td = local_data();
+  if (td.active.empty() || td.active.back().self != &self)
+    return;
+  auto frame = td.active.back();
+  td.active.pop_back();
+  // Skipped messages re-appear later.
+  if (result == invoke_message_result::skipped)
+    return;
+  auto duration = to_ns(clock_type::now() - frame.start);
+  std::unique_lock<std::mutex> guard{td.mtx};
+  auto& st = td.stats[frame.stack];
+  ++st.count;
+  st.total_ns += duration;
+  st.max_ns = std::max(st.max_ns, duration);
+  ++st.buckets[bucket_of(duration)];
+  st.sends += frame.sends;
+  if (frame.latency_ns >= 0) {
+    ++st.latency_count;
+    st.latency_ns += frame.latency_ns;
+  }
+  trace_event ev{frame.stack, frame.event, frame.parent_event, self.id(),
+                 to_ns(frame.start - t0_), duration, frame.sends};
+  if (td.trace.size() < trace_capacity_) {
+    td.trace.emplace_back(ev);
+  } else {
+    td.trace[td.trace_pos] = ev;
+    td.trace_pos = (td.trace_pos + 1) % trace_capacity_;
+  }
+}
+
+void builtin_actor_profiler::before_sending(const local_actor& self,
+                                            mailbox_element& element) {
+  record_send(self, element);
+}
+
+void builtin_actor_profiler::before_sending_scheduled(
+  const local_actor& self, actor_clock::time_point, mailbox_element& element) {
+  record_send(self, element);
+}
+
+// -- exporting ----------------------------------------------------------------
+
+std::vector<builtin_actor_profiler::entry>
+builtin_actor_profiler::entries() const {
+  // Collect the statistics of all threads.
+  std::vector<std::pair<uint32_t, stack_stats>> stats;
+  threads_.with_entries([&stats](auto& xs) {
+    for (auto& td : xs) {
+      std::unique_lock<std::mutex> td_guard{td->mtx};
+      stats.insert(stats.end(), td->stats.begin(), td->stats.end());
+    }
+  });
+  // Merge statistics of all stacks that end in the same frame.
+  std::map<std::pair<std::string, std::string>, entry> merged;
+  {
+    std::unique_lock<std::mutex> guard{intern_mtx_};
+    for (auto& [stack, st] : stats) {
+      auto& info = frames_[stacks_[stack].frame];
+      auto& x = merged[std::make_pair(info.actor_type, info.message_type)];
+      x.count += st.count;
+      x.total_time += timespan{st.total_ns};
+      x.max_time = std::max(x.max_time, timespan{st.max_ns});
+      x.latency_count += st.latency_count;
+      x.total_latency += timespan{st.latency_ns};
+      x.sends += st.sends;
+      for (size_t index = 0; index < num_buckets; ++index)
+        x.buckets[index] += st.buckets[index];
+    }
+  }
+  std::vector<entry> result;
+  result.reserve(merged.size());
+  for (auto& [key, x] : merged) {
+    result.emplace_back(std::move(x));
+    result.back().actor_type = key.first;
+    result.back().message_type = key.second;
+  }
+  std::stable_sort(result.begin(), result.end(),
+                   [](const entry& x, const entry& y) {
+                     return x.total_time > y.total_time;
+                   });
+  return result;
+}
+
+void builtin_actor_profiler::write_collapsed_stacks(std::ostream& out) const {
+  std::unordered_map<uint32_t, int64_t> totals;
+  threads_.with_entries([&totals](auto& xs) {
+    for (auto& td : xs) {
+      std::unique_lock<std::mutex> td_guard{td->mtx};
+      for (auto& [stack, st] : td->stats)
+        totals[stack] += st.total_ns;
+    }
+  });
+  // Different stack IDs may render to the same string, e.g., for actor names
+  // at different addresses.
+  std::map<std::string, int64_t> lines;
+  {
+    std::unique_lock<std::mutex> guard{intern_mtx_};
+    for (auto& [stack, total] : totals)
+      lines[render_stack(stack)] += total;
+  }
+  for (auto& [line, total] : lines)
+    out << line << ' ' << total << '\n';
+}
+
+void builtin_actor_profiler::write_chrome_trace(std::ostream& out) const {
+  // Collect the trace events of all threads in chronological order.
+  std::vector<std::pair<size_t, trace_event>> events;
+  size_t num_threads = 0;
+  threads_.with_entries([&events, &num_threads](auto& xs) {
+    num_threads = xs.size();
+    for (auto& td : xs) {
+      std::unique_lock<std::mutex> td_guard{td->mtx};
+      auto& trace = td->trace;
+      for (size_t i = 0; i < trace.size(); ++i)
+        events.emplace_back(td->index,
+                            trace[(td->trace_pos + i) % trace.size()]);
+    }
+  });
+  std::stable_sort(events.begin(), events.end(),
+                   [](const auto& x, const auto& y) {
+                     return x.second.start_ns < y.second.start_ns;
+                   });
+  std::unordered_map<uint64_t, std::pair<size_t, int64_t>> starts;
+  for (auto& [tid, ev] : events)
+    starts.emplace(ev.id, std::make_pair(tid, ev.start_ns));
+  std::string buf;
+  buf += R"({"displayTimeUnit":"ns","traceEvents":[)";
+  auto sep = [&buf, first = true]() mutable {
+    if (first)
+      first = false;
+    else
+      buf += ",\n";
+  };
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    sep();
+    buf += R"({"name":"thread_name","ph":"M","pid":1,"tid":)";
+    buf += std::to_string(tid);
+    buf += R"(,"args":{"name":"thread )";
+    buf += std::to_string(tid);
+    buf += R"("}})";
+  }
+  std::unique_lock<std::mutex> guard{intern_mtx_};
+  for (auto& [tid, ev] : events) {
+    auto& info = frames_[stacks_[ev.stack].frame];
+    sep();
+    buf += R"({"name":)";
+    detail::print_escaped(buf, info.actor_type + ':' + info.message_type);
+    buf += R"(,"cat":"actor","ph":"X","pid":1,"tid":)";
+    buf += std::to_string(tid);
+    buf += R"(,"ts":)";
+    detail::print_us(buf, ev.start_ns);
+    buf += R"(,"dur":)";
+    detail::print_us(buf, ev.duration_ns);
+    buf += R"(,"args":{"actor_id":)";
+    buf += std::to_string(ev.aid);
+    buf += R"(,"sends":)";
+    buf += std::to_string(ev.sends);
+    buf += "}}";
+    // Connect the handler to the handler that sent the message.
+    if (auto i = starts.find(ev.parent); i != starts.end()) {
+      auto flow_id = std::to_string(ev.id);
+      sep();
+      buf += R"({"name":"message","cat":"causality","ph":"s","id":)";
+      buf += flow_id;
+      buf += R"(,"pid":1,"tid":)";
+      buf += std::to_string(i->second.first);
+      buf += R"(,"ts":)";
+      detail::print_us(buf, i->second.second);
+      buf += "}";
+      sep();
+      buf += R"({"name":"message","cat":"causality","ph":"f","bp":"e","id":)";
+      buf += flow_id;
+      buf += R"(,"pid":1,"tid":)";
+      buf += std::to_string(tid);
+      buf += R"(,"ts":)";
+      detail::print_us(buf, ev.start_ns);
+      buf += "}";
+    }
+  }
+  buf += "]}\n";
+  out << buf;
+}
+
+// -- utility functions --------------------------------------------------------
+
+builtin_actor_profiler::thread_data& builtin_actor_profiler::local_data() {
+  return threads_.local([](size_t index) {
+    auto ptr = std::make_shared<thread_data>();
+    ptr->index = index;
+    return ptr;
+  });
+}
+
+uint32_t builtin_actor_profiler::frame_id(thread_data& td,
+                                          const local_actor& self,
+                                          const mailbox_element& element) {
+  auto types = element.content().types();
+  auto key = std::make_pair(self.name(),
+                            static_cast<const void*>(types.data()));
+  if (auto i = td.frame_cache.find(key); i != td.frame_cache.end())
+    return i->second;
+  std::unique_lock<std::mutex> guard{intern_mtx_};
+  auto [i, added] = frame_ids_.emplace(key, 0);
+  if (added) {
+    i->second = static_cast<uint32_t>(frames_.size());
+    frames_.emplace_back(frame_info{self.name(), to_string(types)});
+  }
+  td.frame_cache.emplace(key, i->second);
+  return i->second;
+}
+
+uint32_t builtin_actor_profiler::stack_id(thread_data& td, uint32_t parent,
+                                          uint32_t frame) {
+  auto key = std::make_pair(parent, frame);
+  if (auto i = td.stack_cache.find(key); i != td.stack_cache.end())
+    return i->second;
+  std::unique_lock<std::mutex> guard{intern_mtx_};
+  // Start over at the root for very long chains, e.g., ping-pong patterns.
+  auto depth = stacks_[parent].depth + 1;
+  if (depth > max_stack_depth) {
+    parent = 0;
+    depth = 1;
+  }
+  auto [i, added] = stack_ids_.emplace(std::make_pair(parent, frame), 0);
+  if (added) {
+    i->second = static_cast<uint32_t>(stacks_.size());
+    stacks_.emplace_back(stack_node{parent, frame, depth});
+  }
+  td.stack_cache.emplace(key, i->second);
+  return i->second;
+}
+
+void builtin_actor_profiler::record_send(const local_actor& self,
+                                         const mailbox_element& element) {
+  auto& td = local_data();
+  if (td.active.empty() || td.active.back().self != &self)
+    return;
+  auto& frame = td.active.back();
+  ++frame.sends;
+  auto key = &element;
+  auto& sh = shards_[std::hash<const void*>{}(key) % num_shards];
+  std::unique_lock<std::mutex> guard{sh.mtx};
+  if (sh.pending.size() >= max_pending_per_shard)
+    sh.pending.clear();
+  sh.pending[key] = origin{element.sender.get(), frame.event, frame.stack,
+                           clock_type::now()};
+}
+
+std::string builtin_actor_profiler::render_stack(uint32_t id) const {
+  std::vector<uint32_t> path;
+  for (; id != 0; id = stacks_[id].parent)
+    path.emplace_back(stacks_[id].frame);
+  std::string result;
+  for (auto i = path.rbegin(); i != path.rend(); ++i) {
+    if (!result.empty())
+      result += ';';
+    auto& info = frames_[*i];
+    result += info.actor_type;
+    result += ':';
+    result += info.message_type;
+  }
+  return result;
+}
+
+} // namespace caf
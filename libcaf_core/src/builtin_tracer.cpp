@@ -0,0 +1,338 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/builtin_tracer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <random>
+
+#include "caf/actor_system.hpp"
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/deserializer.hpp"
+#include "caf/detail/print.hpp"
+#include "caf/invoke_message_result.hpp"
+#include "caf/local_actor.hpp"
+#include "caf/mailbox_element.hpp"
+#include "caf/node_id.hpp"
+#include "caf/serializer.hpp"
+
+namespace caf {
+
+namespace {
+
+// Tracks a handler that is currently running on this thread.
+struct active_frame {
+  // Stores whether the message carried a context.
+  bool traced;
+
+  // Stores whether the tracer records this span.
+  bool sampled;
+
+  // Only meaningful if `traced` is true.
+  builtin_tracer::span data;
+};
+
+int64_t unix_ns() {
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+void append_hex(std::string& out, uint64_t x) {
+  static constexpr char digits[] = "0123456789abcdef";
+  for (int shift = 60; shift >= 0; shift -= 4)
+    out += digits[(x >> shift) & 0x0F];
+}
+
+template <class Serializer>
+bool serialize_context(Serializer& sink, const builtin_tracer::context& x) {
+  return sink.apply(x.trace_id_high)   //
+         && sink.apply(x.trace_id_low) //
+         && sink.apply(x.parent_id)    //
+         && sink.apply(x.sampled);
+}
+
+template <class Deserializer>
+bool deserialize_context(Deserializer& source,
+                         std::unique_ptr<tracing_data>& dst) {
+  uint64_t trace_id_high = 0;
+  uint64_t trace_id_low = 0;
+  uint64_t parent_id = 0;
+  bool sampled = false;
+  if (!source.apply(trace_id_high) || !source.apply(trace_id_low)
+      || !source.apply(parent_id) || !source.apply(sampled))
+    return false;
+  dst.reset(new builtin_tracer::context(trace_id_high, trace_id_low, parent_id,
+                                        sampled));
+  return true;
+}
+
+} // namespace
+
+struct builtin_tracer::thread_data {
+  explicit thread_data(uint64_t seed) : rng_state(seed != 0 ? seed : 1) {
+    // nop
+  }
+
+  /// Returns the next number of the xorshift64* generator. Never returns 0.
+  uint64_t next_random() noexcept {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1Dull;
+  }
+
+  /// State of the random number generator for trace and span IDs. Only
+  /// accessed by the owning thread.
+  uint64_t rng_state;
+
+  /// Stores the running handlers. Only accessed by the owning thread.
+  std::vector<active_frame> active;
+
+  /// Stores whether this thread already set the node ID of the tracer. Only
+  /// accessed by the owning thread.
+  bool has_node = false;
+
+  /// Guards the members below.
+  std::mutex mtx;
+
+  /// Stores the most recent spans.
+  std::vector<span> ring;
+
+  /// Points to the oldest span once `ring` reached its capacity.
+  size_t pos = 0;
+};
+
+// -- context ------------------------------------------------------------------
+
+builtin_tracer::context::context(uint64_t trace_id_high, uint64_t trace_id_low,
+                                 uint64_t parent_id, bool sampled) noexcept
+  : trace_id_high(trace_id_high),
+    trace_id_low(trace_id_low),
+    parent_id(parent_id),
+    sampled(sampled) {
+  // nop
+}
+
+builtin_tracer::context::~context() {
+  // nop
+}
+
+bool builtin_tracer::context::serialize(serializer& sink) const {
+  return serialize_context(sink, *this);
+}
+
+bool builtin_tracer::context::serialize(binary_serializer& sink) const {
+  return serialize_context(sink, *this);
+}
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+builtin_tracer::builtin_tracer(double sample_rate, size_t capacity)
+  : sample_rate_(std::clamp(sample_rate, 0.0, 1.0)),
+    capacity_(std::max(capacity, size_t{1})) {
+  using limits = std::numeric_limits<uint64_t>;
+  if (sample_rate_ >= 1.0)
+    sample_threshold_ = limits::max();
+  else
+    sample_threshold_ = static_cast<uint64_t>(sample_rate_ * 0x1p64);
+}
+
+builtin_tracer::~builtin_tracer() {
+  // nop
+}
+
+// -- actor_profiler overrides -------------------------------------------------
+
+void builtin_tracer::add_actor(const local_actor&, const local_actor*) {
+  // nop
+}
+
+void builtin_tracer::remove_actor(const local_actor&) {
+  // nop
+}
+
+void builtin_tracer::before_processing(
+  [[maybe_unused]] const local_actor& self,
+  [[maybe_unused]] const mailbox_element& element) {
+  auto& td = local_data();
+  auto& frame = td.active.emplace_back();
+  frame.traced = false;
+  frame.sampled = false;
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+  auto ctx = dynamic_cast<const context*>(element.tracing_id.get());
+  if (ctx == nullptr)
+    return;
+  frame.traced = true;
+  frame.sampled = ctx->sampled;
+  auto& x = frame.data;
+  x.trace_id_high = ctx->trace_id_high;
+  x.trace_id_low = ctx->trace_id_low;
+  x.parent_id = ctx->parent_id;
+  if (!ctx->sampled)
+    return;
+  if (!td.has_node) {
+    std::unique_lock<std::mutex> guard{node_mtx_};
+    if (node_.empty())
+      node_ = to_string(self.home_system().node());
+    td.has_node = true;
+  }
+  x.span_id = td.next_random();
+  x.actor_name = self.name();
+  x.aid = self.id();
+  x.message_types = element.content().types();
+  x.start = unix_ns();
+#endif // CAF_ENABLE_ACTOR_PROFILER
+}
+
+void builtin_tracer::after_processing(const local_actor&,
+                                      invoke_message_result result) {
+  auto& td = local_data();
+  if (td.active.empty())
+    return;
+  auto& frame = td.active.back();
+  if (frame.sampled && result != invoke_message_result::skipped) {
+    frame.data.end = unix_ns();
+    std::unique_lock<std::mutex> guard{td.mtx};
+    if (td.ring.size() < capacity_) {
+      td.ring.emplace_back(frame.data);
+    } else {
+      td.ring[td.pos] = frame.data;
+      td.pos = (td.pos + 1) % capacity_;
+    }
+  }
+  td.active.pop_back();
+}
+
+void builtin_tracer::before_sending(const local_actor&,
+                                    [[maybe_unused]] mailbox_element& element) {
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+  element.tracing_id = make_context(local_data());
+#endif // CAF_ENABLE_ACTOR_PROFILER
+}
+
+void builtin_tracer::before_sending_scheduled(
+  const local_actor& self, actor_clock::time_point,
+  mailbox_element& element) {
+  before_sending(self, element);
+}
+
+// -- tracing_data_factory overrides -------------------------------------------
+
+bool builtin_tracer::deserialize(deserializer& source,
+                                 std::unique_ptr<tracing_data>& dst) const {
+  return deserialize_context(source, dst);
+}
+
+bool builtin_tracer::deserialize(binary_deserializer& source,
+                                 std::unique_ptr<tracing_data>& dst) const {
+  return deserialize_context(source, dst);
+}
+
+// -- exporting ----------------------------------------------------------------
+
+std::vector<builtin_tracer::span> builtin_tracer::spans() const {
+  std::vector<span> result;
+  threads_.with_entries([&result](auto& xs) {
+    for (auto& td : xs) {
+      std::unique_lock<std::mutex> td_guard{td->mtx};
+      auto& ring = td->ring;
+      for (size_t i = 0; i < ring.size(); ++i)
+        result.emplace_back(ring[(td->pos + i) % ring.size()]);
+    }
+  });
+  std::stable_sort(result.begin(), result.end(),
+                   [](const span& x, const span& y) {
+                     return x.start < y.start;
+                   });
+  return result;
+}
+
+void builtin_tracer::write_otlp_json(std::ostream& out) const {
+  auto xs = spans();
+  std::string node;
+  {
+    std::unique_lock<std::mutex> guard{node_mtx_};
+    node = node_;
+  }
+  std::string buf;
+  // Renders a single key-value pair of an attribute list.
+  auto add_attribute = [&buf](string_view key, string_view type,
+                              string_view value) {
+    buf += R"({"key":)";
+    detail::print_escaped(buf, key);
+    buf += R"(,"value":{")";
+    buf.insert(buf.end(), type.begin(), type.end());
+    buf += R"(":)";
+    detail::print_escaped(buf, value);
+    buf += "}}";
+  };
+  buf += R"({"resourceSpans":[{"resource":{"attributes":[)";
+  add_attribute("service.name", "stringValue", "caf");
+  if (!node.empty()) {
+    buf += ',';
+    add_attribute("caf.node", "stringValue", node);
+  }
+  buf += R"(]},"scopeSpans":[{"scope":{"name":"caf.builtin_tracer"},)";
+  buf += R"("spans":[)";
+  for (size_t i = 0; i < xs.size(); ++i) {
+    auto& x = xs[i];
+    if (i > 0)
+      buf += ",\n";
+    buf += R"({"traceId":")";
+    append_hex(buf, x.trace_id_high);
+    append_hex(buf, x.trace_id_low);
+    buf += R"(","spanId":")";
+    append_hex(buf, x.span_id);
+    if (x.parent_id != 0) {
+      buf += R"(","parentSpanId":")";
+      append_hex(buf, x.parent_id);
+    }
+    buf += R"(","name":)";
+    detail::print_escaped(buf, x.actor_name);
+    // Processing a message corresponds to SPAN_KIND_CONSUMER.
+    buf += R"(,"kind":5,"startTimeUnixNano":")";
+    buf += std::to_string(x.start);
+    buf += R"(","endTimeUnixNano":")";
+    buf += std::to_string(x.end);
+    buf += R"(","attributes":[)";
+    add_attribute("caf.actor.id", "intValue", std::to_string(x.aid));
+    buf += ',';
+    add_attribute("caf.message.types", "stringValue",
+                  to_string(x.message_types));
+    buf += "]}";
+  }
+  buf += "]}]}]}\n";
+  out << buf;
+}
+
+// -- utility functions --------------------------------------------------------
+
+builtin_tracer::thread_data& builtin_tracer::local_data() {
+  return threads_.local([](size_t) {
+    std::random_device rd;
+    auto seed = (uint64_t{rd()} << 32) | rd();
+    return std::make_shared<thread_data>(seed);
+  });
+}
+
+std::unique_ptr<builtin_tracer::context>
+builtin_tracer::make_context(thread_data& td) {
+  // Messages from a traced handler continue its trace.
+  if (!td.active.empty() && td.active.back().traced) {
+    auto& frame = td.active.back();
+    auto& x = frame.data;
+    return std::make_unique<context>(x.trace_id_high, x.trace_id_low,
+                                     frame.sampled ? x.span_id : 0,
+                                     frame.sampled);
+  }
+  // All other messages start a new trace.
+  auto sampled = td.next_random() <= sample_threshold_;
+  return std::make_unique<context>(td.next_random(), td.next_random(), 0,
+                                   sampled);
+}
+
+} // namespace caf
@@ -512,9 +512,11 @@ config_value::parse_msg_impl(string_view str,
       auto unused = size_t{0};
       reader.begin_sequence(unused);
       CAF_ASSERT(unused == ls_size);
+      auto& layout = detail::layout_of(ls);
       intrusive_ptr<detail::message_data> ptr;
-      if (auto vptr = malloc(sizeof(detail::message_data) + ls.data_size()))
-        ptr.reset(new (vptr) detail::message_data(ls), false);
+      if (auto vptr = malloc(sizeof(detail::message_data)
+                             + layout.storage_size))
+        ptr.reset(new (vptr) detail::message_data(ls, layout), false);
       else
         return false;
       auto pos = ptr->storage();
@@ -0,0 +1,206 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/binary_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+
+namespace caf::detail {
+
+namespace {
+
+constexpr char magic[] = {'C', 'A', 'F', 'L', 'O', 'G'};
+
+// Tags a record that assigns an ID to a string.
+constexpr char string_tag = 'S';
+
+// Tags a record that contains a log event.
+constexpr char event_tag = 'E';
+
+template <class T>
+void append_int(std::vector<char>& buf, T x) {
+  auto y = static_cast<std::make_unsigned_t<T>>(x);
+  for (size_t i = 0; i < sizeof(T); ++i)
+    buf.push_back(static_cast<char>((y >> (i * 8)) & 0xFF));
+}
+
+int64_t to_ns(timestamp x) {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  return duration_cast<nanoseconds>(x.time_since_epoch()).count();
+}
+
+} // namespace
+
+// -- binary_log_writer --------------------------------------------------------
+
+binary_log_writer::binary_log_writer(std::ostream& out, timestamp t0)
+  : out_(out) {
+  buf_.insert(buf_.end(), std::begin(magic), std::end(magic));
+  append_int(buf_, version);
+  append_int(buf_, to_ns(t0));
+  out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+  buf_.clear();
+}
+
+void binary_log_writer::write(const logger::event& x) {
+  // Writes string records for new strings to buf_ before the event itself.
+  auto category = string_id(x.category_name);
+  auto pretty_fun = string_id(x.pretty_fun);
+  auto simple_fun = string_id(x.simple_fun);
+  auto file_name = string_id(x.file_name);
+  auto thread = thread_id(x.tid);
+  buf_.push_back(event_tag);
+  append_int(buf_, static_cast<uint8_t>(x.level));
+  append_int(buf_, static_cast<uint32_t>(x.line_number));
+  append_int(buf_, to_ns(x.tstamp));
+  append_int(buf_, static_cast<uint64_t>(x.aid));
+  append_int(buf_, category);
+  append_int(buf_, pretty_fun);
+  append_int(buf_, simple_fun);
+  append_int(buf_, file_name);
+  append_int(buf_, thread);
+  append_int(buf_, static_cast<uint32_t>(x.message.size()));
+  buf_.insert(buf_.end(), x.message.begin(), x.message.end());
+  out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+  buf_.clear();
+}
+
+uint32_t binary_log_writer::string_id(string_view str) {
+  auto key = std::make_pair(str.data(), str.size());
+  if (auto i = strings_.find(key); i != strings_.end())
+    return i->second;
+  auto id = add_string(str);
+  strings_.emplace(key, id);
+  return id;
+}
+
+uint32_t binary_log_writer::thread_id(std::thread::id tid) {
+  if (auto i = threads_.find(tid); i != threads_.end())
+    return i->second;
+  std::ostringstream oss;
+  oss << tid;
+  auto id = add_string(oss.str());
+  threads_.emplace(tid, id);
+  return id;
+}
+
+uint32_t binary_log_writer::add_string(string_view str) {
+  auto id = next_id_++;
+  buf_.push_back(string_tag);
+  append_int(buf_, id);
+  append_int(buf_, static_cast<uint32_t>(str.size()));
+  buf_.insert(buf_.end(), str.begin(), str.end());
+  return id;
+}
+
+// -- binary_log_reader --------------------------------------------------------
+
+binary_log_reader::binary_log_reader(std::istream& in) : in_(in) {
+  char hdr[sizeof(magic)];
+  uint16_t hdr_version = 0;
+  int64_t t0 = 0;
+  valid_ = read_bytes(hdr, sizeof(hdr))
+           && std::equal(std::begin(hdr), std::end(hdr), std::begin(magic))
+           && read_int(hdr_version)
+           && hdr_version == binary_log_writer::version && read_int(t0);
+  if (valid_)
+    t0_ = timestamp{timespan{t0}};
+}
+
+bool binary_log_reader::next(logger::event& x) {
+  if (!valid_)
+    return false;
+  for (;;) {
+    char tag = 0;
+    if (!read_bytes(&tag, 1)) {
+      // Reaching the end of the input between two records is fine.
+      valid_ = in_.gcount() == 0 && in_.eof();
+      return false;
+    }
+    if (tag == string_tag) {
+      uint32_t id = 0;
+      uint32_t len = 0;
+      if (!read_int(id) || !read_int(len) || id != strings_.size()) {
+        valid_ = false;
+        return false;
+      }
+      auto& str = strings_.emplace_back(len, '\0');
+      if (!read_bytes(str.data(), len)) {
+        valid_ = false;
+        return false;
+      }
+    } else if (tag == event_tag) {
+      uint8_t level = 0;
+      uint32_t line = 0;
+      int64_t ts = 0;
+      uint64_t aid = 0;
+      uint32_t len = 0;
+      if (!read_int(level) || !read_int(line) || !read_int(ts)
+          || !read_int(aid) || !read_string_ref(x.category_name)
+          || !read_string_ref(x.pretty_fun) || !read_string_ref(x.simple_fun)
+          || !read_string_ref(x.file_name) || !read_string_ref(x.thread_name)
+          || !read_int(len)) {
+        valid_ = false;
+        return false;
+      }
+      x.message.resize(len);
+      if (!read_bytes(x.message.data(), len)) {
+        valid_ = false;
+        return false;
+      }
+      x.level = level;
+      x.line_number = line;
+      x.tid = std::thread::id{};
+      x.aid = aid;
+      x.tstamp = timestamp{timespan{ts}};
+      return true;
+    } else {
+      valid_ = false;
+      return false;
+    }
+  }
+}
+
+bool binary_log_reader::read_bytes(void* dst, size_t n) {
+  in_.read(static_cast<char*>(dst), static_cast<std::streamsize>(n));
+  return in_.gcount() == static_cast<std::streamsize>(n);
+}
+
+template <class T>
+bool binary_log_reader::read_int(T& x) {
+  unsigned char bytes[sizeof(T)];
+  if (!read_bytes(bytes, sizeof(T)))
+    return false;
+  std::make_unsigned_t<T> result = 0;
+  for (size_t i = 0; i < sizeof(T); ++i)
+    result |= static_cast<std::make_unsigned_t<T>>(bytes[i]) << (i * 8);
+  x = static_cast<T>(result);
+  return true;
+}
+
+bool binary_log_reader::read_string_ref(string_view& x) {
+  uint32_t id = 0;
+  if (!read_int(id) || id >= strings_.size())
+    return false;
+  x = strings_[id];
+  return true;
+}
+
+// -- free functions -----------------------------------------------------------
+
+bool render_binary_log(std::istream& in, std::ostream& out,
+                       const logger::line_format& lf) {
+  binary_log_reader reader{in};
+  logger::event x;
+  while (reader.next(x))
+    logger::render_event(out, lf, x, reader.t0());
+  return reader.valid();
+}
+
+} // namespace caf::detail
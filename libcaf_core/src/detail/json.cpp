@@ -4,7 +4,10 @@
 
 #include "caf/detail/json.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <limits>
 #include <memory>
 
 #include "caf/config.hpp"
@@ -15,6 +18,10 @@
 #include "caf/detail/scope_guard.hpp"
 #include "caf/pec.hpp"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 CAF_PUSH_UNUSED_LABEL_WARNING
 
 #include "caf/detail/parser/fsm.hpp"
@@ -260,6 +267,331 @@ namespace caf::detail::json {
 
 namespace {
 
+// Returns whether `chars` contains `c`.
+bool is_one_of(char c, string_view chars) noexcept {
+  return chars.find(c) != string_view::npos;
+}
+
+// Returns whether `c` is one of the characters that separate JSON values.
+constexpr bool is_structural(char c) noexcept {
+  switch (c) {
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Tracks the state of the first stage across blocks of the input.
+struct indexer {
+  std::vector<uint32_t>& result;
+  bool in_string = false;
+  bool escaped = false;
+
+  // Appends the position of all structural characters and of all unescaped
+  // quotes in `str[first, last)` to the result, one character at a time.
+  void scan(const char* str, size_t first, size_t last) {
+    for (auto pos = first; pos < last; ++pos) {
+      auto c = str[pos];
+      if (in_string) {
+        if (escaped) {
+          escaped = false;
+        } else if (c == '\\') {
+          escaped = true;
+        } else if (c == '"') {
+          result.push_back(static_cast<uint32_t>(pos));
+          in_string = false;
+        }
+      } else if (c == '"') {
+        result.push_back(static_cast<uint32_t>(pos));
+        in_string = true;
+      } else if (is_structural(c)) {
+        result.push_back(static_cast<uint32_t>(pos));
+      }
+    }
+  }
+};
+
+#ifdef __SSE2__
+
+// Computes the prefix XOR of all bits, i.e., bit i of the result is the XOR
+// of the bits 0 through i of `x`.
+uint32_t prefix_xor(uint32_t x) noexcept {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  return x & 0xFFFF;
+}
+
+// Returns a mask with bit i set if character i of a block is escaped, i.e.,
+// follows an odd number of backslashes. Only the lower 16 bits of
+// `backslashes` are valid. Bit 0 of the result is set if `escaped` is true,
+// i.e., if the previous block ended on an unescaped backslash. Updates
+// `escaped` for the next block.
+uint32_t escaped_chars(uint32_t backslashes, bool& escaped) noexcept {
+  // Subtracting the start of each backslash sequence from the bits after the
+  // sequence flips the bits in the sequence and carries into the character
+  // after it. The odd bits tell apart sequences of odd and even length.
+  constexpr uint32_t odd_bits = 0xAAAA;
+  auto carry = escaped ? 1u : 0u;
+  auto starts = backslashes & ~carry;
+  auto codes = ((((starts << 1) & 0xFFFF) | odd_bits) - starts) ^ odd_bits;
+  codes &= 0xFFFF;
+  escaped = ((codes & backslashes) & 0x8000) != 0;
+  return (codes ^ (backslashes | carry)) & 0xFFFF;
+}
+
+// Scans 16 bytes at once. Expects `first` and `last - first` to be multiples
+// of 16 unless `last` is the end of the input.
+void index_blocks(indexer& f, const char* str, size_t first, size_t last) {
+  auto eq = [](__m128i chunk, char c) {
+    return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+  };
+  auto pos = first;
+  for (; pos + 16 <= last; pos += 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos));
+    auto backslashes = static_cast<uint32_t>(
+      _mm_movemask_epi8(eq(chunk, '\\')));
+    // Backslashes outside of strings are invalid. Hence, the second stage
+    // rejects the input if masking a quote here is wrong.
+    auto quotes = static_cast<uint32_t>(_mm_movemask_epi8(eq(chunk, '"')))
+                  & ~escaped_chars(backslashes, f.escaped);
+    auto structurals = _mm_or_si128(
+      _mm_or_si128(_mm_or_si128(eq(chunk, '{'), eq(chunk, '}')),
+                   _mm_or_si128(eq(chunk, '['), eq(chunk, ']'))),
+      _mm_or_si128(eq(chunk, ':'), eq(chunk, ',')));
+    // Bit i of `inside` is set for opening quotes and all characters up to
+    // (excluding) the closing quote.
+    auto inside = prefix_xor(quotes) ^ (f.in_string ? 0xFFFFu : 0u);
+    auto bits = (static_cast<uint32_t>(_mm_movemask_epi8(structurals))
+                 & ~inside)
+                | quotes;
+    f.in_string = (inside & 0x8000) != 0;
+    while (bits != 0) {
+      auto offset = static_cast<size_t>(__builtin_ctz(bits));
+      f.result.push_back(static_cast<uint32_t>(pos + offset));
+      bits &= bits - 1;
+    }
+  }
+  f.scan(str, pos, last);
+}
+
+#else
+
+void index_blocks(indexer& f, const char* str, size_t first, size_t last) {
+  f.scan(str, first, last);
+}
+
+#endif
+
+// Builds the value tree from the structural index of the input. Indexes the
+// input in chunks as the tree grows, so that an error near the start of a
+// large input fails fast instead of indexing the remainder first.
+class tree_builder {
+public:
+  // Number of bytes the first stage indexes at once. Must be a multiple of 16.
+  static constexpr size_t chunk_size = 4096;
+
+  tree_builder(string_view input, monotonic_buffer_resource* storage)
+    : str_(input.data()), size_(input.size()), storage_(storage) {
+    index_.reserve(size_ / 8 + 16);
+  }
+
+  tree_builder(const tree_builder&) = delete;
+
+  tree_builder& operator=(const tree_builder&) = delete;
+
+  bool run(value& root) {
+    // Valid input has no structural characters after the root value.
+    return read_value(root, 0) && !fill(pos_) && skip_ws(end_, size_);
+  }
+
+private:
+  // Returns whether `c` is a whitespace character for the FSM.
+  static bool is_ws(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n';
+  }
+
+  // Returns whether `str_[first, last)` contains only whitespace.
+  bool skip_ws(size_t first, size_t last) const noexcept {
+    for (auto i = first; i < last; ++i)
+      if (!is_ws(str_[i]))
+        return false;
+    return true;
+  }
+
+  // Indexes more of the input until `index_[n]` exists or the index covers
+  // the entire input. Returns whether `index_[n]` exists.
+  bool fill(size_t n) {
+    while (index_.size() <= n && indexed_ < size_) {
+      auto last = std::min(indexed_ + chunk_size, size_);
+      index_blocks(indexer_, str_, indexed_, last);
+      indexed_ = last;
+    }
+    return n < index_.size();
+  }
+
+  // Returns the position of the next structural character or `size_`.
+  size_t next() {
+    return fill(pos_) ? index_[pos_] : size_;
+  }
+
+  // Consumes the structural character `c` if only whitespace precedes it.
+  bool consume(char c, size_t first) {
+    auto at = next();
+    if (at == size_ || str_[at] != c || !skip_ws(first, at))
+      return false;
+    ++pos_;
+    end_ = at + 1;
+    return true;
+  }
+
+  // Reads a string starting at the quote at `index_[pos_]`.
+  bool read_string(string_view& x) {
+    if (!fill(pos_ + 1))
+      return false;
+    auto first = index_[pos_] + size_t{1};
+    auto last = size_t{index_[pos_ + 1]};
+    // Accept the same escape sequences as the FSM.
+    for (auto i = first; i < last; ++i) {
+      auto ptr = std::memchr(str_ + i, '\\', last - i);
+      if (ptr == nullptr)
+        break;
+      i = static_cast<size_t>(static_cast<const char*>(ptr) - str_);
+      if (++i == last || !is_one_of(str_[i], "\"\\/bfnrt"))
+        return false;
+    }
+    x = string_view{str_ + first, last - first};
+    pos_ += 2;
+    end_ = last + 1;
+    return true;
+  }
+
+  // Reads a number, boolean, null or NaN from `str_[first, last)`. Runs the
+  // same FSMs as `read_value` on the remainder of the input to match its
+  // behavior exactly, e.g., for accepting trailing whitespace.
+  bool read_scalar(value& x, size_t first, size_t last) {
+    while (first < last && is_ws(str_[first]))
+      ++first;
+    if (first == last)
+      return false;
+    string_parser_state ps{str_ + first, str_ + size_};
+    parser::val_consumer consumer{storage_, &x};
+    switch (str_[first]) {
+      case 'f':
+      case 't':
+        parser::read_bool(ps, consumer);
+        break;
+      case 'n':
+        parser::read_json_null_or_nan(ps, consumer);
+        break;
+      default:
+        if (!is_one_of(str_[first], "+-.0123456789"))
+          return false;
+        parser::read_number(ps, consumer);
+    }
+    if (ps.code > pec::trailing_character)
+      return false;
+    auto pos = static_cast<size_t>(ps.i - str_);
+    if (pos > last || !skip_ws(pos, last))
+      return false;
+    end_ = last;
+    return true;
+  }
+
+  // Reads any value that starts at or after `first`.
+  bool read_value(value& x, size_t first) {
+    auto at = next();
+    if (at == size_ || !skip_ws(first, at))
+      return read_scalar(x, first, at);
+    switch (str_[at]) {
+      case '"': {
+        string_view str;
+        if (!read_string(str))
+          return false;
+        x.data = str;
+        return true;
+      }
+      case '{':
+        ++pos_;
+        end_ = at + 1;
+        return read_object(x);
+      case '[':
+        ++pos_;
+        end_ = at + 1;
+        return read_array(x);
+      default:
+        return false;
+    }
+  }
+
+  bool read_object(value& x) {
+    auto mark = members_.size();
+    if (!consume('}', end_)) {
+      do {
+        auto at = next();
+        if (at == size_ || str_[at] != '"' || !skip_ws(end_, at))
+          return false;
+        member kvp;
+        if (!read_string(kvp.key) || !consume(':', end_))
+          return false;
+        kvp.val = make_value(storage_);
+        if (!read_value(*kvp.val, end_))
+          return false;
+        members_.push_back(kvp);
+      } while (consume(',', end_));
+      if (!consume('}', end_))
+        return false;
+    }
+    // Allocate the members once with their final size.
+    x.data = object{value::member_allocator{storage_}};
+    auto& obj = std::get<object>(x.data);
+    obj.reserve(members_.size() - mark);
+    obj.insert(obj.end(), members_.begin() + mark, members_.end());
+    members_.resize(mark);
+    return true;
+  }
+
+  bool read_array(value& x) {
+    auto mark = values_.size();
+    if (!consume(']', end_)) {
+      do {
+        // Nested values may grow `values_`. Hence, we cannot read into it.
+        value element;
+        if (!read_value(element, end_))
+          return false;
+        values_.emplace_back(std::move(element));
+      } while (consume(',', end_));
+      if (!consume(']', end_))
+        return false;
+    }
+    // Allocate the elements once with their final size.
+    x.data = array{value::array_allocator{storage_}};
+    auto& arr = std::get<array>(x.data);
+    arr.reserve(values_.size() - mark);
+    std::move(values_.begin() + mark, values_.end(), std::back_inserter(arr));
+    values_.resize(mark);
+    return true;
+  }
+
+  const char* str_;
+  size_t size_;
+  monotonic_buffer_resource* storage_;
+  std::vector<uint32_t> index_;
+  indexer indexer_{index_};
+  size_t indexed_ = 0;
+  size_t pos_ = 0;
+  size_t end_ = 0;
+  std::vector<value> values_;
+  std::vector<member> members_;
+};
+
 template <class T, class Allocator>
 void init(std::vector<T, Allocator>* ptr, monotonic_buffer_resource* storage) {
   new (ptr) std::vector<T, Allocator>(Allocator{storage});
@@ -302,4 +634,15 @@ value* parse(string_parser_state& ps, monotonic_buffer_resource* storage) {
   return result;
 }
 
+value* parse_indexed(string_view str, monotonic_buffer_resource* storage) {
+  if (str.size() >= std::numeric_limits<uint32_t>::max())
+    return nullptr;
+  monotonic_buffer_resource::allocator<value> alloc{storage};
+  auto result = new (alloc.allocate(1)) value();
+  tree_builder builder{str, storage};
+  if (!builder.run(*result))
+    return nullptr;
+  return result;
+}
+
 } // namespace caf::detail::json
@@ -7,6 +7,7 @@
 #include <cstring>
 #include <numeric>
 
+#include "caf/detail/message_layout.hpp"
 #include "caf/detail/meta_object.hpp"
 #include "caf/error.hpp"
 #include "caf/error_code.hpp"
@@ -17,8 +18,12 @@
 
 namespace caf::detail {
 
-message_data::message_data(type_id_list types) noexcept
-  : rc_(1), types_(std::move(types)), constructed_elements_(0) {
+message_data::message_data(type_id_list types,
+                           const message_layout& layout) noexcept
+  : rc_(1),
+    types_(std::move(types)),
+    layout_(&layout),
+    constructed_elements_(0) {
   // nop
 }
 
@@ -42,14 +47,12 @@ message_data::~message_data() noexcept {
 
 message_data* message_data::copy() const {
   auto gmos = global_meta_objects();
-  size_t storage_size = 0;
-  for (auto id : types_)
-    storage_size += gmos[id].padded_size;
-  auto total_size = sizeof(message_data) + storage_size;
+  auto total_size = sizeof(message_data) + layout_->storage_size;
   auto vptr = malloc(total_size);
   if (vptr == nullptr)
     CAF_RAISE_ERROR(std::bad_alloc, "bad_alloc");
-  intrusive_ptr<message_data> ptr{new (vptr) message_data(types_), false};
+  intrusive_ptr<message_data> ptr{new (vptr) message_data(types_, *layout_),
+                                  false};
   auto src = storage();
   auto dst = ptr->storage();
   for (auto id : types_) {
@@ -64,35 +67,20 @@ message_data* message_data::copy() const {
 
 intrusive_ptr<message_data>
 message_data::make_uninitialized(type_id_list types) {
-  auto gmos = global_meta_objects();
-  size_t storage_size = 0;
-  for (auto id : types)
-    storage_size += gmos[id].padded_size;
-  auto total_size = sizeof(message_data) + storage_size;
+  auto& layout = layout_of(types);
+  auto total_size = sizeof(message_data) + layout.storage_size;
   auto vptr = malloc(total_size);
   if (vptr == nullptr)
     CAF_RAISE_ERROR(std::bad_alloc, "bad_alloc");
-  return {new (vptr) message_data(types), false};
+  return {new (vptr) message_data(types, layout), false};
 }
 
 byte* message_data::at(size_t index) noexcept {
-  if (index == 0)
-    return storage();
-  auto gmos = global_meta_objects();
-  auto ptr = storage();
-  for (size_t i = 0; i < index; ++i)
-    ptr += gmos[types_[i]].padded_size;
-  return ptr;
+  return storage() + layout_->offsets[index];
 }
 
 const byte* message_data::at(size_t index) const noexcept {
-  if (index == 0)
-    return storage();
-  auto gmos = global_meta_objects();
-  auto ptr = storage();
-  for (size_t i = 0; i < index; ++i)
-    ptr += gmos[types_[i]].padded_size;
-  return ptr;
+  return storage() + layout_->offsets[index];
 }
 
 byte* message_data::stepwise_init_from(byte* pos, const message& msg) {
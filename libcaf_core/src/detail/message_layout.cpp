@@ -0,0 +1,75 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/message_layout.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "caf/detail/meta_object.hpp"
+#include "caf/detail/shared_spinlock.hpp"
+#include "caf/locks.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+using layout_ptr = std::unique_ptr<message_layout>;
+
+using exclusive_guard = unique_lock<shared_spinlock>;
+
+using shared_guard = shared_lock<shared_spinlock>;
+
+struct local_cache_entry {
+  const type_id_t* key;
+  const message_layout* value;
+};
+
+constexpr size_t local_cache_size = 16;
+
+thread_local local_cache_entry local_cache[local_cache_size];
+
+shared_spinlock layouts_mtx;
+
+std::unordered_map<const type_id_t*, layout_ptr> layouts;
+
+layout_ptr make_layout(type_id_list types) {
+  auto result = std::make_unique<message_layout>();
+  result->offsets.reserve(types.size());
+  for (auto id : types) {
+    result->offsets.emplace_back(result->storage_size);
+    if (auto meta = global_meta_object(id))
+      result->storage_size += meta->padded_size;
+    else
+      result->valid = false;
+  }
+  return result;
+}
+
+} // namespace
+
+const message_layout& layout_of(type_id_list types) {
+  auto key = types.data();
+  auto& entry = local_cache[(reinterpret_cast<uintptr_t>(key) / sizeof(void*))
+                            % local_cache_size];
+  if (entry.key == key)
+    return *entry.value;
+  const message_layout* result = nullptr;
+  { // Lifetime scope of guard.
+    shared_guard guard{layouts_mtx};
+    if (auto i = layouts.find(key); i != layouts.end())
+      result = i->second.get();
+  }
+  if (result == nullptr) {
+    auto ptr = make_layout(types);
+    exclusive_guard guard{layouts_mtx};
+    result = layouts.emplace(key, std::move(ptr)).first->second.get();
+  }
+  entry.key = key;
+  entry.value = result;
+  return *result;
+}
+
+} // namespace caf::detail
@@ -0,0 +1,52 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/sharded_cells.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace caf::detail {
+
+size_t this_thread_shard() noexcept {
+  static std::atomic<size_t> next_shard;
+  thread_local size_t shard = next_shard.fetch_add(1,
+                                                   std::memory_order_relaxed);
+  return shard;
+}
+
+namespace {
+
+constexpr size_t cells_per_line = CAF_CACHE_LINE_SIZE
+                                  / sizeof(sharded_cells::cell_type);
+
+static_assert(cells_per_line > 0);
+
+} // namespace
+
+sharded_cells::sharded_cells(size_t num_shards, size_t cells_per_shard) {
+  num_shards = std::min(std::max(num_shards, size_t{1}), max_shards);
+  auto rounded = size_t{1};
+  while (rounded < num_shards)
+    rounded <<= 1;
+  mask_ = rounded - 1;
+  auto lines = (std::max(cells_per_shard, size_t{1}) + cells_per_line - 1)
+               / cells_per_line;
+  stride_ = lines * cells_per_line;
+  auto total = rounded * stride_;
+  auto align = std::align_val_t{CAF_CACHE_LINE_SIZE};
+  auto vptr = ::operator new(total * sizeof(cell_type), align);
+  cells_ = static_cast<cell_type*>(vptr);
+  for (size_t index = 0; index < total; ++index)
+    new (cells_ + index) cell_type(0);
+}
+
+sharded_cells::~sharded_cells() {
+  auto total = (mask_ + 1) * stride_;
+  for (size_t index = 0; index < total; ++index)
+    cells_[index].~cell_type();
+  ::operator delete(cells_, std::align_val_t{CAF_CACHE_LINE_SIZE});
+}
+
+} // namespace caf::detail
@@ -0,0 +1,85 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/spsc_byte_queue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace caf::detail {
+
+namespace {
+
+constexpr size_t next_power_of_two(size_t x) {
+  size_t result = 64;
+  while (result < x)
+    result <<= 1;
+  return result;
+}
+
+} // namespace
+
+spsc_byte_queue::spsc_byte_queue(size_t capacity)
+  : mask_(next_power_of_two(capacity) - 1),
+    buf_(new char[mask_ + 1]),
+    rd_pos_(0),
+    wr_pos_(0) {
+  // nop
+}
+
+bool spsc_byte_queue::try_push(const void* header, size_t header_size,
+                               const void* payload,
+                               size_t payload_size) noexcept {
+  auto len = header_size + payload_size;
+  auto total = sizeof(uint32_t) + len;
+  auto wr = wr_pos_.load(std::memory_order_relaxed);
+  auto rd = rd_pos_.load(std::memory_order_acquire);
+  if (capacity() - (wr - rd) < total)
+    return false;
+  auto len32 = static_cast<uint32_t>(len);
+  write(wr, &len32, sizeof(uint32_t));
+  write(wr + sizeof(uint32_t), header, header_size);
+  write(wr + sizeof(uint32_t) + header_size, payload, payload_size);
+  // Publishes the record to the consumer.
+  wr_pos_.store(wr + total, std::memory_order_release);
+  return true;
+}
+
+bool spsc_byte_queue::try_pop(std::vector<char>& buf) {
+  auto rd = rd_pos_.load(std::memory_order_relaxed);
+  auto wr = wr_pos_.load(std::memory_order_acquire);
+  if (rd == wr)
+    return false;
+  uint32_t len = 0;
+  read(rd, &len, sizeof(uint32_t));
+  buf.resize(len);
+  read(rd + sizeof(uint32_t), buf.data(), len);
+  // Releases the memory of the record to the producer.
+  rd_pos_.store(rd + sizeof(uint32_t) + len, std::memory_order_release);
+  return true;
+}
+
+void spsc_byte_queue::write(size_t pos, const void* src, size_t n) noexcept {
+  if (n == 0)
+    return;
+  auto offset = pos & mask_;
+  auto first = std::min(n, capacity() - offset);
+  auto bytes = static_cast<const char*>(src);
+  memcpy(buf_.get() + offset, bytes, first);
+  if (first < n)
+    memcpy(buf_.get(), bytes + first, n - first);
+}
+
+void spsc_byte_queue::read(size_t pos, void* dst, size_t n) const noexcept {
+  if (n == 0)
+    return;
+  auto offset = pos & mask_;
+  auto first = std::min(n, capacity() - offset);
+  auto bytes = static_cast<char*>(dst);
+  memcpy(bytes, buf_.get() + offset, first);
+  if (first < n)
+    memcpy(bytes + first, buf_.get(), n - first);
+}
+
+} // namespace caf::detail
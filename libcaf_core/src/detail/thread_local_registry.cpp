@@ -0,0 +1,22 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/thread_local_registry.hpp"
+
+#include <atomic>
+
+namespace caf::detail {
+
+namespace {
+
+std::atomic<uint64_t> next_id;
+
+} // namespace
+
+uint64_t next_thread_local_registry_id() noexcept {
+  // Starts at 1, since threads use 0 for "no registry".
+  return ++next_id;
+}
+
+} // namespace caf::detail
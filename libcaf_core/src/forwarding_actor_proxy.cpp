@@ -10,6 +10,7 @@
 #include "caf/logger.hpp"
 #include "caf/mailbox_element.hpp"
 #include "caf/send.hpp"
+#include "caf/tracing_data.hpp"
 
 namespace caf {
 
@@ -24,28 +25,40 @@ forwarding_actor_proxy::~forwarding_actor_proxy() {
 
 void forwarding_actor_proxy::forward_msg(strong_actor_ptr sender,
                                          message_id mid, message msg,
-                                         const forwarding_stack* fwd) {
+                                         const forwarding_stack* fwd,
+                                         [[maybe_unused]] tracing_data_ptr
+                                           tracing) {
   CAF_LOG_TRACE(CAF_ARG(id())
                 << CAF_ARG(sender) << CAF_ARG(mid) << CAF_ARG(msg));
   if (msg.match_elements<exit_msg>())
     unlink_from(msg.get_as<exit_msg>(0).source);
   forwarding_stack tmp;
   shared_lock<detail::shared_spinlock> guard(broker_mtx_);
-  if (broker_)
-    broker_->enqueue(nullptr, make_message_id(),
-                     make_message(forward_atom_v, std::move(sender),
-                                  fwd != nullptr ? *fwd : tmp,
-                                  strong_actor_ptr{ctrl()}, mid,
-                                  std::move(msg)),
-                     nullptr);
+  if (broker_) {
+    auto element = make_mailbox_element(
+      nullptr, make_message_id(), {},
+      make_message(forward_atom_v, std::move(sender),
+                   fwd != nullptr ? *fwd : tmp, strong_actor_ptr{ctrl()}, mid,
+                   std::move(msg)));
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+    // Hand the tracing data over to the BASP broker.
+    element->tracing_id = std::move(tracing);
+#endif // CAF_ENABLE_ACTOR_PROFILER
+    broker_->enqueue(std::move(element), nullptr);
+  }
 }
 
 void forwarding_actor_proxy::enqueue(mailbox_element_ptr what,
                                      execution_unit*) {
   CAF_PUSH_AID(0);
   CAF_ASSERT(what);
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+  forward_msg(std::move(what->sender), what->mid, std::move(what->payload),
+              &what->stages, std::move(what->tracing_id));
+#else
   forward_msg(std::move(what->sender), what->mid, std::move(what->payload),
               &what->stages);
+#endif // CAF_ENABLE_ACTOR_PROFILER
 }
 
 bool forwarding_actor_proxy::add_backlink(abstract_actor* x) {
@@ -0,0 +1,264 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/incremental_binary_deserializer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "caf/detail/message_layout.hpp"
+#include "caf/detail/meta_object.hpp"
+#include "caf/detail/type_id_list_builder.hpp"
+#include "caf/message.hpp"
+#include "caf/sec.hpp"
+#include "caf/shared_byte_span.hpp"
+#include "caf/shared_string_view.hpp"
+
+namespace caf {
+
+namespace {
+
+// Checks whether the binary format of `type` consists of a size prefix plus
+// the raw bytes.
+bool is_blob(type_id_t type) noexcept {
+  switch (type) {
+    default:
+      return false;
+    case type_id_v<std::string>:
+    case type_id_v<byte_buffer>:
+    case type_id_v<shared_byte_span>:
+    case type_id_v<shared_string_view>:
+      return true;
+  }
+}
+
+} // namespace
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+incremental_binary_deserializer::incremental_binary_deserializer(
+  execution_unit* ctx, size_t max_buffer_size) noexcept
+  : context_(ctx), max_buffer_size_(max_buffer_size) {
+  // nop
+}
+
+incremental_binary_deserializer::~incremental_binary_deserializer() {
+  // nop
+}
+
+// -- input management ---------------------------------------------------------
+
+void incremental_binary_deserializer::append(const_byte_span bytes) {
+  // Only move the buffered bytes to the front once the consumed prefix is at
+  // least as large. This keeps the total number of copied bytes linear.
+  if (pos_ > 0 && pos_ >= buffered()) {
+    buf_.erase(buf_.begin(), buf_.begin() + pos_);
+    pos_ = 0;
+  }
+  buf_.insert(buf_.end(), bytes.begin(), bytes.end());
+}
+
+void incremental_binary_deserializer::close() noexcept {
+  closed_ = true;
+}
+
+void incremental_binary_deserializer::reset() noexcept {
+  buf_.clear();
+  pos_ = 0;
+  consumed_ = 0;
+  next_attempt_ = 0;
+  closed_ = false;
+  err_.reset();
+  reset_message();
+}
+
+// -- loading ------------------------------------------------------------------
+
+incremental_binary_deserializer::load_result
+incremental_binary_deserializer::load(message& x) {
+  if (msg_data_ != nullptr)
+    return load_elements(x);
+  detail::type_id_list_builder ids;
+  auto res = apply_fn([&ids](binary_deserializer& source) {
+    auto size = size_t{0};
+    if (!source.begin_sequence(size))
+      return false;
+    using uint16_limits = std::numeric_limits<uint16_t>;
+    if (size > static_cast<size_t>(uint16_limits::max() - 1)) {
+      source.emplace_error(sec::invalid_argument, "too many types for message");
+      return false;
+    }
+    ids.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      auto id = type_id_t{0};
+      if (!source.value(id))
+        return false;
+      ids.push_back(id);
+    }
+    return source.end_sequence();
+  });
+  if (res != load_result::done)
+    return res;
+  return load_values(x, ids.move_to_list());
+}
+
+incremental_binary_deserializer::load_result
+incremental_binary_deserializer::load_values(message& x, type_id_list types) {
+  if (msg_data_ != nullptr)
+    return load_elements(x);
+  if (types.empty()) {
+    x.reset();
+    return load_result::done;
+  }
+  if (!detail::layout_of(types).valid) {
+    err_ = make_error(sec::unknown_type);
+    return load_result::failed;
+  }
+  msg_data_ = detail::message_data::make_uninitialized(types);
+  msg_loaded_ = 0;
+  element_constructed_ = false;
+  return load_elements(x);
+}
+
+incremental_binary_deserializer::load_result
+incremental_binary_deserializer::finalize(binary_deserializer& source,
+                                          bool ok) {
+  if (ok) {
+    auto n = buffered() - source.remaining();
+    pos_ += n;
+    consumed_ += n;
+    next_attempt_ = 0;
+    return load_result::done;
+  }
+  err_ = source.get_error();
+  if (err_ != sec::end_of_stream)
+    return load_result::failed;
+  if (closed_)
+    return load_result::failed;
+  if (max_buffer_size_ > 0 && buffered() >= max_buffer_size_) {
+    err_ = make_error(sec::runtime_error,
+                      "object exceeds the maximum buffer size");
+    return load_result::failed;
+  }
+  err_.reset();
+  next_attempt_ = std::max(buffered() * 2, buffered() + 1);
+  if (max_buffer_size_ > 0)
+    next_attempt_ = std::min(next_attempt_, max_buffer_size_);
+  return load_result::incomplete;
+}
+
+incremental_binary_deserializer::load_result
+incremental_binary_deserializer::load_elements(message& x) {
+  auto gmos = detail::global_meta_objects();
+  auto types = msg_data_->types();
+  auto& layout = detail::layout_of(types);
+  while (msg_loaded_ < types.size()) {
+    if (!ready())
+      return load_result::incomplete;
+    auto type = types[msg_loaded_];
+    auto& meta = gmos[type];
+    auto pos = msg_data_->storage() + layout.offsets[msg_loaded_];
+    auto res = load_result::done;
+    if (is_blob(type)) {
+      // Strings and byte buffers receive their bytes as they arrive. Hence,
+      // we keep partially loaded elements.
+      if (!element_constructed_) {
+        meta.default_construct(pos);
+        msg_data_->inc_constructed_elements();
+        element_constructed_ = true;
+      }
+      res = load_blob(type, pos);
+    } else {
+      // The previous attempt may have left the element in a partially loaded
+      // state. Hence, we start over from a default-constructed object.
+      if (element_constructed_) {
+        meta.destroy(pos);
+        meta.default_construct(pos);
+      } else {
+        meta.default_construct(pos);
+        msg_data_->inc_constructed_elements();
+        element_constructed_ = true;
+      }
+      res = apply_fn([&meta, pos](binary_deserializer& source) {
+        return meta.load_binary(source, pos);
+      });
+    }
+    if (res == load_result::incomplete)
+      return res;
+    if (res == load_result::failed) {
+      reset_message();
+      return res;
+    }
+    ++msg_loaded_;
+    element_constructed_ = false;
+  }
+  x.reset(msg_data_.release(), false);
+  msg_loaded_ = 0;
+  return load_result::done;
+}
+
+incremental_binary_deserializer::load_result
+incremental_binary_deserializer::load_blob(type_id_t type, void* ptr) {
+  if (!blob_started_) {
+    auto size = size_t{0};
+    auto res = apply_fn([&size](binary_deserializer& source) {
+      return source.begin_sequence(size);
+    });
+    if (res != load_result::done)
+      return res;
+    blob_started_ = true;
+    blob_pending_ = size;
+    blob_.clear();
+  }
+  // Append the available bytes without reserving `blob_pending_` bytes up
+  // front, since the size comes from the input.
+  auto n = std::min(buffered(), blob_pending_);
+  auto first = buf_.data() + pos_;
+  switch (type) {
+    case type_id_v<std::string>:
+      static_cast<std::string*>(ptr)->append(
+        reinterpret_cast<const char*>(first), n);
+      break;
+    case type_id_v<byte_buffer>: {
+      auto& xs = *static_cast<byte_buffer*>(ptr);
+      xs.insert(xs.end(), first, first + n);
+      break;
+    }
+    default:
+      blob_.insert(blob_.end(), first, first + n);
+  }
+  pos_ += n;
+  consumed_ += n;
+  blob_pending_ -= n;
+  if (blob_pending_ > 0) {
+    if (closed_) {
+      err_ = make_error(sec::end_of_stream);
+      return load_result::failed;
+    }
+    next_attempt_ = 1;
+    return load_result::incomplete;
+  }
+  blob_started_ = false;
+  next_attempt_ = 0;
+  if (type == type_id_v<shared_byte_span>) {
+    *static_cast<shared_byte_span*>(ptr) = shared_byte_span{std::move(blob_)};
+  } else if (type == type_id_v<shared_string_view>) {
+    auto str = std::string{reinterpret_cast<const char*>(blob_.data()),
+                           blob_.size()};
+    *static_cast<shared_string_view*>(ptr) = shared_string_view{std::move(str)};
+  }
+  blob_.clear();
+  return load_result::done;
+}
+
+void incremental_binary_deserializer::reset_message() noexcept {
+  msg_data_.reset();
+  msg_loaded_ = 0;
+  element_constructed_ = false;
+  blob_started_ = false;
+  blob_pending_ = 0;
+  blob_.clear();
+}
+
+} // namespace caf
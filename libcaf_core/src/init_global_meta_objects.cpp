@@ -22,6 +22,8 @@
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
 #include "caf/node_id.hpp"
+#include "caf/shared_byte_span.hpp"
+#include "caf/shared_string_view.hpp"
 #include "caf/system_messages.hpp"
 #include "caf/timespan.hpp"
 #include "caf/timestamp.hpp"
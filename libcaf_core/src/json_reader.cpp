@@ -141,20 +141,24 @@ json_reader::~json_reader() {
 
 bool json_reader::load(string_view json_text) {
   reset();
-  string_parser_state ps{json_text.begin(), json_text.end()};
-  root_ = detail::json::parse(ps, &buf_);
-  if (ps.code != pec::success) {
-    set_error(make_error(ps));
-    st_ = nullptr;
-    return false;
-  } else {
-    err_.reset();
-    detail::monotonic_buffer_resource::allocator<stack_type> alloc{&buf_};
-    st_ = new (alloc.allocate(1)) stack_type(stack_allocator{&buf_});
-    st_->reserve(16);
-    st_->emplace_back(root_);
-    return true;
+  root_ = detail::json::parse_indexed(json_text, &buf_);
+  if (root_ == nullptr) {
+    // Re-parse with the FSM to produce a precise error.
+    buf_.reclaim();
+    string_parser_state ps{json_text.begin(), json_text.end()};
+    root_ = detail::json::parse(ps, &buf_);
+    if (ps.code != pec::success) {
+      set_error(make_error(ps));
+      st_ = nullptr;
+      return false;
+    }
   }
+  err_.reset();
+  detail::monotonic_buffer_resource::allocator<stack_type> alloc{&buf_};
+  st_ = new (alloc.allocate(1)) stack_type(stack_allocator{&buf_});
+  st_->reserve(16);
+  st_->emplace_back(root_);
+  return true;
 }
 
 void json_reader::revert() {
@@ -7,6 +7,13 @@
 #include "caf/detail/append_hex.hpp"
 #include "caf/detail/print.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 namespace caf {
 
 namespace {
@@ -25,6 +32,53 @@ constexpr const char* json_type_name(json_writer::type t) {
   return json_type_names[static_cast<uint8_t>(t)];
 }
 
+// Returns whether the writer may not copy `c` verbatim into a string.
+constexpr bool needs_escaping(char c) noexcept {
+  return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+}
+
+// Returns how many characters at the front of `str` need no escaping. Checks
+// 16 characters at once when compiling with SSE2 and 8 characters at once
+// otherwise.
+size_t verbatim_prefix(const char* str, size_t size) noexcept {
+  size_t pos = 0;
+#ifdef __SSE2__
+  auto quote = _mm_set1_epi8('"');
+  auto backslash = _mm_set1_epi8('\\');
+  auto max_control = _mm_set1_epi8(0x1F);
+  for (; pos + 16 <= size; pos += 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + pos));
+    // A byte is a control character if min(byte, 0x1F) == byte (unsigned).
+    auto control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk);
+    auto special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                _mm_cmpeq_epi8(chunk, backslash));
+    auto mask = _mm_movemask_epi8(_mm_or_si128(control, special));
+    if (mask != 0)
+      return pos + static_cast<size_t>(__builtin_ctz(mask));
+  }
+#else
+  // Classic bit tricks for finding bytes in a word: `has_less(x, n)` is
+  // non-zero if any byte in x is less than n. Searching for a value v is the
+  // same as searching for bytes less than 1 in `x ^ broadcast(v)`.
+  constexpr uint64_t ones = 0x0101010101010101u;
+  constexpr uint64_t highs = 0x8080808080808080u;
+  auto has_less = [](uint64_t x, uint64_t n) {
+    return (x - ones * n) & ~x & highs;
+  };
+  for (; pos + 8 <= size; pos += 8) {
+    uint64_t word;
+    memcpy(&word, str + pos, sizeof(word));
+    auto hits = has_less(word, 0x20) | has_less(word ^ (ones * '"'), 1)
+                | has_less(word ^ (ones * '\\'), 1);
+    if (hits != 0)
+      break;
+  }
+#endif
+  while (pos < size && !needs_escaping(str[pos]))
+    ++pos;
+  return pos;
+}
+
 } // namespace
 
 // -- implementation details ---------------------------------------------------
@@ -77,6 +131,10 @@ void json_writer::reset() {
   push();
 }
 
+void json_writer::reserve(size_t num_bytes) {
+  buf_.reserve(buf_.size() + num_bytes);
+}
+
 // -- overrides ----------------------------------------------------------------
 
 bool json_writer::begin_object(type_id_t id, string_view name) {
@@ -366,17 +424,17 @@ bool json_writer::value(long double x) {
 bool json_writer::value(string_view x) {
   switch (top()) {
     case type::element:
-      detail::print_escaped(buf_, x);
+      add_escaped(x);
       pop();
       return true;
     case type::key:
-      detail::print_escaped(buf_, x);
+      add_escaped(x);
       add(": ");
       pop();
       return true;
     case type::array:
       sep();
-      detail::print_escaped(buf_, x);
+      add_escaped(x);
       return true;
     default:
       fail(type::string);
@@ -548,6 +606,57 @@ bool json_writer::inside_object() const noexcept {
 
 // -- printing ---------------------------------------------------------------
 
+void json_writer::add_escaped(string_view str) {
+  // Produces the same output as detail::print_escaped but copies all
+  // characters between two escape sequences at once.
+  // Grow geometrically, since reserving the exact size for each string would
+  // cause a reallocation per string once the buffer is full.
+  auto required = buf_.size() + str.size() + 2;
+  if (buf_.capacity() < required)
+    buf_.reserve(std::max(2 * buf_.capacity(), required));
+  add('"');
+  auto first = str.data();
+  auto remaining = str.size();
+  while (remaining > 0) {
+    auto n = verbatim_prefix(first, remaining);
+    buf_.insert(buf_.end(), first, first + n);
+    if (n == remaining)
+      break;
+    switch (first[n]) {
+      default:
+        buf_.push_back(first[n]);
+        break;
+      case '\\':
+        add("\\\\");
+        break;
+      case '\b':
+        add("\\b");
+        break;
+      case '\f':
+        add("\\f");
+        break;
+      case '\n':
+        add("\\n");
+        break;
+      case '\r':
+        add("\\r");
+        break;
+      case '\t':
+        add("\\t");
+        break;
+      case '\v':
+        add("\\v");
+        break;
+      case '"':
+        add("\\\"");
+        break;
+    }
+    first += n + 1;
+    remaining -= n + 1;
+  }
+  add('"');
+}
+
 void json_writer::nl() {
   if (indentation_factor_ > 0) {
     buf_.push_back('\n');
@@ -19,10 +19,12 @@
 #include "caf/actor_system_config.hpp"
 #include "caf/config.hpp"
 #include "caf/defaults.hpp"
+#include "caf/detail/binary_log.hpp"
 #include "caf/detail/get_process_id.hpp"
 #include "caf/detail/meta_object.hpp"
 #include "caf/detail/pretty_type_name.hpp"
 #include "caf/detail/set_thread_name.hpp"
+#include "caf/detail/spsc_byte_queue.hpp"
 #include "caf/intrusive/task_result.hpp"
 #include "caf/local_actor.hpp"
 #include "caf/locks.hpp"
@@ -41,6 +43,25 @@ thread_local actor_id current_actor_id;
 // Stores a pointer to the system-wide logger.
 thread_local intrusive_ptr<logger> current_logger_ptr;
 
+// Configures how long the logger thread sleeps if all buffers are empty.
+constexpr auto thread_buffer_poll_interval = std::chrono::milliseconds{10};
+
+// Stores all fields of an event except for the message. The per-thread buffers
+// store this header followed by the message.
+struct buffered_event {
+  unsigned level;
+  unsigned line_number;
+  string_view category_name;
+  string_view pretty_fun;
+  string_view simple_fun;
+  string_view file_name;
+  std::thread::id tid;
+  actor_id aid;
+  timestamp tstamp;
+};
+
+static_assert(std::is_trivially_copyable<buffered_event>::value);
+
 constexpr string_view log_level_name[] = {
   "QUIET",
   "",
@@ -184,7 +205,9 @@ logger::config::config()
       file_verbosity(CAF_LOG_LEVEL),
       console_verbosity(CAF_LOG_LEVEL),
       inline_output(false),
-      console_coloring(false) {
+      console_coloring(false),
+      per_thread_buffers(false),
+      binary_file(false) {
   // nop
 }
 
@@ -255,6 +278,8 @@ actor_id logger::thread_local_aid(actor_id aid) {
 void logger::log(event&& x) {
   if (cfg_.inline_output)
     handle_event(x);
+  else if (cfg_.per_thread_buffers)
+    push_to_thread_buffer(x);
   else
     queue_.push_back(std::move(x));
 }
@@ -274,7 +299,22 @@ bool logger::accepts(unsigned level, string_view cname) {
                       [=](string_view name) { return name == cname; });
 }
 
-logger::logger(actor_system& sys) : system_(sys), t0_(make_timestamp()) {
+struct logger::thread_buffer {
+  explicit thread_buffer(size_t capacity) : queue(capacity), dropped(0) {
+    // nop
+  }
+
+  detail::spsc_byte_queue queue;
+
+  /// Counts events that did not fit into the queue.
+  std::atomic<size_t> dropped;
+};
+
+logger::logger(actor_system& sys)
+  : system_(sys),
+    t0_(make_timestamp()),
+    thread_buffer_size_(defaults::logger::per_thread_buffer_size),
+    stopping_(false) {
   // nop
 }
 
@@ -329,6 +369,12 @@ void logger::init(actor_system_config& cfg) {
   // Set flags.
   if (get_or(cfg, "caf.logger.inline-output", false))
     cfg_.inline_output = true;
+  if (get_or(cfg, "caf.logger.per-thread-buffers", false))
+    cfg_.per_thread_buffers = true;
+  if (get_or(cfg, "caf.logger.file.binary", false))
+    cfg_.binary_file = true;
+  thread_buffer_size_ = get_or(cfg, "caf.logger.per-thread-buffer-size",
+                               lg::per_thread_buffer_size);
   // If not set to `false`, CAF enables colored output when writing to TTYs.
   cfg_.console_coloring = get_or(cfg, "caf.logger.console.colored", true);
 }
@@ -336,11 +382,17 @@ void logger::init(actor_system_config& cfg) {
 bool logger::open_file() {
   if (file_verbosity() == CAF_LOG_LEVEL_QUIET || file_name_.empty())
     return false;
-  file_.open(file_name_, std::ios::out | std::ios::app);
+  // A binary log starts with a header. Hence, we cannot append to a file.
+  if (cfg_.binary_file)
+    file_.open(file_name_, std::ios::out | std::ios::binary | std::ios::trunc);
+  else
+    file_.open(file_name_, std::ios::out | std::ios::app);
   if (!file_) {
     std::cerr << "unable to open log file " << file_name_ << std::endl;
     return false;
   }
+  if (cfg_.binary_file)
+    binary_writer_ = std::make_unique<detail::binary_log_writer>(file_, t0_);
   return true;
 }
 
@@ -428,6 +480,11 @@ void logger::render_date(std::ostream& out, timestamp x) {
 
 void logger::render(std::ostream& out, const line_format& lf,
                     const event& x) const {
+  render_event(out, lf, x, t0_);
+}
+
+void logger::render_event(std::ostream& out, const line_format& lf,
+                          const event& x, timestamp t0) {
   auto ms_time_diff = [](timestamp t0, timestamp tn) {
     using namespace std::chrono;
     return duration_cast<milliseconds>(tn - t0).count();
@@ -444,8 +501,13 @@ void logger::render(std::ostream& out, const line_format& lf,
       case method_field:       render_fun_name(out, x);            break;
       case newline_field:      out << std::endl;                   break;
       case priority_field:     out << log_level_name[x.level];     break;
-      case runtime_field:      out << ms_time_diff(t0_, x.tstamp); break;
-      case thread_field:       out << x.tid;                       break;
+      case runtime_field:      out << ms_time_diff(t0, x.tstamp);  break;
+      case thread_field:
+        if (x.thread_name.empty())
+          out << x.tid;
+        else
+          out << x.thread_name;
+        break;
       case actor_field:        out << "actor" << x.aid;            break;
       case percent_sign_field: out << '%';                         break;
       case plain_text_field:   out << f.text;                      break;
@@ -532,12 +594,90 @@ void logger::run() {
   }
 }
 
+void logger::run_buffered() {
+  if (!open_file() && console_verbosity() == CAF_LOG_LEVEL_QUIET)
+    return;
+  log_first_line();
+  std::vector<event> events;
+  std::vector<char> record;
+  for (;;) {
+    // Check the flag before draining the buffers. Otherwise, we could miss
+    // events that threads pushed right before calling `stop`.
+    auto done = stopping_.load();
+    if (flush_thread_buffers(events, record) > 0)
+      continue;
+    if (done) {
+      log_last_line();
+      return;
+    }
+    std::unique_lock<std::mutex> guard{stopping_mtx_};
+    stopping_cv_.wait_for(guard, thread_buffer_poll_interval,
+                          [this] { return stopping_.load(); });
+  }
+}
+
+void logger::push_to_thread_buffer(const event& x) {
+  // Each thread registers its buffer on the first event.
+  auto buf = &thread_buffers_.local([this](size_t) {
+    return std::make_shared<thread_buffer>(thread_buffer_size_);
+  });
+  buffered_event hdr{x.level,      x.line_number, x.category_name,
+                     x.pretty_fun, x.simple_fun,  x.file_name,
+                     x.tid,        x.aid,         x.tstamp};
+  if (!buf->queue.try_push(&hdr, sizeof(hdr), x.message.data(),
+                           x.message.size()))
+    buf->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t logger::flush_thread_buffers(std::vector<event>& events,
+                                    std::vector<char>& record) {
+  thread_buffers_.with_entries([&](auto& buffers) {
+    for (auto& buf : buffers) {
+      while (buf->queue.try_pop(record)) {
+        buffered_event hdr;
+        memcpy(&hdr, record.data(), sizeof(hdr));
+        events.emplace_back(hdr.level, hdr.line_number, hdr.category_name,
+                            hdr.pretty_fun, hdr.simple_fun, hdr.file_name,
+                            std::string{record.begin() + sizeof(hdr),
+                                        record.end()},
+                            hdr.tid, hdr.aid, hdr.tstamp);
+      }
+      if (auto n = buf->dropped.exchange(0, std::memory_order_relaxed))
+        events.emplace_back(CAF_LOG_MAKE_EVENT(0, CAF_LOG_COMPONENT,
+                                               CAF_LOG_LEVEL_WARNING,
+                                               "dropped" << n
+                                                         << "log events"));
+    }
+    // Remove buffers of terminated threads. The thread-local pointer holds
+    // the only other reference to a buffer.
+    auto is_orphaned = [](const std::shared_ptr<thread_buffer>& buf) {
+      return buf.use_count() == 1 && buf->queue.empty();
+    };
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), is_orphaned),
+                  buffers.end());
+  });
+  // Restore the global order of events from different threads.
+  std::stable_sort(events.begin(), events.end(),
+                   [](const event& x, const event& y) {
+                     return x.tstamp < y.tstamp;
+                   });
+  for (auto& x : events)
+    handle_event(x);
+  auto result = events.size();
+  events.clear();
+  return result;
+}
+
 void logger::handle_file_event(const event& x) {
   // Print to file if available.
   if (file_ && x.level <= file_verbosity()
       && none_of(file_filter_.begin(), file_filter_.end(),
-                 [&x](string_view name) { return name == x.category_name; }))
-    render(file_, file_format_, x);
+                 [&x](string_view name) { return name == x.category_name; })) {
+    if (binary_writer_)
+      binary_writer_->write(x);
+    else
+      render(file_, file_format_, x);
+  }
 }
 
 void logger::handle_console_event(const event& x) {
@@ -649,7 +789,10 @@ void logger::start() {
       CAF_IGNORE_UNUSED(guard);
       detail::set_thread_name("caf.logger");
       system_.thread_started();
-      run();
+      if (cfg_.per_thread_buffers)
+        run_buffered();
+      else
+        run();
       system_.thread_terminates();
     };
     thread_ = std::thread{f, detail::global_meta_objects_guard()};
@@ -663,8 +806,14 @@ void logger::stop() {
   }
   if (!thread_.joinable())
     return;
-  // A default-constructed event causes the logger to shutdown.
-  queue_.push_back(event{});
+  if (cfg_.per_thread_buffers) {
+    std::unique_lock<std::mutex> guard{stopping_mtx_};
+    stopping_ = true;
+    stopping_cv_.notify_all();
+  } else {
+    // A default-constructed event causes the logger to shutdown.
+    queue_.push_back(event{});
+  }
   thread_.join();
 }
 
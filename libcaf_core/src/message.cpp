@@ -10,7 +10,9 @@
 #include "caf/binary_deserializer.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/deserializer.hpp"
+#include "caf/detail/message_layout.hpp"
 #include "caf/detail/meta_object.hpp"
+#include "caf/detail/serialized_size.hpp"
 #include "caf/detail/type_id_list_builder.hpp"
 #include "caf/message_builder.hpp"
 #include "caf/message_handler.hpp"
@@ -41,6 +43,35 @@ bool load(const detail::meta_object& meta, caf::binary_deserializer& source,
   return meta.load_binary(source, obj);
 }
 
+template <class Deserializer>
+bool load_elements(Deserializer& source, type_id_list types,
+                   message::data_ptr& data) {
+  auto& layout = detail::layout_of(types);
+  if (!layout.valid)
+    STOP(sec::unknown_type);
+  intrusive_ptr<detail::message_data> ptr;
+  if (auto vptr = malloc(sizeof(detail::message_data) + layout.storage_size)) {
+    // We don't need to worry about exceptions here: the message_data
+    // constructor is `noexcept`.
+    ptr.reset(new (vptr) detail::message_data(types, layout), false);
+  } else {
+    STOP(sec::runtime_error, "unable to allocate memory");
+  }
+  auto pos = ptr->storage();
+  auto gmos = detail::global_meta_objects();
+  GUARDED(source.begin_tuple(types.size()));
+  for (auto id : types) {
+    auto& meta = gmos[id];
+    meta.default_construct(pos);
+    ptr->inc_constructed_elements();
+    if (!load(meta, source, pos))
+      return false;
+    pos += meta.padded_size;
+  }
+  data.reset(ptr.release(), false);
+  return source.end_tuple();
+}
+
 template <class Deserializer>
 bool load_data(Deserializer& source, message::data_ptr& data) {
   // For machine-to-machine data formats, we prefix the type information.
@@ -69,36 +100,9 @@ bool load_data(Deserializer& source, message::data_ptr& data) {
     }
     GUARDED(source.end_sequence());
     CAF_ASSERT(ids.size() == msg_size);
-    size_t data_size = 0;
-    for (auto id : ids) {
-      if (auto meta_obj = detail::global_meta_object(id))
-        data_size += meta_obj->padded_size;
-      else
-        STOP(sec::unknown_type);
-    }
-    intrusive_ptr<detail::message_data> ptr;
-    if (auto vptr = malloc(sizeof(detail::message_data) + data_size)) {
-      // We don't need to worry about exceptions here: the message_data
-      // constructor as well as `move_to_list` are `noexcept`.
-      ptr.reset(new (vptr) detail::message_data(ids.move_to_list()), false);
-    } else {
-      STOP(sec::runtime_error, "unable to allocate memory");
-    }
-    auto pos = ptr->storage();
-    auto types = ptr->types();
-    auto gmos = detail::global_meta_objects();
     GUARDED(source.begin_field("values"));
-    GUARDED(source.begin_tuple(msg_size));
-    for (size_t i = 0; i < msg_size; ++i) {
-      auto& meta = gmos[types[i]];
-      meta.default_construct(pos);
-      ptr->inc_constructed_elements();
-      if (!load(meta, source, pos))
-        return false;
-      pos += meta.padded_size;
-    }
-    data.reset(ptr.release(), false);
-    return source.end_tuple() && source.end_field() && source.end_object();
+    GUARDED(load_elements(source, ids.move_to_list(), data));
+    return source.end_field() && source.end_object();
   }
   // For human-readable data formats, we serialize messages as a single list of
   // dynamically-typed objects. This is more expensive, because we first need
@@ -172,11 +176,13 @@ bool load_data(Deserializer& source, message::data_ptr& data) {
     }
     GUARDED(source.end_sequence());
     // Merge elements into a single message data object.
+    auto types = ids.move_to_list();
+    auto& layout = detail::layout_of(types);
     intrusive_ptr<detail::message_data> ptr;
     if (auto vptr = malloc(sizeof(detail::message_data) + data_size)) {
       // We don't need to worry about exceptions here: the message_data
-      // constructor as well as `move_to_list` are `noexcept`.
-      ptr.reset(new (vptr) detail::message_data(ids.move_to_list()), false);
+      // constructor is `noexcept`.
+      ptr.reset(new (vptr) detail::message_data(types, layout), false);
     } else {
       STOP(sec::runtime_error, "unable to allocate memory");
     }
@@ -205,6 +211,14 @@ bool message::load(binary_deserializer& source) {
   return load_data(source, data_);
 }
 
+bool message::load_values(binary_deserializer& source, type_id_list types) {
+  if (types.empty()) {
+    data_.reset();
+    return source.begin_tuple(0) && source.end_tuple();
+  }
+  return load_elements(source, types, data_);
+}
+
 namespace {
 
 bool save(const detail::meta_object& meta, caf::serializer& sink,
@@ -217,6 +231,11 @@ bool save(const detail::meta_object& meta, caf::binary_serializer& sink,
   return meta.save_binary(sink, obj);
 }
 
+bool save(const detail::meta_object& meta,
+          detail::serialized_size_inspector& sink, const void* obj) {
+  return meta.save_size(sink, obj);
+}
+
 template <class Serializer>
 typename Serializer::result_type
 save_data(Serializer& sink, const message::data_ptr& data) {
@@ -276,10 +295,41 @@ bool message::save(serializer& sink) const {
   return save_data(sink, data_);
 }
 
-bool message::save(binary_serializer& sink) const {
+bool message::save(detail::serialized_size_inspector& sink) const {
   return save_data(sink, data_);
 }
 
+bool message::save_values(binary_serializer& sink) const {
+  if (data_ == nullptr)
+    return sink.begin_tuple(0) && sink.end_tuple();
+  auto gmos = detail::global_meta_objects();
+  auto types = data_->types();
+  auto storage = data_->storage();
+  GUARDED(sink.begin_tuple(types.size()));
+  for (auto id : types) {
+    auto& meta = gmos[id];
+    GUARDED(meta.save_binary(sink, storage));
+    storage += meta.padded_size;
+  }
+  return sink.end_tuple();
+}
+
+bool message::save(binary_serializer& sink) const {
+  if (!sink.presize() || data_ == nullptr)
+    return save_data(sink, data_);
+  // Computing the size only requires a single pass over the content and saves
+  // us from re-allocating the buffer multiple times for large messages. We
+  // disable pre-sizing for nested messages, since the outer message already
+  // accounts for them.
+  detail::serialized_size_inspector f{sink.context()};
+  if (save_data(f, data_))
+    sink.reserve(f.result);
+  sink.presize(false);
+  auto result = save_data(sink, data_);
+  sink.presize(true);
+  return result;
+}
+
 // -- related non-members ------------------------------------------------------
 
 std::string to_string(const message& msg) {
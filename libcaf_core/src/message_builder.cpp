@@ -4,6 +4,7 @@
 
 #include "caf/message_builder.hpp"
 
+#include "caf/detail/message_layout.hpp"
 #include "caf/detail/meta_object.hpp"
 #include "caf/raise_error.hpp"
 
@@ -23,14 +24,17 @@ message to_message_impl(size_t storage_size, TypeListBuilder& types,
                         ElementVector& elements) {
   if (storage_size == 0)
     return message{};
+  auto ls = [&types] {
+    if constexpr (Policy == move_msg)
+      return types.move_to_list();
+    else
+      return types.copy_to_list();
+  }();
+  auto& layout = layout_of(ls);
   auto vptr = malloc(sizeof(message_data) + storage_size);
   if (vptr == nullptr)
     CAF_RAISE_ERROR(std::bad_alloc, "bad_alloc");
-  message_data* raw_ptr;
-  if constexpr (Policy == move_msg)
-    raw_ptr = new (vptr) message_data(types.move_to_list());
-  else
-    raw_ptr = new (vptr) message_data(types.copy_to_list());
+  auto raw_ptr = new (vptr) message_data(ls, layout);
   intrusive_cow_ptr<message_data> ptr{raw_ptr, false};
   auto storage = raw_ptr->storage();
   for (auto& element : elements)
@@ -13,16 +13,72 @@
 #include "caf/serializer.hpp"
 
 #include "caf/actor_registry.hpp"
+#include "caf/locks.hpp"
 #include "caf/logger.hpp"
 
+namespace {
+
+#ifdef CAF_MSVC
+#  define THREAD_LOCAL thread_local
+#else
+#  define THREAD_LOCAL __thread
+#endif
+
+// Optional cache for get_or_put, usually set by a BASP worker.
+THREAD_LOCAL caf::proxy_registry::local_cache* t_local_cache = nullptr;
+
+#undef THREAD_LOCAL
+
+using exclusive_guard = caf::unique_lock<caf::detail::shared_spinlock>;
+
+using shared_guard = caf::shared_lock<caf::detail::shared_spinlock>;
+
+} // namespace
+
 namespace caf {
 
+// -- local_cache --------------------------------------------------------------
+
+strong_actor_ptr proxy_registry::local_cache::get(const proxy_registry& owner,
+                                                  const node_id& nid,
+                                                  actor_id aid) {
+  auto epoch = owner.epoch();
+  if (owner_ != &owner || epoch_ != epoch) {
+    clear();
+    owner_ = &owner;
+    epoch_ = epoch;
+    return nullptr;
+  }
+  auto& x = entries_[slot(aid)];
+  if (x.aid == aid && x.nid == nid)
+    return x.ptr.lock();
+  return nullptr;
+}
+
+void proxy_registry::local_cache::put(const node_id& nid, actor_id aid,
+                                      const strong_actor_ptr& ptr) {
+  auto& x = entries_[slot(aid)];
+  x.nid = nid;
+  x.aid = aid;
+  x.ptr = actor_cast<weak_actor_ptr>(ptr);
+}
+
+void proxy_registry::local_cache::clear() {
+  for (auto& x : entries_) {
+    x.nid = none;
+    x.aid = invalid_actor_id;
+    x.ptr.reset();
+  }
+}
+
+// -- proxy_registry -----------------------------------------------------------
+
 proxy_registry::backend::~backend() {
   // nop
 }
 
 proxy_registry::proxy_registry(actor_system& sys, backend& be)
-  : system_(sys), backend_(be) {
+  : system_(sys), backend_(be), epoch_(0) {
   // nop
 }
 
@@ -31,13 +87,13 @@ proxy_registry::~proxy_registry() {
 }
 
 size_t proxy_registry::count_proxies(const node_id& node) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = proxies_.find(node);
   return i != proxies_.end() ? i->second.size() : 0;
 }
 
 strong_actor_ptr proxy_registry::get(const node_id& node, actor_id aid) const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = proxies_.find(node);
   if (i == proxies_.end())
     return nullptr;
@@ -47,10 +103,21 @@ strong_actor_ptr proxy_registry::get(const node_id& node, actor_id aid) const {
 
 strong_actor_ptr proxy_registry::get_or_put(const node_id& nid, actor_id aid) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid));
-  std::unique_lock<std::mutex> guard{mtx_};
-  auto& result = proxies_[nid][aid];
-  if (!result)
-    result = backend_.make_proxy(nid, aid);
+  auto cache = t_local_cache;
+  if (cache != nullptr)
+    if (auto result = cache->get(*this, nid, aid))
+      return result;
+  // Proxies for known actors only require a shared lock.
+  auto result = get(nid, aid);
+  if (!result) {
+    exclusive_guard guard{mtx_};
+    auto& entry = proxies_[nid][aid];
+    if (!entry)
+      entry = backend_.make_proxy(nid, aid);
+    result = entry;
+  }
+  if (cache != nullptr && result != nullptr)
+    cache->put(nid, aid, result);
   return result;
 }
 
@@ -59,7 +126,7 @@ proxy_registry::get_all(const node_id& node) const {
   // Reserve at least some memory outside of the critical section.
   std::vector<strong_actor_ptr> result;
   result.reserve(128);
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   auto i = proxies_.find(node);
   if (i != proxies_.end())
     for (auto& kvp : i->second)
@@ -68,7 +135,7 @@ proxy_registry::get_all(const node_id& node) const {
 }
 
 bool proxy_registry::empty() const {
-  std::unique_lock<std::mutex> guard{mtx_};
+  shared_guard guard{mtx_};
   return proxies_.empty();
 }
 
@@ -78,12 +145,13 @@ void proxy_registry::erase(const node_id& nid) {
   proxy_map tmp;
   {
     using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
+    exclusive_guard guard{mtx_};
     auto i = proxies_.find(nid);
     if (i == proxies_.end())
       return;
     swap(i->second, tmp);
     proxies_.erase(i);
+    ++epoch_;
   }
   // Call kill_proxy outside the critical section.
   for (auto& kvp : tmp)
@@ -96,7 +164,7 @@ void proxy_registry::erase(const node_id& nid, actor_id aid, error rsn) {
   strong_actor_ptr erased_proxy;
   {
     using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
+    exclusive_guard guard{mtx_};
     auto i = proxies_.find(nid);
     if (i != proxies_.end()) {
       auto& submap = i->second;
@@ -107,6 +175,7 @@ void proxy_registry::erase(const node_id& nid, actor_id aid, error rsn) {
       submap.erase(j);
       if (submap.empty())
         proxies_.erase(i);
+      ++epoch_;
     }
   }
   // Call kill_proxy outside the critical section.
@@ -120,8 +189,9 @@ void proxy_registry::clear() {
   std::unordered_map<node_id, proxy_map> tmp;
   {
     using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
+    exclusive_guard guard{mtx_};
     swap(proxies_, tmp);
+    ++epoch_;
   }
   // Call kill_proxy outside the critical section.
   for (auto& kvp : tmp)
@@ -130,6 +200,10 @@ void proxy_registry::clear() {
   proxies_.clear();
 }
 
+void proxy_registry::set_local_cache(local_cache* ptr) noexcept {
+  t_local_cache = ptr;
+}
+
 void proxy_registry::kill_proxy(strong_actor_ptr& ptr, error rsn) {
   if (!ptr)
     return;
@@ -146,9 +146,13 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
     ptr->set_enqueue_time();
     metrics_.mailbox_size->inc();
   }
+  using event_type = scheduler::event_tracer::event_type;
+  auto tracer = home_system().scheduler().tracer();
   switch (mailbox().push_back(std::move(ptr))) {
     case intrusive::inbox_result::unblocked_reader: {
       CAF_LOG_ACCEPT_EVENT(true);
+      if (tracer)
+        tracer->record(event_type::mailbox_enqueue, id(), 1);
       intrusive_ptr_add_ref(ctrl());
       if (private_thread_)
         private_thread_->resume(this);
@@ -172,6 +176,8 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
     case intrusive::inbox_result::success:
       // enqueued to a running actors' mailbox; nothing to do
       CAF_LOG_ACCEPT_EVENT(false);
+      if (tracer)
+        tracer->record(event_type::mailbox_enqueue, id(), 0);
       break;
   }
 }
@@ -283,8 +289,17 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
       set_stream_timeout(tout);
     }
   };
+  // Records when this actor takes a message from its mailbox.
+  auto trace_dequeue = [this, tracer{home_system().scheduler().tracer()}](
+                         const mailbox_element& x) {
+    if (tracer)
+      tracer->record(scheduler::event_tracer::event_type::mailbox_dequeue,
+                     id(), x.mid.integer_value());
+  };
   // Callback for handling urgent and normal messages.
-  auto handle_async = [this, max_throughput, &consumed](mailbox_element& x) {
+  auto handle_async = [this, max_throughput, &consumed,
+                       &trace_dequeue](mailbox_element& x) {
+    trace_dequeue(x);
     return run_with_metrics(x, [this, max_throughput, &consumed, &x] {
       switch (reactivate(x)) {
         case activation_result::terminated:
@@ -300,7 +315,9 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
     });
   };
   // Callback for handling upstream messages (e.g., ACKs).
-  auto handle_umsg = [this, max_throughput, &consumed](mailbox_element& x) {
+  auto handle_umsg = [this, max_throughput, &consumed,
+                      &trace_dequeue](mailbox_element& x) {
+    trace_dequeue(x);
     return run_with_metrics(x, [this, max_throughput, &consumed, &x] {
       current_mailbox_element(&x);
       CAF_LOG_RECEIVE_EVENT((&x));
@@ -317,8 +334,10 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
     });
   };
   // Callback for handling downstream messages (e.g., batches).
-  auto handle_dmsg = [this, &consumed, max_throughput](stream_slot, auto& q,
-                                                       mailbox_element& x) {
+  auto handle_dmsg = [this, &consumed, max_throughput,
+                      &trace_dequeue](stream_slot, auto& q,
+                                      mailbox_element& x) {
+    trace_dequeue(x);
     return run_with_metrics(x, [this, max_throughput, &consumed, &q, &x] {
       current_mailbox_element(&x);
       CAF_LOG_RECEIVE_EVENT((&x));
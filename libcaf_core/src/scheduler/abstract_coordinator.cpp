@@ -28,6 +28,7 @@
 #include "caf/scoped_actor.hpp"
 #include "caf/send.hpp"
 #include "caf/system_messages.hpp"
+#include "caf/telemetry/metric_registry.hpp"
 
 namespace caf::scheduler {
 
@@ -189,6 +190,13 @@ void abstract_coordinator::init(actor_system_config& cfg) {
                            sr::max_throughput);
   num_workers_ = get_or(cfg, "caf.scheduler.max-threads",
                         default_thread_count());
+  collect_metrics_ = get_or(cfg, "caf.scheduler.enable-metrics", false);
+  trace_file_ = get_or(cfg, "caf.scheduler.trace-file", sr::trace_file);
+  if (!trace_file_.empty()) {
+    auto size = get_or(cfg, "caf.scheduler.trace-buffer-size",
+                       sr::trace_buffer_size);
+    tracer_ = std::make_unique<event_tracer>(size);
+  }
 }
 
 actor_system::module::id_t abstract_coordinator::id() const {
@@ -207,8 +215,79 @@ void abstract_coordinator::stop_actors() {
   self->wait_for(utility_actors_);
 }
 
+abstract_coordinator::worker_metrics_t
+abstract_coordinator::make_worker_metrics(size_t worker_id) {
+  if (!collect_metrics_)
+    return {};
+  // Running a job usually takes microseconds, since actors only process up to
+  // max-throughput messages per run. Much longer runs block the worker.
+  std::array<double, 9> default_buckets{{
+    0.00001, // 10us
+    0.0001,  // 100us
+    0.0005,  // 500us
+    0.001,   // 1ms
+    0.01,    // 10ms
+    0.1,     // 100ms
+    0.5,     // 500ms
+    1.,      // 1s
+    5.,      // 5s
+  }};
+  auto& reg = system_.metrics();
+  auto id = std::to_string(worker_id);
+  worker_metrics_t result;
+  result.queue_size
+    = reg.gauge_family("caf.scheduler", "queue-size", {"worker"},
+                       "Number of jobs in the queue of a worker.")
+        ->get_or_add({{"worker", id}});
+  auto steals = reg.counter_family("caf.scheduler", "steal-attempts",
+                                   {"worker", "result"},
+                                   "Number of attempts to steal a job.", "1",
+                                   true);
+  result.steals = steals->get_or_add({{"worker", id}, {"result", "success"}});
+  result.failed_steals
+    = steals->get_or_add({{"worker", id}, {"result", "failure"}});
+  auto poll_time = reg.counter_family<double>(
+    "caf.scheduler", "poll-time", {"worker", "strategy"},
+    "Time a worker spent polling for jobs.", "seconds", true);
+  const char* strategies[] = {"aggressive", "moderate", "relaxed"};
+  for (size_t i = 0; i < 3; ++i)
+    result.poll_time[i]
+      = poll_time->get_or_add({{"worker", id}, {"strategy", strategies[i]}});
+  result.parks
+    = reg.counter_family("caf.scheduler", "parks", {"worker"},
+                         "Number of times a worker went to sleep.", "1",
+                         true)
+        ->get_or_add({{"worker", id}});
+  result.unparks
+    = reg.counter_family("caf.scheduler", "unparks", {"worker"},
+                         "Number of times new jobs woke up a worker.", "1",
+                         true)
+        ->get_or_add({{"worker", id}});
+  result.resume_duration
+    = reg.histogram_family<double>("caf.scheduler", "resume-duration",
+                                   {"worker"}, default_buckets,
+                                   "Time a worker runs a job.", "seconds")
+        ->get_or_add({{"worker", id}});
+  return result;
+}
+
+void abstract_coordinator::write_trace_file() {
+  if (!tracer_)
+    return;
+  std::ofstream out{trace_file_};
+  if (!out) {
+    CAF_LOG_WARNING("could not open trace file:" << CAF_ARG(trace_file_));
+    return;
+  }
+  tracer_->write_chrome_trace(out);
+}
+
 abstract_coordinator::abstract_coordinator(actor_system& sys)
-  : next_worker_(0), max_throughput_(0), num_workers_(0), system_(sys) {
+  : next_worker_(0),
+    max_throughput_(0),
+    num_workers_(0),
+    system_(sys),
+    collect_metrics_(false) {
   // nop
 }
 
@@ -0,0 +1,298 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/scheduler/event_tracer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+#include "caf/detail/print.hpp"
+#include "caf/resumable.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::scheduler {
+
+namespace {
+
+const char* resume_result_name(uint64_t x) {
+  switch (x) {
+    case resumable::resume_later:
+      return "resume_later";
+    case resumable::awaiting_message:
+      return "awaiting_message";
+    case resumable::done:
+      return "done";
+    case resumable::shutdown_execution_unit:
+      return "shutdown_execution_unit";
+    default:
+      return "???";
+  }
+}
+
+// Mirrors io::network::operation, which is not available in the core library.
+string_view io_operation_name(uint64_t x) {
+  switch (x) {
+    case 0:
+      return "read";
+    case 1:
+      return "write";
+    case 2:
+      return "propagate_error";
+    default:
+      return "???";
+  }
+}
+
+} // namespace
+
+struct event_tracer::thread_data {
+  /// Stores a single entry. The owning thread writes slots without locking.
+  /// Readers use `seq` for detecting entries that changed while reading them.
+  struct slot {
+    /// Holds `2n + 1` while the owner writes the n-th entry of its thread and
+    /// `2n + 2` afterwards.
+    std::atomic<uint64_t> seq{0};
+    std::atomic<int64_t> time{0};
+    std::atomic<uint64_t> id{0};
+    std::atomic<uint64_t> arg{0};
+    std::atomic<uint8_t> type{0};
+  };
+
+  explicit thread_data(size_t capacity) : slots(new slot[capacity]) {
+    // nop
+  }
+
+  /// Guards `name`.
+  std::mutex name_mtx;
+
+  /// Name of the thread in the exported trace.
+  std::string name;
+
+  /// Stores the most recent entries.
+  std::unique_ptr<slot[]> slots;
+
+  /// Counts how many entries the thread recorded so far.
+  std::atomic<uint64_t> head{0};
+
+  /// Calls `f` for each entry in `slots`, oldest first, while skipping entries
+  /// that the owning thread overwrites concurrently.
+  template <class F>
+  void for_each(size_t capacity, F f) const {
+    auto n = head.load(std::memory_order_acquire);
+    for (auto i = n > capacity ? n - capacity : uint64_t{0}; i < n; ++i) {
+      auto& x = slots[i % capacity];
+      auto seq = x.seq.load(std::memory_order_acquire);
+      if (seq != 2 * i + 2)
+        continue;
+      auto result = entry{x.time.load(std::memory_order_relaxed),
+                          x.id.load(std::memory_order_relaxed),
+                          x.arg.load(std::memory_order_relaxed),
+                          static_cast<event_type>(
+                            x.type.load(std::memory_order_relaxed))};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (x.seq.load(std::memory_order_relaxed) == seq)
+        f(result);
+    }
+  }
+
+  std::string get_name() {
+    std::unique_lock<std::mutex> guard{name_mtx};
+    return name;
+  }
+};
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+event_tracer::event_tracer(size_t capacity)
+  : capacity_(std::max(capacity, size_t{1})),
+    t0_(clock_type::now()) {
+  // nop
+}
+
+event_tracer::~event_tracer() {
+  // nop
+}
+
+// -- recording ----------------------------------------------------------------
+
+void event_tracer::record(event_type type, uint64_t id, uint64_t arg) {
+  auto& td = local_data();
+  auto now = clock_type::now();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0_);
+  // Only this thread writes to `td`, i.e., we only need to publish the slot.
+  auto n = td.head.load(std::memory_order_relaxed);
+  auto& x = td.slots[n % capacity_];
+  x.seq.store(2 * n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  x.time.store(ns.count(), std::memory_order_relaxed);
+  x.id.store(id, std::memory_order_relaxed);
+  x.arg.store(arg, std::memory_order_relaxed);
+  x.type.store(static_cast<uint8_t>(type), std::memory_order_relaxed);
+  x.seq.store(2 * n + 2, std::memory_order_release);
+  td.head.store(n + 1, std::memory_order_release);
+}
+
+void event_tracer::set_thread_name(std::string name) {
+  auto& td = local_data();
+  std::unique_lock<std::mutex> guard{td.name_mtx};
+  td.name = std::move(name);
+}
+
+// -- exporting ----------------------------------------------------------------
+
+std::vector<std::pair<std::string, event_tracer::entry>>
+event_tracer::entries() const {
+  std::vector<std::pair<std::string, entry>> result;
+  threads_.with_entries([this, &result](auto& xs) {
+    for (auto& td : xs) {
+      auto name = td->get_name();
+      td->for_each(capacity_, [&](const entry& x) {
+        result.emplace_back(name, x);
+      });
+    }
+  });
+  std::stable_sort(result.begin(), result.end(),
+                   [](const auto& x, const auto& y) {
+                     return x.second.time < y.second.time;
+                   });
+  return result;
+}
+
+void event_tracer::write_chrome_trace(std::ostream& out) const {
+  // Collect the entries of all threads in chronological order.
+  std::vector<std::pair<size_t, entry>> events;
+  std::vector<std::string> names;
+  threads_.with_entries([this, &events, &names](auto& xs) {
+    for (size_t tid = 0; tid < xs.size(); ++tid) {
+      auto& td = xs[tid];
+      names.emplace_back(td->get_name());
+      td->for_each(capacity_, [&](const entry& x) {
+        events.emplace_back(tid, x);
+      });
+    }
+  });
+  std::stable_sort(events.begin(), events.end(),
+                   [](const auto& x, const auto& y) {
+                     return x.second.time < y.second.time;
+                   });
+  std::string buf;
+  buf += R"({"displayTimeUnit":"ns","traceEvents":[)";
+  auto sep = [&buf, first = true]() mutable {
+    if (first)
+      first = false;
+    else
+      buf += ",\n";
+  };
+  for (size_t tid = 0; tid < names.size(); ++tid) {
+    sep();
+    buf += R"({"name":"thread_name","ph":"M","pid":1,"tid":)";
+    buf += std::to_string(tid);
+    buf += R"(,"args":{"name":)";
+    detail::print_escaped(buf, names[tid]);
+    buf += "}}";
+  }
+  // Renders the fields shared by all events.
+  auto begin_event = [&buf, &sep](string_view name, string_view cat,
+                                  string_view ph, size_t tid, int64_t time) {
+    sep();
+    buf += R"({"name":)";
+    detail::print_escaped(buf, name);
+    buf += R"(,"cat":")";
+    buf.insert(buf.end(), cat.begin(), cat.end());
+    buf += R"(","ph":")";
+    buf.insert(buf.end(), ph.begin(), ph.end());
+    buf += R"(","pid":1,"tid":)";
+    buf += std::to_string(tid);
+    buf += R"(,"ts":)";
+    detail::print_us(buf, time);
+  };
+  // Maps actor IDs to the flow ID of the message that scheduled the actor.
+  std::unordered_map<uint64_t, size_t> pending_flows;
+  size_t next_flow_id = 1;
+  for (auto& [tid, x] : events) {
+    switch (x.type) {
+      case event_type::resume_begin: {
+        auto name = "actor " + std::to_string(x.id);
+        begin_event(name, "scheduler", "B", tid, x.time);
+        buf += R"(,"args":{"actor_id":)";
+        buf += std::to_string(x.id);
+        buf += "}}";
+        // Connect the message that scheduled the actor to this run.
+        if (auto i = pending_flows.find(x.id); i != pending_flows.end()) {
+          begin_event("schedule", "latency", "f", tid, x.time);
+          buf += R"(,"bp":"e","id":)";
+          buf += std::to_string(i->second);
+          buf += "}";
+          pending_flows.erase(i);
+        }
+        break;
+      }
+      case event_type::resume_end: {
+        auto name = "actor " + std::to_string(x.id);
+        begin_event(name, "scheduler", "E", tid, x.time);
+        buf += R"(,"args":{"result":")";
+        buf += resume_result_name(x.arg);
+        buf += R"("}})";
+        break;
+      }
+      case event_type::steal:
+        begin_event("steal", "scheduler", "i", tid, x.time);
+        buf += R"(,"s":"t","args":{"actor_id":)";
+        buf += std::to_string(x.id);
+        buf += R"(,"victim":)";
+        buf += std::to_string(x.arg);
+        buf += "}}";
+        break;
+      case event_type::mailbox_enqueue:
+        begin_event("enqueue", "mailbox", "i", tid, x.time);
+        buf += R"(,"s":"t","args":{"actor_id":)";
+        buf += std::to_string(x.id);
+        buf += R"(,"scheduled":)";
+        buf += x.arg != 0 ? "true" : "false";
+        buf += "}}";
+        if (x.arg != 0) {
+          auto flow_id = next_flow_id++;
+          pending_flows[x.id] = flow_id;
+          begin_event("schedule", "latency", "s", tid, x.time);
+          buf += R"(,"id":)";
+          buf += std::to_string(flow_id);
+          buf += "}";
+        }
+        break;
+      case event_type::mailbox_dequeue:
+        begin_event("dequeue", "mailbox", "i", tid, x.time);
+        buf += R"(,"s":"t","args":{"actor_id":)";
+        buf += std::to_string(x.id);
+        buf += R"(,"message_id":)";
+        buf += std::to_string(x.arg);
+        buf += "}}";
+        break;
+      case event_type::io_begin:
+      case event_type::io_end:
+        begin_event(io_operation_name(x.arg), "io",
+                    x.type == event_type::io_begin ? "B" : "E", tid, x.time);
+        buf += R"(,"args":{"socket":)";
+        buf += std::to_string(x.id);
+        buf += "}}";
+        break;
+    }
+  }
+  buf += "]}\n";
+  out << buf;
+}
+
+// -- utility functions --------------------------------------------------------
+
+event_tracer::thread_data& event_tracer::local_data() {
+  return threads_.local([this](size_t index) {
+    auto ptr = std::make_shared<thread_data>(capacity_);
+    ptr->name = "thread " + std::to_string(index);
+    return ptr;
+  });
+}
+
+} // namespace caf::scheduler
@@ -0,0 +1,192 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/schema_inspector.hpp"
+
+#include <string>
+
+#include "caf/type_id.hpp"
+
+namespace caf {
+
+// -- interface functions ------------------------------------------------------
+
+bool schema_inspector::begin_object(type_id_t type, string_view name) {
+  if (objects_++ == 0)
+    result_.set_type(type, std::string{name.begin(), name.end()});
+  return true;
+}
+
+bool schema_inspector::end_object() {
+  --objects_;
+  return true;
+}
+
+bool schema_inspector::begin_field(string_view name) {
+  names_.emplace_back(name);
+  variable_fields_.push_back(false);
+  return true;
+}
+
+bool schema_inspector::begin_field(string_view name, bool) {
+  // Optional fields add a flag to the binary format and then maybe the value.
+  names_.emplace_back(name);
+  add_variable(invalid_type_id);
+  variable_fields_.push_back(true);
+  ++variable_;
+  return true;
+}
+
+bool schema_inspector::begin_field(string_view name, span<const type_id_t>,
+                                   size_t) {
+  // Variant fields add the index of the alternative and then the value.
+  return begin_field(name, true);
+}
+
+bool schema_inspector::begin_field(string_view name, bool,
+                                   span<const type_id_t>, size_t) {
+  return begin_field(name, true);
+}
+
+bool schema_inspector::end_field() {
+  if (variable_fields_.back())
+    --variable_;
+  variable_fields_.pop_back();
+  names_.pop_back();
+  return true;
+}
+
+bool schema_inspector::begin_tuple(size_t) {
+  return true;
+}
+
+bool schema_inspector::end_tuple() {
+  return true;
+}
+
+bool schema_inspector::begin_key_value_pair() {
+  return true;
+}
+
+bool schema_inspector::end_key_value_pair() {
+  return true;
+}
+
+bool schema_inspector::begin_sequence(size_t) {
+  add_variable(invalid_type_id);
+  ++variable_;
+  return true;
+}
+
+bool schema_inspector::end_sequence() {
+  --variable_;
+  return true;
+}
+
+bool schema_inspector::begin_associative_array(size_t size) {
+  return begin_sequence(size);
+}
+
+bool schema_inspector::end_associative_array() {
+  return end_sequence();
+}
+
+bool schema_inspector::value(byte) {
+  return add_fixed(type_id_v<uint8_t>, 1);
+}
+
+bool schema_inspector::value(bool) {
+  return add_fixed(type_id_v<bool>, 1);
+}
+
+bool schema_inspector::value(int8_t) {
+  return add_fixed(type_id_v<int8_t>, 1);
+}
+
+bool schema_inspector::value(uint8_t) {
+  return add_fixed(type_id_v<uint8_t>, 1);
+}
+
+bool schema_inspector::value(int16_t) {
+  return add_fixed(type_id_v<int16_t>, 2);
+}
+
+bool schema_inspector::value(uint16_t) {
+  return add_fixed(type_id_v<uint16_t>, 2);
+}
+
+bool schema_inspector::value(int32_t) {
+  return add_fixed(type_id_v<int32_t>, 4);
+}
+
+bool schema_inspector::value(uint32_t) {
+  return add_fixed(type_id_v<uint32_t>, 4);
+}
+
+bool schema_inspector::value(int64_t) {
+  return add_fixed(type_id_v<int64_t>, 8);
+}
+
+bool schema_inspector::value(uint64_t) {
+  return add_fixed(type_id_v<uint64_t>, 8);
+}
+
+bool schema_inspector::value(float) {
+  return add_fixed(type_id_v<float>, 4);
+}
+
+bool schema_inspector::value(double) {
+  return add_fixed(type_id_v<double>, 8);
+}
+
+bool schema_inspector::value(long double) {
+  // The binary serializer writes long double values as strings.
+  return add_variable(type_id_v<long double>);
+}
+
+bool schema_inspector::value(string_view) {
+  return add_variable(type_id_v<std::string>);
+}
+
+bool schema_inspector::value(const std::u16string&) {
+  return add_variable(type_id_v<std::u16string>);
+}
+
+bool schema_inspector::value(const std::u32string&) {
+  return add_variable(type_id_v<std::u32string>);
+}
+
+bool schema_inspector::value(span<const byte> x) {
+  return add_fixed(type_id_v<uint8_t>, x.size());
+}
+
+bool schema_inspector::value(const std::vector<bool>&) {
+  return add_variable(invalid_type_id);
+}
+
+// -- utility functions --------------------------------------------------------
+
+std::string schema_inspector::path() const {
+  std::string result;
+  for (auto name : names_) {
+    if (!result.empty())
+      result += '.';
+    result.insert(result.end(), name.begin(), name.end());
+  }
+  return result;
+}
+
+bool schema_inspector::add_fixed(type_id_t type, size_t size) {
+  if (variable_ == 0)
+    result_.add_fixed(path(), type, size);
+  return true;
+}
+
+bool schema_inspector::add_variable(type_id_t type) {
+  if (variable_ == 0)
+    result_.add_variable(path(), type);
+  return true;
+}
+
+} // namespace caf
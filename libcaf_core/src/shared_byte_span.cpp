@@ -0,0 +1,62 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/shared_byte_span.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/make_counted.hpp"
+#include "caf/sec.hpp"
+
+namespace caf {
+
+// -- shared_byte_buffer -------------------------------------------------------
+
+shared_byte_buffer::~shared_byte_buffer() {
+  // nop
+}
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+shared_byte_span::shared_byte_span(byte_buffer bytes) {
+  if (bytes.empty())
+    return;
+  auto ptr = make_counted<shared_byte_buffer>(std::move(bytes));
+  data_ = ptr->bytes.data();
+  size_ = ptr->bytes.size();
+  owner_ = std::move(ptr);
+}
+
+// -- comparison ---------------------------------------------------------------
+
+int shared_byte_span::compare(const shared_byte_span& other) const noexcept {
+  auto n = std::min(size_, other.size_);
+  if (n > 0)
+    if (auto res = memcmp(data_, other.data_, n); res != 0)
+      return res;
+  return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+}
+
+// -- serialization ------------------------------------------------------------
+
+bool shared_byte_span::load(binary_deserializer& source) {
+  auto size = size_t{0};
+  if (!source.begin_sequence(size))
+    return false;
+  if (size > source.remaining()) {
+    source.emplace_error(sec::end_of_stream);
+    return false;
+  }
+  auto bytes = make_span(source.current(), size);
+  if (auto owner = source.input_owner())
+    *this = shared_byte_span{owner, bytes};
+  else
+    *this = shared_byte_span{byte_buffer{bytes.begin(), bytes.end()}};
+  source.skip(size);
+  return source.end_sequence();
+}
+
+} // namespace caf
@@ -0,0 +1,67 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/shared_string_view.hpp"
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/make_counted.hpp"
+#include "caf/sec.hpp"
+
+namespace caf {
+
+namespace {
+
+class string_holder : public ref_counted {
+public:
+  explicit string_holder(std::string str) : str(std::move(str)) {
+    // nop
+  }
+
+  std::string str;
+};
+
+} // namespace
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+shared_string_view::shared_string_view(std::string str) {
+  if (str.empty())
+    return;
+  auto ptr = make_counted<string_holder>(std::move(str));
+  data_ = ptr->str.data();
+  size_ = ptr->str.size();
+  owner_ = std::move(ptr);
+}
+
+// -- comparison ---------------------------------------------------------------
+
+int shared_string_view::compare(const shared_string_view& other) const noexcept {
+  return str().compare(other.str());
+}
+
+int shared_string_view::compare(string_view other) const noexcept {
+  return str().compare(other);
+}
+
+// -- serialization ------------------------------------------------------------
+
+bool shared_string_view::load(binary_deserializer& source) {
+  auto size = size_t{0};
+  if (!source.begin_sequence(size))
+    return false;
+  if (size > source.remaining()) {
+    source.emplace_error(sec::end_of_stream);
+    return false;
+  }
+  auto chars = string_view{reinterpret_cast<const char*>(source.current()),
+                           size};
+  if (auto owner = source.input_owner())
+    *this = shared_string_view{owner, chars};
+  else
+    *this = shared_string_view{std::string{chars.begin(), chars.end()}};
+  source.skip(size);
+  return source.end_sequence();
+}
+
+} // namespace caf
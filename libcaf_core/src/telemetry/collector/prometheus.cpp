@@ -4,8 +4,11 @@
 
 #include "caf/telemetry/collector/prometheus.hpp"
 
+#include <charconv>
 #include <cmath>
+#include <cstdio>
 #include <ctime>
+#include <iterator>
 #include <type_traits>
 
 #include "caf/telemetry/dbl_gauge.hpp"
@@ -35,12 +38,23 @@ struct ms_timestamp {
   ms_timestamp& operator=(const ms_timestamp&) noexcept = default;
 };
 
+/// Seconds since epoch with millisecond resolution, as used by OpenMetrics.
+struct sec_timestamp {
+  int64_t ms;
+};
+
 // Converts separators such as '.' and '-' to underlines to follow the
 // Prometheus naming conventions.
 struct separator_to_underline {
   string_view str;
 };
 
+// Renders the name of a metric family without the `_total` suffix for sums.
+// OpenMetrics uses this name for the meta information of counters.
+struct base_name {
+  const metric_family* family;
+};
+
 void append(prometheus::char_buffer&) {
   // End of recursion.
 }
@@ -61,6 +75,9 @@ template <class T, class... Ts>
 std::enable_if_t<std::is_integral<T>::value>
 append(prometheus::char_buffer& buf, T val, Ts&&... xs);
 
+template <class... Ts>
+void append(prometheus::char_buffer&, base_name, Ts&&...);
+
 template <class... Ts>
 void append(prometheus::char_buffer&, const metric_family*, Ts&&...);
 
@@ -73,6 +90,9 @@ void append(prometheus::char_buffer&, const metric*, Ts&&...);
 template <class... Ts>
 void append(prometheus::char_buffer&, ms_timestamp, Ts&&...);
 
+template <class... Ts>
+void append(prometheus::char_buffer&, sec_timestamp, Ts&&...);
+
 template <class... Ts>
 void append(prometheus::char_buffer&, const prometheus::char_buffer&, Ts&&...);
 
@@ -114,7 +134,13 @@ void append(prometheus::char_buffer& buf, double val, Ts&&... xs) {
     else
       append(buf, "-Inf"_sv);
   } else {
-    append(buf, std::to_string(val));
+    // Same output as std::to_string, but without allocating a string.
+    char tmp[64];
+    auto n = snprintf(tmp, sizeof(tmp), "%f", val);
+    if (n > 0 && static_cast<size_t>(n) < sizeof(tmp))
+      buf.insert(buf.end(), tmp, tmp + n);
+    else
+      append(buf, std::to_string(val));
   }
   append(buf, std::forward<Ts>(xs)...);
 }
@@ -122,17 +148,26 @@ void append(prometheus::char_buffer& buf, double val, Ts&&... xs) {
 template <class T, class... Ts>
 std::enable_if_t<std::is_integral<T>::value>
 append(prometheus::char_buffer& buf, T val, Ts&&... xs) {
-  append(buf, std::to_string(val));
+  char tmp[24];
+  auto res = std::to_chars(tmp, tmp + sizeof(tmp), val);
+  buf.insert(buf.end(), tmp, res.ptr);
   append(buf, std::forward<Ts>(xs)...);
 }
 
 template <class... Ts>
-void append(prometheus::char_buffer& buf, const metric_family* family,
-            Ts&&... xs) {
+void append(prometheus::char_buffer& buf, base_name x, Ts&&... xs) {
+  auto family = x.family;
   append(buf, separator_to_underline{family->prefix()}, '_',
          separator_to_underline{family->name()});
   if (family->unit() != "1"_sv)
     append(buf, '_', family->unit());
+  append(buf, std::forward<Ts>(xs)...);
+}
+
+template <class... Ts>
+void append(prometheus::char_buffer& buf, const metric_family* family,
+            Ts&&... xs) {
+  append(buf, base_name{family});
   if (family->is_sum())
     append(buf, "_total"_sv);
   append(buf, std::forward<Ts>(xs)...);
@@ -163,6 +198,15 @@ void append(prometheus::char_buffer& buf, ms_timestamp ts, Ts&&... xs) {
   append(buf, std::forward<Ts>(xs)...);
 }
 
+template <class... Ts>
+void append(prometheus::char_buffer& buf, sec_timestamp ts, Ts&&... xs) {
+  auto ms = ts.ms % 1000;
+  append(buf, ts.ms / 1000, '.', static_cast<char>('0' + ms / 100),
+         static_cast<char>('0' + ms / 10 % 10),
+         static_cast<char>('0' + ms % 10));
+  append(buf, std::forward<Ts>(xs)...);
+}
+
 template <class... Ts>
 void append(prometheus::char_buffer& buf, const prometheus::char_buffer& x,
             Ts&&... xs) {
@@ -174,12 +218,28 @@ void append(prometheus::char_buffer& buf, const prometheus::char_buffer& x,
 
 // -- properties ---------------------------------------------------------------
 
+void prometheus::format(output_format value) {
+  if (format_ == value)
+    return;
+  format_ = value;
+  // Only the meta information differs between the formats. Resetting the
+  // timestamp forces the next scrape to render again, regardless of the
+  // minimum scrape interval.
+  buf_.clear();
+  last_scrape_ = timestamp{timespan{0}};
+  family_info_.clear();
+  current_family_ = nullptr;
+}
+
 void prometheus::reset() {
   buf_.clear();
   last_scrape_ = timestamp{timespan{0}};
   family_info_.clear();
+  metric_info_.clear();
   histogram_info_.clear();
   current_family_ = nullptr;
+  line_suffix_.clear();
+  format_ = output_format::text;
   min_scrape_interval_ = timespan{0};
 }
 
@@ -190,6 +250,11 @@ bool prometheus::begin_scrape(timestamp now) {
     buf_.clear();
     last_scrape_ = now;
     current_family_ = nullptr;
+    line_suffix_.clear();
+    if (format_ == output_format::text)
+      append(line_suffix_, ' ', ms_timestamp{now}, '\n');
+    else
+      append(line_suffix_, ' ', sec_timestamp{ms_timestamp{now}.value}, '\n');
     return true;
   } else {
     return false;
@@ -197,7 +262,8 @@ bool prometheus::begin_scrape(timestamp now) {
 }
 
 void prometheus::end_scrape() {
-  // nop
+  if (format_ == output_format::open_metrics)
+    append(buf_, "# EOF\n"_sv);
 }
 
 // -- appending into the internal buffer ---------------------------------------
@@ -214,6 +280,18 @@ void prometheus::append_histogram(
   append_histogram_impl(family, instance, buckets, sum);
 }
 
+void prometheus::append_summary(
+  const metric_family* family, const metric* instance,
+  const int_hdr_histogram::snapshot_type& snapshot) {
+  append_summary_impl(family, instance, snapshot);
+}
+
+void prometheus::append_summary(
+  const metric_family* family, const metric* instance,
+  const dbl_hdr_histogram::snapshot_type& snapshot) {
+  append_summary_impl(family, instance, snapshot);
+}
+
 // -- collect API --------------------------------------------------------------
 
 string_view prometheus::collect_from(const metric_registry& registry,
@@ -235,27 +313,44 @@ void prometheus::set_current_family(const metric_family* family,
   auto i = family_info_.find(family);
   if (i == family_info_.end()) {
     i = family_info_.emplace(family, char_buffer{}).first;
-    if (!family->helptext().empty())
-      append(i->second, "# HELP ", family, ' ', family->helptext(), '\n');
-    append(i->second, "# TYPE ", family, ' ', prometheus_type, '\n');
+    auto& info = i->second;
+    if (format_ == output_format::text) {
+      if (!family->helptext().empty())
+        append(info, "# HELP ", family, ' ', family->helptext(), '\n');
+      append(info, "# TYPE ", family, ' ', prometheus_type, '\n');
+    } else {
+      base_name name{family};
+      if (!family->helptext().empty())
+        append(info, "# HELP ", name, ' ', family->helptext(), '\n');
+      append(info, "# TYPE ", name, ' ', prometheus_type, '\n');
+    }
   }
   buf_.insert(buf_.end(), i->second.begin(), i->second.end());
 }
 
+const prometheus::char_buffer&
+prometheus::instance_prefix(const metric_family* family,
+                            const metric* instance) {
+  auto i = metric_info_.find(instance);
+  if (i == metric_info_.end()) {
+    i = metric_info_.emplace(instance, char_buffer{}).first;
+    append(i->second, family, instance, ' ');
+  }
+  return i->second;
+}
+
 void prometheus::append_impl(const metric_family* family,
                              string_view prometheus_type,
                              const metric* instance, int64_t value) {
   set_current_family(family, prometheus_type);
-  append(buf_, family, instance, ' ', value, ' ', ms_timestamp{last_scrape_},
-         '\n');
+  append(buf_, instance_prefix(family, instance), value, line_suffix_);
 }
 
 void prometheus::append_impl(const metric_family* family,
                              string_view prometheus_type,
                              const metric* instance, double value) {
   set_current_family(family, prometheus_type);
-  append(buf_, family, instance, ' ', value, ' ', ms_timestamp{last_scrape_},
-         '\n');
+  append(buf_, instance_prefix(family, instance), value, line_suffix_);
 }
 
 namespace {
@@ -307,10 +402,64 @@ void prometheus::append_histogram_impl(const metric_family* family,
   auto index = size_t{0};
   for (; index < buckets.size(); ++index) {
     acc += buckets[index].count.value();
-    append(buf_, vm[index], acc, ' ', ms_timestamp{last_scrape_}, '\n');
+    append(buf_, vm[index], acc, line_suffix_);
+  }
+  append(buf_, vm[index++], sum, line_suffix_);
+  append(buf_, vm[index++], acc, line_suffix_);
+}
+
+namespace {
+
+// Quantiles for rendering HDR histograms as summary.
+struct summary_quantile {
+  double value;
+  string_view label;
+};
+
+constexpr summary_quantile summary_quantiles[] = {
+  {0.5, "0.5"},
+  {0.9, "0.9"},
+  {0.99, "0.99"},
+  {0.999, "0.999"},
+};
+
+auto make_summary_info(const metric_family* family, const metric* instance) {
+  std::vector<prometheus::char_buffer> result;
+  auto add_result = [&](auto&&... xs) {
+    result.emplace_back();
+    append(result.back(), std::forward<decltype(xs)>(xs)...);
+  };
+  auto labels = instance->labels();
+  labels.emplace_back("quantile", "");
+  result.reserve(std::size(summary_quantiles) + 2);
+  for (auto& quantile : summary_quantiles) {
+    labels.back().value(quantile.label);
+    add_result(family, labels, ' ');
   }
-  append(buf_, vm[index++], sum, ' ', ms_timestamp{last_scrape_}, '\n');
-  append(buf_, vm[index++], acc, ' ', ms_timestamp{last_scrape_}, '\n');
+  labels.pop_back();
+  add_result(family, "_sum", labels, ' ');
+  add_result(family, "_count", labels, ' ');
+  return result;
+}
+
+} // namespace
+
+template <class ValueType>
+void prometheus::append_summary_impl(const metric_family* family,
+                                     const metric* instance,
+                                     const hdr_snapshot<ValueType>& snapshot) {
+  auto i = histogram_info_.find(instance);
+  if (i == histogram_info_.end()) {
+    auto info = make_summary_info(family, instance);
+    i = histogram_info_.emplace(instance, std::move(info)).first;
+  }
+  set_current_family(family, "summary");
+  auto& vm = i->second;
+  auto index = size_t{0};
+  for (auto& quantile : summary_quantiles)
+    append(buf_, vm[index++], snapshot.quantile(quantile.value), line_suffix_);
+  append(buf_, vm[index++], snapshot.sum(), line_suffix_);
+  append(buf_, vm[index++], snapshot.count(), line_suffix_);
 }
 
 } // namespace caf::telemetry::collector
@@ -0,0 +1,63 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/telemetry/hdr_layout.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "caf/settings.hpp"
+
+namespace caf::telemetry {
+
+namespace {
+
+// Restricts exponents to normal double values.
+constexpr int min_normal_exponent = -1022;
+
+constexpr int max_normal_exponent = 1023;
+
+int exponent_of(double value, int fallback) {
+  if (!std::isfinite(value) || value <= 0)
+    return fallback;
+  return std::clamp(std::ilogb(value), min_normal_exponent,
+                    max_normal_exponent);
+}
+
+} // namespace
+
+hdr_layout::hdr_layout(double min_value, double max_value, int precision) {
+  min_exponent_ = exponent_of(min_value, 0);
+  max_exponent_ = std::max(exponent_of(max_value, min_exponent_),
+                           min_exponent_);
+  precision_ = std::clamp(precision, 0, max_precision);
+  lowest_ = std::ldexp(1.0, min_exponent_);
+}
+
+double hdr_layout::lower_bound(size_t index) const noexcept {
+  auto exponent = min_exponent_ + static_cast<int>(index >> precision_);
+  auto sub_bucket = index & ((size_t{1} << precision_) - 1);
+  auto mantissa = 1.0 + std::ldexp(static_cast<double>(sub_bucket),
+                                   -precision_);
+  return std::ldexp(mantissa, exponent);
+}
+
+double hdr_layout::upper_bound(size_t index) const noexcept {
+  auto exponent = min_exponent_ + static_cast<int>(index >> precision_);
+  auto sub_bucket = index & ((size_t{1} << precision_) - 1);
+  auto mantissa = 1.0 + std::ldexp(static_cast<double>(sub_bucket + 1),
+                                   -precision_);
+  return std::ldexp(mantissa, exponent);
+}
+
+hdr_layout hdr_layout::from(const settings& cfg, const hdr_layout& fallback) {
+  auto min_value = get_or(cfg, "min", fallback.min_value());
+  auto max_value = get_or(cfg, "max", std::ldexp(1.0, fallback.max_exponent_));
+  auto precision = get_or(cfg, "precision", int64_t{fallback.precision_});
+  if (precision < 0 || precision > max_precision)
+    precision = fallback.precision_;
+  return hdr_layout{min_value, max_value, static_cast<int>(precision)};
+}
+
+} // namespace caf::telemetry
@@ -4,8 +4,12 @@
 
 #include "caf/telemetry/metric_registry.hpp"
 
+#include <algorithm>
+#include <thread>
+
 #include "caf/actor_system_config.hpp"
 #include "caf/config.hpp"
+#include "caf/hash/fnv.hpp"
 #include "caf/raise_error.hpp"
 #include "caf/telemetry/dbl_gauge.hpp"
 #include "caf/telemetry/int_gauge.hpp"
@@ -28,14 +32,28 @@ metric_registry::metric_registry() : config_(nullptr) {
   // nop
 }
 
-metric_registry::metric_registry(const actor_system_config& cfg) {
-  config_ = get_if<settings>(&cfg, "caf.metrics");
+metric_registry::metric_registry(const actor_system_config& cfg)
+  : config_(nullptr) {
+  config(get_if<settings>(&cfg, "caf.metrics"));
 }
 
 metric_registry::~metric_registry() {
   // nop
 }
 
+void metric_registry::config(const settings* ptr) {
+  config_ = ptr;
+  if (ptr != nullptr)
+    if (auto num_shards = get_as<size_t>(*ptr, "shards"))
+      shards(*num_shards);
+}
+
+void metric_registry::shards(size_t value) noexcept {
+  if (value == 0)
+    value = std::max(std::thread::hardware_concurrency(), 1u);
+  shards_ = value;
+}
+
 void metric_registry::merge(metric_registry& other) {
   if (this == &other)
     return;
@@ -46,21 +64,38 @@ void metric_registry::merge(metric_registry& other) {
   for (auto& fptr : other.families_)
     if (fetch(fptr->prefix(), fptr->name()) != nullptr)
       CAF_RAISE_ERROR("failed to merge metrics: duplicated family found");
-  families_.insert(families_.end(),
-                   std::make_move_iterator(other.families_.begin()),
-                   std::make_move_iterator(other.families_.end()));
+  for (auto& fptr : other.families_)
+    add(std::move(fptr));
   other.families_.clear();
+  other.index_.clear();
 }
 
 metric_family* metric_registry::fetch(const string_view& prefix,
                                       const string_view& name) {
-  auto eq = [&](const auto& ptr) {
-    return ptr->prefix() == prefix && ptr->name() == name;
+  auto eq = [&](const metric_family& family) {
+    return family.prefix() == prefix && family.name() == name;
   };
-  if (auto i = std::find_if(families_.begin(), families_.end(), eq);
-      i != families_.end())
-    return i->get();
-  return nullptr;
+  return index_.find(hash_of(prefix, name), eq);
+}
+
+metric_family* metric_registry::fetch(const string_view& prefix,
+                                      const string_view& name,
+                                      std::unique_lock<std::mutex>& guard) {
+  if (auto result = fetch(prefix, name))
+    return result;
+  // Check again, since another thread may have added the family meanwhile.
+  guard.lock();
+  return fetch(prefix, name);
+}
+
+void metric_registry::add(std::unique_ptr<metric_family> ptr) {
+  auto hash = hash_of(ptr->prefix(), ptr->name());
+  index_.insert(hash, ptr.get());
+  families_.emplace_back(std::move(ptr));
+}
+
+size_t metric_registry::hash_of(string_view prefix, string_view name) noexcept {
+  return hash::fnv<size_t>::compute(prefix, name);
 }
 
 std::vector<std::string>
@@ -0,0 +1,82 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/type_schema.hpp"
+
+#include <algorithm>
+
+namespace caf {
+
+// -- properties ---------------------------------------------------------------
+
+const type_schema::field* type_schema::find(string_view path) const noexcept {
+  auto pred = [path](const field& x) { return x.path == path; };
+  auto i = std::find_if(fields_.begin(), fields_.end(), pred);
+  return i != fields_.end() ? &*i : nullptr;
+}
+
+// -- modifiers ----------------------------------------------------------------
+
+void type_schema::set_type(type_id_t type, std::string name) {
+  type_ = type;
+  name_ = std::move(name);
+}
+
+void type_schema::add_fixed(std::string path, type_id_t type, size_t size) {
+  fields_.emplace_back(field{std::move(path), type, fixed_size_ ? size_ : npos,
+                             size});
+  size_ += size;
+}
+
+void type_schema::add_variable(std::string path, type_id_t type) {
+  fields_.emplace_back(
+    field{std::move(path), type, fixed_size_ ? size_ : npos, 0});
+  fixed_size_ = false;
+}
+
+void type_schema::clear() noexcept {
+  fields_.clear();
+  size_ = 0;
+  fixed_size_ = true;
+}
+
+// -- related free functions ---------------------------------------------------
+
+std::string to_string(const type_schema& x) {
+  std::string result = x.name().empty() ? "anonymous" : x.name();
+  result += " {";
+  auto add_num = [&result](size_t num) { result += std::to_string(num); };
+  auto first = true;
+  for (auto& fld : x.fields()) {
+    if (first)
+      first = false;
+    else
+      result += ',';
+    result += ' ';
+    if (!fld.path.empty()) {
+      result += fld.path;
+      result += ": ";
+    }
+    auto type_name = query_type_name(fld.type);
+    if (!type_name.empty())
+      result.insert(result.end(), type_name.begin(), type_name.end());
+    else
+      result += '?';
+    if (fld.offset != type_schema::npos) {
+      result += " @ ";
+      add_num(fld.offset);
+    }
+    if (fld.size > 0) {
+      result += " [";
+      add_num(fld.size);
+      result += ']';
+    } else {
+      result += " [*]";
+    }
+  }
+  result += " }";
+  return result;
+}
+
+} // namespace caf
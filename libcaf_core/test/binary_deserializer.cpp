@@ -10,6 +10,7 @@
 #include "nasty.hpp"
 
 #include <cstring>
+#include <limits>
 #include <vector>
 
 #include "caf/actor_system.hpp"
@@ -151,6 +152,33 @@ CAF_TEST(container types) {
     CHECK_LOAD(std::set<int8_t>, std::set<int8_t>({1, 2, 4, 8}), //
                4_b, 1_b, 2_b, 4_b, 8_b);
   }
+  SUBTEST("vectors of arithmetic types") {
+    CHECK_LOAD(std::vector<int16_t>, std::vector<int16_t>({85, -32683}), //
+               2_b, 0b00000000_b, 0b01010101_b, 0b10000000_b, 0b01010101_b);
+    CHECK_LOAD(std::vector<uint32_t>, std::vector<uint32_t>({0x01020304u}), //
+               1_b, 1_b, 2_b, 3_b, 4_b);
+    std::vector<double> xs{1.5, -2.25, 1e300};
+    byte_buffer buf;
+    binary_serializer sink{nullptr, buf};
+    CAF_CHECK(sink.apply(xs));
+    CAF_CHECK_EQUAL(load<std::vector<double>>(buf), xs);
+  }
+  SUBTEST("byte buffers") {
+    CHECK_LOAD(byte_buffer, byte_buffer({1_b, 2_b, 4_b}), //
+               3_b, 1_b, 2_b, 4_b);
+  }
+  SUBTEST("truncated input results in end_of_stream") {
+    byte_buffer buf{2_b, 0_b, 1_b, 0_b};
+    binary_deserializer source{nullptr, buf};
+    std::vector<int32_t> xs;
+    CAF_CHECK(!source.apply(xs));
+    CAF_CHECK_EQUAL(source.get_error(), sec::end_of_stream);
+    byte_buffer ys;
+    byte_buffer truncated{5_b, 1_b};
+    binary_deserializer source2{nullptr, truncated};
+    CAF_CHECK(!source2.apply(ys));
+    CAF_CHECK_EQUAL(source2.get_error(), sec::end_of_stream);
+  }
 }
 
 CAF_TEST(binary serializer picks up inspect functions) {
@@ -199,4 +227,54 @@ CAF_TEST(binary serializer picks up inspect functions) {
   }
 }
 
+CAF_TEST(binary deserializer reads compact integers) {
+  auto roundtrip = [](auto x) {
+    byte_buffer buf;
+    binary_serializer sink{nullptr, buf};
+    sink.compact_integers(true);
+    if (!sink.apply(x))
+      CAF_FAIL("binary_serializer failed to save: " << sink.get_error());
+    auto y = decltype(x){};
+    binary_deserializer source{nullptr, buf};
+    source.compact_integers(true);
+    if (!source.apply(y))
+      CAF_FAIL("binary_deserializer failed to load: " << source.get_error());
+    CHECK_EQ(source.remaining(), 0u);
+    return y;
+  };
+  SUBTEST("integers restore their original value") {
+    using i64_limits = std::numeric_limits<int64_t>;
+    using u64_limits = std::numeric_limits<uint64_t>;
+    for (auto x : {int64_t{0}, int64_t{-1}, int64_t{63}, int64_t{-64},
+                   i64_limits::min(), i64_limits::max()})
+      CHECK_EQ(roundtrip(x), x);
+    CHECK_EQ(roundtrip(u64_limits::max()), u64_limits::max());
+    CHECK_EQ(roundtrip(int16_t{-32768}), int16_t{-32768});
+    CHECK_EQ(roundtrip(uint32_t{4294966951u}), uint32_t{4294966951u});
+  }
+  SUBTEST("containers and strings restore their original value") {
+    auto xs = std::vector<int32_t>{1, -1, 200, -70000};
+    CHECK_EQ(roundtrip(xs), xs);
+    auto str = std::u16string{u"hello"};
+    CHECK_EQ(roundtrip(str) == str, true);
+  }
+  SUBTEST("the deserializer rejects values that exceed the integer type") {
+    byte_buffer buf{0xFF_b, 0xFF_b, 0x04_b};
+    binary_deserializer source{nullptr, buf};
+    source.compact_integers(true);
+    auto x = uint16_t{0};
+    CHECK_EQ(source.apply(x), false);
+    CHECK_EQ(source.get_error(), sec::invalid_argument);
+  }
+  SUBTEST("the deserializer rejects overlong encodings") {
+    byte_buffer buf(11, 0x80_b);
+    buf.back() = 0x00_b;
+    binary_deserializer source{nullptr, buf};
+    source.compact_integers(true);
+    auto x = uint64_t{0};
+    CHECK_EQ(source.apply(x), false);
+    CHECK_EQ(source.get_error(), sec::invalid_argument);
+  }
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
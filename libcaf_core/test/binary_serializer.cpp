@@ -10,6 +10,7 @@
 #include "nasty.hpp"
 
 #include <cstring>
+#include <limits>
 #include <vector>
 
 #include "caf/actor_system.hpp"
@@ -49,6 +50,16 @@ struct fixture {
     return result;
   }
 
+  template <class... Ts>
+  auto save_compact(const Ts&... xs) {
+    byte_buffer result;
+    binary_serializer sink{nullptr, result};
+    sink.compact_integers(true);
+    if (!(sink.apply(xs) && ...))
+      CAF_FAIL("binary_serializer failed to save: " << sink.get_error());
+    return result;
+  }
+
   template <class... Ts>
   void save_to_buf(byte_buffer& data, const Ts&... xs) {
     binary_serializer sink{nullptr, data};
@@ -149,6 +160,29 @@ CAF_TEST(container types) {
     CHECK_SAVE(std::set<int8_t>, std::set<int8_t>({1, 2, 4, 8}), //
                4_b, 1_b, 2_b, 4_b, 8_b);
   }
+  SUBTEST("vectors of arithmetic types use the same encoding as sets") {
+    CHECK_SAVE(std::vector<int16_t>, std::vector<int16_t>({85, -32683}), //
+               2_b, 0b00000000_b, 0b01010101_b, 0b10000000_b, 0b01010101_b);
+    CHECK_SAVE(std::vector<uint32_t>, std::vector<uint32_t>({0x01020304u}), //
+               1_b, 1_b, 2_b, 3_b, 4_b);
+    std::vector<double> xs{-2.25, 1.5, 1e300};
+    std::set<double> ys{xs.begin(), xs.end()};
+    CAF_CHECK_EQUAL(save(xs), save(ys));
+    std::vector<int64_t> zs{-1, 0, 42, INT64_MAX};
+    std::set<int64_t> ws{zs.begin(), zs.end()};
+    CAF_CHECK_EQUAL(save(zs), save(ws));
+  }
+  SUBTEST("byte buffers") {
+    CHECK_SAVE(byte_buffer, byte_buffer({1_b, 2_b, 4_b}), //
+               3_b, 1_b, 2_b, 4_b);
+  }
+  SUBTEST("vectors may overwrite existing content") {
+    byte_buffer buf{10_b, 11_b, 12_b, 13_b, 14_b, 15_b};
+    binary_serializer sink{nullptr, buf};
+    sink.seek(1);
+    CAF_CHECK(sink.apply(std::vector<uint16_t>{0x0102u, 0x0304u}));
+    CAF_CHECK_EQUAL(buf, byte_buffer({10_b, 2_b, 1_b, 2_b, 3_b, 4_b}));
+  }
 }
 
 CAF_TEST(binary serializer picks up inspect functions) {
@@ -197,4 +231,35 @@ CAF_TEST(binary serializer picks up inspect functions) {
   }
 }
 
+#define CHECK_SAVE_COMPACT(type, value, ...)                                   \
+  CAF_CHECK_EQUAL(save_compact(type{value}), byte_buffer({__VA_ARGS__}))
+
+CAF_TEST(compact integers use varint and zigzag encoding) {
+  SUBTEST("unsigned integers use varint encoding") {
+    CHECK_SAVE_COMPACT(uint16_t, 0u, 0x00_b);
+    CHECK_SAVE_COMPACT(uint32_t, 127u, 0x7F_b);
+    CHECK_SAVE_COMPACT(uint32_t, 128u, 0x80_b, 0x01_b);
+    CHECK_SAVE_COMPACT(uint64_t, 300u, 0xAC_b, 0x02_b);
+    CHECK_SAVE_COMPACT(uint64_t, std::numeric_limits<uint64_t>::max(), //
+                       0xFF_b, 0xFF_b, 0xFF_b, 0xFF_b, 0xFF_b, 0xFF_b, 0xFF_b,
+                       0xFF_b, 0xFF_b, 0x01_b);
+  }
+  SUBTEST("signed integers use zigzag encoding") {
+    CHECK_SAVE_COMPACT(int16_t, 0, 0x00_b);
+    CHECK_SAVE_COMPACT(int32_t, -1, 0x01_b);
+    CHECK_SAVE_COMPACT(int32_t, 1, 0x02_b);
+    CHECK_SAVE_COMPACT(int64_t, -64, 0x7F_b);
+    CHECK_SAVE_COMPACT(int64_t, 64, 0x80_b, 0x01_b);
+    CHECK_SAVE_COMPACT(int16_t, -32768, 0xFF_b, 0xFF_b, 0x03_b);
+  }
+  SUBTEST("8-bit integers and floating points keep their fixed size") {
+    CHECK_SAVE_COMPACT(int8_t, -61, 0b11000011_b);
+    CHECK_SAVE_COMPACT(float, 3.45f, 0x40_b, 0x5C_b, 0xCC_b, 0xCD_b);
+  }
+  SUBTEST("containers of integers encode each element individually") {
+    CAF_CHECK_EQUAL(save_compact(std::vector<int32_t>{1, -1, 200}),
+                    byte_buffer({3_b, 0x02_b, 0x01_b, 0x90_b, 0x03_b}));
+  }
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,150 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE builtin_actor_profiler
+
+#include "caf/builtin_actor_profiler.hpp"
+
+#include "core-test.hpp"
+
+#include <sstream>
+
+using namespace caf;
+
+namespace {
+
+struct foo_state {
+  static inline const char* name = "foo";
+};
+
+struct bar_state {
+  static inline const char* name = "bar";
+};
+
+struct fixture : test_coordinator_fixture<> {
+  fixture() {
+    foo = sys.spawn([](stateful_actor<foo_state>*) -> behavior {
+      return {[](int32_t) {}};
+    });
+    bar = sys.spawn([](stateful_actor<bar_state>*) -> behavior {
+      return {[](const std::string&) {}};
+    });
+  }
+
+  static local_actor& deref(const actor& hdl) {
+    return *static_cast<local_actor*>(actor_cast<abstract_actor*>(hdl));
+  }
+
+  // Simulates the hooks for foo processing an integer while sending a string
+  // to bar and then bar processing the string.
+  void simulate_chain(builtin_actor_profiler& prof) {
+    auto e1 = make_mailbox_element(nullptr, make_message_id(), {},
+                                   make_message(int32_t{42}));
+    auto e2 = make_mailbox_element(actor_cast<strong_actor_ptr>(foo),
+                                   make_message_id(), {},
+                                   make_message(std::string{"hello"}));
+    prof.before_processing(deref(foo), *e1);
+    prof.before_sending(deref(foo), *e2);
+    prof.after_processing(deref(foo), invoke_message_result::consumed);
+    prof.before_processing(deref(bar), *e2);
+    prof.after_processing(deref(bar), invoke_message_result::consumed);
+  }
+
+  actor foo;
+  actor bar;
+};
+
+size_t sum(const builtin_actor_profiler::entry& x) {
+  size_t result = 0;
+  for (auto n : x.buckets)
+    result += n;
+  return result;
+}
+
+bool contains(const std::string& str, string_view what) {
+  return str.find(what.data(), 0, what.size()) != std::string::npos;
+}
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(builtin_actor_profiler_tests, fixture)
+
+CAF_TEST(the profiler aggregates statistics per actor and message type) {
+  builtin_actor_profiler prof;
+  simulate_chain(prof);
+  simulate_chain(prof);
+  auto entries = prof.entries();
+  CAF_REQUIRE_EQUAL(entries.size(), 2u);
+  auto find = [&entries](const std::string& actor_type) {
+    auto pred = [actor_type](const auto& x) {
+      return x.actor_type == actor_type;
+    };
+    auto i = std::find_if(entries.begin(), entries.end(), pred);
+    if (i == entries.end())
+      CAF_FAIL("no entry found for " << actor_type);
+    return *i;
+  };
+  auto foo_entry = find("foo");
+  CAF_CHECK_EQUAL(foo_entry.message_type, "[int32_t]");
+  CAF_CHECK_EQUAL(foo_entry.count, 2u);
+  CAF_CHECK_EQUAL(foo_entry.sends, 2u);
+  CAF_CHECK_EQUAL(foo_entry.latency_count, 0u);
+  CAF_CHECK_EQUAL(sum(foo_entry), 2u);
+  auto bar_entry = find("bar");
+  CAF_CHECK_EQUAL(bar_entry.message_type, "[std::string]");
+  CAF_CHECK_EQUAL(bar_entry.count, 2u);
+  CAF_CHECK_EQUAL(bar_entry.sends, 0u);
+  CAF_CHECK_EQUAL(bar_entry.latency_count, 2u);
+  CAF_CHECK_GREATER_OR_EQUAL(bar_entry.max_time, timespan{0});
+}
+
+CAF_TEST(the profiler ignores skipped messages) {
+  builtin_actor_profiler prof;
+  auto e1 = make_mailbox_element(nullptr, make_message_id(), {},
+                                 make_message(int32_t{42}));
+  prof.before_processing(deref(foo), *e1);
+  prof.after_processing(deref(foo), invoke_message_result::skipped);
+  CAF_CHECK(prof.entries().empty());
+}
+
+CAF_TEST(the profiler renders causal chains as collapsed stacks) {
+  builtin_actor_profiler prof;
+  simulate_chain(prof);
+  std::ostringstream out;
+  prof.write_collapsed_stacks(out);
+  auto str = out.str();
+  CAF_CHECK(starts_with(str, "foo:[int32_t] "));
+  CAF_CHECK(contains(str, "\nfoo:[int32_t];bar:[std::string] "));
+}
+
+CAF_TEST(the profiler renders trace events with flows) {
+  builtin_actor_profiler prof;
+  simulate_chain(prof);
+  std::ostringstream out;
+  prof.write_chrome_trace(out);
+  auto str = out.str();
+  CAF_CHECK(starts_with(str, R"({"displayTimeUnit":"ns","traceEvents":[)"));
+  CAF_CHECK(contains(str, R"({"name":"foo:[int32_t]","cat":"actor","ph":"X")"));
+  CAF_CHECK(contains(str, R"("name":"bar:[std::string]","cat":"actor")"));
+  CAF_CHECK(contains(str, R"("cat":"causality","ph":"s")"));
+  CAF_CHECK(contains(str, R"("cat":"causality","ph":"f","bp":"e")"));
+  CAF_CHECK(contains(str, "]}\n"));
+}
+
+CAF_TEST(the profiler keeps only the most recent trace events) {
+  builtin_actor_profiler prof{3};
+  for (int i = 0; i < 5; ++i)
+    simulate_chain(prof);
+  std::ostringstream out;
+  prof.write_chrome_trace(out);
+  auto str = out.str();
+  size_t num_events = 0;
+  for (auto pos = str.find(R"("ph":"X")"); pos != std::string::npos;
+       pos = str.find(R"("ph":"X")", pos + 1))
+    ++num_events;
+  CAF_CHECK_EQUAL(num_events, 3u);
+  CAF_CHECK_EQUAL(prof.entries().front().count, 5u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,189 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE builtin_tracer
+
+#include "caf/builtin_tracer.hpp"
+
+#include "core-test.hpp"
+
+#include <sstream>
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/byte_buffer.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct foo_state {
+  static inline const char* name = "foo";
+};
+
+struct bar_state {
+  static inline const char* name = "bar";
+};
+
+struct fixture : test_coordinator_fixture<> {
+  fixture() {
+    foo = sys.spawn([](stateful_actor<foo_state>*) -> behavior {
+      return {[](int32_t) {}};
+    });
+    bar = sys.spawn([](stateful_actor<bar_state>*) -> behavior {
+      return {[](const std::string&) {}};
+    });
+  }
+
+  static local_actor& deref(const actor& hdl) {
+    return *static_cast<local_actor*>(actor_cast<abstract_actor*>(hdl));
+  }
+
+  // Simulates the hooks for foo sending an integer to itself, processing the
+  // integer while sending a string to bar and then bar processing the string.
+  void simulate_chain(builtin_tracer& tracer) {
+    auto e1 = make_mailbox_element(actor_cast<strong_actor_ptr>(foo),
+                                   make_message_id(), {},
+                                   make_message(int32_t{42}));
+    auto e2 = make_mailbox_element(actor_cast<strong_actor_ptr>(foo),
+                                   make_message_id(), {},
+                                   make_message(std::string{"hello"}));
+    tracer.before_sending(deref(foo), *e1);
+    tracer.before_processing(deref(foo), *e1);
+    tracer.before_sending(deref(foo), *e2);
+    tracer.after_processing(deref(foo), invoke_message_result::consumed);
+    tracer.before_processing(deref(bar), *e2);
+    tracer.after_processing(deref(bar), invoke_message_result::consumed);
+  }
+
+  actor foo;
+  actor bar;
+};
+
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+
+bool contains(const std::string& str, string_view what) {
+  return str.find(what.data(), 0, what.size()) != std::string::npos;
+}
+
+#endif // CAF_ENABLE_ACTOR_PROFILER
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(builtin_tracer_tests, fixture)
+
+CAF_TEST(the tracer deserializes its contexts) {
+  builtin_tracer tracer;
+  builtin_tracer::context ctx{1, 2, 3, true};
+  byte_buffer buf;
+  binary_serializer sink{nullptr, buf};
+  CAF_REQUIRE(ctx.serialize(sink));
+  binary_deserializer source{nullptr, buf};
+  tracing_data_ptr copy;
+  CAF_REQUIRE(tracer.deserialize(source, copy));
+  CAF_CHECK_EQUAL(source.remaining(), 0u);
+  auto copy_ptr = dynamic_cast<builtin_tracer::context*>(copy.get());
+  CAF_REQUIRE(copy_ptr != nullptr);
+  CAF_CHECK_EQUAL(copy_ptr->trace_id_high, 1u);
+  CAF_CHECK_EQUAL(copy_ptr->trace_id_low, 2u);
+  CAF_CHECK_EQUAL(copy_ptr->parent_id, 3u);
+  CAF_CHECK_EQUAL(copy_ptr->sampled, true);
+}
+
+CAF_TEST(the tracer clamps the sample rate) {
+  CAF_CHECK_EQUAL(builtin_tracer{2.0}.sample_rate(), 1.0);
+  CAF_CHECK_EQUAL(builtin_tracer{-1.0}.sample_rate(), 0.0);
+  CAF_CHECK_EQUAL(builtin_tracer{0.25}.sample_rate(), 0.25);
+}
+
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+
+CAF_TEST(the tracer records spans for causal chains) {
+  builtin_tracer tracer;
+  simulate_chain(tracer);
+  auto spans = tracer.spans();
+  CAF_REQUIRE_EQUAL(spans.size(), 2u);
+  auto& root = spans[0];
+  auto& child = spans[1];
+  CAF_CHECK_EQUAL(root.actor_name, "foo");
+  CAF_CHECK_EQUAL(root.aid, foo.id());
+  CAF_CHECK_EQUAL(to_string(root.message_types), "[int32_t]");
+  CAF_CHECK_EQUAL(root.parent_id, 0u);
+  CAF_CHECK_LESS_OR_EQUAL(root.start, root.end);
+  CAF_CHECK_EQUAL(child.actor_name, "bar");
+  CAF_CHECK_EQUAL(child.trace_id_high, root.trace_id_high);
+  CAF_CHECK_EQUAL(child.trace_id_low, root.trace_id_low);
+  CAF_CHECK_EQUAL(child.parent_id, root.span_id);
+  CAF_CHECK_NOT_EQUAL(child.span_id, root.span_id);
+  simulate_chain(tracer);
+  spans = tracer.spans();
+  CAF_REQUIRE_EQUAL(spans.size(), 4u);
+  CAF_CHECK_NOT_EQUAL(spans[2].trace_id_low, root.trace_id_low);
+}
+
+CAF_TEST(the tracer propagates the sampling decision) {
+  builtin_tracer tracer{0.0};
+  simulate_chain(tracer);
+  CAF_CHECK(tracer.spans().empty());
+  auto e1 = make_mailbox_element(nullptr, make_message_id(), {},
+                                 make_message(int32_t{42}));
+  auto e2 = make_mailbox_element(nullptr, make_message_id(), {},
+                                 make_message(std::string{"hello"}));
+  tracer.before_sending(deref(foo), *e1);
+  tracer.before_processing(deref(foo), *e1);
+  tracer.before_sending(deref(foo), *e2);
+  tracer.after_processing(deref(foo), invoke_message_result::consumed);
+  auto ctx = dynamic_cast<builtin_tracer::context*>(e2->tracing_id.get());
+  CAF_REQUIRE(ctx != nullptr);
+  CAF_CHECK_EQUAL(ctx->sampled, false);
+}
+
+CAF_TEST(the tracer ignores skipped messages) {
+  builtin_tracer tracer;
+  auto e1 = make_mailbox_element(nullptr, make_message_id(), {},
+                                 make_message(int32_t{42}));
+  tracer.before_sending(deref(foo), *e1);
+  tracer.before_processing(deref(foo), *e1);
+  tracer.after_processing(deref(foo), invoke_message_result::skipped);
+  CAF_CHECK(tracer.spans().empty());
+}
+
+CAF_TEST(the tracer keeps only the most recent spans) {
+  builtin_tracer tracer{1.0, 3};
+  for (int i = 0; i < 5; ++i)
+    simulate_chain(tracer);
+  auto spans = tracer.spans();
+  CAF_REQUIRE_EQUAL(spans.size(), 3u);
+  CAF_CHECK_EQUAL(spans.back().actor_name, "bar");
+}
+
+CAF_TEST(the tracer renders spans as OTLP JSON) {
+  builtin_tracer tracer;
+  simulate_chain(tracer);
+  std::ostringstream out;
+  tracer.write_otlp_json(out);
+  auto str = out.str();
+  CAF_CHECK(starts_with(str, R"({"resourceSpans":[{"resource":)"));
+  CAF_CHECK(contains(str, R"({"key":"service.name")"));
+  CAF_CHECK(contains(str, R"({"key":"caf.node")"));
+  CAF_CHECK(contains(str, R"("scope":{"name":"caf.builtin_tracer"})"));
+  CAF_CHECK(contains(str, R"("name":"foo","kind":5,"startTimeUnixNano":")"));
+  CAF_CHECK(contains(str, R"({"key":"caf.message.types",)"
+                          R"("value":{"stringValue":"[std::string]"}})"));
+  CAF_CHECK(contains(str, R"("parentSpanId":")"));
+  CAF_CHECK(contains(str, "]}]}]}\n"));
+  // IDs are lowercase hex strings with 32 and 16 digits, respectively.
+  auto pos = str.find(R"("traceId":")");
+  CAF_REQUIRE_NOT_EQUAL(pos, std::string::npos);
+  auto id = str.substr(pos + 11, 33);
+  CAF_CHECK_EQUAL(id.back(), '"');
+  id.pop_back();
+  CAF_CHECK(std::all_of(id.begin(), id.end(), [](char c) {
+    return isdigit(c) || (c >= 'a' && c <= 'f');
+  }));
+}
+
+#endif // CAF_ENABLE_ACTOR_PROFILER
+
+CAF_TEST_FIXTURE_SCOPE_END()
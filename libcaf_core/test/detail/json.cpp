@@ -165,3 +165,128 @@ CAF_TEST(json baselines) {
     resource.reclaim();
   }
 }
+
+CAF_TEST(the indexed parser produces the same trees as the FSM) {
+  size_t baseline_index = 0;
+  detail::monotonic_buffer_resource resource;
+  for (auto [input, output] : baselines) {
+    MESSAGE("test baseline at index " << baseline_index++);
+    auto val = detail::json::parse_indexed(input, &resource);
+    if (CHECK(val != nullptr))
+      CHECK_EQ(stringify(*val), output);
+    resource.reclaim();
+  }
+}
+
+CAF_TEST(the indexed parser handles strings across block boundaries) {
+  // Shifts escaped quotes, backslashes and structural characters inside
+  // strings to all positions relative to the 16-byte blocks of the scanner.
+  std::vector<std::string> inputs;
+  for (size_t pad = 0; pad < 20; ++pad) {
+    auto prefix = std::string(pad, ' ');
+    inputs.emplace_back(prefix + R"({"a\"b": ["x\\", "{[,:]}"], "c": 1})");
+    inputs.emplace_back(prefix + R"(["\\\"", "\/\b\f\n\r\t", -1.5e3, 7])");
+    inputs.emplace_back(prefix + R"({"k": {"nested": [true, false, null]}})");
+  }
+  detail::monotonic_buffer_resource resource;
+  for (auto& input : inputs) {
+    MESSAGE("input: " << input);
+    string_parser_state ps{input.data(), input.data() + input.size()};
+    auto expected = detail::json::parse(ps, &resource);
+    CHECK_EQ(ps.code, pec::success);
+    auto val = detail::json::parse_indexed(input, &resource);
+    if (CHECK(val != nullptr))
+      CHECK_EQ(stringify(*val), stringify(*expected));
+    resource.reclaim();
+  }
+}
+
+CAF_TEST(the indexed parser handles runs of backslashes) {
+  // Runs of up to 20 backslashes, shifted to all positions of a block and
+  // followed by a quote or another character.
+  std::vector<std::string> inputs;
+  for (size_t pad = 0; pad < 16; ++pad) {
+    for (size_t n = 1; n <= 20; ++n) {
+      auto prefix = std::string(pad, ' ');
+      auto run = std::string(n, '\\');
+      auto tail = n % 2 == 0 ? std::string{} : std::string{"\""};
+      inputs.emplace_back(prefix + "[\"" + run + tail + "x\", 1]");
+      if (n % 2 == 0)
+        inputs.emplace_back(prefix + "{\"" + run + "\": " + std::to_string(n)
+                            + "}");
+    }
+  }
+  detail::monotonic_buffer_resource resource;
+  for (auto& input : inputs) {
+    MESSAGE("input: " << input);
+    string_parser_state ps{input.data(), input.data() + input.size()};
+    auto expected = detail::json::parse(ps, &resource);
+    CHECK_EQ(ps.code, pec::success);
+    auto val = detail::json::parse_indexed(input, &resource);
+    if (CHECK(val != nullptr))
+      CHECK_EQ(stringify(*val), stringify(*expected));
+    resource.reclaim();
+  }
+}
+
+CAF_TEST(the indexed parser handles inputs that span several chunks) {
+  std::string input = "[";
+  for (size_t i = 0; i < 2000; ++i) {
+    if (i > 0)
+      input += ", ";
+    input += R"({"id": )" + std::to_string(i) + R"(, "text": "a\"b\\c{[,"})";
+  }
+  input += "]";
+  detail::monotonic_buffer_resource resource;
+  string_parser_state ps{input.data(), input.data() + input.size()};
+  auto expected = detail::json::parse(ps, &resource);
+  CHECK_EQ(ps.code, pec::success);
+  auto val = detail::json::parse_indexed(input, &resource);
+  if (CHECK(val != nullptr))
+    CHECK_EQ(stringify(*val), stringify(*expected));
+  MESSAGE("errors at the start or the end make the parser fail");
+  auto early = input;
+  early[early.find(',')] = '?';
+  CHECK(detail::json::parse_indexed(early, &resource) == nullptr);
+  auto late = input;
+  late.back() = '?';
+  CHECK(detail::json::parse_indexed(late, &resource) == nullptr);
+}
+
+CAF_TEST(the indexed parser rejects invalid input) {
+  string_view inputs[] = {
+    R"()",       R"(   )",      R"({)",          R"(})",
+    R"([1,])",   R"([1 2])",    R"({"a" 1})",    R"({"a":})",
+    R"({1: 2})", R"(["abc)",    R"(["\x"])",     R"(42 43)",
+    R"([1]])",   R"({"a":1,})", "[1,\r2]",       R"(nope)",
+  };
+  detail::monotonic_buffer_resource resource;
+  for (auto input : inputs) {
+    MESSAGE("input: " << input);
+    CHECK(detail::json::parse_indexed(input, &resource) == nullptr);
+    string_parser_state ps{input.begin(), input.end()};
+    detail::json::parse(ps, &resource);
+    CHECK_NE(ps.code, pec::success);
+    resource.reclaim();
+  }
+}
+
+CAF_TEST(the indexed parser agrees with the FSM on scalar edge cases) {
+  string_view inputs[] = {
+    R"([-])", R"([+, 1])", R"([null ])", "[nan\t]", R"([1 ])", R"( 7 )",
+  };
+  detail::monotonic_buffer_resource resource;
+  for (auto input : inputs) {
+    MESSAGE("input: " << input);
+    string_parser_state ps{input.begin(), input.end()};
+    auto expected = detail::json::parse(ps, &resource);
+    auto val = detail::json::parse_indexed(input, &resource);
+    if (ps.code == pec::success) {
+      if (CHECK(val != nullptr))
+        CHECK_EQ(stringify(*val), stringify(*expected));
+    } else {
+      CHECK(val == nullptr);
+    }
+    resource.reclaim();
+  }
+}
@@ -0,0 +1,76 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.message_layout
+
+#include "caf/detail/message_layout.hpp"
+
+#include "core-test.hpp"
+
+#include <string>
+
+#include "caf/detail/meta_object.hpp"
+#include "caf/detail/type_id_list_builder.hpp"
+#include "caf/message.hpp"
+
+using namespace caf;
+
+CAF_TEST(layouts store the offset of each element) {
+  auto types = make_type_id_list<int8_t, std::string, int64_t>();
+  auto& layout = detail::layout_of(types);
+  CHECK(layout.valid);
+  auto& i8 = *detail::global_meta_object(type_id_v<int8_t>);
+  auto& str = *detail::global_meta_object(type_id_v<std::string>);
+  auto& i64 = *detail::global_meta_object(type_id_v<int64_t>);
+  CHECK_EQ(layout.storage_size, i8.padded_size + str.padded_size
+                                  + i64.padded_size);
+  if (CHECK_EQ(layout.offsets.size(), 3u)) {
+    CHECK_EQ(layout.offsets[0], 0u);
+    CHECK_EQ(layout.offsets[1], i8.padded_size);
+    CHECK_EQ(layout.offsets[2], i8.padded_size + str.padded_size);
+  }
+}
+
+CAF_TEST(layouts are computed once per type list) {
+  auto types = make_type_id_list<int32_t, double>();
+  CHECK_EQ(&detail::layout_of(types), &detail::layout_of(types));
+  detail::type_id_list_builder builder;
+  builder.push_back(type_id_v<int32_t>);
+  builder.push_back(type_id_v<double>);
+  auto interned = builder.move_to_list();
+  CHECK_EQ(&detail::layout_of(interned), &detail::layout_of(interned));
+  CHECK_EQ(detail::layout_of(interned).storage_size,
+           detail::layout_of(types).storage_size);
+}
+
+CAF_TEST(layouts flag unknown types) {
+  detail::type_id_list_builder builder;
+  builder.push_back(type_id_v<int32_t>);
+  builder.push_back(invalid_type_id - 1);
+  CHECK(!detail::layout_of(builder.move_to_list()).valid);
+}
+
+CAF_TEST(messages access their elements via the layout) {
+  auto msg = make_message(int8_t{1}, std::string{"two"}, int64_t{3});
+  CHECK_EQ(msg.get_as<int8_t>(0), 1);
+  CHECK_EQ(msg.get_as<std::string>(1), "two");
+  CHECK_EQ(msg.get_as<int64_t>(2), 3);
+}
+
+CAF_TEST(make_message computes layouts from the static types) {
+  auto msg = make_message(int8_t{1}, std::string{"two"}, int64_t{3});
+  auto& layout = msg.cptr()->layout();
+  auto& static_layout
+    = detail::static_layout_of<int8_t, std::string, int64_t>();
+  CHECK_EQ(&layout, &static_layout);
+  auto& expected = detail::layout_of(msg.types());
+  CHECK_NE(&layout, &expected);
+  CHECK_EQ(layout.storage_size, expected.storage_size);
+  CHECK_EQ(layout.offsets, expected.offsets);
+  CAF_MESSAGE("copies keep the layout of the original");
+  auto copy = msg;
+  copy.force_unshare();
+  CHECK_EQ(&copy.cptr()->layout(), &layout);
+  CHECK_EQ(copy.get_as<std::string>(1), "two");
+}
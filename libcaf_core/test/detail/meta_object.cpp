@@ -14,6 +14,7 @@
 #include "caf/binary_deserializer.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/detail/make_meta_object.hpp"
+#include "caf/detail/serialized_size.hpp"
 #include "caf/init_global_meta_objects.hpp"
 
 using namespace std::string_literals;
@@ -64,6 +65,19 @@ CAF_TEST(meta objects allow serialization of objects) {
   CAF_CHECK_EQUAL(i32_wrapper::instances, 1u);
 }
 
+CAF_TEST(save_size computes the same size as save) {
+  auto meta_i32_wrapper = make_meta_object<i32_wrapper>("i32_wrapper");
+  i32_wrapper x;
+  x.value = 42;
+  CAF_MESSAGE("save_size is equivalent to calling save with a size inspector");
+  serialized_size_inspector g1;
+  serialized_size_inspector g2;
+  CAF_CHECK(meta_i32_wrapper.save_size(g1, &x));
+  CAF_CHECK(meta_i32_wrapper.save(g2, &x));
+  CAF_CHECK_EQUAL(g1.result, g2.result);
+  CAF_CHECK_EQUAL(g1.result, sizeof(int32_t));
+}
+
 CAF_TEST(init_global_meta_objects takes care of creating a meta object table) {
   auto xs = global_meta_objects();
   CAF_REQUIRE_EQUAL(xs.size(), caf::id_block::core_test::end);
@@ -0,0 +1,37 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.print
+
+#include "caf/detail/print.hpp"
+
+#include "core-test.hpp"
+
+#include <limits>
+
+using namespace caf;
+
+namespace {
+
+std::string us(int64_t ns) {
+  std::string result;
+  detail::print_us(result, ns);
+  return result;
+}
+
+} // namespace
+
+CAF_TEST(print_us renders nanoseconds as microseconds) {
+  CAF_CHECK_EQUAL(us(0), "0.000");
+  CAF_CHECK_EQUAL(us(7), "0.007");
+  CAF_CHECK_EQUAL(us(1005), "1.005");
+  CAF_CHECK_EQUAL(us(123456789), "123456.789");
+}
+
+CAF_TEST(print_us renders negative values with a single sign) {
+  CAF_CHECK_EQUAL(us(-7), "-0.007");
+  CAF_CHECK_EQUAL(us(-1005), "-1.005");
+  CAF_CHECK_EQUAL(us(std::numeric_limits<int64_t>::min()),
+                  "-9223372036854775.808");
+}
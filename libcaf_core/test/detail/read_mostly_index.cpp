@@ -0,0 +1,81 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.read_mostly_index
+
+#include "caf/detail/read_mostly_index.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+struct entry {
+  int key;
+};
+
+// Maps keys to few hash values to force collisions.
+size_t hash_of(int key) {
+  return static_cast<size_t>(key % 7);
+}
+
+auto has_key(int key) {
+  return [key](const entry& x) { return x.key == key; };
+}
+
+} // namespace
+
+CAF_TEST(the index finds all inserted entries) {
+  std::vector<entry> entries;
+  for (int key = 0; key < 100; ++key)
+    entries.emplace_back(entry{key});
+  detail::read_mostly_index<entry> index;
+  CAF_CHECK_EQUAL(index.find(hash_of(1), has_key(1)), nullptr);
+  for (auto& x : entries)
+    index.insert(hash_of(x.key), &x);
+  CAF_CHECK_EQUAL(index.size(), 100u);
+  for (auto& x : entries)
+    CAF_CHECK_EQUAL(index.find(hash_of(x.key), has_key(x.key)), &x);
+  CAF_CHECK_EQUAL(index.find(hash_of(100), has_key(100)), nullptr);
+  index.clear();
+  CAF_CHECK_EQUAL(index.size(), 0u);
+  CAF_CHECK_EQUAL(index.find(hash_of(1), has_key(1)), nullptr);
+  index.insert(hash_of(1), &entries[1]);
+  CAF_CHECK_EQUAL(index.find(hash_of(1), has_key(1)), &entries[1]);
+}
+
+CAF_TEST(readers may access the index while a writer inserts entries) {
+  static constexpr int num_entries = 1000;
+  std::vector<entry> entries;
+  for (int key = 0; key < num_entries; ++key)
+    entries.emplace_back(entry{key});
+  detail::read_mostly_index<entry> index;
+  std::atomic<int> inserted{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; ++i)
+    readers.emplace_back([&] {
+      for (int n = inserted.load(); n < num_entries; n = inserted.load()) {
+        // All entries up to `n` must be visible.
+        for (int key = 0; key < n; ++key) {
+          auto hash = static_cast<size_t>(key);
+          if (index.find(hash, has_key(key)) != &entries[key])
+            failed = true;
+        }
+      }
+    });
+  for (auto& x : entries) {
+    index.insert(static_cast<size_t>(x.key), &x);
+    ++inserted;
+  }
+  for (auto& t : readers)
+    t.join();
+  CAF_CHECK(!failed);
+}
@@ -0,0 +1,110 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.spsc_byte_queue
+
+#include "caf/detail/spsc_byte_queue.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <string>
+#include <thread>
+
+using namespace caf;
+
+namespace {
+
+struct fixture {
+  detail::spsc_byte_queue queue{64};
+
+  std::vector<char> buf;
+
+  bool push(uint32_t hdr, const std::string& str) {
+    return queue.try_push(&hdr, sizeof(hdr), str.data(), str.size());
+  }
+
+  std::string pop() {
+    if (!queue.try_pop(buf))
+      CAF_FAIL("queue is empty");
+    uint32_t hdr = 0;
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    return std::to_string(hdr) + ':'
+           + std::string{buf.begin() + sizeof(hdr), buf.end()};
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(spsc_byte_queue_tests, fixture)
+
+CAF_TEST(queues round up their capacity to the next power of two) {
+  CAF_CHECK_EQUAL(queue.capacity(), 64u);
+  CAF_CHECK_EQUAL(detail::spsc_byte_queue{1}.capacity(), 64u);
+  CAF_CHECK_EQUAL(detail::spsc_byte_queue{100}.capacity(), 128u);
+}
+
+CAF_TEST(queues return records in the order of insertion) {
+  CAF_CHECK(queue.empty());
+  CAF_CHECK(push(1, "hello"));
+  CAF_CHECK(push(2, ""));
+  CAF_CHECK(push(3, "world"));
+  CAF_CHECK(!queue.empty());
+  CAF_CHECK_EQUAL(pop(), "1:hello");
+  CAF_CHECK_EQUAL(pop(), "2:");
+  CAF_CHECK_EQUAL(pop(), "3:world");
+  CAF_CHECK(queue.empty());
+  CAF_CHECK(!queue.try_pop(buf));
+}
+
+CAF_TEST(queues reject records that exceed the free space) {
+  // Each record occupies 4 + 4 + 24 = 32 bytes.
+  std::string str(24, 'x');
+  CAF_CHECK(push(1, str));
+  CAF_CHECK(push(2, str));
+  CAF_CHECK(!push(3, str));
+  CAF_CHECK(!push(3, "a"));
+  CAF_CHECK_EQUAL(pop(), "1:" + str);
+  CAF_CHECK(push(3, "a"));
+  CAF_CHECK_EQUAL(pop(), "2:" + str);
+  CAF_CHECK_EQUAL(pop(), "3:a");
+}
+
+CAF_TEST(records may wrap around the end of the buffer) {
+  for (uint32_t i = 0; i < 100; ++i) {
+    auto str = std::string(i % 40, static_cast<char>('a' + i % 26));
+    CAF_REQUIRE(push(i, str));
+    CAF_REQUIRE_EQUAL(pop(), std::to_string(i) + ':' + str);
+  }
+  CAF_CHECK(queue.empty());
+}
+
+CAF_TEST(concurrent access) {
+  detail::spsc_byte_queue q{256};
+  constexpr uint32_t n = 10'000;
+  std::thread producer{[&q] {
+    for (uint32_t i = 0; i < n; ++i) {
+      auto str = std::to_string(i);
+      while (!q.try_push(&i, sizeof(i), str.data(), str.size()))
+        std::this_thread::yield();
+    }
+  }};
+  uint32_t received = 0;
+  uint32_t in_order = 0;
+  while (received < n) {
+    if (!q.try_pop(buf)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t hdr = 0;
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    std::string str{buf.begin() + sizeof(hdr), buf.end()};
+    if (hdr == received && str == std::to_string(received))
+      ++in_order;
+    ++received;
+  }
+  producer.join();
+  CAF_CHECK_EQUAL(in_order, n);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,97 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.thread_local_registry
+
+#include "caf/detail/thread_local_registry.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+struct counter {
+  explicit counter(size_t index) : index(index) {
+    // nop
+  }
+
+  size_t index;
+  int value = 0;
+};
+
+auto make_counter = [](size_t index) {
+  return std::make_shared<counter>(index);
+};
+
+size_t sum_of(const detail::thread_local_registry<counter>& registry) {
+  return registry.with_entries([](auto& xs) {
+    size_t result = 0;
+    for (auto& x : xs)
+      result += static_cast<size_t>(x->value);
+    return result;
+  });
+}
+
+} // namespace
+
+CAF_TEST(each thread receives its own object) {
+  detail::thread_local_registry<counter> registry;
+  auto& x = registry.local(make_counter);
+  CAF_CHECK_EQUAL(x.index, 0u);
+  CAF_CHECK_EQUAL(&registry.local(make_counter), &x);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&registry] {
+      for (int j = 0; j < 100; ++j)
+        ++registry.local(make_counter).value;
+    });
+  for (auto& t : threads)
+    t.join();
+  x.value = 1;
+  CAF_CHECK_EQUAL(registry.with_entries([](auto& xs) { return xs.size(); }),
+                  5u);
+  CAF_CHECK_EQUAL(sum_of(registry), 401u);
+}
+
+CAF_TEST(threads register once for each registry) {
+  detail::thread_local_registry<counter> r1;
+  detail::thread_local_registry<counter> r2;
+  ++r1.local(make_counter).value;
+  ++r2.local(make_counter).value;
+  ++r1.local(make_counter).value;
+  CAF_CHECK_EQUAL(sum_of(r1), 2u);
+  CAF_CHECK_EQUAL(sum_of(r2), 1u);
+  CAF_CHECK_EQUAL(r1.with_entries([](auto& xs) { return xs.size(); }), 1u);
+}
+
+CAF_TEST(threads keep one object per registry when alternating) {
+  detail::thread_local_registry<counter> r1;
+  detail::thread_local_registry<counter> r2;
+  for (int i = 0; i < 1000; ++i) {
+    ++r1.local(make_counter).value;
+    ++r2.local(make_counter).value;
+  }
+  CAF_CHECK_EQUAL(r1.with_entries([](auto& xs) { return xs.size(); }), 1u);
+  CAF_CHECK_EQUAL(r2.with_entries([](auto& xs) { return xs.size(); }), 1u);
+  CAF_CHECK_EQUAL(sum_of(r1), 1000u);
+  CAF_CHECK_EQUAL(sum_of(r2), 1000u);
+}
+
+CAF_TEST(threads release objects of destroyed registries) {
+  std::weak_ptr<counter> obj;
+  {
+    detail::thread_local_registry<counter> r1;
+    r1.local(make_counter);
+    obj = r1.with_entries([](auto& xs) { return xs.front(); });
+  }
+  CAF_MESSAGE("the thread keeps its object until accessing a new registry");
+  CAF_CHECK(!obj.expired());
+  detail::thread_local_registry<counter> r2;
+  r2.local(make_counter);
+  CAF_CHECK(obj.expired());
+}
@@ -0,0 +1,239 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE fixed_size_codec
+
+#include "caf/fixed_size_codec.hpp"
+
+#include "core-test.hpp"
+#include "inspector-tests.hpp"
+
+#include <array>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/default_enum_inspect.hpp"
+#include "caf/detail/make_meta_object.hpp"
+
+using namespace caf;
+
+namespace {
+
+enum class color : uint8_t { red, green, blue };
+
+std::string to_string(color x) {
+  switch (x) {
+    case color::red:
+      return "red";
+    case color::green:
+      return "green";
+    default:
+      return "blue";
+  }
+}
+
+bool from_string(string_view str, color& x) {
+  for (auto val : {color::red, color::green, color::blue}) {
+    if (str == to_string(val)) {
+      x = val;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool from_integer(uint8_t val, color& x) {
+  if (val > static_cast<uint8_t>(color::blue))
+    return false;
+  x = static_cast<color>(val);
+  return true;
+}
+
+template <class Inspector>
+bool inspect(Inspector& f, color& x) {
+  return default_enum_inspect(f, x);
+}
+
+struct sample {
+  bool flag;
+  color tint;
+  uint16_t port;
+  int64_t stamp;
+  float ratio;
+  double value;
+  std::array<int32_t, 3> ids;
+  line segment;
+};
+
+[[maybe_unused]] bool operator==(const sample& x, const sample& y) {
+  return std::tie(x.flag, x.tint, x.port, x.stamp, x.ratio, x.value, x.ids,
+                  x.segment)
+         == std::tie(y.flag, y.tint, y.port, y.stamp, y.ratio, y.value, y.ids,
+                     y.segment);
+}
+
+template <class Inspector>
+bool inspect(Inspector& f, sample& x) {
+  return f.object(x).fields(f.field("flag", x.flag), f.field("tint", x.tint),
+                            f.field("port", x.port), f.field("stamp", x.stamp),
+                            f.field("ratio", x.ratio),
+                            f.field("value", x.value), f.field("ids", x.ids),
+                            f.field("segment", x.segment));
+}
+
+// Writes a second field only for some values. Hence, the schema derived from
+// the default value does not fit all values.
+struct irregular {
+  int32_t id;
+  int32_t extra;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, irregular& x) {
+  if constexpr (Inspector::is_loading) {
+    return f.object(x).fields(f.field("id", x.id));
+  } else {
+    if (x.extra == 0)
+      return f.object(x).fields(f.field("id", x.id));
+    return f.object(x).fields(f.field("id", x.id), f.field("extra", x.extra));
+  }
+}
+
+// Counts how often the binary serializer inspects a `counted` object. The
+// codec uses its own inspectors instead.
+size_t binary_serializer_calls = 0;
+
+struct counted {
+  int32_t id;
+  double value;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, counted& x) {
+  if constexpr (std::is_same_v<Inspector, binary_serializer>)
+    ++binary_serializer_calls;
+  return f.object(x).fields(f.field("id", x.id), f.field("value", x.value));
+}
+
+sample make_sample() {
+  return sample{true,
+                color::blue,
+                8080,
+                -1234567890123,
+                0.5f,
+                -2.75,
+                {{1, -2, 3}},
+                line{{1, 2, 3}, {-4, -5, -6}}};
+}
+
+struct fixture {
+  template <class T>
+  byte_buffer generic_save(const T& x, bool compact = false) {
+    byte_buffer result;
+    binary_serializer sink{nullptr, result};
+    sink.compact_integers(compact);
+    if (!sink.apply(x))
+      CAF_FAIL("binary_serializer failed to save: " << sink.get_error());
+    return result;
+  }
+
+  template <class T>
+  byte_buffer codec_save(const T& x, bool compact = false) {
+    byte_buffer result;
+    binary_serializer sink{nullptr, result};
+    sink.compact_integers(compact);
+    if (!fixed_size_codec<T>::save(sink, x))
+      CAF_FAIL("fixed_size_codec failed to save: " << sink.get_error());
+    return result;
+  }
+};
+
+} // namespace
+
+CAF_USE_FIXED_SIZE_CODEC(counted)
+
+CAF_TEST_FIXTURE_SCOPE(fixed_size_codec_tests, fixture)
+
+CAF_TEST(the codec applies to types with a fixed binary size) {
+  CHECK(fixed_size_codec<point_3d>::enabled());
+  CHECK(fixed_size_codec<line>::enabled());
+  CHECK(fixed_size_codec<sample>::enabled());
+  CHECK(!fixed_size_codec<person>::enabled());
+  CHECK(!fixed_size_codec<dummy_message>::enabled());
+  CHECK(!fixed_size_codec<basics>::enabled());
+}
+
+CAF_TEST(the codec produces the same output as the binary serializer) {
+  auto x = make_sample();
+  CHECK_EQ(codec_save(x), generic_save(x));
+  CHECK_EQ(codec_save(x).size(), fixed_size_codec<sample>::schema().size());
+  CHECK_EQ(codec_save(x, true), generic_save(x, true));
+  auto y = person{"Bob", std::string{"555-1234"}};
+  CHECK_EQ(codec_save(y), generic_save(y));
+}
+
+CAF_TEST(the codec writes at the current position of the serializer) {
+  auto x = line{{1, 2, 3}, {4, 5, 6}};
+  auto expected = generic_save(int8_t{7});
+  auto tmp = generic_save(x);
+  expected.insert(expected.end(), tmp.begin(), tmp.end());
+  byte_buffer buf;
+  binary_serializer sink{nullptr, buf};
+  CHECK(sink.apply(int8_t{7}));
+  CHECK(fixed_size_codec<line>::save(sink, x));
+  CHECK_EQ(buf, expected);
+  CHECK_EQ(sink.write_pos(), buf.size());
+}
+
+CAF_TEST(the codec reads the output of the binary serializer) {
+  auto x = make_sample();
+  auto buf = generic_save(x);
+  buf.push_back(byte{42});
+  binary_deserializer source{nullptr, buf};
+  sample y;
+  CHECK(fixed_size_codec<sample>::load(source, y));
+  CHECK_EQ(x, y);
+  CHECK_EQ(source.remaining(), 1u);
+}
+
+CAF_TEST(the codec reports truncated input like the binary deserializer) {
+  auto buf = generic_save(make_sample());
+  buf.pop_back();
+  binary_deserializer source{nullptr, buf};
+  sample y;
+  CHECK(!fixed_size_codec<sample>::load(source, y));
+  CHECK_EQ(source.get_error(), sec::end_of_stream);
+}
+
+CAF_TEST(the codec falls back to the generic path for mismatching values) {
+  CHECK(fixed_size_codec<irregular>::enabled());
+  CHECK_EQ(fixed_size_codec<irregular>::schema().size(), 4u);
+  MESSAGE("values that match the schema take the fast path");
+  auto x = irregular{1, 0};
+  CHECK_EQ(codec_save(x), generic_save(x));
+  MESSAGE("values that exceed the schema take the generic path");
+  auto y = irregular{1, 2};
+  CHECK_EQ(codec_save(y), generic_save(y));
+  CHECK_EQ(codec_save(y).size(), 8u);
+}
+
+CAF_TEST(meta objects use the codec for types that opt in) {
+  CHECK(use_fixed_size_codec_v<counted>);
+  CHECK(!use_fixed_size_codec_v<sample>);
+  auto meta = detail::make_meta_object<counted>("counted");
+  auto x = counted{42, 2.5};
+  auto expected = generic_save(x);
+  binary_serializer_calls = 0;
+  byte_buffer buf;
+  binary_serializer sink{nullptr, buf};
+  CHECK(meta.save_binary(sink, &x));
+  CHECK_EQ(buf, expected);
+  CHECK_EQ(binary_serializer_calls, 0u);
+  auto y = counted{0, 0.};
+  binary_deserializer source{nullptr, buf};
+  CHECK(meta.load_binary(source, &y));
+  CHECK_EQ(y.id, 42);
+  CHECK_EQ(y.value, 2.5);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
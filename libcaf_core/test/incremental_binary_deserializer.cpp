@@ -0,0 +1,181 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE incremental_binary_deserializer
+
+#include "caf/incremental_binary_deserializer.hpp"
+
+#include "core-test.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "caf/binary_serializer.hpp"
+#include "caf/message.hpp"
+#include "caf/shared_byte_span.hpp"
+#include "caf/shared_string_view.hpp"
+
+using namespace caf;
+
+using load_result = incremental_binary_deserializer::load_result;
+
+namespace {
+
+struct fixture {
+  template <class... Ts>
+  byte_buffer serialize(const Ts&... xs) {
+    byte_buffer buf;
+    binary_serializer sink{nullptr, buf};
+    if (!(sink.apply(xs) && ...))
+      CAF_FAIL("failed to serialize: " << sink.get_error());
+    return buf;
+  }
+
+  // Feeds `bytes` to `source` in chunks of `chunk_size` bytes and calls `fn`
+  // after each chunk until it returns something other than `incomplete`.
+  template <class F>
+  load_result feed(incremental_binary_deserializer& source,
+                   const byte_buffer& bytes, size_t chunk_size, F fn) {
+    auto res = load_result::incomplete;
+    auto first = bytes.begin();
+    while (first != bytes.end() && res == load_result::incomplete) {
+      auto n = std::min(chunk_size,
+                        static_cast<size_t>(std::distance(first, bytes.end())));
+      source.append(make_span(&*first, n));
+      first += n;
+      if (first == bytes.end())
+        source.close();
+      res = fn();
+    }
+    return res;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(incremental_binary_deserializer_tests, fixture)
+
+CAF_TEST(the deserializer loads objects as soon as their bytes arrive) {
+  auto bytes = serialize(int32_t{42}, std::string{"hello world"});
+  incremental_binary_deserializer source{nullptr};
+  int32_t x = 0;
+  std::string y;
+  source.append(make_span(bytes.data(), 3));
+  CHECK(source.load(x) == load_result::incomplete);
+  source.append(make_span(bytes.data() + 3, 3));
+  CHECK(source.load(x) == load_result::done);
+  CHECK_EQ(x, 42);
+  CHECK_EQ(source.consumed(), 4u);
+  CHECK_EQ(source.buffered(), 2u);
+  CHECK(source.load(y) == load_result::incomplete);
+  source.append(make_span(bytes.data() + 6, bytes.size() - 6));
+  CHECK(source.load(y) == load_result::done);
+  CHECK_EQ(y, "hello world");
+  CHECK_EQ(source.buffered(), 0u);
+  CHECK_EQ(source.consumed(), bytes.size());
+}
+
+CAF_TEST(the deserializer loads messages one element at a time) {
+  auto msg = make_message(std::string(1024, 'a'), int32_t{42},
+                          std::vector<int32_t>(512, 7), std::string(2048, 'b'));
+  auto bytes = serialize(msg);
+  for (size_t chunk_size : {1u, 7u, 100u, 4096u}) {
+    MESSAGE("chunk size: " << chunk_size);
+    incremental_binary_deserializer source{nullptr};
+    message copy;
+    auto res = feed(source, bytes, chunk_size,
+                    [&] { return source.load(copy); });
+    CHECK(res == load_result::done);
+    CHECK_EQ(source.buffered(), 0u);
+    CHECK_EQ(copy.types(), msg.types());
+    CHECK_EQ(to_string(copy), to_string(msg));
+  }
+}
+
+CAF_TEST(the deserializer loads values of messages with known types) {
+  auto msg = make_message(int32_t{1}, std::string(300, 'x'), int32_t{3});
+  byte_buffer bytes;
+  {
+    binary_serializer sink{nullptr, bytes};
+    CHECK(msg.save_values(sink));
+  }
+  incremental_binary_deserializer source{nullptr};
+  message copy;
+  auto res = feed(source, bytes, 16,
+                  [&] { return source.load_values(copy, msg.types()); });
+  CHECK(res == load_result::done);
+  CHECK_EQ(to_string(copy), to_string(msg));
+}
+
+CAF_TEST(the deserializer only buffers one element of a message) {
+  auto msg = make_message(std::string(1000, 'a'), std::string(1000, 'b'),
+                          std::string(1000, 'c'));
+  auto bytes = serialize(msg);
+  incremental_binary_deserializer source{nullptr, 1100};
+  message copy;
+  size_t max_buffered = 0;
+  auto res = feed(source, bytes, 64, [&] {
+    max_buffered = std::max(max_buffered, source.buffered());
+    return source.load(copy);
+  });
+  CHECK(res == load_result::done);
+  // The buffer may exceed the limit by less than one chunk.
+  CHECK_LT(max_buffered, 1100u + 64u);
+  CHECK_LT(max_buffered, bytes.size() / 2);
+  CHECK_EQ(to_string(copy), to_string(msg));
+}
+
+CAF_TEST(the deserializer streams strings and byte buffers) {
+  auto msg = make_message(std::string(10000, 'a'), byte_buffer(5000, byte{1}),
+                          shared_byte_span{byte_buffer(3000, byte{2})},
+                          shared_string_view{std::string(2000, 'b')},
+                          std::string{});
+  auto bytes = serialize(msg);
+  for (size_t chunk_size : {1u, 7u, 1000u}) {
+    MESSAGE("chunk size: " << chunk_size);
+    incremental_binary_deserializer source{nullptr, 64};
+    message copy;
+    size_t max_buffered = 0;
+    auto res = feed(source, bytes, chunk_size, [&] {
+      max_buffered = std::max(max_buffered, source.buffered());
+      return source.load(copy);
+    });
+    CHECK(res == load_result::done);
+    CHECK_LE(max_buffered, 64u + chunk_size);
+    CHECK_EQ(copy.types(), msg.types());
+    CHECK_EQ(to_string(copy), to_string(msg));
+  }
+}
+
+CAF_TEST(the deserializer rejects truncated strings after closing the input) {
+  auto bytes = serialize(make_message(std::string(1000, 'a')));
+  bytes.resize(bytes.size() - 1);
+  incremental_binary_deserializer source{nullptr};
+  message copy;
+  auto res = feed(source, bytes, 64, [&] { return source.load(copy); });
+  CHECK(res == load_result::failed);
+  CHECK_EQ(source.get_error(), sec::end_of_stream);
+}
+
+CAF_TEST(the deserializer rejects objects that exceed its buffer size) {
+  auto bytes = serialize(make_message(std::vector<int32_t>(1000, 1)));
+  incremental_binary_deserializer source{nullptr, 512};
+  message copy;
+  auto res = feed(source, bytes, 64, [&] { return source.load(copy); });
+  CHECK(res == load_result::failed);
+  CHECK_EQ(source.get_error(), sec::runtime_error);
+}
+
+CAF_TEST(the deserializer fails on truncated input after closing it) {
+  auto bytes = serialize(std::string{"hello world"});
+  bytes.resize(bytes.size() - 1);
+  incremental_binary_deserializer source{nullptr};
+  std::string x;
+  auto res = feed(source, bytes, 4, [&] { return source.load(x); });
+  CHECK(res == load_result::failed);
+  CHECK_EQ(source.get_error(), sec::end_of_stream);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
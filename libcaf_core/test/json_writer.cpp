@@ -8,6 +8,10 @@
 
 #include "core-test.hpp"
 
+#include <limits>
+
+#include "caf/detail/print.hpp"
+
 using namespace caf;
 
 using namespace std::literals::string_literals;
@@ -296,4 +300,70 @@ SCENARIO("the JSON writer annotates variant fields") {
   }
 }
 
+SCENARIO("the JSON writer escapes strings of any length") {
+  GIVEN("strings with special characters at arbitrary positions") {
+    auto make_str = [](size_t size, size_t pos, char c) {
+      auto str = std::string(size, 'x');
+      if (pos < size)
+        str[pos] = c;
+      return str;
+    };
+    WHEN("converting them to JSON") {
+      THEN("the JSON writer produces the same output as print_escaped") {
+        for (auto c : {'"', '\\', '\n', '\t', '\x01', 'y'}) {
+          for (size_t size : {0u, 1u, 7u, 8u, 15u, 16u, 17u, 33u, 100u}) {
+            for (size_t pos = 0; pos < size; ++pos) {
+              auto str = make_str(size, pos, c);
+              std::string out;
+              detail::print_escaped(out, str);
+              CHECK_EQ(to_json_string(str, 0), out);
+            }
+          }
+        }
+      }
+    }
+  }
+  GIVEN("a string with multiple special characters") {
+    auto str = "line 1\nline 2 \"quoted\"\tand\\a backslash\r\n"s;
+    WHEN("converting it to JSON") {
+      THEN("the JSON output escapes all special characters") {
+        auto out = R"_("line 1\nline 2 \"quoted\"\tand\\a backslash\r\n")_"s;
+        CHECK_EQ(to_json_string(str, 0), out);
+      }
+    }
+  }
+}
+
+SCENARIO("the JSON writer prints numbers") {
+  GIVEN("integers at the limits of their types") {
+    WHEN("converting them to JSON") {
+      THEN("the JSON output contains all digits") {
+        using i64_limits = std::numeric_limits<int64_t>;
+        using u64_limits = std::numeric_limits<uint64_t>;
+        CHECK_EQ(to_json_string(int8_t{-128}, 0), "-128"s);
+        CHECK_EQ(to_json_string(int32_t{-7}, 0), "-7"s);
+        CHECK_EQ(to_json_string(uint16_t{100}, 0), "100"s);
+        CHECK_EQ(to_json_string(i64_limits::min(), 0),
+                 "-9223372036854775808"s);
+        CHECK_EQ(to_json_string(i64_limits::max(), 0),
+                 "9223372036854775807"s);
+        CHECK_EQ(to_json_string(u64_limits::max(), 0),
+                 "18446744073709551615"s);
+      }
+    }
+  }
+  GIVEN("floating point numbers") {
+    WHEN("converting them to JSON") {
+      THEN("the JSON output drops trailing zeros") {
+        CHECK_EQ(to_json_string(3.5, 0), "3.5"s);
+        CHECK_EQ(to_json_string(-2.0, 0), "-2"s);
+        CHECK_EQ(to_json_string(1e20, 0), "100000000000000000000"s);
+        auto huge = std::to_string(1e100);
+        huge.erase(huge.find('.'));
+        CHECK_EQ(to_json_string(1e100, 0), huge);
+      }
+    }
+  }
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
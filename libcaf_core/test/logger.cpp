@@ -8,10 +8,14 @@
 
 #include "core-test.hpp"
 
+#include <cstdio>
 #include <ctime>
+#include <fstream>
+#include <sstream>
 #include <string>
 
 #include "caf/all.hpp"
+#include "caf/detail/binary_log.hpp"
 
 using namespace caf;
 using namespace std::chrono;
@@ -199,4 +203,74 @@ CAF_TEST(render_fun_prefix) {
   foo::tpl<T>::run();
 }
 
+CAF_TEST(binary logs preserve all rendered fields of an event) {
+  auto t0 = make_timestamp();
+  auto e1 = CAF_LOG_MAKE_EVENT(0, "unit_test", CAF_LOG_LEVEL_WARNING,
+                               "hello" << 42);
+  logger::event e2{
+    CAF_LOG_LEVEL_DEBUG,
+    23,
+    "unit_test",
+    "void ns::foo::bar()",
+    "bar",
+    "foo.cpp",
+    "",
+    std::this_thread::get_id(),
+    7,
+    t0 + 5ms,
+  };
+  std::stringstream buf;
+  {
+    detail::binary_log_writer writer{buf, t0};
+    writer.write(e1);
+    writer.write(e2);
+    writer.write(e1);
+  }
+  auto lf = logger::parse_format("%r %c %p %a %t %C %M %F:%L %m%n");
+  std::ostringstream expected;
+  for (auto* x : {&e1, &e2, &e1})
+    logger::render_event(expected, lf, *x, t0);
+  std::ostringstream decoded;
+  CAF_CHECK(detail::render_binary_log(buf, decoded, lf));
+  CAF_CHECK_EQUAL(decoded.str(), expected.str());
+  CAF_MESSAGE("the decoder rejects malformed input");
+  std::istringstream garbage{"CAFLOX"};
+  CAF_CHECK(!detail::render_binary_log(garbage, decoded, lf));
+  auto truncated_str = buf.str();
+  truncated_str.pop_back();
+  std::istringstream truncated{truncated_str};
+  CAF_CHECK(!detail::render_binary_log(truncated, decoded, lf));
+}
+
+CAF_TEST(per-thread buffers collect events from all threads) {
+  const char* file_name = "logger-test-per-thread-buffers.log";
+  cfg.set("caf.logger.per-thread-buffers", true);
+  cfg.set("caf.logger.file.binary", true);
+  cfg.set("caf.logger.file.path", file_name);
+  {
+    actor_system sys{cfg};
+    auto producer = [&sys] {
+      for (int i = 0; i < 100; ++i)
+        sys.logger().log(
+          CAF_LOG_MAKE_EVENT(0, "unit_test", CAF_LOG_LEVEL_DEBUG, "event"));
+    };
+    std::thread t1{producer};
+    std::thread t2{producer};
+    t1.join();
+    t2.join();
+  }
+  std::ifstream in{file_name, std::ios::binary};
+  detail::binary_log_reader reader{in};
+  CAF_REQUIRE(reader.valid());
+  size_t num_events = 0;
+  logger::event x;
+  while (reader.next(x))
+    if (x.message == "event")
+      ++num_events;
+  CAF_CHECK(reader.valid());
+  CAF_CHECK_EQUAL(num_events, 200u);
+  in.close();
+  std::remove(file_name);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
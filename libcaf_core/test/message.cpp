@@ -13,6 +13,9 @@
 #include <string>
 #include <vector>
 
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/detail/serialized_size.hpp"
 #include "caf/init_global_meta_objects.hpp"
 #include "caf/message_handler.hpp"
 #include "caf/type_id.hpp"
@@ -133,3 +136,53 @@ CAF_TEST(messages are concatenable) {
   CHECK(message::concat(make_tuple(int16_t{1}), make_message(uint8_t{2}))
           .matches(int16_t{1}, uint8_t{2}));
 }
+
+CAF_TEST(pre-sizing messages reserves memory once without changing the output) {
+  auto msg = make_message(std::string(4096, 'a'), int32_t{42},
+                          make_message(std::string(1024, 'b')),
+                          std::vector<std::string>(16, std::string(64, 'c')));
+  byte_buffer plain;
+  {
+    binary_serializer sink{nullptr, plain};
+    CHECK(sink.apply(msg));
+  }
+  CHECK_EQ(plain.size(), detail::serialized_size(msg));
+  byte_buffer presized;
+  binary_serializer sink{nullptr, presized};
+  sink.presize(true);
+  CHECK(sink.apply(msg));
+  CHECK(sink.presize());
+  CHECK_EQ(presized, plain);
+  CHECK_GE(presized.capacity(), presized.size());
+}
+
+CAF_TEST(messages can omit their type information for known type lists) {
+  auto msg = make_message(int32_t{42}, "hello"s, std::vector<int32_t>{1, 2});
+  byte_buffer full;
+  byte_buffer values;
+  {
+    binary_serializer sink{nullptr, full};
+    CHECK(sink.apply(msg));
+  }
+  {
+    binary_serializer sink{nullptr, values};
+    CHECK(msg.save_values(sink));
+  }
+  CHECK_LT(values.size(), full.size());
+  message copy;
+  binary_deserializer source{nullptr, values};
+  CHECK(copy.load_values(source, msg.types()));
+  CHECK_EQ(source.remaining(), 0u);
+  CHECK_EQ(copy.types(), msg.types());
+  CHECK_EQ(to_string(copy), to_string(msg));
+  MESSAGE("empty type lists produce empty messages");
+  byte_buffer empty;
+  {
+    binary_serializer sink{nullptr, empty};
+    CHECK(message{}.save_values(sink));
+  }
+  CHECK(empty.empty());
+  binary_deserializer empty_source{nullptr, empty};
+  CHECK(copy.load_values(empty_source, make_type_id_list()));
+  CHECK(copy.empty());
+}
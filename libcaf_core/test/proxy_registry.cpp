@@ -0,0 +1,94 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE proxy_registry
+
+#include "caf/proxy_registry.hpp"
+
+#include "core-test.hpp"
+
+#include "caf/forwarding_actor_proxy.hpp"
+
+using namespace caf;
+
+namespace {
+
+behavior dummy() {
+  return {[](int i) { return i; }};
+}
+
+struct dummy_backend : proxy_registry::backend {
+  dummy_backend(actor_system& sys, actor dest) : sys(sys), dest(dest) {
+    // nop
+  }
+
+  strong_actor_ptr make_proxy(node_id nid, actor_id aid) override {
+    ++created;
+    actor_config cfg;
+    return make_actor<forwarding_actor_proxy, strong_actor_ptr>(aid, nid, &sys,
+                                                                cfg, dest);
+  }
+
+  void set_last_hop(node_id*) override {
+    // nop
+  }
+
+  actor_system& sys;
+  actor dest;
+  size_t created = 0;
+};
+
+struct fixture : test_coordinator_fixture<> {
+  fixture() : be(sys, sys.spawn(dummy)), registry(sys, be) {
+    nid = unbox(make_node_id(42, "0102030405060708090A0B0C0D0E0F1011121314"));
+  }
+
+  ~fixture() {
+    proxy_registry::set_local_cache(nullptr);
+    registry.clear();
+    anon_send_exit(be.dest, exit_reason::user_shutdown);
+    run();
+  }
+
+  dummy_backend be;
+  proxy_registry registry;
+  node_id nid;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(proxy_registry_tests, fixture)
+
+CAF_TEST(get_or_put creates proxies only once) {
+  auto p1 = registry.get_or_put(nid, 1);
+  auto p2 = registry.get_or_put(nid, 1);
+  auto p3 = registry.get_or_put(nid, 2);
+  CAF_CHECK_EQUAL(be.created, 2u);
+  CAF_CHECK_EQUAL(p1, p2);
+  CAF_CHECK_NOT_EQUAL(p1, p3);
+  CAF_CHECK_EQUAL(registry.count_proxies(nid), 2u);
+  CAF_CHECK_EQUAL(registry.get(nid, 1), p1);
+}
+
+CAF_TEST(erasing proxies invalidates local caches) {
+  proxy_registry::local_cache cache;
+  proxy_registry::set_local_cache(&cache);
+  auto p1 = registry.get_or_put(nid, 1);
+  CAF_CHECK_EQUAL(registry.get_or_put(nid, 1), p1);
+  CAF_CHECK_EQUAL(cache.get(registry, nid, 1), p1);
+  CAF_MESSAGE("the cache must not return erased proxies");
+  auto epoch = registry.epoch();
+  registry.erase(nid, 1);
+  CAF_CHECK_NOT_EQUAL(registry.epoch(), epoch);
+  CAF_CHECK_EQUAL(cache.get(registry, nid, 1), nullptr);
+  auto p2 = registry.get_or_put(nid, 1);
+  CAF_CHECK_NOT_EQUAL(p1, p2);
+  CAF_CHECK_EQUAL(be.created, 2u);
+  CAF_CHECK_EQUAL(registry.get_or_put(nid, 1), p2);
+  CAF_CHECK_EQUAL(cache.get(registry, nid, 1), p2);
+  registry.clear();
+  CAF_CHECK_EQUAL(cache.get(registry, nid, 1), nullptr);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
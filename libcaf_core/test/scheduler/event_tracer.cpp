@@ -0,0 +1,139 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE scheduler.event_tracer
+
+#include "caf/scheduler/event_tracer.hpp"
+
+#include "core-test.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+#include "caf/scoped_actor.hpp"
+
+using namespace caf;
+
+using scheduler::event_tracer;
+
+using event_type = event_tracer::event_type;
+
+namespace {
+
+bool contains(const std::string& str, string_view what) {
+  return str.find(what.data(), 0, what.size()) != std::string::npos;
+}
+
+} // namespace
+
+CAF_TEST(tracers keep the most recent entries of each thread) {
+  event_tracer tracer{3};
+  for (uint64_t id = 0; id < 5; ++id)
+    tracer.record(event_type::mailbox_enqueue, id, 0);
+  std::thread worker{[&tracer] {
+    tracer.set_thread_name("worker");
+    tracer.record(event_type::steal, 10, 1);
+  }};
+  worker.join();
+  auto entries = tracer.entries();
+  CAF_REQUIRE_EQUAL(entries.size(), 4u);
+  CAF_CHECK_EQUAL(entries[0].first, "thread 0");
+  CAF_CHECK_EQUAL(entries[0].second.id, 2u);
+  CAF_CHECK_EQUAL(entries[1].second.id, 3u);
+  CAF_CHECK_EQUAL(entries[2].second.id, 4u);
+  CAF_CHECK_EQUAL(entries[3].first, "worker");
+  CAF_CHECK_EQUAL(entries[3].second.id, 10u);
+  CAF_CHECK(entries[3].second.type == event_type::steal);
+  for (size_t i = 1; i < entries.size(); ++i)
+    CAF_CHECK_LESS_OR_EQUAL(entries[i - 1].second.time,
+                            entries[i].second.time);
+}
+
+CAF_TEST(tracers only export complete entries while threads record) {
+  event_tracer tracer{16};
+  std::atomic<bool> done{false};
+  std::thread worker{[&tracer, &done] {
+    for (uint64_t id = 0; id < 100000; ++id)
+      tracer.record(event_type::mailbox_dequeue, id, id * 2);
+    done = true;
+  }};
+  size_t exported = 0;
+  while (!done) {
+    for (auto& [name, x] : tracer.entries()) {
+      CAF_CHECK_EQUAL(x.arg, x.id * 2);
+      ++exported;
+    }
+  }
+  worker.join();
+  auto entries = tracer.entries();
+  CAF_REQUIRE_EQUAL(entries.size(), 16u);
+  CAF_CHECK_EQUAL(entries.back().second.id, 99999u);
+  CAF_MESSAGE("exported " << exported << " entries while recording");
+}
+
+CAF_TEST(tracers render Chrome trace events with scheduling latencies) {
+  event_tracer tracer{64};
+  tracer.set_thread_name("caf.worker.0");
+  tracer.record(event_type::mailbox_enqueue, 42, 1);
+  tracer.record(event_type::resume_begin, 42, 0);
+  tracer.record(event_type::mailbox_dequeue, 42, 7);
+  tracer.record(event_type::resume_end, 42, resumable::awaiting_message);
+  tracer.record(event_type::steal, 43, 1);
+  tracer.record(event_type::io_begin, 5, 0);
+  tracer.record(event_type::io_end, 5, 0);
+  std::ostringstream out;
+  tracer.write_chrome_trace(out);
+  auto str = out.str();
+  CAF_CHECK(starts_with(str, R"({"displayTimeUnit":"ns","traceEvents":[)"));
+  CAF_CHECK(contains(str, R"("args":{"name":"caf.worker.0"})"));
+  CAF_CHECK(contains(str, R"({"name":"actor 42","cat":"scheduler","ph":"B")"));
+  CAF_CHECK(contains(str, R"("args":{"result":"awaiting_message"})"));
+  CAF_CHECK(contains(str, R"("args":{"actor_id":42,"scheduled":true})"));
+  CAF_CHECK(contains(str, R"("args":{"actor_id":42,"message_id":7})"));
+  CAF_CHECK(contains(str, R"("args":{"actor_id":43,"victim":1})"));
+  CAF_CHECK(contains(str, R"({"name":"read","cat":"io","ph":"B")"));
+  CAF_CHECK(contains(str, R"({"name":"schedule","cat":"latency","ph":"s")"));
+  CAF_CHECK(contains(str, R"({"name":"schedule","cat":"latency","ph":"f")"));
+  CAF_CHECK(contains(str, "]}\n"));
+}
+
+CAF_TEST(actor systems write a trace file if configured) {
+  const char* file_name = "event-tracer-test.json";
+  actor_system_config cfg;
+  cfg.set("caf.scheduler.max-threads", size_t{2});
+  cfg.set("caf.scheduler.trace-file", file_name);
+  {
+    actor_system sys{cfg};
+    CAF_REQUIRE(sys.scheduler().tracer() != nullptr);
+    auto worker = sys.spawn([]() -> behavior {
+      return {
+        [](int32_t x) { return x * 2; },
+      };
+    });
+    scoped_actor self{sys};
+    for (int32_t i = 0; i < 10; ++i)
+      self->request(worker, infinite, i)
+        .receive([&](int32_t y) { CAF_CHECK_EQUAL(y, i * 2); },
+                 [](const error& err) { CAF_FAIL("error: " << err); });
+  }
+  std::ifstream in{file_name};
+  std::string str{std::istreambuf_iterator<char>{in},
+                  std::istreambuf_iterator<char>{}};
+  in.close();
+  std::remove(file_name);
+  CAF_CHECK(starts_with(str, R"({"displayTimeUnit":"ns","traceEvents":[)"));
+  CAF_CHECK(contains(str, R"("args":{"name":"caf.worker.)"));
+  CAF_CHECK(contains(str, R"("cat":"scheduler","ph":"B")"));
+  CAF_CHECK(contains(str, R"("cat":"mailbox")"));
+}
+
+CAF_TEST(actor systems only create tracers if configured) {
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  CAF_CHECK(sys.scheduler().tracer() == nullptr);
+}
@@ -0,0 +1,85 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE scheduler.worker_metrics
+
+#include "caf/scheduler/abstract_coordinator.hpp"
+
+#include "core-test.hpp"
+
+#include <sstream>
+
+#include "caf/scoped_actor.hpp"
+#include "caf/telemetry/collector/prometheus.hpp"
+#include "caf/telemetry/metric_registry.hpp"
+
+using namespace caf;
+
+namespace {
+
+bool contains(const std::string& str, string_view what) {
+  return str.find(what.data(), 0, what.size()) != std::string::npos;
+}
+
+std::string render(const telemetry::metric_registry& reg) {
+  telemetry::collector::prometheus exporter;
+  return to_string(exporter.collect_from(reg));
+}
+
+// Sums up all samples of the metric with given name (excluding labels).
+double sum_of(const std::string& text, const std::string& name) {
+  double result = 0;
+  std::istringstream in{text};
+  std::string line;
+  while (std::getline(in, line))
+    if (starts_with(line, name + "{")) {
+      std::istringstream line_in{line.substr(line.find('}') + 1)};
+      double value = 0;
+      line_in >> value;
+      result += value;
+    }
+  return result;
+}
+
+} // namespace
+
+CAF_TEST(workers collect metrics if configured) {
+  actor_system_config cfg;
+  cfg.set("caf.scheduler.policy", "stealing");
+  cfg.set("caf.scheduler.max-threads", size_t{2});
+  cfg.set("caf.scheduler.enable-metrics", true);
+  actor_system sys{cfg};
+  auto worker = sys.spawn([]() -> behavior {
+    return {
+      [](int32_t x) { return x * 2; },
+    };
+  });
+  scoped_actor self{sys};
+  for (int32_t i = 0; i < 10; ++i)
+    self->request(worker, infinite, i)
+      .receive([&](int32_t y) { CAF_CHECK_EQUAL(y, i * 2); },
+               [](const error& err) { CAF_FAIL("error: " << err); });
+  auto str = render(sys.metrics());
+  CAF_CHECK(contains(str, R"(caf_scheduler_queue_size{worker="0"})"));
+  CAF_CHECK(contains(str, R"(caf_scheduler_queue_size{worker="1"})"));
+  CAF_CHECK(contains(str, "caf_scheduler_steal_attempts_total{"));
+  CAF_CHECK(contains(str, R"(strategy="aggressive")"));
+  CAF_CHECK(contains(str, "caf_scheduler_parks_total{"));
+  CAF_CHECK(contains(str, "caf_scheduler_unparks_total{"));
+  CAF_CHECK(contains(str, "caf_scheduler_resume_duration_seconds_bucket{"));
+  // Actors may process several messages per run, so we cannot predict the
+  // exact number of runs.
+  auto runs = sum_of(str, "caf_scheduler_resume_duration_seconds_count");
+  CAF_CHECK_GREATER(runs, 0.);
+  auto steal_attempts = sum_of(str, "caf_scheduler_steal_attempts_total");
+  CAF_CHECK_GREATER(steal_attempts, 0.);
+}
+
+CAF_TEST(workers collect no metrics by default) {
+  actor_system_config cfg;
+  cfg.set("caf.scheduler.max-threads", size_t{2});
+  actor_system sys{cfg};
+  auto str = render(sys.metrics());
+  CAF_CHECK(!contains(str, "caf_scheduler_"));
+}
@@ -0,0 +1,127 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE schema_inspector
+
+#include "caf/schema_inspector.hpp"
+
+#include "core-test.hpp"
+#include "inspector-tests.hpp"
+
+#include "caf/binary_serializer.hpp"
+#include "caf/byte_buffer.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct sample {
+  bool flag;
+  uint16_t port;
+  double value;
+  std::array<int8_t, 3> bytes;
+  line segment;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, sample& x) {
+  return f.object(x).fields(f.field("flag", x.flag), f.field("port", x.port),
+                            f.field("value", x.value),
+                            f.field("bytes", x.bytes),
+                            f.field("segment", x.segment));
+}
+
+template <class T>
+size_t binary_size(const T& x) {
+  byte_buffer buf;
+  binary_serializer sink{nullptr, buf};
+  if (!sink.apply(x))
+    CAF_FAIL("failed to serialize: " << sink.get_error());
+  return buf.size();
+}
+
+} // namespace
+
+CAF_TEST(schemas of primitive types consist of a single value) {
+  auto xs = make_type_schema<int32_t>();
+  CHECK(xs.fixed_size());
+  CHECK_EQ(xs.size(), 4u);
+  if (CHECK_EQ(xs.fields().size(), 1u)) {
+    auto& fld = xs.fields().front();
+    CHECK_EQ(fld.path, "");
+    CHECK_EQ(fld.type, type_id_v<int32_t>);
+    CHECK_EQ(fld.offset, 0u);
+    CHECK_EQ(fld.size, 4u);
+  }
+  auto ys = make_type_schema<std::string>();
+  CHECK(!ys.fixed_size());
+  CHECK_EQ(ys.size(), type_schema::npos);
+}
+
+CAF_TEST(schemas flatten nested objects) {
+  auto xs = make_type_schema<line>();
+  CHECK_EQ(xs.name(), "line");
+  CHECK(xs.fixed_size());
+  CHECK_EQ(xs.size(), 24u);
+  CHECK_EQ(xs.size(), binary_size(line{{1, 2, 3}, {4, 5, 6}}));
+  if (CHECK_EQ(xs.fields().size(), 6u)) {
+    auto offset = size_t{0};
+    for (auto path : {"p1.x", "p1.y", "p1.z", "p2.x", "p2.y", "p2.z"}) {
+      auto fld = xs.find(path);
+      if (CHECK(fld != nullptr)) {
+        CHECK_EQ(fld->type, type_id_v<int32_t>);
+        CHECK_EQ(fld->offset, offset);
+        CHECK_EQ(fld->size, 4u);
+      }
+      offset += 4;
+    }
+  }
+  CHECK_EQ(to_string(xs),
+           "line { p1.x: int32_t @ 0 [4], p1.y: int32_t @ 4 [4], "
+           "p1.z: int32_t @ 8 [4], p2.x: int32_t @ 12 [4], "
+           "p2.y: int32_t @ 16 [4], p2.z: int32_t @ 20 [4] }");
+}
+
+CAF_TEST(schemas compute offsets in the order of the binary format) {
+  auto xs = make_type_schema<sample>();
+  CHECK(xs.fixed_size());
+  CHECK_EQ(xs.size(), 1u + 2u + 8u + 3u + 24u);
+  CHECK_EQ(xs.size(), binary_size(sample{}));
+  CHECK_EQ(xs.fields().size(), 3u + 3u + 6u);
+  CHECK_EQ(xs.find("flag")->offset, 0u);
+  CHECK_EQ(xs.find("port")->offset, 1u);
+  CHECK_EQ(xs.find("value")->offset, 3u);
+  CHECK_EQ(xs.find("value")->type, type_id_v<double>);
+  CHECK_EQ(xs.find("bytes")->offset, 11u);
+  CHECK_EQ(xs.find("segment.p1.x")->offset, 14u);
+  CHECK_EQ(xs.find("segment.p2.z")->offset, 34u);
+}
+
+CAF_TEST(schemas list values with variable size without their content) {
+  MESSAGE("strings and optional fields have no fixed size");
+  auto xs = make_type_schema<person>();
+  CHECK(!xs.fixed_size());
+  if (CHECK_EQ(xs.fields().size(), 2u)) {
+    CHECK_EQ(xs.fields()[0].path, "name");
+    CHECK_EQ(xs.fields()[0].type, type_id_v<std::string>);
+    CHECK_EQ(xs.fields()[0].offset, 0u);
+    CHECK_EQ(xs.fields()[0].size, 0u);
+    CHECK_EQ(xs.fields()[1].path, "phone");
+    CHECK_EQ(xs.fields()[1].type, invalid_type_id);
+    CHECK_EQ(xs.fields()[1].offset, type_schema::npos);
+  }
+  MESSAGE("variant fields have no fixed size");
+  auto ys = make_type_schema<dummy_message>();
+  CHECK(!ys.fixed_size());
+  if (CHECK_EQ(ys.fields().size(), 1u))
+    CHECK_EQ(ys.fields()[0].path, "content");
+  MESSAGE("sequences and maps have no fixed size");
+  auto zs = make_type_schema<basics>();
+  CHECK(!zs.fixed_size());
+  CHECK_EQ(zs.find("v2")->offset, 0u);
+  CHECK_EQ(zs.find("v4.content")->offset, 5 * sizeof(int32_t));
+  CHECK_EQ(zs.find("v5")->offset, type_schema::npos);
+  CHECK_EQ(zs.find("v7")->size, 0u);
+  CHECK_EQ(zs.find("v8")->size, 0u);
+}
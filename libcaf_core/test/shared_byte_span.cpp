@@ -0,0 +1,82 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE shared_byte_span
+
+#include "caf/shared_byte_span.hpp"
+
+#include "core-test.hpp"
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/json_writer.hpp"
+#include "caf/make_counted.hpp"
+
+using namespace caf;
+
+namespace {
+
+byte operator"" _b(unsigned long long int x) {
+  return static_cast<byte>(x);
+}
+
+struct fixture {
+  template <class T>
+  byte_buffer serialize(const T& x) {
+    byte_buffer result;
+    binary_serializer sink{nullptr, result};
+    if (!sink.apply(x))
+      CAF_FAIL("failed to serialize " << x << ": " << sink.get_error());
+    return result;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(shared_byte_span_tests, fixture)
+
+CAF_TEST(shared byte spans use the same binary format as byte buffers) {
+  auto bytes = byte_buffer{1_b, 2_b, 3_b};
+  auto x = shared_byte_span{bytes};
+  CHECK_EQ(serialize(x), serialize(bytes));
+  json_writer writer;
+  CHECK(writer.apply(x));
+  CHECK_EQ(writer.str(), "[1, 2, 3]");
+}
+
+CAF_TEST(shared byte spans point into the input of a deserializer) {
+  auto bytes = byte_buffer{1_b, 2_b, 3_b};
+  auto buf = make_counted<shared_byte_buffer>(serialize(bytes));
+  MESSAGE("without input owner, the deserializer copies the bytes");
+  {
+    binary_deserializer source{nullptr, buf->bytes};
+    shared_byte_span x;
+    CHECK(source.apply(x));
+    CHECK(std::equal(x.begin(), x.end(), bytes.begin(), bytes.end()));
+    CHECK_NE(x.owner(), buf.get());
+    CHECK(buf->unique());
+  }
+  MESSAGE("with input owner, the deserializer shares the input");
+  {
+    binary_deserializer source{nullptr, buf->bytes};
+    source.input_owner(buf.get());
+    shared_byte_span x;
+    CHECK(source.apply(x));
+    CHECK(std::equal(x.begin(), x.end(), bytes.begin(), bytes.end()));
+    CHECK_EQ(x.owner(), buf.get());
+    CHECK_EQ(x.data(), buf->bytes.data() + 1);
+    CHECK(!buf->unique());
+  }
+  CHECK(buf->unique());
+}
+
+CAF_TEST(shared byte spans reject truncated input) {
+  auto input = byte_buffer{5_b, 1_b, 2_b};
+  binary_deserializer source{nullptr, input};
+  shared_byte_span x;
+  CHECK(!source.apply(x));
+  CHECK_EQ(source.get_error(), sec::end_of_stream);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
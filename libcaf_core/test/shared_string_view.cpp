@@ -0,0 +1,56 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE shared_string_view
+
+#include "caf/shared_string_view.hpp"
+
+#include "core-test.hpp"
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/make_counted.hpp"
+#include "caf/shared_byte_span.hpp"
+
+using namespace caf;
+
+CAF_TEST(shared string views use the same binary format as strings) {
+  byte_buffer buf1;
+  byte_buffer buf2;
+  binary_serializer sink1{nullptr, buf1};
+  binary_serializer sink2{nullptr, buf2};
+  CHECK(sink1.apply(shared_string_view{"hello world"}));
+  CHECK(sink2.apply(std::string{"hello world"}));
+  CHECK_EQ(buf1, buf2);
+}
+
+CAF_TEST(shared string views point into the input of a deserializer) {
+  auto buf = make_counted<shared_byte_buffer>();
+  binary_serializer sink{nullptr, buf->bytes};
+  CHECK(sink.apply(std::string{"hello world"}));
+  binary_deserializer source{nullptr, buf->bytes};
+  source.input_owner(buf.get());
+  shared_string_view x;
+  CHECK(source.apply(x));
+  CHECK_EQ(x, "hello world");
+  CHECK_EQ(x.owner(), buf.get());
+  CHECK_EQ(x.data(), reinterpret_cast<const char*>(buf->bytes.data()) + 1);
+}
+
+CAF_TEST(shared string views are usable as message elements) {
+  auto msg = make_message(shared_string_view{"hello world"});
+  byte_buffer buf;
+  binary_serializer sink{nullptr, buf};
+  CHECK(sink.apply(msg));
+  auto owner = make_counted<shared_byte_buffer>(std::move(buf));
+  binary_deserializer source{nullptr, owner->bytes};
+  source.input_owner(owner.get());
+  message copy;
+  CHECK(source.apply(copy));
+  if (CHECK(copy.match_elements<shared_string_view>())) {
+    auto& str = copy.get_as<shared_string_view>(0);
+    CHECK_EQ(str, "hello world");
+    CHECK_EQ(str.owner(), owner.get());
+  }
+}
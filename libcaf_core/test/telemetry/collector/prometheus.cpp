@@ -75,4 +75,73 @@ some_request_duration_seconds_count{x="get"} 3 42000
   CAF_CHECK_EQUAL(res1, exporter.collect_from(registry, ts));
 }
 
+CAF_TEST(the Prometheus collector renders HDR histograms as summaries) {
+  auto sl = registry.hdr_histogram_family("some", "latency", {"x"},
+                                          hdr_layout{1, 1024, 3}, "Some help.",
+                                          "seconds");
+  auto h = sl->get_or_add({{"x", "get"}});
+  h->observe(3);
+  h->observe(4);
+  h->observe(7);
+  CAF_CHECK_EQUAL(exporter.collect_from(registry, timestamp{42s}),
+                  R"(# HELP some_latency_seconds Some help.
+# TYPE some_latency_seconds summary
+some_latency_seconds{x="get",quantile="0.5"} 4 42000
+some_latency_seconds{x="get",quantile="0.9"} 7 42000
+some_latency_seconds{x="get",quantile="0.99"} 7 42000
+some_latency_seconds{x="get",quantile="0.999"} 7 42000
+some_latency_seconds_sum{x="get"} 14 42000
+some_latency_seconds_count{x="get"} 3 42000
+)"_sv);
+}
+
+CAF_TEST(the Prometheus collector optionally generates OpenMetrics output) {
+  auto sr = registry.counter_family("some", "requests", {"x"}, "Some help.",
+                                    "1", true);
+  auto fb = registry.gauge_family("foo", "bar", {}, "", "seconds");
+  sr->get_or_add({{"x", "get"}})->inc(3);
+  fb->get_or_add({})->value(2);
+  exporter.format(collector::prometheus::output_format::open_metrics);
+  CAF_CHECK_EQUAL(exporter.collect_from(registry, timestamp{42123ms}),
+                  R"(# HELP some_requests Some help.
+# TYPE some_requests counter
+some_requests_total{x="get"} 3 42.123
+# TYPE foo_bar_seconds gauge
+foo_bar_seconds 2 42.123
+# EOF
+)"_sv);
+  CAF_MESSAGE("switching back to the text format restores the old output");
+  exporter.format(collector::prometheus::output_format::text);
+  CAF_CHECK_EQUAL(exporter.collect_from(registry, timestamp{42123ms}),
+                  R"(# HELP some_requests_total Some help.
+# TYPE some_requests_total counter
+some_requests_total{x="get"} 3 42123
+# TYPE foo_bar_seconds gauge
+foo_bar_seconds 2 42123
+)"_sv);
+}
+
+CAF_TEST(changing the format renders again within the min scrape interval) {
+  auto fb = registry.gauge_family("foo", "bar", {}, "", "seconds");
+  fb->get_or_add({})->value(2);
+  exporter.min_scrape_interval(timespan{1s});
+  CAF_CHECK_EQUAL(exporter.collect_from(registry, timestamp{42123ms}),
+                  R"(# TYPE foo_bar_seconds gauge
+foo_bar_seconds 2 42123
+)"_sv);
+  fb->get_or_add({})->value(3);
+  CAF_MESSAGE("scrapes within the interval return the cached output");
+  CAF_CHECK_EQUAL(exporter.collect_from(registry, timestamp{42124ms}),
+                  R"(# TYPE foo_bar_seconds gauge
+foo_bar_seconds 2 42123
+)"_sv);
+  CAF_MESSAGE("switching the format discards the cached output");
+  exporter.format(collector::prometheus::output_format::open_metrics);
+  CAF_CHECK_EQUAL(exporter.collect_from(registry, timestamp{42125ms}),
+                  R"(# TYPE foo_bar_seconds gauge
+foo_bar_seconds 3 42.125
+# EOF
+)"_sv);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
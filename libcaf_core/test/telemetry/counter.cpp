@@ -8,6 +8,9 @@
 
 #include "caf/test/dsl.hpp"
 
+#include <thread>
+#include <vector>
+
 using namespace caf;
 
 CAF_TEST(double counters can only increment) {
@@ -35,3 +38,24 @@ CAF_TEST(integer counters can only increment) {
   CAF_MESSAGE("users can create counters with custom start values");
   CAF_CHECK_EQUAL(telemetry::int_counter{42}.value(), 42);
 }
+
+CAF_TEST(sharded counters sum up the increments of all threads) {
+  telemetry::int_counter c{{}, 4};
+  telemetry::dbl_counter d{{}, 4};
+  CAF_CHECK(c.sharded());
+  CAF_CHECK(!telemetry::int_counter{}.sharded());
+  CAF_CHECK_EQUAL(c.value(), 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+    threads.emplace_back([&c, &d] {
+      for (int j = 0; j < 1000; ++j) {
+        c.inc();
+        d.inc(0.5);
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+  CAF_CHECK_EQUAL(c.value(), 8000);
+  CAF_CHECK_EQUAL(d.value(), 4000.0);
+  CAF_CHECK_EQUAL(++c, 8001);
+}
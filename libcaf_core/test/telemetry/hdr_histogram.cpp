@@ -0,0 +1,137 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE telemetry.hdr_histogram
+
+#include "caf/telemetry/hdr_histogram.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+using namespace caf::telemetry;
+
+namespace {
+
+// Checks whether `x` is within the relative error bounds of the layout. Integer
+// results may be off by another 0.5 due to rounding.
+template <class T>
+bool approx(T x, double expected, int precision) {
+  auto tolerance = std::ldexp(expected, -(precision + 1));
+  if constexpr (std::is_integral<T>::value)
+    tolerance += 0.5;
+  return std::abs(static_cast<double>(x) - expected) <= tolerance;
+}
+
+} // namespace
+
+CAF_TEST(layouts split each power of two into equally sized buckets) {
+  hdr_layout layout{1, 1024, 3};
+  CAF_CHECK_EQUAL(layout.size(), 88u);
+  CAF_CHECK_EQUAL(layout.min_value(), 1.0);
+  CAF_CHECK_EQUAL(layout.max_value(), 2048.0);
+  CAF_CHECK_EQUAL(layout.index_of(1.0), 0u);
+  CAF_CHECK_EQUAL(layout.index_of(1.124), 0u);
+  CAF_CHECK_EQUAL(layout.index_of(1.125), 1u);
+  CAF_CHECK_EQUAL(layout.index_of(2.0), 8u);
+  CAF_CHECK_EQUAL(layout.index_of(2.3), 9u);
+  CAF_CHECK_EQUAL(layout.lower_bound(9), 2.25);
+  CAF_CHECK_EQUAL(layout.upper_bound(9), 2.5);
+  CAF_CHECK_EQUAL(layout.value_at(9), 2.375);
+  CAF_MESSAGE("values outside of the layout fall into the first or last "
+              "bucket");
+  using limits = std::numeric_limits<double>;
+  CAF_CHECK_EQUAL(layout.index_of(0.5), 0u);
+  CAF_CHECK_EQUAL(layout.index_of(0.0), 0u);
+  CAF_CHECK_EQUAL(layout.index_of(-1.0), 0u);
+  CAF_CHECK_EQUAL(layout.index_of(limits::quiet_NaN()), 0u);
+  CAF_CHECK_EQUAL(layout.index_of(2047.0), 87u);
+  CAF_CHECK_EQUAL(layout.index_of(4096.0), 87u);
+  CAF_CHECK_EQUAL(layout.index_of(limits::infinity()), 87u);
+}
+
+CAF_TEST(layouts are configurable via settings) {
+  hdr_layout fallback{1, 1024, 3};
+  settings cfg;
+  put(cfg, "min", 0.001);
+  put(cfg, "precision", 2);
+  auto layout = hdr_layout::from(cfg, fallback);
+  CAF_CHECK_EQUAL(layout.min_value(), std::ldexp(1.0, -10));
+  CAF_CHECK_EQUAL(layout.max_value(), 2048.0);
+  CAF_CHECK_EQUAL(layout.precision(), 2);
+  CAF_CHECK_NOT_EQUAL(layout, fallback);
+  CAF_CHECK_EQUAL(hdr_layout::from(settings{}, fallback), fallback);
+}
+
+CAF_TEST(HDR histograms compute quantiles with bounded relative errors) {
+  int_hdr_histogram h1{hdr_layout{1, 1e6, 7}};
+  for (int64_t value = 1; value <= 10000; ++value)
+    h1.observe(value);
+  auto snapshot = h1.snapshot();
+  CAF_CHECK_EQUAL(snapshot.count(), 10000);
+  CAF_CHECK_EQUAL(snapshot.sum(), 50005000);
+  CAF_CHECK_EQUAL(h1.sum(), 50005000);
+  CAF_CHECK(approx(snapshot.quantile(0.5), 5000, 7));
+  CAF_CHECK(approx(snapshot.quantile(0.9), 9000, 7));
+  CAF_CHECK(approx(snapshot.quantile(0.99), 9900, 7));
+  CAF_CHECK(approx(snapshot.quantile(0.999), 9990, 7));
+  CAF_CHECK(approx(snapshot.quantile(1.0), 10000, 7));
+  CAF_CHECK_EQUAL(snapshot.quantile(0.0), 1);
+  dbl_hdr_histogram h2{hdr_layout{1e-6, 10, 5}};
+  CAF_CHECK_EQUAL(h2.snapshot().quantile(0.5), 0.0);
+  for (int i = 0; i < 999; ++i)
+    h2.observe(0.001);
+  h2.observe(2.0);
+  CAF_CHECK(approx(h2.snapshot().quantile(0.99), 0.001, 5));
+  CAF_CHECK(approx(h2.snapshot().quantile(0.9995), 2.0, 5));
+}
+
+CAF_TEST(threads may merge local snapshots into a histogram) {
+  int_hdr_histogram h1{{}, nullptr, hdr_layout{1, 1024, 4}, 4};
+  CAF_CHECK(h1.sharded());
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&h1] {
+      int_hdr_histogram::snapshot_type local{h1.layout()};
+      for (int64_t value = 1; value <= 100; ++value) {
+        local.observe(value);
+        h1.observe(value);
+      }
+      h1.merge(local);
+    });
+  for (auto& t : threads)
+    t.join();
+  auto snapshot = h1.snapshot();
+  CAF_CHECK_EQUAL(snapshot.count(), 800);
+  CAF_CHECK_EQUAL(snapshot.sum(), 40400);
+  CAF_CHECK(approx(snapshot.quantile(0.5), 50, 4));
+  CAF_MESSAGE("snapshots with the same layout are mergeable");
+  auto copy = snapshot;
+  CAF_CHECK(copy.merge(snapshot));
+  CAF_CHECK_EQUAL(copy.count(), 1600);
+  CAF_CHECK_EQUAL(copy.sum(), 80800);
+  CAF_MESSAGE("merging snapshots with different layouts fails");
+  int_hdr_histogram::snapshot_type other{hdr_layout{1, 1024, 3}};
+  CAF_CHECK(!copy.merge(other));
+  CAF_CHECK(!h1.merge(other));
+  copy.reset();
+  CAF_CHECK_EQUAL(copy.count(), 0);
+  CAF_CHECK_EQUAL(copy.quantile(0.5), 0);
+}
+
+CAF_TEST(labels may override the layout of HDR histograms) {
+  settings cfg;
+  put(cfg, "method=put.min", 16);
+  std::vector<label> put_labels{{"method", "put"}};
+  std::vector<label> get_labels{{"method", "get"}};
+  hdr_layout layout{1, 1024, 3};
+  int_hdr_histogram h1{put_labels, &cfg, layout};
+  int_hdr_histogram h2{get_labels, &cfg, layout};
+  CAF_CHECK_EQUAL(h1.layout().min_value(), 16.0);
+  CAF_CHECK_EQUAL(h2.layout(), layout);
+}
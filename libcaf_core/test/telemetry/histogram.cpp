@@ -8,8 +8,11 @@
 
 #include "caf/test/dsl.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include "caf/telemetry/gauge.hpp"
 
@@ -45,3 +48,83 @@ CAF_TEST(histograms aggregate to buckets and keep a sum) {
   CAF_CHECK_EQUAL(buckets[3].count.value(), 2); // 9, 10
   CAF_CHECK_EQUAL(h1.sum(), 55);
 }
+
+CAF_TEST(histograms find the first bucket that covers a value) {
+  // Looks up the bucket the same way as the original implementation.
+  auto find_bucket = [](auto& hist, auto value) {
+    auto buckets = hist.buckets();
+    for (size_t index = 0;; ++index)
+      if (value <= buckets[index].upper_bound)
+        return index;
+  };
+  std::vector<int64_t> bounds;
+  for (int64_t bound = 1; bound <= 1000; bound += bound / 4 + 1)
+    bounds.emplace_back(bound);
+  int_histogram few{1, 2, 4, 8};
+  int_histogram many{{}, nullptr, make_span(bounds)};
+  for (int64_t value = -5; value < 1100; ++value) {
+    CAF_CHECK_EQUAL(few.bucket_index(value), find_bucket(few, value));
+    CAF_CHECK_EQUAL(many.bucket_index(value), find_bucket(many, value));
+  }
+  using limits = std::numeric_limits<int64_t>;
+  CAF_CHECK_EQUAL(few.bucket_index(limits::max()), 4u);
+  CAF_CHECK_EQUAL(many.bucket_index(limits::max()), bounds.size());
+  for (int64_t value = 1; value < 11; ++value) {
+    few.observe(value);
+    many.observe(value);
+  }
+  CAF_CHECK_EQUAL(few.buckets()[2].count.value(), 2); // 3, 4
+  CAF_CHECK_EQUAL(few.buckets()[4].count.value(), 2); // 9, 10
+  CAF_CHECK_EQUAL(many.buckets()[2].count.value(), 1); // 3
+  CAF_CHECK_EQUAL(many.buckets()[6].count.value(), 2); // 9, 10
+  CAF_CHECK_EQUAL(few.sum(), 55);
+  CAF_CHECK_EQUAL(many.sum(), 55);
+}
+
+CAF_TEST(log-linear layouts split each power of two into sub-buckets) {
+  auto ints = int_histogram::log_linear_buckets(1, 16, 4);
+  auto int_bounds = std::vector<int64_t>{1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14,
+                                         16};
+  CAF_CHECK_EQUAL(ints, int_bounds);
+  auto dbls = dbl_histogram::log_linear_buckets(.001, .005, 2);
+  CAF_REQUIRE_EQUAL(dbls.size(), 6u);
+  auto dbl_bounds = std::vector<double>{.001, .0015, .002, .003, .004, .006};
+  for (size_t index = 0; index < dbls.size(); ++index)
+    CAF_CHECK_LESS(std::abs(dbls[index] - dbl_bounds[index]), 1e-12);
+  CAF_MESSAGE("the layout does not overflow for large integers");
+  using limits = std::numeric_limits<int64_t>;
+  auto large = int_histogram::log_linear_buckets(1, limits::max(), 1);
+  CAF_CHECK_EQUAL(large.size(), 63u);
+  CAF_CHECK(std::is_sorted(large.begin(), large.end()));
+  CAF_MESSAGE("invalid parameters result in an empty layout");
+  CAF_CHECK(int_histogram::log_linear_buckets(0, 16, 4).empty());
+  CAF_CHECK(int_histogram::log_linear_buckets(16, 16, 4).empty());
+  CAF_CHECK(int_histogram::log_linear_buckets(1, 16, 0).empty());
+}
+
+CAF_TEST(sharded histograms aggregate the observations of all threads) {
+  int64_t int_bounds[] = {2, 4, 8};
+  double dbl_bounds[] = {.5};
+  int_histogram h1{{}, nullptr, make_span(int_bounds), 4};
+  dbl_histogram h2{{}, nullptr, make_span(dbl_bounds), 4};
+  CAF_CHECK(h1.sharded());
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&h1, &h2] {
+      for (int64_t value = 1; value < 11; ++value) {
+        h1.observe(value);
+        h2.observe(0.25);
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+  auto buckets = h1.buckets();
+  CAF_REQUIRE_EQUAL(buckets.size(), 4u);
+  CAF_CHECK_EQUAL(buckets[0].count.value(), 8);
+  CAF_CHECK_EQUAL(buckets[1].count.value(), 8);
+  CAF_CHECK_EQUAL(buckets[2].count.value(), 16);
+  CAF_CHECK_EQUAL(buckets[3].count.value(), 8);
+  CAF_CHECK_EQUAL(h1.sum(), 220);
+  CAF_CHECK_EQUAL(h2.buckets()[0].count.value(), 40);
+  CAF_CHECK_EQUAL(h2.sum(), 10.0);
+}
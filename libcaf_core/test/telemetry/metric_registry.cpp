@@ -48,6 +48,13 @@ struct test_collector {
     result += std::to_string(wrapped->sum());
   }
 
+  template <class T>
+  void operator()(const metric_family* family, const metric* instance,
+                  const hdr_histogram<T>* wrapped) {
+    concat(family, instance);
+    result += std::to_string(wrapped->sum());
+  }
+
   void concat(const metric_family* family, const metric* instance) {
     result += '\n';
     result += family->prefix();
@@ -182,6 +189,94 @@ CAF_TEST(buckets for histograms are configurable via runtime settings) {
   CAF_CHECK_EQUAL(bounds(h2->buckets()), alternative_upper_bounds);
 }
 
+CAF_TEST(histograms accept log-linear bucket layouts via runtime settings) {
+  auto bounds = [](auto&& buckets) {
+    std::vector<int64_t> result;
+    for (auto&& bucket : buckets)
+      result.emplace_back(bucket.upper_bound);
+    result.pop_back();
+    return result;
+  };
+  settings cfg;
+  std::vector<int64_t> default_upper_bounds{1, 2, 4, 8};
+  put(cfg, "caf.response-time.log-linear-buckets.min", 4);
+  put(cfg, "caf.response-time.log-linear-buckets.max", 16);
+  put(cfg, "caf.response-time.log-linear-buckets.sub-buckets", 2);
+  put(cfg, "caf.response-time.var1=foo.log-linear-buckets.min", 10);
+  put(cfg, "caf.response-time.var1=foo.log-linear-buckets.max", 40);
+  registry.config(&cfg);
+  auto hf = registry.histogram_family("caf", "response-time", {"var1"},
+                                      default_upper_bounds,
+                                      "How long take requests?");
+  auto upper_bounds = std::vector<int64_t>{4, 6, 8, 12, 16};
+  CAF_CHECK_EQUAL(hf->extra_setting(), upper_bounds);
+  auto h1 = hf->get_or_add({{"var1", "bar"}});
+  CAF_CHECK_EQUAL(bounds(h1->buckets()), upper_bounds);
+  auto h2 = hf->get_or_add({{"var1", "foo"}});
+  auto alternative_upper_bounds = std::vector<int64_t>{10, 12, 15, 17, 20,
+                                                       25, 30, 35, 40};
+  CAF_CHECK_EQUAL(bounds(h2->buckets()), alternative_upper_bounds);
+}
+
+CAF_TEST(layouts for HDR histograms are configurable via runtime settings) {
+  settings cfg;
+  put(cfg, "caf.latency.precision", 3);
+  put(cfg, "caf.latency.var1=foo.min", 16);
+  registry.config(&cfg);
+  auto hf = registry.hdr_histogram_family("caf", "latency", {"var1"},
+                                          hdr_layout{1, 1024},
+                                          "How long take requests?");
+  CAF_CHECK_EQUAL(hf->extra_setting(), (hdr_layout{1, 1024, 3}));
+  auto h1 = hf->get_or_add({{"var1", "bar"}});
+  CAF_CHECK_EQUAL(h1->layout(), (hdr_layout{1, 1024, 3}));
+  auto h2 = hf->get_or_add({{"var1", "foo"}});
+  CAF_CHECK_EQUAL(h2->layout(), (hdr_layout{16, 1024, 3}));
+  h2->observe(20);
+  registry.collect(collector);
+  CAF_CHECK_EQUAL(collector.result, R"(
+caf.latency{var1="bar"} 0
+caf.latency{var1="foo"} 20)");
+}
+
+CAF_TEST(HDR histogram instances create their family on first use) {
+  auto h1 = registry.hdr_histogram_instance("caf", "latency", {{"var1", "foo"}},
+                                            hdr_layout{1, 1024},
+                                            "How long take requests?");
+  auto h2 = registry.hdr_histogram_instance("caf", "latency", {{"var1", "foo"}},
+                                            hdr_layout{1, 1024},
+                                            "How long take requests?");
+  CAF_CHECK_EQUAL(h1, h2);
+  h1->observe(20);
+  registry.collect(collector);
+  CAF_CHECK_EQUAL(collector.result, R"(
+caf.latency{var1="foo"} 20)");
+}
+
+CAF_TEST(the number of shards for counters and histograms is configurable) {
+  settings cfg;
+  put(cfg, "shards", 4);
+  registry.config(&cfg);
+  CHECK_EQ(registry.shards(), 4u);
+  std::vector<int64_t> upper_bounds{1, 2, 4, 8};
+  auto c = registry.counter_singleton("foo", "count", "Some count.");
+  auto h = registry.histogram_singleton("foo", "time", upper_bounds,
+                                        "Some duration.");
+  auto g = registry.gauge_singleton("foo", "level", "Some level.");
+  CHECK(c->sharded());
+  CHECK(h->sharded());
+  c->inc(3);
+  h->observe(5);
+  g->value(7);
+  registry.collect(collector);
+  CHECK_EQ(collector.result, R"(
+foo.count 3
+foo.time 5
+foo.level 7)");
+  MESSAGE("a value of 0 selects one shard per hardware thread");
+  registry.shards(0);
+  CHECK_GE(registry.shards(), 1u);
+}
+
 CAF_TEST(counter_instance is a shortcut for using the family manually) {
   auto fptr = registry.counter_family("http", "requests", {"method"},
                                       "Number of HTTP requests.", "seconds",
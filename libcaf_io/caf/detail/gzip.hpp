@@ -0,0 +1,20 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
+#include "caf/detail/io_export.hpp"
+
+namespace caf::detail {
+
+/// Appends `input` to `output`, encoded as a single gzip member (RFC 1952).
+/// The encoder emits one DEFLATE block with the fixed Huffman codes (RFC 1951)
+/// and uses the same greedy match finder as `lz4_compress`. This trades some
+/// compression ratio for speed, which is a good fit for highly repetitive
+/// text such as metrics in the Prometheus format.
+CAF_IO_EXPORT void gzip_compress(const_byte_span input, byte_buffer& output);
+
+} // namespace caf::detail
@@ -0,0 +1,30 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
+#include "caf/detail/io_export.hpp"
+
+namespace caf::detail {
+
+/// Appends `input` to `output`, encoded in the LZ4 block format. The encoder
+/// uses a fast, greedy match finder and never allocates besides growing
+/// `output`.
+CAF_IO_EXPORT void lz4_compress(const_byte_span input, byte_buffer& output);
+
+/// Decodes the LZ4 block `input` and appends the result to `output`.
+/// @param input An LZ4 block, e.g., produced by `lz4_compress`.
+/// @param decoded_size Expected size of the decoded block. Callers must check
+///                     this value before passing it from untrusted input.
+/// @param output Receives the decoded bytes.
+/// @returns `false` if `input` is malformed or does not decode to exactly
+///          `decoded_size` bytes, `true` otherwise.
+CAF_IO_EXPORT bool lz4_decompress(const_byte_span input, size_t decoded_size,
+                                  byte_buffer& output);
+
+} // namespace caf::detail
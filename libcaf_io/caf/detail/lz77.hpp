@@ -0,0 +1,28 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace caf::detail {
+
+/// Reads four bytes from `ptr` without any alignment requirement.
+inline uint32_t lz77_read32(const uint8_t* ptr) {
+  uint32_t result;
+  memcpy(&result, ptr, sizeof(uint32_t));
+  return result;
+}
+
+/// Maps four bytes of input to a slot in a match finder table with
+/// `2^HashLog` entries, using Knuth's multiplicative hashing.
+template <size_t HashLog>
+size_t lz77_hash(uint32_t x) {
+  static_assert(HashLog > 0 && HashLog < 32);
+  return (x * 2654435761u) >> (32 - HashLog);
+}
+
+} // namespace caf::detail
@@ -4,20 +4,20 @@
 
 #pragma once
 
-#include <ctime>
 #include <unordered_map>
-#include <vector>
 
+#include "caf/actor.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/fwd.hpp"
 #include "caf/io/broker.hpp"
-#include "caf/telemetry/collector/prometheus.hpp"
 #include "caf/telemetry/importer/process.hpp"
 
 namespace caf::detail {
 
-/// Makes system metrics in the Prometheus format available via HTTP 1.1.
+/// Makes system metrics in the Prometheus format available via HTTP 1.1. The
+/// broker only parses requests and ships responses. A helper actor renders the
+/// metrics on the scheduler to keep the I/O loop responsive.
 class CAF_IO_EXPORT prometheus_broker : public io::broker {
 public:
   explicit prometheus_broker(actor_config& cfg);
@@ -34,13 +34,21 @@ public:
 
   behavior make_behavior() override;
 
+  void on_exit() override;
+
 private:
-  void scrape();
+  void flush_and_close(io::connection_handle hdl);
 
   std::unordered_map<io::connection_handle, byte_buffer> requests_;
-  telemetry::collector::prometheus collector_;
-  time_t last_scrape_ = 0;
-  telemetry::importer::process proc_importer_;
+
+  /// Renders the metrics outside of the I/O loop.
+  actor renderer_;
+
+  /// Allows responding in the OpenMetrics format if the client accepts it.
+  bool open_metrics_;
+
+  /// Allows compressing responses if the client accepts gzip encoding.
+  bool gzip_;
 };
 
 } // namespace caf::detail
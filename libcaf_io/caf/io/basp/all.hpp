@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "caf/io/basp/codec.hpp"
 #include "caf/io/basp/connection_state.hpp"
 #include "caf/io/basp/endpoint_context.hpp"
 #include "caf/io/basp/header.hpp"
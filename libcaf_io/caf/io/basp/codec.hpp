@@ -0,0 +1,47 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#pragma once
+
+#include <memory>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::io::basp {
+
+/// Compresses and decompresses BASP payloads. Nodes announce the names of
+/// their codecs during the handshake and then compress payloads above a
+/// configurable threshold with the first codec in the server's list that the
+/// client supports as well.
+class CAF_IO_EXPORT codec {
+public:
+  virtual ~codec();
+
+  /// Returns a unique name for identifying this codec during the handshake.
+  virtual string_view name() const noexcept = 0;
+
+  /// Appends the compressed representation of `input` to `output`.
+  virtual bool compress(const_byte_span input, byte_buffer& output) = 0;
+
+  /// Appends the decompressed representation of `input` to `output`.
+  /// @returns `false` if `input` is malformed or if the decompressed data
+  ///          would exceed `max_size` bytes, `true` otherwise.
+  virtual bool decompress(const_byte_span input, byte_buffer& output,
+                          size_t max_size)
+    = 0;
+};
+
+/// @relates codec
+using codec_ptr = std::unique_ptr<codec>;
+
+/// Creates one of the built-in codecs by name. Currently, CAF only ships the
+/// codec `lz4`.
+/// @returns A new codec instance or `nullptr` if `name` is unknown.
+/// @relates codec
+CAF_IO_EXPORT codec_ptr make_codec(string_view name);
+
+} // namespace caf::io::basp
@@ -21,6 +21,9 @@ enum connection_state {
   /// Indicates that this node has received a header with non-zero payload
   /// and is waiting for the data.
   await_payload,
+  /// Indicates that this node has received a header with a large payload and
+  /// deserializes the payload while receiving it in chunks.
+  await_payload_chunk,
   /// Indicates that this connection no longer exists.
   close_connection,
   /// See `sec::incompatible_versions`.
@@ -40,9 +43,9 @@ enum connection_state {
 /// Returns whether the connection state requires a shutdown of the socket
 /// connection.
 constexpr bool requires_shutdown(connection_state x) noexcept {
-  // Any enum value other than await_header (0) and await_payload (1) signal the
-  // BASP broker to shutdown the connection.
-  return static_cast<int>(x) > 1;
+  // Any enum value other than await_header (0), await_payload (1) and
+  // await_payload_chunk (2) signal the BASP broker to shutdown the connection.
+  return static_cast<int>(x) > 2;
 }
 
 /// Converts the connection state to a system error code if it holds one of the
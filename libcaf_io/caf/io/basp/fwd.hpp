@@ -8,6 +8,7 @@ namespace caf::io::basp {
 
 struct header;
 
+class codec;
 class worker;
 class worker_hub;
 class message_queue;
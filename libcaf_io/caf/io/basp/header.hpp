@@ -47,6 +47,25 @@ struct header {
   /// Identifies a receiver by name rather than ID.
   static const uint8_t named_receiver_flag = 0x01;
 
+  /// Marks payloads that were compressed with the codec of the connection.
+  static const uint8_t compressed_flag = 0x02;
+
+  /// Marks routed messages that encode source and destination node with the
+  /// connection-local aliases of their connection.
+  static const uint8_t node_alias_flag = 0x04;
+
+  /// Marks direct messages that encode the types of their content with a
+  /// connection-local type list alias instead of the full list.
+  static const uint8_t type_alias_flag = 0x08;
+
+  /// Marks direct messages that encode integers in their payload with varint
+  /// and zigzag encoding.
+  static const uint8_t compact_integers_flag = 0x10;
+
+  /// Marks direct messages that carry tracing data in front of their
+  /// forwarding stack.
+  static const uint8_t tracing_flag = 0x20;
+
   /// Identifies the config server.
   static const uint64_t config_server_id = 1;
 
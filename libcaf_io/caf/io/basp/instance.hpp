@@ -5,13 +5,21 @@
 #pragma once
 
 #include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "caf/actor_system_config.hpp"
 #include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
 #include "caf/callback.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/detail/worker_hub.hpp"
 #include "caf/error.hpp"
+#include "caf/incremental_binary_deserializer.hpp"
+#include "caf/io/basp/codec.hpp"
 #include "caf/io/basp/connection_state.hpp"
 #include "caf/io/basp/header.hpp"
 #include "caf/io/basp/message_queue.hpp"
@@ -19,6 +27,10 @@
 #include "caf/io/basp/routing_table.hpp"
 #include "caf/io/basp/worker.hpp"
 #include "caf/io/middleman.hpp"
+#include "caf/node_id.hpp"
+#include "caf/string_view.hpp"
+#include "caf/tracing_data.hpp"
+#include "caf/type_id_list.hpp"
 #include "caf/variant.hpp"
 
 namespace caf::io::basp {
@@ -84,6 +96,11 @@ public:
     /// Flushes the underlying write buffer of `hdl`.
     virtual void flush(connection_handle hdl) = 0;
 
+    /// Flushes the underlying write buffer of `hdl` eventually, allowing the
+    /// callee to coalesce multiple messages into a single write operation. The
+    /// default implementation calls `flush` immediately.
+    virtual void schedule_flush(connection_handle hdl);
+
     /// Returns a handle to the callee actor.
     virtual strong_actor_ptr this_actor() = 0;
 
@@ -99,6 +116,95 @@ public:
   using removed_published_actor
     = callback<void(const strong_actor_ptr&, uint16_t)>;
 
+  /// Stores the connection-local node aliases of a single connection.
+  struct node_alias_table {
+    /// Maps nodes to the aliases we have announced to the remote side.
+    std::unordered_map<node_id, uint32_t> outbound;
+
+    /// Stores the aliases announced by the remote side, i.e., `inbound[0]` is
+    /// the node for alias 1.
+    std::vector<node_id> inbound;
+  };
+
+  /// Stores the connection-local type list aliases of a single connection.
+  struct type_list_alias_table {
+    /// Maps interned type lists to the aliases we have announced to the remote
+    /// side.
+    std::unordered_map<const type_id_t*, uint32_t> outbound;
+
+    /// Stores the aliases announced by the remote side, i.e., `inbound[0]` is
+    /// the type list for alias 1.
+    std::vector<type_id_list> inbound;
+  };
+
+  /// Deserializes the payload of a direct message while receiving it.
+  struct payload_stream {
+    payload_stream(execution_unit* ctx, size_t max_buffer_size)
+      : source(ctx, max_buffer_size) {
+      // nop
+    }
+
+    /// Number of payload bytes that did not arrive yet.
+    size_t pending = 0;
+
+    /// Reserves the position of the message in the ::message_queue.
+    uint64_t msg_id = 0;
+
+    /// Buffers the received bytes that still wait for deserialization.
+    incremental_binary_deserializer source;
+
+    /// Stores whether `types` holds the resolved type list alias.
+    bool has_types = false;
+
+    /// Stores the type list for payloads with the `type_alias_flag`.
+    type_id_list types = make_type_id_list();
+
+    /// Stores whether `tracing` holds the tracing data of the message.
+    bool has_tracing = false;
+
+    /// Stores the tracing data for payloads with the `tracing_flag`.
+    tracing_data_ptr tracing;
+
+    /// Stores whether `stages` holds the forwarding stack.
+    bool has_stages = false;
+
+    /// Stores the forwarding stack of the message.
+    std::vector<strong_actor_ptr> stages;
+
+    /// Stores the content of the message.
+    message content;
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  /// Names the protocol extension for connection-local node aliases.
+  static constexpr string_view node_aliases_feature = "node-aliases";
+
+  /// Marks an alias tag that defines a new alias.
+  static constexpr uint32_t alias_definition_bit = 0x80000000u;
+
+  /// Restricts how many aliases a single connection may define.
+  static constexpr uint32_t max_node_aliases = 4096;
+
+  /// Restricts how many nodes the instance keeps in its interning cache.
+  static constexpr size_t max_cached_nodes = 1024;
+
+  /// Names the protocol extension for connection-local type list aliases.
+  static constexpr string_view type_list_aliases_feature = "type-list-aliases";
+
+  /// Restricts how many type list aliases a single connection may define.
+  static constexpr uint32_t max_type_list_aliases = 4096;
+
+  /// Names the protocol extension for varint and zigzag encoded integers.
+  static constexpr string_view compact_integers_feature = "compact-integers";
+
+  /// Names the protocol extension for attaching tracing data to messages.
+  static constexpr string_view tracing_feature = "tracing";
+
+  /// Restricts how many bytes the BASP broker reads at once while receiving
+  /// a payload in chunks.
+  static constexpr size_t max_chunk_size = 65536;
+
   instance(abstract_broker* parent, callee& lstnr);
 
   /// Handles received data and returns a config for receiving the
@@ -117,9 +223,43 @@ public:
 
   /// Sends a BASP message and implicitly flushes the output buffer of `r`.
   /// This function will update `hdr.payload_len` if a payload was written.
-  void write(execution_unit* ctx, const routing_table::route& r, header& hdr,
+  bool write(execution_unit* ctx, const routing_table::route& r, header& hdr,
              payload_writer* writer = nullptr);
 
+  /// Adds `ptr` to the codecs that this instance offers during the handshake.
+  /// Codecs added first take precedence.
+  void add_codec(codec_ptr ptr);
+
+  /// Returns the codec for compressing payloads on `hdl` or `nullptr` if
+  /// both nodes failed to agree on a codec for this connection.
+  codec* codec_for(connection_handle hdl) const noexcept;
+
+  /// Returns the alias table for `hdl` or `nullptr` if the nodes did not
+  /// agree on using node aliases for this connection.
+  node_alias_table* aliases_for(connection_handle hdl) noexcept;
+
+  /// Returns the type list alias table for `hdl` or `nullptr` if the nodes did
+  /// not agree on using type list aliases for this connection.
+  type_list_alias_table* type_lists_for(connection_handle hdl) noexcept;
+
+  /// Returns whether the nodes agreed on encoding integers in direct messages
+  /// on `hdl` in compact form.
+  bool compact_integers_for(connection_handle hdl) const noexcept;
+
+  /// Returns whether messages on `hdl` may carry tracing data.
+  bool tracing_for(connection_handle hdl) const noexcept;
+
+  /// Returns the payload stream for `hdl` or `nullptr` if BASP currently
+  /// receives no payload in chunks on this connection.
+  payload_stream* stream_for(connection_handle hdl) noexcept;
+
+  /// Returns how many bytes the BASP broker may read on `hdl` while receiving
+  /// a payload in chunks.
+  size_t next_chunk_size(connection_handle hdl) noexcept;
+
+  /// Drops the compression, alias and streaming state for `hdl`.
+  void erase_connection_state(connection_handle hdl);
+
   /// Adds a new actor to the map of published actors.
   void add_published_actor(uint16_t port, strong_actor_ptr published_actor,
                            std::set<std::string> published_interface);
@@ -134,10 +274,13 @@ public:
                                 removed_published_actor* cb = nullptr);
 
   /// Returns `true` if a path to destination existed, `false` otherwise.
+  /// Attaches `tracing` to the message if the connection to `dest_node`
+  /// supports tracing and the message requires no routing.
   bool dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                 const std::vector<strong_actor_ptr>& forwarding_stack,
                 const node_id& dest_node, uint64_t dest_actor, uint8_t flags,
-                message_id mid, const message& msg);
+                message_id mid, const message& msg,
+                const tracing_data* tracing = nullptr);
 
   /// Returns the actor namespace associated to this BASP protocol instance.
   proxy_registry& proxies() {
@@ -162,9 +305,12 @@ public:
     return published_actors_;
   }
 
-  /// Writes a header followed by its payload to `storage`.
-  static void write(execution_unit* ctx, byte_buffer& buf, header& hdr,
-                    payload_writer* pw = nullptr);
+  /// Writes a header followed by its payload to `storage`. Restores the
+  /// original size of `buf` if the payload writer fails. Passing
+  /// `presize = true` enables pre-sizing of messages in the payload.
+  /// @see binary_serializer::presize
+  static bool write(execution_unit* ctx, byte_buffer& buf, header& hdr,
+                    payload_writer* pw = nullptr, bool presize = false);
 
   /// Writes the server handshake containing the information of the
   /// actor published at `port` to `buf`. If `port == none` or
@@ -212,8 +358,85 @@ public:
                           header& hdr, byte_buffer* payload);
 
 private:
-  void forward(execution_unit* ctx, const node_id& dest_node, const header& hdr,
-               byte_buffer& payload);
+  /// Forwards a routed message to the next hop for `dest_node`. The `payload`
+  /// contains the message without source and destination node.
+  void forward(execution_unit* ctx, const node_id& source_node,
+               const node_id& dest_node, const header& hdr,
+               const_byte_span payload);
+
+  /// Writes a message to the buffer of `hdl`, compressing the payload if
+  /// necessary. Does not flush the buffer.
+  bool write_message(execution_unit* ctx, connection_handle hdl, header& hdr,
+                     payload_writer* writer);
+
+  /// Reads a node ID from a routed message, resolving node aliases if `hdr`
+  /// has the `node_alias_flag`.
+  bool read_node(binary_deserializer& source, connection_handle hdl,
+                 const header& hdr, node_id& x);
+
+  /// Writes a node ID for a routed message, using (and defining) a node alias
+  /// if `aliases` is not `nullptr`.
+  static bool write_node(binary_serializer& sink, node_alias_table* aliases,
+                         const node_id& x);
+
+  /// Removes all outbound aliases that `aliases` defined after it contained
+  /// `size` aliases, e.g., after failing to write a message.
+  static void rollback_aliases(node_alias_table* aliases, size_t size);
+
+  /// Reads the type list alias of a direct message.
+  bool read_types(binary_deserializer& source, connection_handle hdl,
+                  type_id_list& types);
+
+  /// Writes the type list of a direct message, using (and defining) an alias.
+  static bool write_types(binary_serializer& sink,
+                          type_list_alias_table& type_lists,
+                          type_id_list types);
+
+  /// Removes all outbound aliases that `type_lists` defined after it contained
+  /// `size` aliases, e.g., after failing to write a message.
+  static void rollback_type_lists(type_list_alias_table* type_lists,
+                                  size_t size);
+
+  /// Checks whether BASP deserializes the payload for `hdr` while receiving it
+  /// and creates the payload stream for `hdl` if so.
+  bool start_stream(execution_unit* ctx, connection_handle hdl,
+                    const header& hdr);
+
+  /// Feeds a chunk of the payload into the payload stream of `hdl` and
+  /// delivers the message once it is complete.
+  connection_state handle_chunk(connection_handle hdl, header& hdr,
+                                const byte_buffer& chunk);
+
+  /// Deserializes as much of the payload in `stream` as possible.
+  incremental_binary_deserializer::load_result
+  advance(connection_handle hdl, const header& hdr, payload_stream& stream);
+
+  /// Reads a node ID and replaces it with a previously cached instance of the
+  /// same node. Avoids allocating new node data for known nodes.
+  bool read_interned(binary_deserializer& source, node_id& x);
+
+  /// Enables protocol extensions on `hdl` that both nodes support.
+  void select_features(connection_handle hdl,
+                       const std::vector<std::string>& remote_features);
+
+  /// Replaces the payload of the message at `offset` in `buf` with its
+  /// compressed representation if `hdl` uses compression and if the payload
+  /// exceeds the threshold.
+  void compress(execution_unit* ctx, connection_handle hdl, byte_buffer& buf,
+                size_t offset, header& hdr);
+
+  /// Decompresses `payload` into `decompressed_` and updates `hdr`.
+  bool decompress(connection_handle hdl, header& hdr,
+                  const byte_buffer& payload);
+
+  /// Picks the first codec from `server_codecs` that also appears in
+  /// `client_codecs` for compressing payloads on `hdl`.
+  void select_codec(connection_handle hdl,
+                    const std::vector<std::string>& server_codecs,
+                    const std::vector<std::string>& client_codecs);
+
+  /// Returns the names of all codecs in `codecs_`.
+  std::vector<std::string> codec_names() const;
 
   routing_table tbl_;
   published_actor_map published_actors_;
@@ -221,6 +444,25 @@ private:
   callee& callee_;
   message_queue queue_;
   detail::worker_hub<worker> hub_;
+  std::vector<codec_ptr> codecs_;
+  std::unordered_map<connection_handle, codec*> connection_codecs_;
+  std::vector<std::string> features_;
+  std::unordered_map<connection_handle, node_alias_table> connection_aliases_;
+  std::unordered_map<connection_handle, type_list_alias_table>
+    connection_type_lists_;
+  std::unordered_set<connection_handle> compact_connections_;
+  std::unordered_set<connection_handle> tracing_connections_;
+  std::unordered_set<node_id> known_nodes_;
+  node_id scratch_node_;
+  std::unordered_map<connection_handle, std::unique_ptr<payload_stream>>
+    streams_;
+  size_t max_payload_size_;
+  size_t compression_threshold_;
+  size_t streaming_threshold_;
+  size_t streaming_buffer_size_;
+  bool presize_payloads_;
+  byte_buffer compressed_;
+  byte_buffer decompressed_;
 };
 
 /// @}
@@ -4,28 +4,83 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 #include "caf/actor_control_block.hpp"
+#include "caf/config.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/fwd.hpp"
 #include "caf/mailbox_element.hpp"
 
 namespace caf::io::basp {
 
-/// Enforces strict order of message delivery, i.e., deliver messages in the
-/// same order as if they were deserialized by a single thread.
+/// Enforces message delivery in the same order as if the messages were
+/// deserialized by a single thread, but only for messages that share the same
+/// receiver. Messages for different receivers are ordered by independent
+/// sequencers, i.e., BASP workers only contend if their receivers map to the
+/// same sequencer.
 class CAF_IO_EXPORT message_queue {
 public:
+  // -- constants --------------------------------------------------------------
+
+  /// Number of bits in a message ID that select the sequencer.
+  static constexpr uint64_t sequencer_bits = 4;
+
+  /// Number of independent sequencers.
+  static constexpr size_t num_sequencers = size_t{1} << sequencer_bits;
+
   // -- member types -----------------------------------------------------------
 
+  /// Shared state of a message that waits for all sequencers.
+  struct barrier {
+    barrier(strong_actor_ptr receiver, mailbox_element_ptr content)
+      : pending(num_sequencers),
+        receiver(std::move(receiver)),
+        content(std::move(content)) {
+      // nop
+    }
+
+    /// Number of sequencers that did not reach the barrier yet.
+    std::atomic<size_t> pending;
+
+    /// Receives `content` after all sequencers reached the barrier.
+    strong_actor_ptr receiver;
+
+    /// The delayed message.
+    mailbox_element_ptr content;
+  };
+
+  using barrier_ptr = std::shared_ptr<barrier>;
+
   /// Request for sending a message to an actor at a later time.
   struct actor_msg {
     uint64_t id;
     strong_actor_ptr receiver;
     mailbox_element_ptr content;
+    barrier_ptr sync;
+  };
+
+  /// Establishes strict ordering for all receivers that map to it.
+  struct alignas(CAF_CACHE_LINE_SIZE) sequencer {
+    /// Protects all other properties.
+    std::mutex lock;
+
+    /// The next available ascending ID. The counter is large enough to
+    /// overflow after roughly 36 years if we dispatch a message every
+    /// nanosecond to the same sequencer.
+    uint64_t next_id = 0;
+
+    /// The next ID that we can ship.
+    uint64_t next_undelivered = 0;
+
+    /// Keeps messages in sorted order in case a message other than
+    /// `next_undelivered` gets ready first.
+    std::vector<actor_msg> pending;
   };
 
   // -- constructors, destructors, and assignment operators --------------------
@@ -35,30 +90,42 @@ public:
   // -- mutators ---------------------------------------------------------------
 
   /// Adds a new message to the queue or deliver it immediately if possible.
+  /// @pre `id` was obtained by calling `new_id`.
   void push(execution_unit* ctx, uint64_t id, strong_actor_ptr receiver,
             mailbox_element_ptr content);
 
   /// Marks given ID as dropped, effectively skipping it without effect.
   void drop(execution_unit* ctx, uint64_t id);
 
-  /// Returns the next ascending ID.
-  uint64_t new_id();
+  /// Delivers `content` to `receiver` after all messages with previously
+  /// acquired IDs were delivered or dropped, regardless of their receiver.
+  void push_barrier(execution_unit* ctx, strong_actor_ptr receiver,
+                    mailbox_element_ptr content);
+
+  /// Returns the next ascending ID for a message to `receiver`.
+  uint64_t new_id(actor_id receiver);
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the index of the sequencer for `receiver`.
+  static constexpr size_t sequencer_index(actor_id receiver) noexcept {
+    return static_cast<size_t>(receiver & (num_sequencers - 1));
+  }
 
   // -- member variables -------------------------------------------------------
 
-  /// Protects all other properties.
-  std::mutex lock;
+  /// Independent sequencers, selected by the receiver ID.
+  std::array<sequencer, num_sequencers> sequencers;
+
+  /// Optional gauge for tracking the number of messages in `pending` lists.
+  telemetry::int_gauge* pending_messages = nullptr;
 
-  /// The next available ascending ID. The counter is large enough to overflow
-  /// after roughly 600 years if we dispatch a message every microsecond.
-  uint64_t next_id;
+private:
+  // -- utility functions ------------------------------------------------------
 
-  /// The next ID that we can ship.
-  uint64_t next_undelivered;
+  void push_impl(execution_unit* ctx, sequencer& seq, actor_msg msg);
 
-  /// Keeps messages in sorted order in case a message other than
-  /// `next_undelivered` gets ready first.
-  std::vector<actor_msg> pending;
+  void deliver(execution_unit* ctx, actor_msg& msg);
 };
 
 } // namespace caf::io::basp
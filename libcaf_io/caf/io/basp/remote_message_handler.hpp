@@ -12,6 +12,7 @@
 #include "caf/binary_deserializer.hpp"
 #include "caf/config.hpp"
 #include "caf/const_typed_message_view.hpp"
+#include "caf/detail/io_export.hpp"
 #include "caf/detail/scope_guard.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/execution_unit.hpp"
@@ -21,28 +22,94 @@
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
 #include "caf/node_id.hpp"
+#include "caf/sec.hpp"
 #include "caf/telemetry/histogram.hpp"
 #include "caf/telemetry/timer.hpp"
+#include "caf/tracing_data.hpp"
 
 namespace caf::io::basp {
 
+/// Reads the tracing data of a direct message with the `tracing_flag`.
+CAF_IO_EXPORT bool read_tracing_data(actor_system& sys,
+                                     binary_deserializer& source,
+                                     tracing_data_ptr& x);
+
 template <class Subtype>
 class remote_message_handler {
 public:
+  /// Deserializes the message in the payload and delivers it.
   void handle_remote_message(execution_unit* ctx) {
     CAF_LOG_TRACE("");
     // Local variables.
     auto& dref = static_cast<Subtype&>(*this);
-    auto& sys = *dref.system_;
     strong_actor_ptr src;
     strong_actor_ptr dst;
+    tracing_data_ptr tracing;
     std::vector<strong_actor_ptr> stages;
     message msg;
     auto mid = make_message_id(dref.hdr_.operation_data);
     binary_deserializer source{ctx, dref.payload_};
+    source.input_owner(dref.payload_owner_.get());
+    auto compact = dref.hdr_.has(basp::header::compact_integers_flag);
+    source.compact_integers(compact);
     // Make sure to drop the message in case we return abnormally.
     auto guard
       = detail::make_scope_guard([&] { dref.queue_->drop(ctx, dref.msg_id_); });
+    if (!resolve(src, dst, mid))
+      return;
+    // Get the remainder of the message.
+    if (dref.hdr_.has(basp::header::tracing_flag)
+        && !read_tracing_data(*dref.system_, source, tracing)) {
+      CAF_LOG_ERROR("failed to read tracing data:" << source.get_error());
+      return;
+    }
+    if (!source.apply(stages)) {
+      CAF_LOG_ERROR("failed to read stages:" << source.get_error());
+      return;
+    }
+    auto& mm_metrics = ctx->system().middleman().metric_singletons;
+    auto t0 = telemetry::timer::clock_type::now();
+    auto content_ok = dref.hdr_.has(basp::header::type_alias_flag)
+                        ? msg.load_values(source, dref.types_)
+                        : source.apply(msg);
+    if (!content_ok) {
+      CAF_LOG_ERROR("failed to read message content:" << source.get_error());
+      return;
+    }
+    telemetry::timer::observe(mm_metrics.deserialization_time, t0);
+    auto signed_size = static_cast<int64_t>(dref.payload_.size());
+    mm_metrics.inbound_messages_size->observe(signed_size);
+    guard.disable();
+    deliver(ctx, std::move(src), std::move(dst), mid, std::move(tracing),
+            std::move(stages), std::move(msg));
+  }
+
+  /// Delivers a message that the BASP broker deserialized while receiving it.
+  void handle_remote_message(execution_unit* ctx, tracing_data_ptr tracing,
+                             std::vector<strong_actor_ptr> stages,
+                             message msg) {
+    CAF_LOG_TRACE(CAF_ARG(stages) << CAF_ARG(msg));
+    auto& dref = static_cast<Subtype&>(*this);
+    strong_actor_ptr src;
+    strong_actor_ptr dst;
+    auto mid = make_message_id(dref.hdr_.operation_data);
+    if (!resolve(src, dst, mid)) {
+      dref.queue_->drop(ctx, dref.msg_id_);
+      return;
+    }
+    auto& mm_metrics = ctx->system().middleman().metric_singletons;
+    auto signed_size = static_cast<int64_t>(dref.hdr_.payload_len);
+    mm_metrics.inbound_messages_size->observe(signed_size);
+    deliver(ctx, std::move(src), std::move(dst), mid, std::move(tracing),
+            std::move(stages), std::move(msg));
+  }
+
+private:
+  /// Looks up sender and receiver of the message.
+  /// @returns `false` if there is nothing to deliver.
+  bool resolve(strong_actor_ptr& src, strong_actor_ptr& dst, message_id mid) {
+    auto& dref = static_cast<Subtype&>(*this);
+    auto& sys = *dref.system_;
     // Registry setup.
     dref.proxies_->set_last_hop(&dref.last_hop_);
     // Get the local receiver.
@@ -59,23 +126,12 @@ public:
     // Short circuit if we already know there's nothing to do.
     if (dst == nullptr && !mid.is_request()) {
       CAF_LOG_INFO("drop asynchronous remote message: unknown destination");
-      return;
+      return false;
     }
-    // Deserialize source and destination node for routed messages.
+    // The BASP broker already deserialized source and destination node of
+    // routed messages, i.e., the payload starts at the forwarding stack.
     if (dref.hdr_.operation == basp::message_type::routed_message) {
-      node_id src_node;
-      node_id dst_node;
-      if (!source.apply(src_node)) {
-        CAF_LOG_ERROR(
-          "failed to read source of routed message:" << source.get_error());
-        return;
-      }
-      if (!source.apply(dst_node)) {
-        CAF_LOG_ERROR("failed to read destination of routed message:"
-                      << source.get_error());
-        return;
-      }
-      CAF_ASSERT(dst_node == sys.node());
+      const auto& src_node = dref.source_node_;
       if (dref.hdr_.source_actor != 0) {
         src = src_node == sys.node()
                 ? sys.registry().get(dref.hdr_.source_actor)
@@ -91,22 +147,16 @@ public:
       CAF_LOG_INFO("drop remote request: unknown destination");
       detail::sync_request_bouncer srb{exit_reason::remote_link_unreachable};
       srb(src, mid);
-      return;
+      return false;
     }
-    // Get the remainder of the message.
-    if (!source.apply(stages)) {
-      CAF_LOG_ERROR("failed to read stages:" << source.get_error());
-      return;
-    }
-    auto& mm_metrics = ctx->system().middleman().metric_singletons;
-    auto t0 = telemetry::timer::clock_type::now();
-    if (!source.apply(msg)) {
-      CAF_LOG_ERROR("failed to read message content:" << source.get_error());
-      return;
-    }
-    telemetry::timer::observe(mm_metrics.deserialization_time, t0);
-    auto signed_size = static_cast<int64_t>(dref.payload_.size());
-    mm_metrics.inbound_messages_size->observe(signed_size);
+    return true;
+  }
+
+  /// Ships the message to its receiver.
+  void deliver(execution_unit* ctx, strong_actor_ptr src, strong_actor_ptr dst,
+               message_id mid, [[maybe_unused]] tracing_data_ptr tracing,
+               std::vector<strong_actor_ptr> stages, message msg) {
+    auto& dref = static_cast<Subtype&>(*this);
     // Intercept link messages. Forwarding actor proxies signalize linking
     // by sending link_atom/unlink_atom message with src == dest.
     if (auto view
@@ -116,6 +166,7 @@ public:
         static_cast<actor_proxy*>(ptr->get())->add_link(dst->get());
       else
         CAF_LOG_WARNING("received link message with invalid target");
+      dref.queue_->drop(ctx, dref.msg_id_);
       return;
     }
     if (auto view
@@ -125,13 +176,16 @@ public:
         static_cast<actor_proxy*>(ptr->get())->remove_link(dst->get());
       else
         CAF_LOG_DEBUG("received unlink message with invalid target");
+      dref.queue_->drop(ctx, dref.msg_id_);
       return;
     }
     // Ship the message.
-    guard.disable();
-    dref.queue_->push(ctx, dref.msg_id_, std::move(dst),
-                      make_mailbox_element(std::move(src), mid,
-                                           std::move(stages), std::move(msg)));
+    auto element = make_mailbox_element(std::move(src), mid, std::move(stages),
+                                        std::move(msg));
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+    element->tracing_id = std::move(tracing);
+#endif // CAF_ENABLE_ACTOR_PROFILER
+    dref.queue_->push(ctx, dref.msg_id_, std::move(dst), std::move(element));
   }
 };
 
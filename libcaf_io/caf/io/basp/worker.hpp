@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "caf/byte_buffer.hpp"
+#include "caf/byte_span.hpp"
 #include "caf/config.hpp"
 #include "caf/detail/abstract_worker.hpp"
 #include "caf/detail/io_export.hpp"
@@ -18,7 +19,10 @@
 #include "caf/io/basp/header.hpp"
 #include "caf/io/basp/remote_message_handler.hpp"
 #include "caf/node_id.hpp"
+#include "caf/proxy_registry.hpp"
 #include "caf/resumable.hpp"
+#include "caf/shared_byte_span.hpp"
+#include "caf/type_id_list.hpp"
 
 namespace caf::io::basp {
 
@@ -47,8 +51,14 @@ public:
 
   // -- management -------------------------------------------------------------
 
-  void launch(const node_id& last_hop, const basp::header& hdr,
-              const byte_buffer& payload);
+  /// Deserializes `payload` asynchronously. For routed messages, `payload`
+  /// excludes source and destination node and `source_node` identifies the
+  /// original sender. For direct messages, `source_node` is `last_hop`. If
+  /// `hdr` has the `type_alias_flag`, `types` contains the resolved types of
+  /// the message content and `payload` excludes the type list alias.
+  void launch(const node_id& last_hop, const node_id& source_node,
+              const basp::header& hdr, const_byte_span payload,
+              type_id_list types = make_type_id_list());
 
   // -- implementation of resumable --------------------------------------------
 
@@ -88,12 +98,29 @@ private:
   /// Identifies the node that sent us `hdr_` and `payload_`.
   node_id last_hop_;
 
+  /// Identifies the node that originally sent the message.
+  node_id source_node_;
+
   /// The header for the next message. Either a direct_message or a
   /// routed_message.
   header hdr_;
 
-  /// Contains whatever this worker deserializes next.
-  byte_buffer payload_;
+  /// Contains whatever this worker deserializes next. Points into
+  /// `payload_owner_`.
+  const_byte_span payload_;
+
+  /// Stores the types of the message content if `hdr_` has the
+  /// `type_alias_flag`.
+  type_id_list types_;
+
+  /// Owns the bytes of `payload_`. Messages may keep a reference to this
+  /// buffer, e.g., for ::shared_byte_span elements. Hence, the worker only
+  /// re-uses the buffer if no message refers to it anymore.
+  shared_byte_buffer_ptr payload_owner_;
+
+  /// Caches recently used proxies in order to resolve hot remote senders
+  /// without locking the proxy registry.
+  proxy_registry::local_cache proxy_cache_;
 };
 
 } // namespace caf::io::basp
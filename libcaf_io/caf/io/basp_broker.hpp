@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <future>
 #include <map>
 #include <set>
@@ -23,6 +24,7 @@
 #include "caf/io/typed_broker.hpp"
 #include "caf/proxy_registry.hpp"
 #include "caf/stateful_actor.hpp"
+#include "caf/timespan.hpp"
 
 namespace caf::io {
 
@@ -82,6 +84,8 @@ public:
 
   void flush(connection_handle hdl) override;
 
+  void schedule_flush(connection_handle hdl) override;
+
   void handle_heartbeat() override;
 
   execution_unit* current_execution_unit() override;
@@ -103,6 +107,9 @@ public:
   /// Cleans up any state for `hdl`.
   void connection_cleanup(connection_handle hdl, sec code);
 
+  /// Flushes all connections with deferred output.
+  void flush_pending();
+
   /// Sends a basp::down_message message to a remote node.
   void send_basp_down_message(const node_id& nid, actor_id aid, error err);
 
@@ -152,6 +159,26 @@ public:
 
   /// Keeps track of nodes that monitor local actors.
   monitored_actor_map monitored_actors;
+
+  /// Stores connections with deferred output. The broker flushes these
+  /// connections at the latest when returning from `resume`.
+  std::vector<connection_handle> pending_flushes;
+
+  /// Stores when the broker deferred the first flush in `pending_flushes`.
+  std::chrono::steady_clock::time_point first_pending_flush;
+
+  /// Configures how many bytes the broker buffers per connection before
+  /// flushing. Setting this to 0 disables output batching.
+  size_t output_batch_size = 0;
+
+  /// Configures how long the broker may defer flushing a connection. The
+  /// broker checks the delay whenever it defers another flush and flushes all
+  /// connections when returning from `resume` regardless of the delay, i.e.,
+  /// output never waits for more than one run of the broker.
+  timespan output_batch_delay;
+
+  /// Signals whether the broker currently runs `resume`.
+  bool resuming = false;
 };
 
 } // namespace caf::io
@@ -47,6 +47,22 @@ public:
 
     /// Samples how long the middleman needs to serialize outbound messages.
     telemetry::dbl_histogram* serialization_time = nullptr;
+
+    /// Counts the BASP workers for deserializing inbound messages.
+    telemetry::int_gauge* deserialization_workers = nullptr;
+
+    /// Counts deserialized messages that wait for delivery of messages to the
+    /// same receiver that arrived earlier.
+    telemetry::int_gauge* pending_messages = nullptr;
+
+    /// Samples how long the middleman needs to compress outbound payloads.
+    telemetry::dbl_histogram* compression_time = nullptr;
+
+    /// Samples how long the middleman needs to decompress inbound payloads.
+    telemetry::dbl_histogram* decompression_time = nullptr;
+
+    /// Samples the size of compressed payloads relative to their original size.
+    telemetry::dbl_histogram* compression_ratio = nullptr;
   };
 
   /// Independent tasks that run in the background, usually in their own thread.
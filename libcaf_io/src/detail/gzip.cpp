@@ -0,0 +1,226 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/gzip.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+#include "caf/detail/lz77.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+// -- constants from the DEFLATE and gzip specifications -----------------------
+
+constexpr size_t min_match = 4;
+
+constexpr size_t max_match = 258;
+
+constexpr size_t max_offset = 32768;
+
+constexpr size_t hash_log = 14;
+
+constexpr uint8_t gzip_header[] = {
+  0x1F, 0x8B, // Magic number.
+  0x08,       // Compression method: DEFLATE.
+  0x00,       // Flags: none.
+  0x00, 0x00, 0x00, 0x00, // Modification time: not available.
+  0x00,       // Extra flags: none.
+  0xFF,       // Operating system: unknown.
+};
+
+constexpr uint16_t length_base[] = {3,  4,  5,  6,   7,   8,   9,   10,
+                                    11, 13, 15, 17,  19,  23,  27,  31,
+                                    35, 43, 51, 59,  67,  83,  99,  115,
+                                    131, 163, 195, 227, 258};
+
+constexpr uint8_t length_extra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                    1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                    4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+constexpr uint16_t distance_base[] = {
+  1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+  33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+  1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+constexpr uint8_t distance_extra[] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                      4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                      9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// -- CRC-32 as used by gzip ---------------------------------------------------
+
+constexpr std::array<uint32_t, 256> make_crc_table() {
+  std::array<uint32_t, 256> result{};
+  for (uint32_t index = 0; index < 256; ++index) {
+    auto x = index;
+    for (int bit = 0; bit < 8; ++bit)
+      x = (x & 1) ? 0xEDB88320u ^ (x >> 1) : x >> 1;
+    result[index] = x;
+  }
+  return result;
+}
+
+constexpr auto crc_table = make_crc_table();
+
+uint32_t crc32(const uint8_t* first, size_t len) {
+  uint32_t result = 0xFFFFFFFFu;
+  for (size_t i = 0; i < len; ++i)
+    result = crc_table[(result ^ first[i]) & 0xFF] ^ (result >> 8);
+  return result ^ 0xFFFFFFFFu;
+}
+
+// -- fixed Huffman codes ------------------------------------------------------
+
+struct huffman_code {
+  uint16_t bits; // Stored in reverse order, i.e., ready for writing.
+  uint8_t len;
+};
+
+constexpr uint16_t reverse_bits(uint16_t code, uint8_t len) {
+  uint16_t result = 0;
+  for (uint8_t i = 0; i < len; ++i) {
+    result = static_cast<uint16_t>((result << 1) | (code & 1));
+    code >>= 1;
+  }
+  return result;
+}
+
+// Computes the codes for the literal/length alphabet (RFC 1951, 3.2.6).
+constexpr std::array<huffman_code, 288> make_fixed_codes() {
+  std::array<huffman_code, 288> result{};
+  for (uint16_t symbol = 0; symbol < 288; ++symbol) {
+    uint16_t code = 0;
+    uint8_t len = 0;
+    if (symbol < 144) {
+      code = 0x30 + symbol;
+      len = 8;
+    } else if (symbol < 256) {
+      code = 0x190 + symbol - 144;
+      len = 9;
+    } else if (symbol < 280) {
+      code = symbol - 256;
+      len = 7;
+    } else {
+      code = 0xC0 + symbol - 280;
+      len = 8;
+    }
+    result[symbol] = huffman_code{reverse_bits(code, len), len};
+  }
+  return result;
+}
+
+constexpr auto fixed_codes = make_fixed_codes();
+
+// -- utility functions --------------------------------------------------------
+
+// Returns the index of the last element in `bases` that is less or equal to
+// `value`.
+template <class T, size_t N>
+size_t code_index(const T (&bases)[N], size_t value) {
+  auto i = std::upper_bound(std::begin(bases), std::end(bases), value);
+  return static_cast<size_t>(std::distance(std::begin(bases), i)) - 1;
+}
+
+void write32le(byte_buffer& out, uint32_t x) {
+  for (int i = 0; i < 4; ++i)
+    out.push_back(static_cast<byte>((x >> (i * 8)) & 0xFF));
+}
+
+/// Writes a stream of bits, starting with the least significant bit.
+class bit_writer {
+public:
+  explicit bit_writer(byte_buffer& out) : out_(out) {
+    // nop
+  }
+
+  void put(uint32_t bits, uint8_t len) {
+    acc_ |= uint64_t{bits} << len_;
+    len_ += len;
+    while (len_ >= 8) {
+      out_.push_back(static_cast<byte>(acc_ & 0xFF));
+      acc_ >>= 8;
+      len_ -= 8;
+    }
+  }
+
+  void put(huffman_code code) {
+    put(code.bits, code.len);
+  }
+
+  void flush() {
+    if (len_ > 0) {
+      out_.push_back(static_cast<byte>(acc_ & 0xFF));
+      acc_ = 0;
+      len_ = 0;
+    }
+  }
+
+private:
+  byte_buffer& out_;
+  uint64_t acc_ = 0;
+  uint8_t len_ = 0;
+};
+
+void write_literals(bit_writer& out, const uint8_t* first, size_t len) {
+  for (size_t i = 0; i < len; ++i)
+    out.put(fixed_codes[first[i]]);
+}
+
+void write_match(bit_writer& out, size_t len, size_t offset) {
+  auto li = code_index(length_base, len);
+  out.put(fixed_codes[257 + li]);
+  out.put(static_cast<uint32_t>(len - length_base[li]), length_extra[li]);
+  auto di = code_index(distance_base, offset);
+  out.put(reverse_bits(static_cast<uint16_t>(di), 5), 5);
+  out.put(static_cast<uint32_t>(offset - distance_base[di]),
+          distance_extra[di]);
+}
+
+} // namespace
+
+void gzip_compress(const_byte_span input, byte_buffer& output) {
+  auto src = reinterpret_cast<const uint8_t*>(input.data());
+  auto n = input.size();
+  auto hdr = reinterpret_cast<const byte*>(gzip_header);
+  output.insert(output.end(), hdr, hdr + sizeof(gzip_header));
+  bit_writer out{output};
+  // BFINAL = 1, BTYPE = 01 (fixed Huffman codes).
+  out.put(0b011, 3);
+  size_t anchor = 0;
+  if (n >= min_match) {
+    std::array<uint32_t, size_t{1} << hash_log> table;
+    table.fill(0);
+    size_t pos = 0;
+    while (pos + min_match <= n) {
+      auto h = lz77_hash<hash_log>(lz77_read32(src + pos));
+      size_t candidate = table[h];
+      table[h] = static_cast<uint32_t>(pos);
+      if (candidate < pos && pos - candidate <= max_offset
+          && lz77_read32(src + candidate) == lz77_read32(src + pos)) {
+        auto limit = std::min(max_match, n - pos);
+        auto len = min_match;
+        while (len < limit && src[candidate + len] == src[pos + len])
+          ++len;
+        write_literals(out, src + anchor, pos - anchor);
+        write_match(out, len, pos - candidate);
+        pos += len;
+        anchor = pos;
+      } else {
+        ++pos;
+      }
+    }
+  }
+  write_literals(out, src + anchor, n - anchor);
+  // End of block.
+  out.put(fixed_codes[256]);
+  out.flush();
+  write32le(output, crc32(src, n));
+  write32le(output, static_cast<uint32_t>(n));
+}
+
+} // namespace caf::detail
@@ -0,0 +1,155 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/detail/lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "caf/detail/lz77.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+// -- constants from the LZ4 block format specification ------------------------
+
+constexpr size_t min_match = 4;
+
+constexpr size_t last_literals = 5;
+
+constexpr size_t mf_limit = 12;
+
+constexpr size_t max_offset = 65535;
+
+constexpr size_t hash_log = 12;
+
+// -- utility functions --------------------------------------------------------
+
+void write_length(byte_buffer& out, size_t len) {
+  for (; len >= 255; len -= 255)
+    out.push_back(byte{255});
+  out.push_back(static_cast<byte>(len));
+}
+
+void write_literals(byte_buffer& out, const uint8_t* first, size_t len) {
+  auto ptr = reinterpret_cast<const byte*>(first);
+  out.insert(out.end(), ptr, ptr + len);
+}
+
+void write_sequence(byte_buffer& out, const uint8_t* literals,
+                    size_t literals_len, size_t offset, size_t match_len) {
+  auto ml = match_len - min_match;
+  auto token = (std::min(literals_len, size_t{15}) << 4)
+               | std::min(ml, size_t{15});
+  out.push_back(static_cast<byte>(token));
+  if (literals_len >= 15)
+    write_length(out, literals_len - 15);
+  write_literals(out, literals, literals_len);
+  out.push_back(static_cast<byte>(offset & 0xFF));
+  out.push_back(static_cast<byte>(offset >> 8));
+  if (ml >= 15)
+    write_length(out, ml - 15);
+}
+
+} // namespace
+
+void lz4_compress(const_byte_span input, byte_buffer& output) {
+  auto src = reinterpret_cast<const uint8_t*>(input.data());
+  auto n = input.size();
+  size_t anchor = 0;
+  if (n > mf_limit) {
+    std::array<uint32_t, size_t{1} << hash_log> table;
+    table.fill(0);
+    auto match_limit = n - last_literals;
+    auto search_limit = n - mf_limit;
+    size_t pos = 0;
+    while (pos <= search_limit) {
+      auto h = lz77_hash<hash_log>(lz77_read32(src + pos));
+      size_t candidate = table[h];
+      table[h] = static_cast<uint32_t>(pos);
+      if (candidate < pos && pos - candidate <= max_offset
+          && lz77_read32(src + candidate) == lz77_read32(src + pos)) {
+        // Extend the match backwards into pending literals.
+        while (pos > anchor && candidate > 0
+               && src[pos - 1] == src[candidate - 1]) {
+          --pos;
+          --candidate;
+        }
+        // Extend the match forward, leaving the last bytes as literals.
+        auto len = min_match;
+        while (pos + len < match_limit && src[candidate + len] == src[pos + len])
+          ++len;
+        write_sequence(output, src + anchor, pos - anchor, pos - candidate,
+                       len);
+        pos += len;
+        anchor = pos;
+      } else {
+        ++pos;
+      }
+    }
+  }
+  // The last sequence consists of literals only.
+  auto len = n - anchor;
+  output.push_back(static_cast<byte>(std::min(len, size_t{15}) << 4));
+  if (len >= 15)
+    write_length(output, len - 15);
+  write_literals(output, src + anchor, len);
+}
+
+bool lz4_decompress(const_byte_span input, size_t decoded_size,
+                    byte_buffer& output) {
+  auto src = reinterpret_cast<const uint8_t*>(input.data());
+  auto end = src + input.size();
+  auto offset0 = output.size();
+  // Each input byte decodes to at most 255 output bytes, i.e., we never reserve
+  // more memory than a valid block can produce, regardless of `decoded_size`.
+  output.reserve(offset0 + std::min(decoded_size, input.size() * 255));
+  auto read_length = [&](size_t& len) {
+    uint8_t x = 0;
+    do {
+      if (src == end)
+        return false;
+      x = *src++;
+      len += x;
+    } while (x == 255);
+    return true;
+  };
+  while (src != end) {
+    auto token = *src++;
+    // Copy literals.
+    size_t literals_len = token >> 4;
+    if (literals_len == 15 && !read_length(literals_len))
+      return false;
+    if (static_cast<size_t>(end - src) < literals_len
+        || output.size() - offset0 + literals_len > decoded_size)
+      return false;
+    write_literals(output, src, literals_len);
+    src += literals_len;
+    // The last sequence has no match part.
+    if (src == end)
+      break;
+    if (end - src < 2)
+      return false;
+    size_t offset = src[0] | (size_t{src[1]} << 8);
+    src += 2;
+    auto produced = output.size() - offset0;
+    if (offset == 0 || offset > produced)
+      return false;
+    size_t match_len = token & 0x0F;
+    if (match_len == 15 && !read_length(match_len))
+      return false;
+    match_len += min_match;
+    if (produced + match_len > decoded_size)
+      return false;
+    // Matches may overlap with their own output, so we copy byte-by-byte.
+    auto from = output.size() - offset;
+    for (size_t i = 0; i < match_len; ++i)
+      output.push_back(output[from + i]);
+  }
+  return output.size() - offset0 == decoded_size;
+}
+
+} // namespace caf::detail
@@ -4,9 +4,19 @@
 
 #include "caf/detail/prometheus_broker.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+
+#include "caf/actor_system_config.hpp"
+#include "caf/detail/gzip.hpp"
+#include "caf/event_based_actor.hpp"
+#include "caf/send.hpp"
 #include "caf/span.hpp"
+#include "caf/stateful_actor.hpp"
 #include "caf/string_algorithms.hpp"
 #include "caf/string_view.hpp"
+#include "caf/telemetry/collector/prometheus.hpp"
 #include "caf/telemetry/dbl_gauge.hpp"
 #include "caf/telemetry/int_gauge.hpp"
 
@@ -26,16 +36,104 @@ constexpr string_view request_too_large
 constexpr string_view request_not_supported = "HTTP/1.1 501 Not Implemented\r\n"
                                               "Connection: Closed\r\n\r\n";
 
-// HTTP header when sending a payload.
-constexpr string_view request_ok = "HTTP/1.1 200 OK\r\n"
-                                   "Content-Type: text/plain\r\n"
-                                   "Connection: Closed\r\n\r\n";
+// HTTP response for requests that we failed to render.
+constexpr string_view request_failed
+  = "HTTP/1.1 500 Internal Server Error\r\n"
+    "Connection: Closed\r\n\r\n";
+
+// HTTP header fields when sending a payload.
+constexpr string_view request_ok = "HTTP/1.1 200 OK\r\n";
+
+constexpr string_view text_content_type = "Content-Type: text/plain\r\n";
+
+constexpr string_view open_metrics_content_type
+  = "Content-Type: application/openmetrics-text; version=1.0.0; "
+    "charset=utf-8\r\n";
+
+constexpr string_view gzip_content_encoding = "Content-Encoding: gzip\r\n";
+
+constexpr string_view connection_closed = "Connection: Closed\r\n\r\n";
+
+// Checks whether the value of the header field `field` contains `what`.
+bool header_contains(string_view request, string_view field,
+                     string_view what) {
+  auto icase_equal = [](char x, char y) {
+    return tolower(static_cast<unsigned char>(x))
+           == tolower(static_cast<unsigned char>(y));
+  };
+  // The first line is the request line, i.e., "GET /metrics HTTP/1.1".
+  for (auto pos = request.find("\r\n"); pos != string_view::npos;
+       pos = request.find("\r\n")) {
+    request.remove_prefix(pos + 2);
+    auto line = request.substr(0, request.find("\r\n"));
+    if (line.size() > field.size() && line[field.size()] == ':'
+        && std::equal(field.begin(), field.end(), line.begin(), icase_equal))
+      return line.find(what) != string_view::npos;
+  }
+  return false;
+}
+
+void append(byte_buffer& buf, string_view str) {
+  auto bytes = as_bytes(make_span(str));
+  buf.insert(buf.end(), bytes.begin(), bytes.end());
+}
+
+struct prometheus_renderer_state {
+  static inline const char* name = "caf.system.prometheus-renderer";
+
+  explicit prometheus_renderer_state(event_based_actor* self)
+    : self(self), proc_importer(self->system().metrics()) {
+    // nop
+  }
+
+  byte_buffer render(bool open_metrics, bool gzip) {
+    using output_format = telemetry::collector::prometheus::output_format;
+    // Scrape system metrics at most once per second.
+    auto now = time(NULL);
+    if (last_scrape < now) {
+      last_scrape = now;
+      proc_importer.update();
+    }
+    collector.format(open_metrics ? output_format::open_metrics
+                                  : output_format::text);
+    auto text = collector.collect_from(self->system().metrics());
+    byte_buffer result;
+    append(result, request_ok);
+    append(result,
+           open_metrics ? open_metrics_content_type : text_content_type);
+    if (gzip) {
+      append(result, gzip_content_encoding);
+      append(result, connection_closed);
+      gzip_compress(as_bytes(make_span(text)), result);
+    } else {
+      append(result, connection_closed);
+      append(result, text);
+    }
+    return result;
+  }
+
+  event_based_actor* self;
+  telemetry::collector::prometheus collector;
+  time_t last_scrape = 0;
+  telemetry::importer::process proc_importer;
+};
+
+behavior
+prometheus_renderer(stateful_actor<prometheus_renderer_state>* self) {
+  return {
+    [self](get_atom, bool open_metrics, bool gzip) {
+      return self->state.render(open_metrics, gzip);
+    },
+  };
+}
 
 } // namespace
 
-prometheus_broker::prometheus_broker(actor_config& cfg)
-  : io::broker(cfg), proc_importer_(system().metrics()) {
-  // nop
+prometheus_broker::prometheus_broker(actor_config& cfg) : io::broker(cfg) {
+  auto& sys_cfg = system().config();
+  open_metrics_ = get_or(sys_cfg, "caf.middleman.prometheus-http.open-metrics",
+                         false);
+  gzip_ = get_or(sys_cfg, "caf.middleman.prometheus-http.gzip", false);
 }
 
 prometheus_broker::prometheus_broker(actor_config& cfg, io::doorman_ptr ptr)
@@ -52,19 +150,13 @@ const char* prometheus_broker::name() const {
 }
 
 behavior prometheus_broker::make_behavior() {
+  renderer_ = system().spawn<hidden>(prometheus_renderer);
   return {
     [=](const io::new_data_msg& msg) {
-      auto flush_and_close = [this, &msg] {
-        flush(msg.handle);
-        close(msg.handle);
-        requests_.erase(msg.handle);
-        if (num_connections() + num_doormen() == 0)
-          quit();
-      };
       auto& req = requests_[msg.handle];
       if (req.size() + msg.buf.size() > max_request_size) {
         write(msg.handle, as_bytes(make_span(request_too_large)));
-        flush_and_close();
+        flush_and_close(msg.handle);
         return;
       }
       req.insert(req.end(), msg.buf.begin(), msg.buf.end());
@@ -77,18 +169,33 @@ behavior prometheus_broker::make_behavior() {
       // Everything else, we ignore for now.
       if (!starts_with(req_str, "GET /metrics HTTP/1.")) {
         write(msg.handle, as_bytes(make_span(request_not_supported)));
-        flush_and_close();
+        flush_and_close(msg.handle);
         return;
       }
-      // Collect metrics, ship response, and close.
-      scrape();
-      auto hdr = as_bytes(make_span(request_ok));
-      auto text = collector_.collect_from(system().metrics());
-      auto payload = as_bytes(make_span(text));
-      auto& dst = wr_buf(msg.handle);
-      dst.insert(dst.end(), hdr.begin(), hdr.end());
-      dst.insert(dst.end(), payload.begin(), payload.end());
-      flush_and_close();
+      // Render metrics in the background, ship response, and close.
+      auto open_metrics
+        = open_metrics_
+          && header_contains(req_str, "Accept", "application/openmetrics-text");
+      auto gzip = gzip_ && header_contains(req_str, "Accept-Encoding", "gzip");
+      auto hdl = msg.handle;
+      request(renderer_, infinite, get_atom_v, open_metrics, gzip)
+        .then(
+          [this, hdl](const byte_buffer& response) {
+            // The client may have closed the connection in the meantime.
+            if (requests_.count(hdl) == 0)
+              return;
+            auto& dst = wr_buf(hdl);
+            dst.insert(dst.end(), response.begin(), response.end());
+            flush_and_close(hdl);
+          },
+          [this, hdl](const error& err) {
+            CAF_IGNORE_UNUSED(err);
+            CAF_LOG_ERROR("failed to render metrics:" << err);
+            if (requests_.count(hdl) == 0)
+              return;
+            write(hdl, as_bytes(make_span(request_failed)));
+            flush_and_close(hdl);
+          });
     },
     [=](const io::new_connection_msg& msg) {
       // Pre-allocate buffer for maximum request size.
@@ -109,13 +216,19 @@ behavior prometheus_broker::make_behavior() {
   };
 }
 
-void prometheus_broker::scrape() {
-  // Scrape system metrics at most once per second.
-  auto now = time(NULL);
-  if (last_scrape_ < now) {
-    last_scrape_ = now;
-    proc_importer_.update();
+void prometheus_broker::on_exit() {
+  if (renderer_) {
+    anon_send_exit(renderer_, exit_reason::user_shutdown);
+    renderer_ = nullptr;
   }
 }
 
+void prometheus_broker::flush_and_close(io::connection_handle hdl) {
+  flush(hdl);
+  close(hdl);
+  requests_.erase(hdl);
+  if (num_connections() + num_doormen() == 0)
+    quit();
+}
+
 } // namespace caf::detail
@@ -0,0 +1,59 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include "caf/io/basp/codec.hpp"
+
+#include <cstdint>
+
+#include "caf/detail/lz4.hpp"
+
+namespace caf::io::basp {
+
+namespace {
+
+/// Prefixes LZ4 blocks with the decoded size as 32-bit integer in network byte
+/// order, since the LZ4 block format does not include it.
+class lz4_codec : public codec {
+public:
+  string_view name() const noexcept override {
+    return "lz4";
+  }
+
+  bool compress(const_byte_span input, byte_buffer& output) override {
+    if (input.size() > UINT32_MAX)
+      return false;
+    auto len = static_cast<uint32_t>(input.size());
+    for (auto shift = 24; shift >= 0; shift -= 8)
+      output.push_back(static_cast<byte>((len >> shift) & 0xFF));
+    detail::lz4_compress(input, output);
+    return true;
+  }
+
+  bool decompress(const_byte_span input, byte_buffer& output,
+                  size_t max_size) override {
+    if (input.size() < sizeof(uint32_t))
+      return false;
+    size_t len = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+      len = (len << 8) | static_cast<size_t>(input[i]);
+    if (len > max_size)
+      return false;
+    return detail::lz4_decompress(input.subspan(sizeof(uint32_t)), len,
+                                  output);
+  }
+};
+
+} // namespace
+
+codec::~codec() {
+  // nop
+}
+
+codec_ptr make_codec(string_view name) {
+  if (name == "lz4")
+    return std::make_unique<lz4_codec>();
+  return nullptr;
+}
+
+} // namespace caf::io::basp
@@ -10,6 +10,16 @@ namespace caf::io::basp {
 
 const uint8_t header::named_receiver_flag;
 
+const uint8_t header::compressed_flag;
+
+const uint8_t header::node_alias_flag;
+
+const uint8_t header::type_alias_flag;
+
+const uint8_t header::compact_integers_flag;
+
+const uint8_t header::tracing_flag;
+
 std::string to_bin(uint8_t x) {
   std::string res;
   for (auto offset = 7; offset > -1; --offset)
@@ -53,7 +63,9 @@ bool direct_message_valid(const header& hdr) {
 }
 
 bool routed_message_valid(const header& hdr) {
-  return !zero(hdr.dest_actor) && !zero(hdr.payload_len);
+  return !zero(hdr.dest_actor) && !zero(hdr.payload_len)
+         && !hdr.has(header::compact_integers_flag)
+         && !hdr.has(header::tracing_flag);
 }
 
 bool monitor_message_valid(const header& hdr) {
@@ -10,15 +10,51 @@
 #include "caf/binary_deserializer.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/defaults.hpp"
+#include "caf/detail/type_id_list_builder.hpp"
 #include "caf/io/basp/remote_message_handler.hpp"
 #include "caf/io/basp/version.hpp"
 #include "caf/io/basp/worker.hpp"
 #include "caf/settings.hpp"
+#include "caf/shared_byte_span.hpp"
 #include "caf/telemetry/histogram.hpp"
+#include "caf/telemetry/int_gauge.hpp"
 #include "caf/telemetry/timer.hpp"
+#include "caf/tracing_data_factory.hpp"
 
 namespace caf::io::basp {
 
+namespace {
+
+// Deserializes messages on the broker thread if no worker is available.
+struct handler : remote_message_handler<handler> {
+  handler(message_queue* queue, proxy_registry* proxies, actor_system* system,
+          node_id last_hop, node_id source_node, basp::header& hdr,
+          const_byte_span payload, type_id_list types, uint64_t msg_id)
+    : queue_(queue),
+      proxies_(proxies),
+      system_(system),
+      last_hop_(std::move(last_hop)),
+      source_node_(std::move(source_node)),
+      hdr_(hdr),
+      payload_(payload),
+      types_(types),
+      msg_id_(msg_id) {
+    // nop
+  }
+  message_queue* queue_;
+  proxy_registry* proxies_;
+  actor_system* system_;
+  node_id last_hop_;
+  node_id source_node_;
+  basp::header& hdr_;
+  const_byte_span payload_;
+  shared_byte_buffer_ptr payload_owner_;
+  type_id_list types_;
+  uint64_t msg_id_;
+};
+
+} // namespace
+
 instance::callee::callee(actor_system& sys, proxy_registry::backend& backend)
   : namespace_(sys, backend) {
   // nop
@@ -28,6 +64,10 @@ instance::callee::~callee() {
   // nop
 }
 
+void instance::callee::schedule_flush(connection_handle hdl) {
+  flush(hdl);
+}
+
 instance::instance(abstract_broker* parent, callee& lstnr)
   : tbl_(parent), this_node_(parent->system().node()), callee_(lstnr) {
   CAF_ASSERT(this_node_ != none);
@@ -38,6 +78,39 @@ instance::instance(abstract_broker* parent, callee& lstnr)
     workers = std::min(3u, std::thread::hardware_concurrency() / 4u) + 1;
   for (size_t i = 0; i < workers; ++i)
     hub_.add_new_worker(queue_, proxies());
+  auto& mm_metrics = system().middleman().metric_singletons;
+  queue_.pending_messages = mm_metrics.pending_messages;
+  mm_metrics.deserialization_workers->value(static_cast<int64_t>(workers));
+  using string_list = std::vector<std::string>;
+  if (auto names = get_as<string_list>(config(), "caf.middleman.compression")) {
+    for (auto& name : *names) {
+      if (auto ptr = make_codec(name))
+        add_codec(std::move(ptr));
+      else
+        CAF_LOG_WARNING("unknown codec:" << name);
+    }
+  }
+  compression_threshold_ = get_or(config(),
+                                  "caf.middleman.compression-threshold",
+                                  defaults::middleman::compression_threshold);
+  presize_payloads_ = get_or(config(), "caf.middleman.presize-payloads",
+                             defaults::middleman::presize_payloads);
+  streaming_threshold_ = get_or(config(), "caf.middleman.streaming-threshold",
+                                defaults::middleman::streaming_threshold);
+  streaming_buffer_size_
+    = get_or(config(), "caf.middleman.streaming-buffer-size",
+             defaults::middleman::streaming_buffer_size);
+  max_payload_size_ = get_or(config(), "caf.middleman.max-payload-size",
+                             defaults::middleman::max_payload_size);
+  if (get_or(config(), "caf.middleman.node-aliases", false))
+    features_.emplace_back(to_string(node_aliases_feature));
+  if (get_or(config(), "caf.middleman.type-list-aliases", false))
+    features_.emplace_back(to_string(type_list_aliases_feature));
+  if (get_or(config(), "caf.middleman.compact-integers", false))
+    features_.emplace_back(to_string(compact_integers_feature));
+  // Only nodes with a tracing context can deserialize tracing data.
+  if (system().tracing_context() != nullptr)
+    features_.emplace_back(to_string(tracing_feature));
 }
 
 connection_state instance::handle(execution_unit* ctx, new_data_msg& dm,
@@ -47,16 +120,28 @@ connection_state instance::handle(execution_unit* ctx, new_data_msg& dm,
   auto err = [&](connection_state code) {
     if (auto nid = tbl_.erase_direct(dm.handle))
       callee_.purge_state(nid);
+    erase_connection_state(dm.handle);
     return code;
   };
   byte_buffer* payload = nullptr;
   if (is_payload) {
+    if (stream_for(dm.handle) != nullptr) {
+      auto next = handle_chunk(dm.handle, hdr, dm.buf);
+      return requires_shutdown(next) ? err(next) : next;
+    }
     payload = &dm.buf;
     if (payload->size() != hdr.payload_len) {
       CAF_LOG_WARNING("received invalid payload, expected"
                       << hdr.payload_len << "bytes, got" << payload->size());
       return err(malformed_basp_message);
     }
+    if (hdr.has(header::compressed_flag)) {
+      if (!decompress(dm.handle, hdr, *payload)) {
+        CAF_LOG_WARNING("received invalid compressed payload");
+        return err(malformed_basp_message);
+      }
+      payload = &decompressed_;
+    }
   } else {
     binary_deserializer source{ctx, dm.buf};
     if (!source.apply(hdr)) {
@@ -67,7 +152,16 @@ connection_state instance::handle(execution_unit* ctx, new_data_msg& dm,
       CAF_LOG_WARNING("received invalid header:" << CAF_ARG(hdr));
       return err(malformed_basp_message);
     }
+    if (hdr.payload_len > max_payload_size_) {
+      CAF_LOG_WARNING("received payload exceeds max-payload-size:"
+                      << CAF_ARG(hdr));
+      return err(malformed_basp_message);
+    }
     if (hdr.payload_len > 0) {
+      if (start_stream(ctx, dm.handle, hdr)) {
+        CAF_LOG_DEBUG("deserialize payload while receiving it");
+        return await_payload_chunk;
+      }
       CAF_LOG_DEBUG("await payload before processing further");
       return await_payload;
     }
@@ -93,12 +187,66 @@ void instance::flush(const routing_table::route& path) {
   callee_.flush(path.hdl);
 }
 
-void instance::write(execution_unit* ctx, const routing_table::route& r,
+bool instance::write(execution_unit* ctx, const routing_table::route& r,
                      header& hdr, payload_writer* writer) {
   CAF_LOG_TRACE(CAF_ARG(hdr));
   CAF_ASSERT(hdr.payload_len == 0 || writer != nullptr);
-  write(ctx, callee_.get_buffer(r.hdl), hdr, writer);
+  auto result = write_message(ctx, r.hdl, hdr, writer);
   flush(r);
+  return result;
+}
+
+void instance::add_codec(codec_ptr ptr) {
+  CAF_ASSERT(ptr != nullptr);
+  codecs_.emplace_back(std::move(ptr));
+}
+
+codec* instance::codec_for(connection_handle hdl) const noexcept {
+  auto i = connection_codecs_.find(hdl);
+  return i != connection_codecs_.end() ? i->second : nullptr;
+}
+
+instance::node_alias_table*
+instance::aliases_for(connection_handle hdl) noexcept {
+  auto i = connection_aliases_.find(hdl);
+  return i != connection_aliases_.end() ? &i->second : nullptr;
+}
+
+instance::type_list_alias_table*
+instance::type_lists_for(connection_handle hdl) noexcept {
+  auto i = connection_type_lists_.find(hdl);
+  return i != connection_type_lists_.end() ? &i->second : nullptr;
+}
+
+bool instance::compact_integers_for(connection_handle hdl) const noexcept {
+  return compact_connections_.count(hdl) > 0;
+}
+
+bool instance::tracing_for(connection_handle hdl) const noexcept {
+  return tracing_connections_.count(hdl) > 0;
+}
+
+instance::payload_stream* instance::stream_for(connection_handle hdl) noexcept {
+  auto i = streams_.find(hdl);
+  return i != streams_.end() ? i->second.get() : nullptr;
+}
+
+size_t instance::next_chunk_size(connection_handle hdl) noexcept {
+  auto stream = stream_for(hdl);
+  return stream != nullptr ? std::min(stream->pending, max_chunk_size) : 0;
+}
+
+void instance::erase_connection_state(connection_handle hdl) {
+  connection_codecs_.erase(hdl);
+  connection_aliases_.erase(hdl);
+  connection_type_lists_.erase(hdl);
+  compact_connections_.erase(hdl);
+  tracing_connections_.erase(hdl);
+  if (auto i = streams_.find(hdl); i != streams_.end()) {
+    // Release the position in the queue of the incomplete message.
+    queue_.drop(callee_.current_execution_unit(), i->second->msg_id);
+    streams_.erase(i);
+  }
 }
 
 void instance::add_published_actor(uint16_t port,
@@ -155,7 +303,8 @@ size_t instance::remove_published_actor(const actor_addr& whom, uint16_t port,
 bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                         const std::vector<strong_actor_ptr>& forwarding_stack,
                         const node_id& dest_node, uint64_t dest_actor,
-                        uint8_t flags, message_id mid, const message& msg) {
+                        uint8_t flags, message_id mid, const message& msg,
+                        const tracing_data* tracing) {
   CAF_LOG_TRACE(CAF_ARG(sender)
                 << CAF_ARG(dest_node) << CAF_ARG(mid) << CAF_ARG(msg));
   CAF_ASSERT(dest_node && this_node_ != dest_node);
@@ -164,17 +313,47 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
     return false;
   auto& source_node = sender ? sender->node() : this_node_;
   if (dest_node == path->next_hop && source_node == this_node_) {
+    auto type_lists = type_lists_for(path->hdl);
+    if (type_lists != nullptr)
+      flags |= header::type_alias_flag;
+    if (compact_integers_for(path->hdl))
+      flags |= header::compact_integers_flag;
+    if (tracing != nullptr && tracing_for(path->hdl))
+      flags |= header::tracing_flag;
+    else
+      tracing = nullptr;
+    // Writes the tracing data in front of the forwarding stack, if present.
+    auto write_tracing = [tracing](binary_serializer& sink) {
+      return tracing == nullptr || tracing->serialize(sink);
+    };
     header hdr{message_type::direct_message,
                flags,
                0,
                mid.integer_value(),
                sender ? sender->id() : invalid_actor_id,
                dest_actor};
-    auto writer = make_callback([&](binary_serializer& sink) { //
-      return sink.apply(forwarding_stack) && sink.apply(msg);
-    });
-    write(ctx, callee_.get_buffer(path->hdl), hdr, &writer);
+    if (type_lists == nullptr) {
+      auto writer = make_callback([&](binary_serializer& sink) {
+        return write_tracing(sink)              //
+               && sink.apply(forwarding_stack) //
+               && sink.apply(msg);
+      });
+      write_message(ctx, path->hdl, hdr, &writer);
+    } else {
+      auto writer = make_callback([&](binary_serializer& sink) {
+        return write_types(sink, *type_lists, msg.types()) //
+               && write_tracing(sink)                       //
+               && sink.apply(forwarding_stack)              //
+               && msg.save_values(sink);
+      });
+      auto num_type_lists = type_lists->outbound.size();
+      if (!write_message(ctx, path->hdl, hdr, &writer))
+        rollback_type_lists(type_lists, num_type_lists);
+    }
   } else {
+    auto aliases = aliases_for(path->hdl);
+    if (aliases != nullptr)
+      flags |= header::node_alias_flag;
     header hdr{message_type::routed_message,
                flags,
                0,
@@ -185,41 +364,51 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
       CAF_LOG_DEBUG("send routed message: "
                     << CAF_ARG(source_node) << CAF_ARG(dest_node)
                     << CAF_ARG(forwarding_stack) << CAF_ARG(msg));
-      return sink.apply(source_node)         //
-             && sink.apply(dest_node)        //
-             && sink.apply(forwarding_stack) //
+      return write_node(sink, aliases, source_node)  //
+             && write_node(sink, aliases, dest_node) //
+             && sink.apply(forwarding_stack)         //
              && sink.apply(msg);
     });
-    write(ctx, callee_.get_buffer(path->hdl), hdr, &writer);
+    auto num_aliases = aliases != nullptr ? aliases->outbound.size() : 0;
+    if (!write_message(ctx, path->hdl, hdr, &writer))
+      rollback_aliases(aliases, num_aliases);
   }
-  flush(*path);
+  callee_.schedule_flush(path->hdl);
   return true;
 }
 
-void instance::write(execution_unit* ctx, byte_buffer& buf, header& hdr,
-                     payload_writer* pw) {
+bool instance::write(execution_unit* ctx, byte_buffer& buf, header& hdr,
+                     payload_writer* pw, bool presize) {
   CAF_ASSERT(ctx != nullptr);
   CAF_LOG_TRACE(CAF_ARG(hdr));
   binary_serializer sink{ctx, buf};
+  sink.presize(presize);
   if (pw != nullptr) {
     // Write the BASP header after the payload.
     auto header_offset = buf.size();
     sink.skip(header_size);
+    sink.compact_integers(hdr.has(header::compact_integers_flag));
     auto& mm_metrics = ctx->system().middleman().metric_singletons;
     auto t0 = telemetry::timer::clock_type::now();
     if (!(*pw)(sink)) {
       CAF_LOG_ERROR(sink.get_error());
-      return;
+      buf.resize(header_offset);
+      return false;
     }
     telemetry::timer::observe(mm_metrics.serialization_time, t0);
+    // The BASP header always has a fixed size.
+    sink.compact_integers(false);
     sink.seek(header_offset);
     auto payload_len = buf.size() - (header_offset + basp::header_size);
     auto signed_payload_len = static_cast<uint32_t>(payload_len);
     mm_metrics.outbound_messages_size->observe(signed_payload_len);
     hdr.payload_len = static_cast<uint32_t>(payload_len);
   }
-  if (!sink.apply(hdr))
+  if (!sink.apply(hdr)) {
     CAF_LOG_ERROR(sink.get_error());
+    return false;
+  }
+  return true;
 }
 
 void instance::write_server_handshake(execution_unit* ctx, byte_buffer& out_buf,
@@ -247,10 +436,13 @@ void instance::write_server_handshake(execution_unit* ctx, byte_buffer& out_buf,
       aid = pa->first->id();
       iface = pa->second;
     }
+    auto codecs = codec_names();
     return sink.apply(this_node_) //
            && sink.apply(app_ids) //
            && sink.apply(aid)     //
-           && sink.apply(iface);
+           && sink.apply(iface)   //
+           && ((codecs.empty() && features_.empty()) || sink.apply(codecs))
+           && (features_.empty() || sink.apply(features_));
   });
   header hdr{message_type::server_handshake,
              0,
@@ -262,8 +454,11 @@ void instance::write_server_handshake(execution_unit* ctx, byte_buffer& out_buf,
 }
 
 void instance::write_client_handshake(execution_unit* ctx, byte_buffer& buf) {
-  auto writer = make_callback([&](binary_serializer& sink) { //
-    return sink.apply(this_node_);
+  auto writer = make_callback([&](binary_serializer& sink) {
+    auto codecs = codec_names();
+    return sink.apply(this_node_)
+           && ((codecs.empty() && features_.empty()) || sink.apply(codecs))
+           && (features_.empty() || sink.apply(features_));
   });
   header hdr{message_type::client_handshake,
              0,
@@ -325,10 +520,14 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       string_list app_ids;
       actor_id aid = invalid_actor_id;
       std::set<std::string> sigs;
+      string_list codecs;
+      string_list features;
       if (!source.apply(source_node) //
           || !source.apply(app_ids)  //
           || !source.apply(aid)      //
-          || !source.apply(sigs)) {
+          || !source.apply(sigs)     //
+          || (source.remaining() > 0 && !source.apply(codecs))
+          || (source.remaining() > 0 && !source.apply(features))) {
         CAF_LOG_WARNING("unable to deserialize payload of server handshake:"
                         << source.get_error());
         return serializing_basp_payload_failed;
@@ -363,6 +562,8 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       // Add direct route to this node and remove any indirect entry.
       CAF_LOG_DEBUG("new direct connection:" << CAF_ARG(source_node));
       tbl_.add_direct(hdl, source_node);
+      select_codec(hdl, codecs, codec_names());
+      select_features(hdl, features);
       auto was_indirect = tbl_.erase_indirect(source_node);
       // write handshake as client in response
       auto path = tbl_.lookup(source_node);
@@ -378,7 +579,11 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       // Deserialize payload.
       binary_deserializer source{ctx, *payload};
       node_id source_node;
-      if (!source.apply(source_node)) {
+      std::vector<std::string> codecs;
+      std::vector<std::string> features;
+      if (!source.apply(source_node)
+          || (source.remaining() > 0 && !source.apply(codecs))
+          || (source.remaining() > 0 && !source.apply(features))) {
         CAF_LOG_WARNING("unable to deserialize payload of client handshake:"
                         << source.get_error());
         return serializing_basp_payload_failed;
@@ -392,65 +597,72 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       // Add direct route to this node and remove any indirect entry.
       CAF_LOG_DEBUG("new direct connection:" << CAF_ARG(source_node));
       tbl_.add_direct(hdl, source_node);
+      select_codec(hdl, codec_names(), codecs);
+      select_features(hdl, features);
       auto was_indirect = tbl_.erase_indirect(source_node);
       callee_.learned_new_node_directly(source_node, was_indirect);
       break;
     }
-    case message_type::routed_message: {
-      // Deserialize payload.
-      binary_deserializer source{ctx, *payload};
-      node_id source_node;
-      node_id dest_node;
-      if (!source.apply(source_node) || !source.apply(dest_node)) {
-        CAF_LOG_WARNING(
-          "unable to deserialize source and destination for routed message:"
-          << source.get_error());
-        return serializing_basp_payload_failed;
+    case message_type::routed_message:
+    case message_type::direct_message: {
+      auto last_hop = tbl_.lookup_direct(hdl);
+      auto source_node = last_hop;
+      const_byte_span content{payload->data(), payload->size()};
+      if (hdr.operation == message_type::routed_message) {
+        // Deserialize source and destination node on this thread, since only
+        // the broker can resolve node aliases of this connection.
+        binary_deserializer source{ctx, *payload};
+        node_id dest_node;
+        if (!read_node(source, hdl, hdr, source_node)
+            || !read_node(source, hdl, hdr, dest_node)) {
+          CAF_LOG_WARNING(
+            "unable to deserialize source and destination for routed message:"
+            << source.get_error());
+          return serializing_basp_payload_failed;
+        }
+        content = content.subspan(payload->size() - source.remaining());
+        if (dest_node != this_node_) {
+          forward(ctx, source_node, dest_node, hdr, content);
+          return await_header;
+        }
+        if (source_node != none && source_node != this_node_
+            && last_hop != source_node
+            && tbl_.add_indirect(last_hop, source_node))
+          callee_.learned_new_node_indirectly(source_node);
       }
-      if (dest_node != this_node_) {
-        forward(ctx, dest_node, hdr, *payload);
-        return await_header;
+      // Resolve type list aliases on this thread as well, since aliases may
+      // refer to definitions in previous messages on this connection.
+      auto types = make_type_id_list();
+      if (hdr.has(header::type_alias_flag)) {
+        binary_deserializer source{ctx, content};
+        source.compact_integers(hdr.has(header::compact_integers_flag));
+        if (hdr.operation != message_type::direct_message
+            || !read_types(source, hdl, types)) {
+          CAF_LOG_WARNING("unable to resolve type list alias:"
+                          << source.get_error());
+          return serializing_basp_payload_failed;
+        }
+        content = content.subspan(content.size() - source.remaining());
       }
-      auto last_hop = tbl_.lookup_direct(hdl);
-      if (source_node != none && source_node != this_node_
-          && last_hop != source_node
-          && tbl_.add_indirect(last_hop, source_node))
-        callee_.learned_new_node_indirectly(source_node);
-    }
-    // fall through
-    case message_type::direct_message: {
       auto worker = hub_.pop();
-      auto last_hop = tbl_.lookup_direct(hdl);
       if (worker != nullptr) {
         CAF_LOG_DEBUG("launch BASP worker for deserializing a"
                       << hdr.operation);
-        worker->launch(last_hop, hdr, *payload);
+        worker->launch(last_hop, source_node, hdr, content, types);
       } else {
         CAF_LOG_DEBUG("out of BASP workers, continue deserializing a"
                       << hdr.operation);
         // If no worker is available then we have no other choice than to take
         // the performance hit and deserialize in this thread.
-        struct handler : remote_message_handler<handler> {
-          handler(message_queue* queue, proxy_registry* proxies,
-                  actor_system* system, node_id last_hop, basp::header& hdr,
-                  byte_buffer& payload)
-            : queue_(queue),
-              proxies_(proxies),
-              system_(system),
-              last_hop_(std::move(last_hop)),
-              hdr_(hdr),
-              payload_(payload) {
-            msg_id_ = queue_->new_id();
-          }
-          message_queue* queue_;
-          proxy_registry* proxies_;
-          actor_system* system_;
-          node_id last_hop_;
-          basp::header& hdr_;
-          byte_buffer& payload_;
-          uint64_t msg_id_;
-        };
-        handler f{&queue_, &proxies(), &system(), last_hop, hdr, *payload};
+        handler f{&queue_,
+                  &proxies(),
+                  &system(),
+                  std::move(last_hop),
+                  std::move(source_node),
+                  hdr,
+                  content,
+                  types,
+                  queue_.new_id(hdr.dest_actor)};
         f.handle_remote_message(callee_.current_execution_unit());
       }
       break;
@@ -460,15 +672,19 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       binary_deserializer source{ctx, *payload};
       node_id source_node;
       node_id dest_node;
-      if (!source.apply(source_node) || !source.apply(dest_node)) {
+      if (!read_node(source, hdl, hdr, source_node)
+          || !read_node(source, hdl, hdr, dest_node)) {
         CAF_LOG_WARNING("unable to deserialize payload of monitor message:"
                         << source.get_error());
         return serializing_basp_payload_failed;
       }
-      if (dest_node == this_node_)
+      if (dest_node == this_node_) {
         callee_.proxy_announced(source_node, hdr.dest_actor);
-      else
-        forward(ctx, dest_node, hdr, *payload);
+      } else {
+        auto content = make_span(*payload).subspan(payload->size()
+                                                   - source.remaining());
+        forward(ctx, source_node, dest_node, hdr, content);
+      }
       break;
     }
     case message_type::down_message: {
@@ -477,24 +693,29 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       node_id source_node;
       node_id dest_node;
       error fail_state;
-      if (!source.apply(source_node)  //
-          || !source.apply(dest_node) //
-          || !source.apply(fail_state)) {
+      if (!read_node(source, hdl, hdr, source_node)
+          || !read_node(source, hdl, hdr, dest_node)) {
+        CAF_LOG_WARNING("unable to deserialize payload of down message:"
+                        << source.get_error());
+        return serializing_basp_payload_failed;
+      }
+      auto nodes_size = payload->size() - source.remaining();
+      if (!source.apply(fail_state)) {
         CAF_LOG_WARNING("unable to deserialize payload of down message:"
                         << source.get_error());
         return serializing_basp_payload_failed;
       }
       if (dest_node == this_node_) {
         // Delay this message to make sure we don't skip in-flight messages.
-        auto msg_id = queue_.new_id();
         auto ptr = make_mailbox_element(nullptr, make_message_id(), {},
                                         delete_atom_v, source_node,
                                         hdr.source_actor,
                                         std::move(fail_state));
-        queue_.push(callee_.current_execution_unit(), msg_id,
-                    callee_.this_actor(), std::move(ptr));
+        queue_.push_barrier(callee_.current_execution_unit(),
+                            callee_.this_actor(), std::move(ptr));
       } else {
-        forward(ctx, dest_node, hdr, *payload);
+        auto content = make_span(*payload).subspan(nodes_size);
+        forward(ctx, source_node, dest_node, hdr, content);
       }
       break;
     }
@@ -511,21 +732,445 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
   return await_header;
 }
 
-void instance::forward(execution_unit* ctx, const node_id& dest_node,
-                       const header& hdr, byte_buffer& payload) {
-  CAF_LOG_TRACE(CAF_ARG(dest_node) << CAF_ARG(hdr) << CAF_ARG(payload));
+void instance::forward(execution_unit* ctx, const node_id& source_node,
+                       const node_id& dest_node, const header& hdr,
+                       const_byte_span payload) {
+  CAF_LOG_TRACE(CAF_ARG(source_node) << CAF_ARG(dest_node) << CAF_ARG(hdr));
   auto path = lookup(dest_node);
-  if (path) {
-    binary_serializer sink{ctx, callee_.get_buffer(path->hdl)};
-    if (!sink.apply(hdr)) {
-      CAF_LOG_ERROR("unable to serialize BASP header:" << sink.get_error());
+  if (!path) {
+    CAF_LOG_WARNING("cannot forward message, no route to destination");
+    return;
+  }
+  // Node aliases are connection-local. Hence, we need to re-encode source and
+  // destination for the next hop.
+  node_alias_table* aliases = nullptr;
+  auto out_hdr = hdr;
+  out_hdr.flags &= ~header::node_alias_flag;
+  if (hdr.operation == message_type::routed_message) {
+    aliases = aliases_for(path->hdl);
+    if (aliases != nullptr)
+      out_hdr.flags |= header::node_alias_flag;
+  }
+  auto& buf = callee_.get_buffer(path->hdl);
+  auto offset = buf.size();
+  auto num_aliases = aliases != nullptr ? aliases->outbound.size() : 0;
+  binary_serializer sink{ctx, buf};
+  sink.skip(header_size);
+  if (!write_node(sink, aliases, source_node)
+      || !write_node(sink, aliases, dest_node)) {
+    CAF_LOG_ERROR("unable to serialize forwarded nodes:" << sink.get_error());
+    rollback_aliases(aliases, num_aliases);
+    buf.resize(offset);
+    return;
+  }
+  sink.value(payload);
+  out_hdr.payload_len = static_cast<uint32_t>(buf.size() - offset
+                                              - header_size);
+  sink.seek(offset);
+  if (!sink.apply(out_hdr)) {
+    CAF_LOG_ERROR("unable to serialize BASP header:" << sink.get_error());
+    rollback_aliases(aliases, num_aliases);
+    buf.resize(offset);
+    return;
+  }
+  compress(ctx, path->hdl, buf, offset, out_hdr);
+  flush(*path);
+}
+
+bool instance::write_message(execution_unit* ctx, connection_handle hdl,
+                             header& hdr, payload_writer* writer) {
+  auto& buf = callee_.get_buffer(hdl);
+  auto offset = buf.size();
+  if (!write(ctx, buf, hdr, writer, presize_payloads_))
+    return false;
+  compress(ctx, hdl, buf, offset, hdr);
+  return true;
+}
+
+bool instance::read_node(binary_deserializer& source, connection_handle hdl,
+                         const header& hdr, node_id& x) {
+  if (!hdr.has(header::node_alias_flag))
+    return read_interned(source, x);
+  auto aliases = aliases_for(hdl);
+  if (aliases == nullptr) {
+    source.emplace_error(sec::malformed_basp_message,
+                         "received node alias on a connection without aliases");
+    return false;
+  }
+  uint32_t tag = 0;
+  if (!source.apply(tag))
+    return false;
+  auto& inbound = aliases->inbound;
+  if (tag == 0)
+    return read_interned(source, x);
+  if ((tag & alias_definition_bit) == 0) {
+    if (tag > inbound.size()) {
+      source.emplace_error(sec::malformed_basp_message, "unknown node alias");
+      return false;
+    }
+    x = inbound[tag - 1];
+    return true;
+  }
+  // Aliases are consecutive, because the sender never skips an alias.
+  auto alias = tag & ~alias_definition_bit;
+  if (alias != inbound.size() + 1 || alias > max_node_aliases) {
+    source.emplace_error(sec::malformed_basp_message, "invalid node alias");
+    return false;
+  }
+  if (!read_interned(source, x))
+    return false;
+  inbound.emplace_back(x);
+  return true;
+}
+
+bool instance::write_node(binary_serializer& sink, node_alias_table* aliases,
+                          const node_id& x) {
+  if (aliases == nullptr)
+    return sink.apply(x);
+  auto& outbound = aliases->outbound;
+  if (auto i = outbound.find(x); i != outbound.end())
+    return sink.apply(i->second);
+  if (outbound.size() >= max_node_aliases)
+    return sink.apply(uint32_t{0}) && sink.apply(x);
+  auto alias = static_cast<uint32_t>(outbound.size() + 1);
+  outbound.emplace(x, alias);
+  return sink.apply(alias | alias_definition_bit) && sink.apply(x);
+}
+
+void instance::rollback_aliases(node_alias_table* aliases, size_t size) {
+  if (aliases == nullptr)
+    return;
+  auto& outbound = aliases->outbound;
+  for (auto i = outbound.begin(); i != outbound.end();) {
+    if (i->second > size)
+      i = outbound.erase(i);
+    else
+      ++i;
+  }
+}
+
+bool instance::start_stream(execution_unit* ctx, connection_handle hdl,
+                            const header& hdr) {
+  // Routed messages and compressed payloads require the entire payload.
+  if (streaming_threshold_ == 0 || hdr.payload_len < streaming_threshold_
+      || hdr.operation != message_type::direct_message
+      || hdr.has(header::compressed_flag) || tbl_.lookup_direct(hdl) == none)
+    return false;
+  auto stream = std::make_unique<payload_stream>(ctx, streaming_buffer_size_);
+  stream->pending = hdr.payload_len;
+  stream->source.compact_integers(hdr.has(header::compact_integers_flag));
+  // Reserve the position of the message now. Otherwise, messages that arrive
+  // later but finish first could overtake it.
+  stream->msg_id = queue_.new_id(hdr.dest_actor);
+  streams_[hdl] = std::move(stream);
+  return true;
+}
+
+connection_state instance::handle_chunk(connection_handle hdl, header& hdr,
+                                        const byte_buffer& chunk) {
+  using load_result = incremental_binary_deserializer::load_result;
+  auto& stream = *stream_for(hdl);
+  if (chunk.size() > stream.pending) {
+    CAF_LOG_WARNING("received more bytes than the payload size");
+    return malformed_basp_message;
+  }
+  stream.pending -= chunk.size();
+  stream.source.append(chunk);
+  if (stream.pending == 0)
+    stream.source.close();
+  switch (advance(hdl, hdr, stream)) {
+    case load_result::incomplete:
+      return await_payload_chunk;
+    case load_result::failed:
+      CAF_LOG_WARNING("unable to deserialize payload:"
+                      << stream.source.get_error());
+      return serializing_basp_payload_failed;
+    default:
+      break;
+  }
+  if (stream.pending > 0 || stream.source.buffered() > 0) {
+    CAF_LOG_WARNING("payload contains trailing bytes");
+    return malformed_basp_message;
+  }
+  auto tracing = std::move(stream.tracing);
+  auto stages = std::move(stream.stages);
+  auto content = std::move(stream.content);
+  auto msg_id = stream.msg_id;
+  streams_.erase(hdl);
+  auto last_hop = tbl_.lookup_direct(hdl);
+  handler f{&queue_,
+            &proxies(),
+            &system(),
+            last_hop,
+            last_hop,
+            hdr,
+            const_byte_span{},
+            make_type_id_list(),
+            msg_id};
+  f.handle_remote_message(callee_.current_execution_unit(), std::move(tracing),
+                          std::move(stages), std::move(content));
+  return await_header;
+}
+
+incremental_binary_deserializer::load_result
+instance::advance(connection_handle hdl, const header& hdr,
+                  payload_stream& stream) {
+  using load_result = incremental_binary_deserializer::load_result;
+  auto& source = stream.source;
+  auto with_types = hdr.has(header::type_alias_flag);
+  if (with_types && !stream.has_types) {
+    auto res = source.apply_fn([this, hdl, &stream](binary_deserializer& f) {
+      return read_types(f, hdl, stream.types);
+    });
+    if (res != load_result::done)
+      return res;
+    stream.has_types = true;
+  }
+  if (hdr.has(header::tracing_flag) && !stream.has_tracing) {
+    auto res = source.apply_fn([this, &stream](binary_deserializer& f) {
+      return read_tracing_data(system(), f, stream.tracing);
+    });
+    if (res != load_result::done)
+      return res;
+    stream.has_tracing = true;
+  }
+  if (!stream.has_stages) {
+    auto res = source.load(stream.stages);
+    if (res != load_result::done)
+      return res;
+    stream.has_stages = true;
+  }
+  return with_types ? source.load_values(stream.content, stream.types)
+                    : source.load(stream.content);
+}
+
+bool read_tracing_data(actor_system& sys, binary_deserializer& source,
+                       tracing_data_ptr& x) {
+  auto tc = sys.tracing_context();
+  if (tc == nullptr) {
+    source.emplace_error(sec::no_tracing_context,
+                         "received tracing data without tracing context");
+    return false;
+  }
+  return tc->deserialize(source, x);
+}
+
+bool instance::read_types(binary_deserializer& source, connection_handle hdl,
+                          type_id_list& types) {
+  auto type_lists = type_lists_for(hdl);
+  if (type_lists == nullptr) {
+    source.emplace_error(sec::malformed_basp_message,
+                         "received type list alias on a connection without "
+                         "type list aliases");
+    return false;
+  }
+  uint32_t tag = 0;
+  if (!source.apply(tag))
+    return false;
+  auto& inbound = type_lists->inbound;
+  auto read_list = [&source, &types] {
+    auto size = size_t{0};
+    if (!source.begin_sequence(size))
+      return false;
+    // Check the size before allocating any memory. Compact integers occupy
+    // at least one byte.
+    auto min_size = source.compact_integers() ? size_t{1} : sizeof(type_id_t);
+    if (size > source.remaining() / min_size) {
+      source.emplace_error(sec::malformed_basp_message,
+                           "type list exceeds the remaining payload");
+      return false;
+    }
+    detail::type_id_list_builder builder;
+    builder.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      auto id = type_id_t{0};
+      if (!source.value(id))
+        return false;
+      builder.push_back(id);
+    }
+    types = builder.move_to_list();
+    return source.end_sequence();
+  };
+  if (tag == 0)
+    return read_list();
+  if ((tag & alias_definition_bit) == 0) {
+    if (tag > inbound.size()) {
+      source.emplace_error(sec::malformed_basp_message,
+                           "unknown type list alias");
+      return false;
+    }
+    types = inbound[tag - 1];
+    return true;
+  }
+  // Aliases are consecutive, because the sender never skips an alias.
+  auto alias = tag & ~alias_definition_bit;
+  if (alias != inbound.size() + 1 || alias > max_type_list_aliases) {
+    source.emplace_error(sec::malformed_basp_message,
+                         "invalid type list alias");
+    return false;
+  }
+  if (!read_list())
+    return false;
+  inbound.emplace_back(types);
+  return true;
+}
+
+bool instance::write_types(binary_serializer& sink,
+                           type_list_alias_table& type_lists,
+                           type_id_list types) {
+  auto write_list = [&sink, types] {
+    if (!sink.begin_sequence(types.size()))
+      return false;
+    for (auto id : types)
+      if (!sink.value(id))
+        return false;
+    return sink.end_sequence();
+  };
+  auto& outbound = type_lists.outbound;
+  if (auto i = outbound.find(types.data()); i != outbound.end())
+    return sink.apply(i->second);
+  if (outbound.size() >= max_type_list_aliases)
+    return sink.apply(uint32_t{0}) && write_list();
+  auto alias = static_cast<uint32_t>(outbound.size() + 1);
+  outbound.emplace(types.data(), alias);
+  return sink.apply(alias | alias_definition_bit) && write_list();
+}
+
+void instance::rollback_type_lists(type_list_alias_table* type_lists,
+                                   size_t size) {
+  if (type_lists == nullptr)
+    return;
+  auto& outbound = type_lists->outbound;
+  for (auto i = outbound.begin(); i != outbound.end();) {
+    if (i->second > size)
+      i = outbound.erase(i);
+    else
+      ++i;
+  }
+}
+
+bool instance::read_interned(binary_deserializer& source, node_id& x) {
+  // Deserializing into the scratch object re-uses its node data as long as
+  // nobody else holds a reference to it.
+  if (!source.apply(scratch_node_))
+    return false;
+  if (!scratch_node_) {
+    x = none;
+    return true;
+  }
+  if (auto i = known_nodes_.find(scratch_node_); i != known_nodes_.end()) {
+    x = *i;
+    return true;
+  }
+  if (known_nodes_.size() >= max_cached_nodes)
+    known_nodes_.clear();
+  auto copy = [](const auto& content) { return node_id{content}; };
+  x = *known_nodes_.emplace(visit(copy, scratch_node_->content)).first;
+  return true;
+}
+
+void instance::select_features(
+  connection_handle hdl, const std::vector<std::string>& remote_features) {
+  auto supports = [&](string_view name) {
+    auto has_name = [name](const std::string& x) { return x == name; };
+    return std::any_of(features_.begin(), features_.end(), has_name)
+           && std::any_of(remote_features.begin(), remote_features.end(),
+                          has_name);
+  };
+  if (supports(node_aliases_feature)) {
+    CAF_LOG_DEBUG("use node aliases" << CAF_ARG(hdl));
+    connection_aliases_[hdl];
+  }
+  if (supports(type_list_aliases_feature)) {
+    CAF_LOG_DEBUG("use type list aliases" << CAF_ARG(hdl));
+    connection_type_lists_[hdl];
+  }
+  if (supports(compact_integers_feature)) {
+    CAF_LOG_DEBUG("use compact integers" << CAF_ARG(hdl));
+    compact_connections_.emplace(hdl);
+  }
+  if (supports(tracing_feature)) {
+    CAF_LOG_DEBUG("use tracing" << CAF_ARG(hdl));
+    tracing_connections_.emplace(hdl);
+  }
+}
+
+void instance::compress(execution_unit* ctx, connection_handle hdl,
+                        byte_buffer& buf, size_t offset, header& hdr) {
+  auto impl = codec_for(hdl);
+  if (impl == nullptr || hdr.payload_len < compression_threshold_
+      || hdr.has(header::compressed_flag)
+      || (hdr.operation != message_type::direct_message
+          && hdr.operation != message_type::routed_message))
+    return;
+  auto payload_offset = offset + header_size;
+  if (buf.size() != payload_offset + hdr.payload_len)
+    return;
+  auto& mm_metrics = system().middleman().metric_singletons;
+  auto t0 = telemetry::timer::clock_type::now();
+  compressed_.clear();
+  const_byte_span payload{buf.data() + payload_offset, hdr.payload_len};
+  if (!impl->compress(payload, compressed_)) {
+    CAF_LOG_WARNING("failed to compress payload with codec" << impl->name());
+    return;
+  }
+  telemetry::timer::observe(mm_metrics.compression_time, t0);
+  mm_metrics.compression_ratio->observe(static_cast<double>(compressed_.size())
+                                        / hdr.payload_len);
+  // Send the original payload if compressing it does not pay off.
+  if (compressed_.size() >= hdr.payload_len)
+    return;
+  buf.resize(payload_offset);
+  buf.insert(buf.end(), compressed_.begin(), compressed_.end());
+  hdr.flags |= header::compressed_flag;
+  hdr.payload_len = static_cast<uint32_t>(compressed_.size());
+  binary_serializer sink{ctx, buf};
+  sink.seek(offset);
+  if (!sink.apply(hdr))
+    CAF_LOG_ERROR(sink.get_error());
+}
+
+bool instance::decompress(connection_handle hdl, header& hdr,
+                          const byte_buffer& payload) {
+  auto impl = codec_for(hdl);
+  if (impl == nullptr)
+    return false;
+  auto& mm_metrics = system().middleman().metric_singletons;
+  auto t0 = telemetry::timer::clock_type::now();
+  decompressed_.clear();
+  const_byte_span input{payload.data(), payload.size()};
+  if (!impl->decompress(input, decompressed_,
+                        std::min(max_payload_size_,
+                                 size_t{std::numeric_limits<uint32_t>::max()})))
+    return false;
+  telemetry::timer::observe(mm_metrics.decompression_time, t0);
+  hdr.flags &= ~header::compressed_flag;
+  hdr.payload_len = static_cast<uint32_t>(decompressed_.size());
+  return true;
+}
+
+void instance::select_codec(connection_handle hdl,
+                            const std::vector<std::string>& server_codecs,
+                            const std::vector<std::string>& client_codecs) {
+  for (auto& name : server_codecs) {
+    if (std::find(client_codecs.begin(), client_codecs.end(), name)
+        == client_codecs.end())
+      continue;
+    auto pred = [&](const codec_ptr& ptr) { return ptr->name() == name; };
+    auto i = std::find_if(codecs_.begin(), codecs_.end(), pred);
+    if (i != codecs_.end()) {
+      CAF_LOG_DEBUG("compress payloads with codec" << name << CAF_ARG(hdl));
+      connection_codecs_[hdl] = i->get();
       return;
     }
-    sink.value(span<const byte>{payload.data(), payload.size()});
-    flush(*path);
-  } else {
-    CAF_LOG_WARNING("cannot forward message, no route to destination");
   }
 }
 
+std::vector<std::string> instance::codec_names() const {
+  std::vector<std::string> result;
+  for (auto& ptr : codecs_)
+    result.emplace_back(to_string(ptr->name()));
+  return result;
+}
+
 } // namespace caf::io::basp
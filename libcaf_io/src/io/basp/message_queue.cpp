@@ -4,56 +4,90 @@
 
 #include "caf/io/basp/message_queue.hpp"
 
+#include <algorithm>
 #include <iterator>
 
+#include "caf/telemetry/int_gauge.hpp"
+
 namespace caf::io::basp {
 
-message_queue::message_queue() : next_id(0), next_undelivered(0) {
+message_queue::message_queue() {
   // nop
 }
 
 void message_queue::push(execution_unit* ctx, uint64_t id,
                          strong_actor_ptr receiver,
                          mailbox_element_ptr content) {
-  std::unique_lock<std::mutex> guard{lock};
-  CAF_ASSERT(id >= next_undelivered);
-  CAF_ASSERT(id < next_id);
-  auto first = pending.begin();
-  auto last = pending.end();
-  if (id == next_undelivered) {
+  auto& seq = sequencers[id & (num_sequencers - 1)];
+  std::unique_lock<std::mutex> guard{seq.lock};
+  push_impl(ctx, seq,
+            actor_msg{id >> sequencer_bits, std::move(receiver),
+                      std::move(content), nullptr});
+}
+
+void message_queue::drop(execution_unit* ctx, uint64_t id) {
+  push(ctx, id, nullptr, nullptr);
+}
+
+void message_queue::push_barrier(execution_unit* ctx, strong_actor_ptr receiver,
+                                 mailbox_element_ptr content) {
+  auto sync = std::make_shared<barrier>(std::move(receiver),
+                                        std::move(content));
+  for (auto& seq : sequencers) {
+    std::unique_lock<std::mutex> guard{seq.lock};
+    auto id = seq.next_id++;
+    push_impl(ctx, seq, actor_msg{id, nullptr, nullptr, sync});
+  }
+}
+
+uint64_t message_queue::new_id(actor_id receiver) {
+  auto index = sequencer_index(receiver);
+  auto& seq = sequencers[index];
+  std::unique_lock<std::mutex> guard{seq.lock};
+  return (seq.next_id++ << sequencer_bits) | index;
+}
+
+void message_queue::push_impl(execution_unit* ctx, sequencer& seq,
+                              actor_msg msg) {
+  CAF_ASSERT(msg.id >= seq.next_undelivered);
+  CAF_ASSERT(msg.id < seq.next_id);
+  auto first = seq.pending.begin();
+  auto last = seq.pending.end();
+  if (msg.id == seq.next_undelivered) {
     // Dispatch current head.
-    if (receiver != nullptr)
-      receiver->enqueue(std::move(content), ctx);
-    auto next = id + 1;
+    deliver(ctx, msg);
+    auto next = msg.id + 1;
     // Check whether we can deliver more.
     if (first == last || first->id != next) {
-      next_undelivered = next;
-      CAF_ASSERT(next_undelivered <= next_id);
+      seq.next_undelivered = next;
+      CAF_ASSERT(seq.next_undelivered <= seq.next_id);
       return;
     }
     // Deliver everything until reaching a non-consecutive ID or the end.
     auto i = first;
     for (; i != last && i->id == next; ++i, ++next)
-      if (i->receiver != nullptr)
-        i->receiver->enqueue(std::move(i->content), ctx);
-    next_undelivered = next;
-    pending.erase(first, i);
-    CAF_ASSERT(next_undelivered <= next_id);
+      deliver(ctx, *i);
+    seq.next_undelivered = next;
+    if (pending_messages != nullptr)
+      pending_messages->dec(static_cast<int64_t>(std::distance(first, i)));
+    seq.pending.erase(first, i);
+    CAF_ASSERT(seq.next_undelivered <= seq.next_id);
     return;
   }
   // Get the insertion point.
-  auto pred = [&](const actor_msg& x) { return x.id >= id; };
-  pending.emplace(std::find_if(first, last, pred),
-                  actor_msg{id, std::move(receiver), std::move(content)});
-}
-
-void message_queue::drop(execution_unit* ctx, uint64_t id) {
-  push(ctx, id, nullptr, nullptr);
+  auto pred = [&](const actor_msg& x) { return x.id >= msg.id; };
+  seq.pending.emplace(std::find_if(first, last, pred), std::move(msg));
+  if (pending_messages != nullptr)
+    pending_messages->inc();
 }
 
-uint64_t message_queue::new_id() {
-  std::unique_lock<std::mutex> guard{lock};
-  return next_id++;
+void message_queue::deliver(execution_unit* ctx, actor_msg& msg) {
+  if (msg.sync != nullptr) {
+    if (--msg.sync->pending == 0 && msg.sync->receiver != nullptr)
+      msg.sync->receiver->enqueue(std::move(msg.sync->content), ctx);
+  } else if (msg.receiver != nullptr) {
+    msg.receiver->enqueue(std::move(msg.content), ctx);
+  }
 }
 
 } // namespace caf::io::basp
@@ -6,6 +6,7 @@
 
 #include "caf/actor_system.hpp"
 #include "caf/io/basp/message_queue.hpp"
+#include "caf/make_counted.hpp"
 #include "caf/proxy_registry.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
 
@@ -14,7 +15,11 @@ namespace caf::io::basp {
 // -- constructors, destructors, and assignment operators ----------------------
 
 worker::worker(hub_type& hub, message_queue& queue, proxy_registry& proxies)
-  : hub_(&hub), queue_(&queue), proxies_(&proxies), system_(&proxies.system()) {
+  : hub_(&hub),
+    queue_(&queue),
+    proxies_(&proxies),
+    system_(&proxies.system()),
+    types_(make_type_id_list()) {
   CAF_IGNORE_UNUSED(pad_);
 }
 
@@ -24,15 +29,21 @@ worker::~worker() {
 
 // -- management ---------------------------------------------------------------
 
-void worker::launch(const node_id& last_hop, const basp::header& hdr,
-                    const byte_buffer& payload) {
+void worker::launch(const node_id& last_hop, const node_id& source_node,
+                    const basp::header& hdr, const_byte_span payload,
+                    type_id_list types) {
   CAF_ASSERT(hdr.dest_actor != 0);
   CAF_ASSERT(hdr.operation == basp::message_type::direct_message
              || hdr.operation == basp::message_type::routed_message);
-  msg_id_ = queue_->new_id();
+  msg_id_ = queue_->new_id(hdr.dest_actor);
   last_hop_ = last_hop;
+  source_node_ = source_node;
   memcpy(&hdr_, &hdr, sizeof(basp::header));
-  payload_.assign(payload.begin(), payload.end());
+  types_ = types;
+  if (payload_owner_ == nullptr || !payload_owner_->unique())
+    payload_owner_ = make_counted<shared_byte_buffer>();
+  payload_owner_->bytes.assign(payload.begin(), payload.end());
+  payload_ = make_span(payload_owner_->bytes);
   ref();
   system_->scheduler().enqueue(this);
 }
@@ -41,7 +52,9 @@ void worker::launch(const node_id& last_hop, const basp::header& hdr,
 
 resumable::resume_result worker::resume(execution_unit* ctx, size_t) {
   ctx->proxy_registry_ptr(proxies_);
+  proxy_registry::set_local_cache(&proxy_cache_);
   handle_remote_message(ctx);
+  proxy_registry::set_local_cache(nullptr);
   hub_->push(this);
   return resumable::awaiting_message;
 }
@@ -4,6 +4,7 @@
 
 #include "caf/io/basp_broker.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <limits>
 
@@ -19,6 +20,7 @@
 #include "caf/io/middleman.hpp"
 #include "caf/io/network/interfaces.hpp"
 #include "caf/logger.hpp"
+#include "caf/mailbox_element.hpp"
 #include "caf/make_counted.hpp"
 #include "caf/sec.hpp"
 #include "caf/send.hpp"
@@ -36,6 +38,16 @@ THREAD_LOCAL caf::node_id* t_last_hop = nullptr;
 
 #undef THREAD_LOCAL
 
+// Returns the tracing data of the message that the broker currently handles.
+const caf::tracing_data*
+tracing_data_of([[maybe_unused]] const caf::mailbox_element* x) {
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+  return x != nullptr ? x->tracing_id.get() : nullptr;
+#else
+  return nullptr;
+#endif // CAF_ENABLE_ACTOR_PROFILER
+}
+
 } // namespace
 
 namespace caf::io {
@@ -49,6 +61,10 @@ basp_broker::basp_broker(actor_config& cfg)
     this_context(nullptr) {
   new (&instance) basp::instance(this, *this);
   CAF_ASSERT(this_node() != none);
+  output_batch_size = get_or(config(), "caf.middleman.output-batch-size",
+                             defaults::middleman::output_batch_size);
+  output_batch_delay = get_or(config(), "caf.middleman.output-batch-delay",
+                              defaults::middleman::output_batch_delay);
 }
 
 basp_broker::~basp_broker() {
@@ -129,13 +145,18 @@ behavior basp_broker::make_behavior() {
       set_context(msg.handle);
       auto& ctx = *this_context;
       auto next = instance.handle(context(), msg, ctx.hdr,
-                                  ctx.cstate == basp::await_payload);
+                                  ctx.cstate != basp::await_header);
       if (requires_shutdown(next)) {
         connection_cleanup(msg.handle, to_sec(next));
         close(msg.handle);
         return;
       }
-      if (next != ctx.cstate) {
+      if (next == basp::await_payload_chunk) {
+        // Never read beyond the payload, since the next header follows.
+        auto rd_size = instance.next_chunk_size(msg.handle);
+        configure_read(msg.handle, receive_policy::at_most(rd_size));
+        ctx.cstate = next;
+      } else if (next != ctx.cstate) {
         auto rd_size = next == basp::await_payload ? ctx.hdr.payload_len
                                                    : basp::header_size;
         configure_read(msg.handle, receive_policy::exactly(rd_size));
@@ -157,7 +178,8 @@ behavior basp_broker::make_behavior() {
       if (src && system().node() == src->node())
         system().registry().put(src->id(), src);
       if (!instance.dispatch(context(), src, fwd_stack, dest->node(),
-                             dest->id(), 0, mid, msg)
+                             dest->id(), 0, mid, msg,
+                             tracing_data_of(current_mailbox_element()))
           && mid.is_request()) {
         detail::sync_request_bouncer srb{exit_reason::remote_link_unreachable};
         srb(src, mid);
@@ -176,8 +198,8 @@ behavior basp_broker::make_behavior() {
       if (system().node() == sender->node())
         system().registry().put(sender->id(), sender);
       if (!instance.dispatch(context(), sender, cme->stages, dest_node, dest_id,
-                             basp::header::named_receiver_flag, cme->mid,
-                             msg)) {
+                             basp::header::named_receiver_flag, cme->mid, msg,
+                             tracing_data_of(cme))) {
         detail::sync_request_bouncer srb{exit_reason::remote_link_unreachable};
         srb(sender, cme->mid);
       }
@@ -258,14 +280,13 @@ behavior basp_broker::make_behavior() {
       CAF_LOG_TRACE(CAF_ARG(msg.handle));
       // We might still have pending messages from this connection. To
       // make sure there's no BASP worker deserializing a message, we are
-      // sending us a message through the queue. This message gets
-      // delivered only after all received messages up to this point were
-      // deserialized and delivered.
-      auto& q = instance.queue();
-      auto msg_id = q.new_id();
-      q.push(context(), msg_id, ctrl(),
-             make_mailbox_element(nullptr, make_message_id(), {}, delete_atom_v,
-                                  msg.handle));
+      // sending us a message through the queue as a barrier. This message
+      // gets delivered only after all received messages up to this point
+      // were deserialized and delivered.
+      instance.queue().push_barrier(
+        context(), ctrl(),
+        make_mailbox_element(nullptr, make_message_id(), {}, delete_atom_v,
+                             msg.handle));
     },
     // received from the message handler above for connection_closed_msg
     [=](delete_atom, connection_handle hdl) {
@@ -275,11 +296,10 @@ behavior basp_broker::make_behavior() {
     [=](const acceptor_closed_msg& msg) {
       CAF_LOG_TRACE("");
       // Same reasoning as in connection_closed_msg.
-      auto& q = instance.queue();
-      auto msg_id = q.new_id();
-      q.push(context(), msg_id, ctrl(),
-             make_mailbox_element(nullptr, make_message_id(), {}, delete_atom_v,
-                                  msg.handle));
+      instance.queue().push_barrier(
+        context(), ctrl(),
+        make_mailbox_element(nullptr, make_message_id(), {}, delete_atom_v,
+                             msg.handle));
     },
     // received from the message handler above for acceptor_closed_msg
     [=](delete_atom, accept_handle hdl) {
@@ -424,8 +444,12 @@ proxy_registry* basp_broker::proxy_registry_ptr() {
 
 resumable::resume_result basp_broker::resume(execution_unit* ctx, size_t mt) {
   ctx->proxy_registry_ptr(&instance.proxies());
-  auto guard
-    = detail::make_scope_guard([=] { ctx->proxy_registry_ptr(nullptr); });
+  resuming = true;
+  auto guard = detail::make_scope_guard([=] {
+    ctx->proxy_registry_ptr(nullptr);
+    resuming = false;
+    flush_pending();
+  });
   return super::resume(ctx, mt);
 }
 
@@ -499,6 +523,12 @@ void basp_broker::purge_state(const node_id& nid) {
     kvp.second.erase(nid);
 }
 
+void basp_broker::flush_pending() {
+  for (auto hdl : pending_flushes)
+    flush(hdl);
+  pending_flushes.clear();
+}
+
 void basp_broker::send_basp_down_message(const node_id& nid, actor_id aid,
                                          error rsn) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid) << CAF_ARG(rsn));
@@ -666,6 +696,10 @@ void basp_broker::connection_cleanup(connection_handle hdl, sec code) {
     emit_node_down_msg(nid, code);
     purge_state(nid);
   }
+  instance.erase_connection_state(hdl);
+  pending_flushes.erase(std::remove(pending_flushes.begin(),
+                                    pending_flushes.end(), hdl),
+                        pending_flushes.end());
   // Remove the context for `hdl`, making sure clients receive an error in case
   // this connection was closed during handshake.
   auto i = ctx.find(hdl);
@@ -689,6 +723,25 @@ void basp_broker::flush(connection_handle hdl) {
   super::flush(hdl);
 }
 
+void basp_broker::schedule_flush(connection_handle hdl) {
+  auto i = std::find(pending_flushes.begin(), pending_flushes.end(), hdl);
+  // Outside of resume, nothing guarantees that we flush the buffer later.
+  if (!resuming || output_batch_size == 0
+      || wr_buf(hdl).size() >= output_batch_size) {
+    if (i != pending_flushes.end())
+      pending_flushes.erase(i);
+    flush(hdl);
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (pending_flushes.empty())
+    first_pending_flush = now;
+  if (i == pending_flushes.end())
+    pending_flushes.emplace_back(hdl);
+  if (now - first_pending_flush >= output_batch_delay)
+    flush_pending();
+}
+
 void basp_broker::handle_heartbeat() {
   // nop
 }
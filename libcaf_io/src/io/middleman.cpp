@@ -77,6 +77,17 @@ auto make_metrics(telemetry::metric_registry& reg) {
     500'000,
     1'000'000,
   }};
+  std::array<double, 9> default_ratio_buckets{{
+    .1, //  10%
+    .2, //  20%
+    .3, //  30%
+    .4, //  40%
+    .5, //  50%
+    .6, //  60%
+    .7, //  70%
+    .8, //  80%
+    .9, //  90%
+  }};
   return middleman::metric_singletons_t{
     reg.histogram_singleton(
       "caf.middleman", "inbound-messages-size", default_size_buckets,
@@ -90,6 +101,21 @@ auto make_metrics(telemetry::metric_registry& reg) {
     reg.histogram_singleton<double>(
       "caf.middleman", "serialization-time", default_time_buckets,
       "Time the middleman needs to serialize outbound messages.", "seconds"),
+    reg.gauge_singleton(
+      "caf.middleman", "deserialization-workers",
+      "Number of BASP workers for deserializing inbound messages."),
+    reg.gauge_singleton(
+      "caf.middleman", "pending-messages",
+      "Number of deserialized messages waiting for an earlier message."),
+    reg.histogram_singleton<double>(
+      "caf.middleman", "compression-time", default_time_buckets,
+      "Time the middleman needs to compress outbound payloads.", "seconds"),
+    reg.histogram_singleton<double>(
+      "caf.middleman", "decompression-time", default_time_buckets,
+      "Time the middleman needs to decompress inbound payloads.", "seconds"),
+    reg.histogram_singleton<double>(
+      "caf.middleman", "compression-ratio", default_ratio_buckets,
+      "Size of compressed payloads relative to their original size."),
   };
 }
 
@@ -206,10 +232,40 @@ void middleman::add_module_options(actor_system_config& cfg) {
                "schedule utility actors instead of dedicating threads")
     .add<bool>("manual-multiplexing",
                "disables background activity of the multiplexer")
-    .add<size_t>("workers", "number of deserialization workers");
+    .add<size_t>("workers", "number of deserialization workers")
+    .add<std::vector<std::string>>("compression",
+                                   "codecs for compressing BASP payloads "
+                                   "in order of preference, e.g., [\"lz4\"]")
+    .add<size_t>("compression-threshold",
+                 "min. payload size in bytes for compressing BASP payloads")
+    .add<bool>("node-aliases",
+               "offers connection-local node aliases for routed messages")
+    .add<bool>("type-list-aliases",
+               "offers connection-local type list aliases for direct messages")
+    .add<bool>("compact-integers",
+               "offers varint and zigzag encoded integers for direct messages")
+    .add<bool>("presize-payloads",
+               "computes the size of messages before serializing them")
+    .add<size_t>("streaming-threshold",
+                 "min. payload size in bytes for deserializing direct "
+                 "messages while receiving them (disables streaming if 0)")
+    .add<size_t>("streaming-buffer-size",
+                 "max. bytes for buffering a single message element other "
+                 "than strings and byte buffers while deserializing a "
+                 "payload incrementally")
+    .add<size_t>("max-payload-size",
+                 "max. size of inbound BASP payloads in bytes, checked "
+                 "before allocating memory and after decompression")
+    .add<size_t>("output-batch-size",
+                 "max. bytes for coalescing outbound messages per connection "
+                 "(disables batching if 0)")
+    .add<timespan>("output-batch-delay",
+                   "max. time for coalescing outbound messages");
   config_option_adder{cfg.custom_options(), "caf.middleman.prometheus-http"}
     .add<uint16_t>("port", "listening port for incoming scrapes")
-    .add<std::string>("address", "bind address for the HTTP server socket");
+    .add<std::string>("address", "bind address for the HTTP server socket")
+    .add<bool>("open-metrics", "allows responding in the OpenMetrics format")
+    .add<bool>("gzip", "allows compressing responses with gzip");
 }
 
 actor_system::module* middleman::make(actor_system& sys, detail::type_list<>) {
@@ -443,6 +499,8 @@ void middleman::start() {
     auto run_backend = [this, sync_ptr{&sync}] {
       CAF_LOG_TRACE("");
       backend().thread_id(std::this_thread::get_id());
+      if (auto tracer = system().scheduler().tracer())
+        tracer->set_thread_name("caf.io.mpx");
       sync_ptr->count_down();
       backend().run();
     };
@@ -545,23 +545,34 @@ void default_multiplexer::handle_socket_event(native_socket fd, int mask,
                                               event_handler* ptr) {
   CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(mask));
   CAF_ASSERT(ptr != nullptr);
+  using event_type = scheduler::event_tracer::event_type;
+  auto tracer = system().scheduler().tracer();
+  auto handle_event = [fd, ptr, tracer](operation op) {
+    auto sock = static_cast<uint64_t>(fd);
+    auto op_id = static_cast<uint64_t>(op);
+    if (tracer)
+      tracer->record(event_type::io_begin, sock, op_id);
+    ptr->handle_event(op);
+    if (tracer)
+      tracer->record(event_type::io_end, sock, op_id);
+  };
   bool checkerror = true;
   if ((mask & input_mask) != 0) {
     checkerror = false;
     // ignore read events if a previous event caused
     // this socket to be shut down for reading
     if (!ptr->read_channel_closed())
-      ptr->handle_event(operation::read);
+      handle_event(operation::read);
   }
   if ((mask & output_mask) != 0) {
     checkerror = false;
-    ptr->handle_event(operation::write);
+    handle_event(operation::write);
   }
   if (checkerror && ((mask & error_mask) != 0)) {
     CAF_LOG_DEBUG("error occurred on socket:"
                   << CAF_ARG(fd) << CAF_ARG(last_socket_error())
                   << CAF_ARG(last_socket_error_as_string()));
-    ptr->handle_event(operation::propagate_error);
+    handle_event(operation::propagate_error);
     del(operation::read, fd, ptr);
     del(operation::write, fd, ptr);
   }
@@ -602,7 +613,18 @@ bool default_multiplexer::poll_once(bool block) {
 
 void default_multiplexer::resume(intrusive_ptr<resumable> ptr) {
   CAF_LOG_TRACE("");
-  switch (ptr->resume(this, max_throughput_)) {
+  using event_type = scheduler::event_tracer::event_type;
+  auto tracer = system().scheduler().tracer();
+  actor_id aid = 0;
+  if (tracer) {
+    if (auto dptr = dynamic_cast<abstract_actor*>(ptr.get()))
+      aid = dptr->id();
+    tracer->record(event_type::resume_begin, aid, 0);
+  }
+  auto res = ptr->resume(this, max_throughput_);
+  if (tracer)
+    tracer->record(event_type::resume_end, aid, res);
+  switch (res) {
     case resumable::resume_later:
       // Delay resumable until next cycle.
       internally_posted_.emplace_back(ptr.release(), false);
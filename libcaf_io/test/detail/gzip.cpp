@@ -0,0 +1,178 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.gzip
+
+#include "caf/detail/gzip.hpp"
+
+#include "io-test.hpp"
+
+#include <cstdint>
+#include <string>
+
+using namespace caf;
+
+namespace {
+
+byte_buffer to_bytes(const std::string& str) {
+  auto first = reinterpret_cast<const byte*>(str.data());
+  return byte_buffer{first, first + str.size()};
+}
+
+uint32_t read32le(const byte_buffer& buf, size_t offset) {
+  uint32_t result = 0;
+  for (size_t i = 0; i < 4; ++i)
+    result |= static_cast<uint32_t>(buf[offset + i]) << (i * 8);
+  return result;
+}
+
+// Minimal decoder for gzip members with a single DEFLATE block that uses the
+// fixed Huffman codes, i.e., the output of `gzip_compress`.
+class fixed_inflater {
+public:
+  explicit fixed_inflater(const byte_buffer& input) : input_(input) {
+    // nop
+  }
+
+  bool run(byte_buffer& output) {
+    if (input_.size() < 18 || input_[0] != byte{0x1F}
+        || input_[1] != byte{0x8B})
+      return false;
+    pos_ = 10 * 8;
+    // Expect BFINAL = 1 and BTYPE = 01.
+    if (bits(1) != 1 || bits(2) != 1)
+      return false;
+    for (;;) {
+      auto symbol = literal_or_length();
+      if (symbol < 256) {
+        output.push_back(static_cast<byte>(symbol));
+      } else if (symbol == 256) {
+        return !failed_;
+      } else if (symbol > 285 || failed_) {
+        return false;
+      } else {
+        auto li = symbol - 257;
+        auto len = length_base[li] + bits(length_extra[li]);
+        auto di = code(5);
+        if (di >= 30)
+          return false;
+        auto offset = distance_base[di] + bits(distance_extra[di]);
+        if (failed_ || offset > output.size())
+          return false;
+        auto from = output.size() - offset;
+        for (uint32_t i = 0; i < len; ++i)
+          output.push_back(output[from + i]);
+      }
+    }
+  }
+
+private:
+  static constexpr uint32_t length_base[] = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+
+  static constexpr uint32_t length_extra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                              1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                              4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+  static constexpr uint32_t distance_base[] = {
+    1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+    33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+  static constexpr uint32_t distance_extra[] = {0, 0, 0, 0, 1,  1,  2,  2,
+                                                3, 3, 4, 4, 5,  5,  6,  6,
+                                                7, 7, 8, 8, 9,  9,  10, 10,
+                                                11, 11, 12, 12, 13, 13};
+
+  // Reads `n` bits, starting with the least significant bit.
+  uint32_t bits(uint32_t n) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < n; ++i)
+      result |= next_bit() << i;
+    return result;
+  }
+
+  // Reads `n` bits of a Huffman code, starting with the most significant bit.
+  uint32_t code(uint32_t n) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < n; ++i)
+      result = (result << 1) | next_bit();
+    return result;
+  }
+
+  uint32_t next_bit() {
+    if (pos_ / 8 >= input_.size()) {
+      failed_ = true;
+      return 0;
+    }
+    auto x = static_cast<uint32_t>(input_[pos_ / 8]);
+    auto result = (x >> (pos_ % 8)) & 1;
+    ++pos_;
+    return result;
+  }
+
+  uint32_t literal_or_length() {
+    auto x = code(7);
+    if (x <= 0x17)
+      return x + 256;
+    x = (x << 1) | next_bit();
+    if (x >= 0x30 && x <= 0xBF)
+      return x - 0x30;
+    if (x >= 0xC0 && x <= 0xC7)
+      return x - 0xC0 + 280;
+    x = (x << 1) | next_bit();
+    return x - 0x190 + 144;
+  }
+
+  const byte_buffer& input_;
+  size_t pos_ = 0;
+  bool failed_ = false;
+};
+
+byte_buffer roundtrip(const byte_buffer& input) {
+  byte_buffer compressed;
+  detail::gzip_compress(input, compressed);
+  byte_buffer result;
+  if (!fixed_inflater{compressed}.run(result))
+    CAF_FAIL("failed to decompress a gzip member");
+  return result;
+}
+
+} // namespace
+
+CAF_TEST(gzip members carry the CRC32 and the size of the input) {
+  auto input = to_bytes("123456789");
+  byte_buffer compressed;
+  detail::gzip_compress(input, compressed);
+  CAF_REQUIRE_GREATER(compressed.size(), 18u);
+  CAF_CHECK_EQUAL(compressed[0], byte{0x1F});
+  CAF_CHECK_EQUAL(compressed[1], byte{0x8B});
+  CAF_CHECK_EQUAL(read32le(compressed, compressed.size() - 8), 0xCBF43926u);
+  CAF_CHECK_EQUAL(read32le(compressed, compressed.size() - 4), 9u);
+  CAF_CHECK_EQUAL(roundtrip(input), input);
+  CAF_CHECK_EQUAL(roundtrip(byte_buffer{}), byte_buffer{});
+}
+
+CAF_TEST(gzip compresses repetitive inputs) {
+  std::string str;
+  for (int i = 0; i < 1000; ++i)
+    str += "caf_system_running_actors{node=\"n" + std::to_string(i % 7)
+           + "\"} " + std::to_string(i) + " 1600000000000\n";
+  auto input = to_bytes(str);
+  byte_buffer compressed;
+  detail::gzip_compress(input, compressed);
+  CAF_CHECK_LESS(compressed.size() * 5, input.size());
+  CAF_CHECK_EQUAL(roundtrip(input), input);
+}
+
+CAF_TEST(gzip round-trips non-repetitive inputs) {
+  byte_buffer input;
+  uint32_t x = 42;
+  for (size_t i = 0; i < 100'000; ++i) {
+    x = x * 1103515245u + 12345u;
+    input.push_back(static_cast<byte>(x >> 24));
+  }
+  CAF_CHECK_EQUAL(roundtrip(input), input);
+}
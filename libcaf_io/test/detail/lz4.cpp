@@ -0,0 +1,115 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#define CAF_SUITE detail.lz4
+
+#include "caf/detail/lz4.hpp"
+
+#include "io-test.hpp"
+
+#include <string>
+
+#include "caf/io/basp/codec.hpp"
+
+using namespace caf;
+
+namespace {
+
+byte_buffer to_bytes(const std::string& str) {
+  auto first = reinterpret_cast<const byte*>(str.data());
+  return byte_buffer{first, first + str.size()};
+}
+
+byte_buffer roundtrip(const byte_buffer& input) {
+  byte_buffer compressed;
+  detail::lz4_compress(input, compressed);
+  byte_buffer result;
+  if (!detail::lz4_decompress(compressed, input.size(), result))
+    CAF_FAIL("failed to decompress an LZ4 block");
+  return result;
+}
+
+} // namespace
+
+CAF_TEST(LZ4 encodes short inputs as literals) {
+  auto input = to_bytes("hello");
+  byte_buffer compressed;
+  detail::lz4_compress(input, compressed);
+  CAF_CHECK_EQUAL(compressed.size(), input.size() + 1);
+  CAF_CHECK_EQUAL(roundtrip(input), input);
+  CAF_CHECK_EQUAL(roundtrip(byte_buffer{}), byte_buffer{});
+}
+
+CAF_TEST(LZ4 compresses repetitive inputs) {
+  std::string str;
+  for (int i = 0; i < 1000; ++i)
+    str += "caf::io::basp::message_type::direct_message";
+  auto input = to_bytes(str);
+  byte_buffer compressed;
+  detail::lz4_compress(input, compressed);
+  CAF_CHECK_LESS(compressed.size() * 10, input.size());
+  CAF_CHECK_EQUAL(roundtrip(input), input);
+}
+
+CAF_TEST(LZ4 round-trips non-repetitive inputs) {
+  byte_buffer input;
+  uint32_t x = 42;
+  for (size_t i = 0; i < 100'000; ++i) {
+    x = x * 1103515245u + 12345u;
+    input.push_back(static_cast<byte>(x >> 24));
+  }
+  CAF_CHECK_EQUAL(roundtrip(input), input);
+}
+
+CAF_TEST(LZ4 rejects malformed inputs) {
+  auto input = to_bytes("abcdabcdabcdabcdabcdabcdabcdabcd");
+  byte_buffer compressed;
+  detail::lz4_compress(input, compressed);
+  byte_buffer output;
+  CAF_CHECK(!detail::lz4_decompress(compressed, input.size() - 1, output));
+  output.clear();
+  CAF_CHECK(!detail::lz4_decompress(compressed, input.size() + 1, output));
+  output.clear();
+  compressed.pop_back();
+  CAF_CHECK(!detail::lz4_decompress(compressed, input.size(), output));
+  output.clear();
+  byte_buffer bad_offset{byte{0x10}, byte{'a'}, byte{0x02}, byte{0x00}};
+  CAF_CHECK(!detail::lz4_decompress(bad_offset, 5, output));
+}
+
+CAF_TEST(the BASP codec lz4 stores the decompressed size) {
+  auto uut = io::basp::make_codec("lz4");
+  CAF_REQUIRE(uut != nullptr);
+  CAF_CHECK_EQUAL(uut->name(), "lz4");
+  CAF_CHECK(io::basp::make_codec("foobar") == nullptr);
+  std::string str;
+  for (int i = 0; i < 100; ++i)
+    str += "foobar";
+  auto input = to_bytes(str);
+  byte_buffer compressed;
+  CAF_REQUIRE(uut->compress(input, compressed));
+  byte_buffer output;
+  CAF_CHECK(!uut->decompress(compressed, output, input.size() - 1));
+  output.clear();
+  CAF_REQUIRE(uut->decompress(compressed, output, input.size()));
+  CAF_CHECK_EQUAL(output, input);
+}
+
+CAF_TEST(LZ4 never trusts the decoded size for allocating memory) {
+  byte_buffer block{byte{0x10}, byte{'a'}};
+  byte_buffer output;
+  CAF_CHECK(!detail::lz4_decompress(block, size_t{1} << 32, output));
+  CAF_CHECK_LESS_OR_EQUAL(output.capacity(), block.size() * 255);
+}
+
+CAF_TEST(the BASP codec lz4 rejects forged decompressed sizes) {
+  auto uut = io::basp::make_codec("lz4");
+  CAF_REQUIRE(uut != nullptr);
+  // A five-byte packet that claims to decompress to almost 4 GiB.
+  byte_buffer forged{byte{0xFF}, byte{0xFF}, byte{0xFF}, byte{0xF0},
+                     byte{0x00}};
+  byte_buffer output;
+  CAF_CHECK(!uut->decompress(forged, output, 1024));
+  CAF_CHECK_EQUAL(output.capacity(), 0u);
+}
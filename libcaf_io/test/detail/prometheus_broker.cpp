@@ -142,3 +142,34 @@ SCENARIO("setting caf.middleman.prometheus-http.port exports metrics to HTTP") {
     }
   }
 }
+
+SCENARIO("the prometheus broker optionally compresses OpenMetrics output") {
+  GIVEN("a config that enables OpenMetrics and gzip for scraping") {
+    actor_system_config cfg;
+    cfg.load<io::middleman>();
+    cfg.set("caf.scheduler.max-threads", 2);
+    cfg.set("caf.middleman.prometheus-http.port", 0);
+    cfg.set("caf.middleman.prometheus-http.open-metrics", true);
+    cfg.set("caf.middleman.prometheus-http.gzip", true);
+    WHEN("a client accepts both OpenMetrics and gzip") {
+      actor_system sys{cfg};
+      auto scraping_port = sys.middleman().prometheus_scraping_port();
+      REQUIRE_NE(scraping_port, 0);
+      auto response_buf = read_all(http_request, "localhost", scraping_port);
+      string_view response{reinterpret_cast<char*>(response_buf.data()),
+                           response_buf.size()};
+      THEN("the broker responds with compressed OpenMetrics output") {
+        CAF_CHECK(starts_with(response, "HTTP/1.1 200 OK\r\n"));
+        CAF_CHECK(contains(response, "\r\nContent-Type: "
+                                     "application/openmetrics-text;"));
+        CAF_CHECK(contains(response, "\r\nContent-Encoding: gzip\r\n"));
+        auto pos = response.find("\r\n\r\n");
+        REQUIRE_NE(pos, string_view::npos);
+        auto payload = response.substr(pos + 4);
+        REQUIRE_GE(payload.size(), 18u);
+        CHECK_EQ(static_cast<uint8_t>(payload[0]), 0x1Fu);
+        CHECK_EQ(static_cast<uint8_t>(payload[1]), 0x8Bu);
+      }
+    }
+  }
+}
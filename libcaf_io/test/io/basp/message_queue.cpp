@@ -25,22 +25,30 @@ behavior testee_impl() {
 struct fixture : test_coordinator_fixture<> {
   io::basp::message_queue queue;
   strong_actor_ptr testee;
+  strong_actor_ptr other;
+  std::vector<uint64_t> ids;
 
   fixture() {
-    auto hdl = sys.spawn<lazy_init>(testee_impl);
-    testee = actor_cast<strong_actor_ptr>(hdl);
+    testee = actor_cast<strong_actor_ptr>(sys.spawn<lazy_init>(testee_impl));
+    other = actor_cast<strong_actor_ptr>(sys.spawn<lazy_init>(testee_impl));
   }
 
   void acquire_ids(size_t num) {
     for (size_t i = 0; i < num; ++i)
-      queue.new_id();
+      ids.emplace_back(queue.new_id(testee->id()));
   }
 
   void push(int msg_id) {
-    queue.push(nullptr, static_cast<uint64_t>(msg_id), testee,
+    queue.push(nullptr, ids[static_cast<size_t>(msg_id)], testee,
                make_mailbox_element(self->ctrl(), make_message_id(), {},
                                     ok_atom_v, msg_id));
   }
+
+  void push_other(uint64_t id, int content) {
+    queue.push(nullptr, id, other,
+               make_mailbox_element(self->ctrl(), make_message_id(), {},
+                                    ok_atom_v, content));
+  }
 };
 
 } // namespace
@@ -48,16 +56,22 @@ struct fixture : test_coordinator_fixture<> {
 CAF_TEST_FIXTURE_SCOPE(message_queue_tests, fixture)
 
 CAF_TEST(default construction) {
-  CAF_CHECK_EQUAL(queue.next_id, 0u);
-  CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
-  CAF_CHECK_EQUAL(queue.pending.size(), 0u);
+  for (auto& seq : queue.sequencers) {
+    CAF_CHECK_EQUAL(seq.next_id, 0u);
+    CAF_CHECK_EQUAL(seq.next_undelivered, 0u);
+    CAF_CHECK_EQUAL(seq.pending.size(), 0u);
+  }
 }
 
 CAF_TEST(ascending IDs) {
-  CAF_CHECK_EQUAL(queue.new_id(), 0u);
-  CAF_CHECK_EQUAL(queue.new_id(), 1u);
-  CAF_CHECK_EQUAL(queue.new_id(), 2u);
-  CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
+  auto id0 = queue.new_id(testee->id());
+  auto id1 = queue.new_id(testee->id());
+  auto id2 = queue.new_id(testee->id());
+  CAF_CHECK_LESS(id0, id1);
+  CAF_CHECK_LESS(id1, id2);
+  auto& seq = queue.sequencers[queue.sequencer_index(testee->id())];
+  CAF_CHECK_EQUAL(seq.next_id, 3u);
+  CAF_CHECK_EQUAL(seq.next_undelivered, 0u);
 }
 
 CAF_TEST(push order 0 - 1 - 2) {
@@ -131,11 +145,37 @@ CAF_TEST(dropping) {
   acquire_ids(3);
   push(2);
   disallow((ok_atom, int), from(self).to(testee));
-  queue.drop(nullptr, 1);
+  queue.drop(nullptr, ids[1]);
   disallow((ok_atom, int), from(self).to(testee));
   push(0);
   expect((ok_atom, int), from(self).to(testee).with(_, 0));
   expect((ok_atom, int), from(self).to(testee).with(_, 2));
 }
 
+CAF_TEST(messages to different receivers do not block each other) {
+  CAF_REQUIRE_NOT_EQUAL(queue.sequencer_index(testee->id()),
+                        queue.sequencer_index(other->id()));
+  acquire_ids(1);
+  auto other_id = queue.new_id(other->id());
+  push_other(other_id, 1);
+  expect((ok_atom, int), from(self).to(other).with(_, 1));
+  push(0);
+  expect((ok_atom, int), from(self).to(testee).with(_, 0));
+}
+
+CAF_TEST(barriers wait for all previously acquired IDs) {
+  acquire_ids(1);
+  auto other_id = queue.new_id(other->id());
+  queue.push_barrier(nullptr, other,
+                     make_mailbox_element(self->ctrl(), make_message_id(), {},
+                                          ok_atom_v, 42));
+  disallow((ok_atom, int), from(self).to(other));
+  push(0);
+  expect((ok_atom, int), from(self).to(testee).with(_, 0));
+  disallow((ok_atom, int), from(self).to(other));
+  push_other(other_id, 1);
+  expect((ok_atom, int), from(self).to(other).with(_, 1));
+  expect((ok_atom, int), from(self).to(other).with(_, 42));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "caf/all.hpp"
+#include "caf/builtin_tracer.hpp"
 #include "caf/deep_to_string.hpp"
 #include "caf/io/all.hpp"
 #include "caf/io/network/interfaces.hpp"
@@ -90,9 +91,19 @@ struct node {
 
 class fixture {
 public:
-  fixture(bool autoconn = false)
-    : sys(cfg.load<io::middleman, network::test_multiplexer>()
+  fixture(bool autoconn = false, bool node_aliases = false,
+          bool type_list_aliases = false, size_t streaming_threshold = 0,
+          bool compact_integers = false,
+          tracing_data_factory* tracing_context = nullptr)
+    : type_list_aliases(type_list_aliases),
+      compact_integers(compact_integers),
+      sys(init(cfg, tracing_context)
+            .load<io::middleman, network::test_multiplexer>()
             .set("caf.middleman.enable-automatic-connections", autoconn)
+            .set("caf.middleman.node-aliases", node_aliases)
+            .set("caf.middleman.type-list-aliases", type_list_aliases)
+            .set("caf.middleman.streaming-threshold", streaming_threshold)
+            .set("caf.middleman.compact-integers", compact_integers)
             .set("caf.middleman.heartbeat-interval", timespan{0})
             .set("caf.middleman.connection-timeout", timespan{0})
             .set("caf.middleman.workers", size_t{0})
@@ -101,6 +112,12 @@ public:
             .set("caf.logger.console.verbosity", "debug")
             .set("caf.middleman.attach-utility-actors", autoconn)) {
     app_ids.emplace_back(to_string(defaults::middleman::app_identifier));
+    if (node_aliases)
+      features.emplace_back("node-aliases");
+    if (type_list_aliases)
+      features.emplace_back("type-list-aliases");
+    if (compact_integers)
+      features.emplace_back("compact-integers");
     auto& mm = sys.middleman();
     mpx_ = dynamic_cast<network::test_multiplexer*>(&mm.backend());
     CAF_REQUIRE(mpx_ != nullptr);
@@ -199,6 +216,12 @@ public:
     return aut()->proxies();
   }
 
+  static actor_system_config& init(actor_system_config& cfg,
+                                   tracing_data_factory* tracing_context) {
+    cfg.tracing_context = tracing_context;
+    return cfg;
+  }
+
   // stores the singleton pointer for convenience
   actor_registry* registry() {
     return registry_;
@@ -207,8 +230,9 @@ public:
   using payload_writer = basp::instance::payload_writer;
 
   template <class... Ts>
-  void to_payload(byte_buffer& buf, const Ts&... xs) {
+  void to_payload(byte_buffer& buf, bool compact, const Ts&... xs) {
     binary_serializer sink{mpx_, buf};
+    sink.compact_integers(compact);
     if (!(sink.apply(xs) && ...))
       CAF_FAIL("failed to serialize payload: " << sink.get_error());
   }
@@ -253,20 +277,45 @@ public:
     mpx_->accept_connection(src);
     // technically, the server handshake arrives
     // before we send the client handshake
-    mock(hdl,
-         {basp::message_type::client_handshake, 0, 0, 0, invalid_actor_id,
-          invalid_actor_id},
-         n.id)
-      .receive(hdl, basp::message_type::server_handshake, no_flags, any_vals,
-               basp::version, invalid_actor_id, invalid_actor_id, this_node(),
-               app_ids, published_actor_id, published_actor_ifs)
-      // upon receiving our client handshake, BASP will check
-      // whether there is a SpawnServ actor on this node
-      .receive(hdl, basp::message_type::direct_message,
-               basp::header::named_receiver_flag, any_vals,
-               default_operation_data, any_vals, spawn_serv_id,
-               std::vector<strong_actor_ptr>{},
-               make_message(sys_atom_v, get_atom_v, "info"));
+    auto mx = features.empty()
+                ? mock(hdl,
+                       {basp::message_type::client_handshake, 0, 0, 0,
+                        invalid_actor_id, invalid_actor_id},
+                       n.id)
+                : mock(hdl,
+                       {basp::message_type::client_handshake, 0, 0, 0,
+                        invalid_actor_id, invalid_actor_id},
+                       n.id, std::vector<std::string>{}, features);
+    if (features.empty())
+      mx.receive(hdl, basp::message_type::server_handshake, no_flags,
+                 any_vals, basp::version, invalid_actor_id, invalid_actor_id,
+                 this_node(), app_ids, published_actor_id,
+                 published_actor_ifs);
+    else
+      mx.receive(hdl, basp::message_type::server_handshake, no_flags,
+                 any_vals, basp::version, invalid_actor_id, invalid_actor_id,
+                 this_node(), app_ids, published_actor_id, published_actor_ifs,
+                 std::vector<std::string>{}, features);
+    // upon receiving our client handshake, BASP will check
+    // whether there is a SpawnServ actor on this node
+    auto spawn_serv_flags = basp::header::named_receiver_flag;
+    if (compact_integers)
+      spawn_serv_flags |= basp::header::compact_integers_flag;
+    if (type_list_aliases)
+      mx.receive(hdl, basp::message_type::direct_message,
+                 static_cast<uint8_t>(spawn_serv_flags
+                                      | basp::header::type_alias_flag),
+                 any_vals, default_operation_data, any_vals, spawn_serv_id,
+                 uint32_t{1} | basp::instance::alias_definition_bit,
+                 std::vector<type_id_t>{type_id_v<sys_atom>,
+                                        type_id_v<get_atom>,
+                                        type_id_v<std::string>},
+                 std::vector<strong_actor_ptr>{}, std::string{"info"});
+    else
+      mx.receive(hdl, basp::message_type::direct_message, spawn_serv_flags,
+                 any_vals, default_operation_data, any_vals, spawn_serv_id,
+                 std::vector<strong_actor_ptr>{},
+                 make_message(sys_atom_v, get_atom_v, "info"));
     // test whether basp instance correctly updates the
     // routing table upon receiving client handshakes
     auto path = tbl().lookup(n.id);
@@ -326,8 +375,6 @@ public:
                     maybe<actor_id> source_actor, maybe<actor_id> dest_actor,
                     const Ts&... xs) {
       CAF_MESSAGE("expect #" << num);
-      byte_buffer buf;
-      this_->to_payload(buf, xs...);
       auto& ob = this_->mpx()->output_buffer(hdl);
       while (this_->mpx()->try_exec_runnable()) {
         // repeat
@@ -339,6 +386,9 @@ public:
         if (!source.apply(hdr))
           CAF_FAIL("failed to deserialize header: " << source.get_error());
       }
+      byte_buffer buf;
+      this_->to_payload(buf, hdr.has(basp::header::compact_integers_flag),
+                        xs...);
       byte_buffer payload;
       if (hdr.payload_len > 0) {
         CAF_REQUIRE(ob.size() >= (basp::header_size + hdr.payload_len));
@@ -383,9 +433,12 @@ public:
     return {this};
   }
 
+  bool type_list_aliases;
+  bool compact_integers;
   actor_system_config cfg;
   actor_system sys;
   std::vector<std::string> app_ids;
+  std::vector<std::string> features;
 
 private:
   basp_broker* aut_;
@@ -428,6 +481,65 @@ public:
   }
 };
 
+class node_alias_fixture : public fixture {
+public:
+  static constexpr uint8_t alias_flag = basp::header::node_alias_flag;
+
+  static constexpr uint32_t define(uint32_t alias) {
+    return alias | basp::instance::alias_definition_bit;
+  }
+
+  node_alias_fixture() : fixture(false, true) {
+    // nop
+  }
+};
+
+class type_list_alias_fixture : public fixture {
+public:
+  static constexpr uint8_t alias_flag = basp::header::type_alias_flag;
+
+  static constexpr uint32_t define(uint32_t alias) {
+    return alias | basp::instance::alias_definition_bit;
+  }
+
+  type_list_alias_fixture() : fixture(false, false, true) {
+    // nop
+  }
+};
+
+class streaming_fixture : public fixture {
+public:
+  static constexpr size_t threshold = 1024;
+
+  streaming_fixture() : fixture(false, false, false, threshold) {
+    // nop
+  }
+};
+
+class compact_integers_fixture : public fixture {
+public:
+  static constexpr uint8_t compact_flag
+    = basp::header::compact_integers_flag;
+
+  compact_integers_fixture() : fixture(false, false, false, 0, true) {
+    // nop
+  }
+};
+
+class tracing_fixture : public fixture {
+public:
+  static constexpr uint8_t tracing_flag = basp::header::tracing_flag;
+
+  tracing_fixture() : fixture(false, false, false, 0, false, tracer()) {
+    features.emplace_back("tracing");
+  }
+
+  static builtin_tracer* tracer() {
+    static builtin_tracer instance;
+    return &instance;
+  }
+};
+
 } // namespace
 
 CAF_TEST_FIXTURE_SCOPE(basp_tests, fixture)
@@ -695,6 +807,387 @@ CAF_TEST(indirect_connections) {
                  make_message("hello from earth!"));
 }
 
+CAF_TEST(BASP drops connections that announce oversized payloads) {
+  connect_node(jupiter());
+  auto max_size = defaults::middleman::max_payload_size;
+  basp::header hdr{basp::message_type::direct_message, 0,
+                   static_cast<uint32_t>(max_size + 1), 0,
+                   jupiter().dummy_actor->id(), self()->id()};
+  byte_buffer buf;
+  binary_serializer sink{mpx(), buf};
+  if (!sink.apply(hdr))
+    CAF_FAIL("failed to serialize header: " << sink.get_error());
+  mpx()->virtual_send(jupiter().connection, buf);
+  mpx()->flush_runnables();
+  CAF_CHECK_EQUAL(tbl().lookup_direct(jupiter().id), none);
+}
+
+CAF_TEST(BASP flushes each message by default) {
+  connect_node(jupiter());
+  auto hdl = jupiter().connection;
+  CAF_CHECK_EQUAL(aut()->output_batch_size, 0u);
+  aut()->resuming = true;
+  aut()->wr_buf(hdl).resize(10);
+  aut()->schedule_flush(hdl);
+  CAF_CHECK(aut()->pending_flushes.empty());
+  aut()->resuming = false;
+  aut()->wr_buf(hdl).clear();
+}
+
+CAF_TEST(BASP coalesces output until reaching the batch size) {
+  connect_node(jupiter());
+  auto hdl = jupiter().connection;
+  aut()->output_batch_size = 100;
+  aut()->output_batch_delay = timespan{60'000'000'000};
+  aut()->resuming = true;
+  auto& buf = aut()->wr_buf(hdl);
+  buf.resize(50);
+  aut()->schedule_flush(hdl);
+  aut()->schedule_flush(hdl);
+  CAF_CHECK_EQUAL(aut()->pending_flushes,
+                  std::vector<connection_handle>{hdl});
+  CAF_MESSAGE("reaching the batch size flushes the connection");
+  buf.resize(100);
+  aut()->schedule_flush(hdl);
+  CAF_CHECK(aut()->pending_flushes.empty());
+  aut()->resuming = false;
+  buf.clear();
+}
+
+CAF_TEST(BASP flushes coalesced output after the batch delay) {
+  connect_node(jupiter());
+  auto hdl = jupiter().connection;
+  aut()->output_batch_size = 100;
+  aut()->output_batch_delay = timespan{100'000};
+  aut()->resuming = true;
+  aut()->wr_buf(hdl).resize(10);
+  aut()->schedule_flush(hdl);
+  CAF_CHECK_EQUAL(aut()->pending_flushes.size(), 1u);
+  CAF_MESSAGE("deferring another flush after the delay flushes everything");
+  aut()->first_pending_flush -= std::chrono::milliseconds{1};
+  aut()->schedule_flush(hdl);
+  CAF_CHECK(aut()->pending_flushes.empty());
+  CAF_MESSAGE("outside of resume, the broker never defers flushes");
+  aut()->resuming = false;
+  aut()->schedule_flush(hdl);
+  CAF_CHECK(aut()->pending_flushes.empty());
+  aut()->wr_buf(hdl).clear();
+}
+
+CAF_TEST(BASP flushes coalesced output when returning from resume) {
+  connect_node(jupiter());
+  aut()->output_batch_size = 65536;
+  auto prx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+  mock().receive(jupiter().connection, basp::message_type::monitor_message,
+                 no_flags, any_vals, no_operation_data, invalid_actor_id,
+                 prx->id(), this_node(), prx->node());
+  anon_send(actor_cast<actor>(prx), 42);
+  mpx()->flush_runnables();
+  CAF_CHECK(aut()->pending_flushes.empty());
+  mock().receive(jupiter().connection, basp::message_type::direct_message,
+                 no_flags, any_vals, default_operation_data, invalid_actor_id,
+                 prx->id(), std::vector<strong_actor_ptr>{}, make_message(42));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_tests_with_node_aliases, node_alias_fixture)
+
+CAF_TEST(forwarding re-encodes node aliases per connection) {
+  connect_node(jupiter());
+  connect_node(mars());
+  CAF_CHECK(instance().aliases_for(jupiter().connection) != nullptr);
+  CAF_CHECK(instance().aliases_for(mars().connection) != nullptr);
+  auto msg = make_message(1, 2, 3);
+  CAF_MESSAGE("the first message defines aliases for both nodes");
+  mock(jupiter().connection,
+       {basp::message_type::routed_message, alias_flag, 0,
+        default_operation_data, invalid_actor_id, mars().dummy_actor->id()},
+       define(1), jupiter().id, define(2), mars().id,
+       std::vector<strong_actor_ptr>{}, msg)
+    .receive(mars().connection, basp::message_type::routed_message, alias_flag,
+             any_vals, default_operation_data, invalid_actor_id,
+             mars().dummy_actor->id(), define(1), jupiter().id, define(2),
+             mars().id, std::vector<strong_actor_ptr>{}, msg);
+  CAF_MESSAGE("subsequent messages only refer to the aliases");
+  mock(jupiter().connection,
+       {basp::message_type::routed_message, alias_flag, 0,
+        default_operation_data, invalid_actor_id, mars().dummy_actor->id()},
+       uint32_t{1}, uint32_t{2}, std::vector<strong_actor_ptr>{}, msg)
+    .receive(mars().connection, basp::message_type::routed_message, alias_flag,
+             any_vals, default_operation_data, invalid_actor_id,
+             mars().dummy_actor->id(), uint32_t{1}, uint32_t{2},
+             std::vector<strong_actor_ptr>{}, msg);
+}
+
+CAF_TEST(routed messages may refer to nodes by alias) {
+  connect_node(mars());
+  CAF_MESSAGE("Mars defines aliases for itself and for this node");
+  mock(mars().connection,
+       {basp::message_type::routed_message, alias_flag, 0,
+        default_operation_data, invalid_actor_id, self()->id()},
+       define(1), mars().id, define(2), this_node(),
+       std::vector<strong_actor_ptr>{}, make_message("hello"));
+  self()->receive(
+    [](const std::string& str) { CAF_CHECK_EQUAL(str, "hello"); });
+  CAF_MESSAGE("Mars refers to both nodes by alias");
+  mock(mars().connection,
+       {basp::message_type::routed_message, alias_flag, 0,
+        default_operation_data, invalid_actor_id, self()->id()},
+       uint32_t{1}, uint32_t{2}, std::vector<strong_actor_ptr>{},
+       make_message("world"));
+  self()->receive(
+    [](const std::string& str) { CAF_CHECK_EQUAL(str, "world"); });
+  CAF_MESSAGE("BASP drops connections that refer to unknown aliases");
+  mock(mars().connection,
+       {basp::message_type::routed_message, alias_flag, 0,
+        default_operation_data, invalid_actor_id, self()->id()},
+       uint32_t{1}, uint32_t{3}, std::vector<strong_actor_ptr>{},
+       make_message("!"));
+  mpx()->flush_runnables();
+  CAF_CHECK(instance().aliases_for(mars().connection) == nullptr);
+  CAF_CHECK_EQUAL(tbl().lookup_direct(mars().id), none);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_tests_with_type_list_aliases,
+                       type_list_alias_fixture)
+
+CAF_TEST(direct messages may refer to type lists by alias) {
+  connect_node(jupiter());
+  CAF_REQUIRE(instance().type_lists_for(jupiter().connection) != nullptr);
+  using int_list = std::vector<type_id_t>;
+  auto i32 = type_id_v<int32_t>;
+  CAF_MESSAGE("Jupiter defines an alias for (int32_t, int32_t, int32_t)");
+  mock(jupiter().connection,
+       {basp::message_type::direct_message, alias_flag, 0, 0,
+        jupiter().dummy_actor->id(), self()->id()},
+       define(1), int_list{i32, i32, i32}, std::vector<strong_actor_ptr>{},
+       int32_t{1}, int32_t{2}, int32_t{3})
+    .receive(jupiter().connection, basp::message_type::monitor_message,
+             no_flags, any_vals, no_operation_data, invalid_actor_id,
+             jupiter().dummy_actor->id(), this_node(), jupiter().id);
+  self()->receive([](int32_t a, int32_t b, int32_t c) {
+    CAF_CHECK_EQUAL(a, 1);
+    CAF_CHECK_EQUAL(b, 2);
+    CAF_CHECK_EQUAL(c, 3);
+    return a + b + c;
+  });
+  CAF_MESSAGE("the response defines the next alias on our side");
+  mpx()->exec_runnable();
+  mock().receive(jupiter().connection, basp::message_type::direct_message,
+                 alias_flag, any_vals, any_vals, self()->id(),
+                 jupiter().dummy_actor->id(), define(2), int_list{i32},
+                 std::vector<strong_actor_ptr>{}, int32_t{6});
+  CAF_MESSAGE("subsequent messages only refer to the alias");
+  mock(jupiter().connection,
+       {basp::message_type::direct_message, alias_flag, 0, 0,
+        jupiter().dummy_actor->id(), self()->id()},
+       uint32_t{1}, std::vector<strong_actor_ptr>{}, int32_t{4}, int32_t{5},
+       int32_t{6});
+  self()->receive([](int32_t a, int32_t b, int32_t c) {
+    CAF_CHECK_EQUAL(a, 4);
+    CAF_CHECK_EQUAL(b, 5);
+    CAF_CHECK_EQUAL(c, 6);
+  });
+  CAF_MESSAGE("BASP drops connections that refer to unknown aliases");
+  mock(jupiter().connection,
+       {basp::message_type::direct_message, alias_flag, 0, 0,
+        jupiter().dummy_actor->id(), self()->id()},
+       uint32_t{2}, std::vector<strong_actor_ptr>{}, int32_t{7});
+  mpx()->flush_runnables();
+  CAF_CHECK(instance().type_lists_for(jupiter().connection) == nullptr);
+  CAF_CHECK_EQUAL(tbl().lookup_direct(jupiter().id), none);
+}
+
+CAF_TEST(BASP drops connections that define oversized type lists) {
+  connect_node(jupiter());
+  CAF_MESSAGE("Jupiter claims to send a list with 2^32 - 1 type IDs");
+  byte_buffer buf;
+  basp::header hdr{basp::message_type::direct_message, alias_flag, 0, 0,
+                   jupiter().dummy_actor->id(), self()->id()};
+  auto writer = make_callback([](binary_serializer& sink) {
+    return sink.apply(define(1))
+           && sink.begin_sequence(std::numeric_limits<uint32_t>::max())
+           && sink.apply(type_id_v<int32_t>);
+  });
+  to_buf(buf, hdr, &writer);
+  mpx()->virtual_send(jupiter().connection, buf);
+  mpx()->flush_runnables();
+  CAF_CHECK(instance().type_lists_for(jupiter().connection) == nullptr);
+  CAF_CHECK_EQUAL(tbl().lookup_direct(jupiter().id), none);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_tests_with_streaming, streaming_fixture)
+
+CAF_TEST(BASP deserializes large payloads while receiving them) {
+  connect_node(jupiter());
+  auto large = std::string(3 * basp::instance::max_chunk_size, 'x');
+  byte_buffer buf;
+  basp::header hdr{basp::message_type::direct_message, 0, 0, 0,
+                   jupiter().dummy_actor->id(), self()->id()};
+  to_buf(buf, hdr, nullptr, std::vector<strong_actor_ptr>{},
+         make_message(large, int32_t{42}));
+  CAF_REQUIRE_GREATER(hdr.payload_len, 2 * basp::instance::max_chunk_size);
+  CAF_MESSAGE("send the header and the first half of the payload");
+  auto half = static_cast<ptrdiff_t>(buf.size() / 2);
+  mpx()->virtual_send(jupiter().connection,
+                      byte_buffer{buf.begin(), buf.begin() + half});
+  mpx()->flush_runnables();
+  auto stream = instance().stream_for(jupiter().connection);
+  CAF_REQUIRE(stream != nullptr);
+  CAF_CHECK_EQUAL(stream->pending, buf.size() - static_cast<size_t>(half));
+  CAF_CHECK_GREATER(stream->source.consumed(), 0u);
+  CAF_MESSAGE("strings go directly into the message instead of the buffer");
+  CAF_CHECK_LESS(stream->source.buffered(), basp::instance::max_chunk_size);
+  CAF_MESSAGE("send the remainder of the payload and a small message");
+  mpx()->virtual_send(jupiter().connection,
+                      byte_buffer{buf.begin() + half, buf.end()});
+  mock(jupiter().connection,
+       {basp::message_type::direct_message, 0, 0, 0,
+        jupiter().dummy_actor->id(), self()->id()},
+       std::vector<strong_actor_ptr>{}, make_message("done"))
+    .receive(jupiter().connection, basp::message_type::monitor_message,
+             no_flags, any_vals, no_operation_data, invalid_actor_id,
+             jupiter().dummy_actor->id(), this_node(), jupiter().id);
+  CAF_CHECK(instance().stream_for(jupiter().connection) == nullptr);
+  self()->receive([&](const std::string& str, int32_t x) {
+    CAF_CHECK_EQUAL(str, large);
+    CAF_CHECK_EQUAL(x, 42);
+  });
+  self()->receive([](const std::string& str) { //
+    CAF_CHECK_EQUAL(str, "done");
+  });
+}
+
+CAF_TEST(BASP drops connections with malformed streamed payloads) {
+  connect_node(jupiter());
+  byte_buffer buf;
+  basp::header hdr{basp::message_type::direct_message, 0, 0, 0,
+                   jupiter().dummy_actor->id(), self()->id()};
+  to_buf(buf, hdr, nullptr, std::vector<strong_actor_ptr>{},
+         make_message(std::string(2 * threshold, 'x')));
+  CAF_MESSAGE("corrupt the type ID of the message content");
+  auto type_pos = basp::header_size + 2;
+  buf[type_pos] = byte{0xFF};
+  buf[type_pos + 1] = byte{0xFE};
+  mpx()->virtual_send(jupiter().connection, buf);
+  mpx()->flush_runnables();
+  CAF_CHECK(instance().stream_for(jupiter().connection) == nullptr);
+  CAF_CHECK_EQUAL(tbl().lookup_direct(jupiter().id), none);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_tests_with_compact_integers,
+                       compact_integers_fixture)
+
+CAF_TEST(direct messages may encode integers in compact form) {
+  connect_node(jupiter());
+  CAF_REQUIRE(instance().compact_integers_for(jupiter().connection));
+  CAF_MESSAGE("Jupiter sends a message with compact integers");
+  mock(jupiter().connection,
+       {basp::message_type::direct_message, compact_flag, 0, 0,
+        jupiter().dummy_actor->id(), self()->id()},
+       std::vector<strong_actor_ptr>{},
+       make_message(int32_t{-1}, int64_t{-70000}))
+    .receive(jupiter().connection, basp::message_type::monitor_message,
+             no_flags, any_vals, no_operation_data, invalid_actor_id,
+             jupiter().dummy_actor->id(), this_node(), jupiter().id);
+  self()->receive([](int32_t x, int64_t y) {
+    CAF_CHECK_EQUAL(x, -1);
+    CAF_CHECK_EQUAL(y, -70000);
+    return x + y;
+  });
+  CAF_MESSAGE("the response uses compact integers as well");
+  mpx()->exec_runnable();
+  mock().receive(jupiter().connection, basp::message_type::direct_message,
+                 compact_flag, any_vals, any_vals, self()->id(),
+                 jupiter().dummy_actor->id(), std::vector<strong_actor_ptr>{},
+                 make_message(int64_t{-70001}));
+}
+
+CAF_TEST(routed messages must not use compact integers) {
+  basp::header hdr{basp::message_type::routed_message, compact_flag, 1, 0,
+                   jupiter().dummy_actor->id(), self()->id()};
+  CAF_CHECK(!basp::valid(hdr));
+  hdr.flags = 0;
+  CAF_CHECK(basp::valid(hdr));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_tests_with_tracing, tracing_fixture)
+
+CAF_TEST(direct messages may carry tracing data) {
+  connect_node(jupiter());
+  CAF_REQUIRE(instance().tracing_for(jupiter().connection));
+  CAF_MESSAGE("Jupiter sends a message with tracing data");
+  // The tracing data of the builtin tracer consists of the trace ID, the
+  // parent span ID and the sampling decision.
+  mock(jupiter().connection,
+       {basp::message_type::direct_message, tracing_flag, 0, 0,
+        jupiter().dummy_actor->id(), self()->id()},
+       uint64_t{1}, uint64_t{2}, uint64_t{3}, true,
+       std::vector<strong_actor_ptr>{}, make_message(int32_t{42}))
+    .receive(jupiter().connection, basp::message_type::monitor_message,
+             no_flags, any_vals, no_operation_data, invalid_actor_id,
+             jupiter().dummy_actor->id(), this_node(), jupiter().id);
+  self()->receive([this](int32_t x) {
+    CAF_CHECK_EQUAL(x, 42);
+#ifdef CAF_ENABLE_ACTOR_PROFILER
+    auto& tracing = self()->current_mailbox_element()->tracing_id;
+    auto ctx = dynamic_cast<builtin_tracer::context*>(tracing.get());
+    CAF_REQUIRE(ctx != nullptr);
+    CAF_CHECK_EQUAL(ctx->trace_id_high, 1u);
+    CAF_CHECK_EQUAL(ctx->trace_id_low, 2u);
+    CAF_CHECK_EQUAL(ctx->parent_id, 3u);
+    CAF_CHECK_EQUAL(ctx->sampled, true);
+#endif // CAF_ENABLE_ACTOR_PROFILER
+  });
+}
+
+CAF_TEST(the BASP instance writes tracing data in front of the stages) {
+  connect_node(jupiter());
+  builtin_tracer::context ctx{1, 2, 3, false};
+  auto src = actor_cast<strong_actor_ptr>(self());
+  instance().dispatch(mpx(), src, {}, jupiter().id,
+                      jupiter().dummy_actor->id(), 0, make_message_id(),
+                      make_message(int32_t{42}), &ctx);
+  mock().receive(jupiter().connection, basp::message_type::direct_message,
+                 tracing_flag, any_vals, default_operation_data,
+                 self()->id(), jupiter().dummy_actor->id(), uint64_t{1},
+                 uint64_t{2}, uint64_t{3}, false,
+                 std::vector<strong_actor_ptr>{}, make_message(int32_t{42}));
+}
+
+CAF_TEST(routed messages must not carry tracing data) {
+  basp::header hdr{basp::message_type::routed_message, tracing_flag, 1, 0,
+                   jupiter().dummy_actor->id(), self()->id()};
+  CAF_CHECK(!basp::valid(hdr));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(basp_tests_without_tracing, fixture)
+
+CAF_TEST(the BASP instance drops tracing data if the peer lacks support) {
+  connect_node(jupiter());
+  CAF_REQUIRE(!instance().tracing_for(jupiter().connection));
+  builtin_tracer::context ctx{1, 2, 3, true};
+  auto src = actor_cast<strong_actor_ptr>(self());
+  instance().dispatch(mpx(), src, {}, jupiter().id,
+                      jupiter().dummy_actor->id(), 0, make_message_id(),
+                      make_message(int32_t{42}), &ctx);
+  mock().receive(jupiter().connection, basp::message_type::direct_message,
+                 no_flags, any_vals, default_operation_data, self()->id(),
+                 jupiter().dummy_actor->id(), std::vector<strong_actor_ptr>{},
+                 make_message(int32_t{42}));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
 
 CAF_TEST_FIXTURE_SCOPE(basp_tests_with_autoconn, autoconn_enabled_fixture)
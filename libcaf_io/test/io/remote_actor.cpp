@@ -85,6 +85,30 @@ behavior linking_actor(event_based_actor* self,
   };
 }
 
+behavior string_sink(event_based_actor* self, std::shared_ptr<std::string> buf) {
+  return {
+    [=](const std::string& str) {
+      *buf = str;
+      self->quit();
+    },
+  };
+}
+
+struct compression_config : test_node_fixture_config {
+  compression_config() {
+    set("caf.middleman.compression", std::vector<std::string>{"lz4"});
+    set("caf.middleman.compression-threshold", size_t{128});
+  }
+};
+
+using compression_base_fixture = test_coordinator_fixture<compression_config>;
+
+struct compression_fixture : point_to_point_fixture<compression_base_fixture> {
+  compression_fixture() {
+    prepare_connection(mars, earth, "mars", 8080);
+  }
+};
+
 struct fixture : point_to_point_fixture<> {
   fixture() {
     prepare_connection(mars, earth, "mars", 8080);
@@ -127,3 +151,23 @@ CAF_TEST(remote_link) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(compression_tests, compression_fixture)
+
+CAF_TEST(nodes compress large payloads after negotiating a codec) {
+  auto buf = std::make_shared<std::string>();
+  auto port = mars.publish(mars.sys.spawn(string_sink, buf), 8080);
+  CAF_CHECK_EQUAL(port, 8080u);
+  auto sink = earth.remote_actor("mars", 8080);
+  std::string str;
+  for (int i = 0; i < 100; ++i)
+    str += "hello world! ";
+  anon_send(sink, str);
+  run();
+  CAF_CHECK_EQUAL(*buf, str);
+  auto& earth_metrics = earth.mm.metric_singletons;
+  CAF_CHECK_GREATER(earth_metrics.compression_ratio->sum(), 0.0);
+  CAF_CHECK_LESS(earth_metrics.compression_ratio->sum(), 0.5);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
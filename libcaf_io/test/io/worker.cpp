@@ -115,7 +115,7 @@ CAF_TEST(deliver serialized message) {
                        42,
                        testee.id()};
   CAF_MESSAGE("launch worker");
-  w->launch(last_hop, hdr, payload);
+  w->launch(last_hop, last_hop, hdr, payload);
   sched.run_once();
   expect((ok_atom), from(_).to(testee));
 }
@@ -0,0 +1,123 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+// Measures the throughput of small remote messages and the round-trip time of
+// remote requests between two actor systems in the same process, connected
+// via BASP over the loopback interface. Running this tool with different
+// values for caf.middleman.output-batch-size and
+// caf.middleman.output-batch-delay shows the trade-off of output batching.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct config : public actor_system_config {
+  size_t messages = 1'000'000;
+  size_t round_trips = 10'000;
+  config() {
+    opt_group{custom_options_, "global"}
+      .add(messages, "messages,m", "Number of messages for the throughput test")
+      .add(round_trips, "round-trips,r",
+           "Number of requests for the latency test");
+    // Load the middleman before parsing the CLI to accept its options.
+    load<io::middleman>();
+  }
+};
+
+// Counts integers and echoes 64-bit integers.
+behavior sink(event_based_actor*) {
+  auto count = std::make_shared<uint64_t>(0);
+  return {
+    [count](int32_t) { ++*count; },
+    [count](get_atom) { return *count; },
+    [](int64_t x) { return x; },
+  };
+}
+
+void run(actor_system& sys, actor_system& client_sys, const config& cfg) {
+  using clock = std::chrono::steady_clock;
+  using std::chrono::duration;
+  auto server = sys.spawn(sink);
+  auto port = sys.middleman().publish(server, 0, "127.0.0.1");
+  if (!port) {
+    fprintf(stderr, "*** publish failed: %s\n",
+            to_string(port.error()).c_str());
+    anon_send_exit(server, exit_reason::user_shutdown);
+    return;
+  }
+  auto remote = client_sys.middleman().remote_actor("127.0.0.1", *port);
+  if (!remote) {
+    fprintf(stderr, "*** remote_actor failed: %s\n",
+            to_string(remote.error()).c_str());
+    anon_send_exit(server, exit_reason::user_shutdown);
+    return;
+  }
+  printf("output-batch-size: %zu, output-batch-delay: %s\n",
+         get_or(cfg, "caf.middleman.output-batch-size",
+                defaults::middleman::output_batch_size),
+         deep_to_string(get_or(cfg, "caf.middleman.output-batch-delay",
+                               defaults::middleman::output_batch_delay))
+           .c_str());
+  scoped_actor self{client_sys};
+  auto on_error = [](const error& err) {
+    fprintf(stderr, "*** request failed: %s\n", to_string(err).c_str());
+  };
+  // Throughput: send all messages without waiting, then wait for the sink to
+  // process them. The connection preserves the order of messages, so the
+  // response arrives after the sink received all messages.
+  auto t0 = clock::now();
+  for (size_t i = 0; i < cfg.messages; ++i)
+    self->send(*remote, int32_t{1});
+  self->request(*remote, infinite, get_atom_v)
+    .receive(
+      [&](uint64_t count) {
+        duration<double> secs = clock::now() - t0;
+        printf("throughput: %.0f msgs/s (%llu messages in %.3f s)\n",
+               static_cast<double>(count) / secs.count(),
+               static_cast<unsigned long long>(count), secs.count());
+      },
+      on_error);
+  // Latency: send one request at a time.
+  t0 = clock::now();
+  for (size_t i = 0; i < cfg.round_trips; ++i)
+    self->request(*remote, infinite, static_cast<int64_t>(i))
+      .receive([](int64_t) {}, on_error);
+  if (cfg.round_trips > 0) {
+    duration<double, std::micro> us = clock::now() - t0;
+    printf("latency: %.2f us per round trip (%zu requests)\n",
+           us.count() / static_cast<double>(cfg.round_trips), cfg.round_trips);
+  }
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  core::init_global_meta_objects();
+  io::middleman::init_global_meta_objects();
+  // Both systems use the same settings, e.g., for output batching.
+  config cfg;
+  config client_cfg;
+  for (auto ptr : {&cfg, &client_cfg}) {
+    if (auto err = ptr->parse(argc, argv)) {
+      fprintf(stderr, "*** error parsing command line: %s\n",
+              to_string(err).c_str());
+      return EXIT_FAILURE;
+    }
+    if (ptr->cli_helptext_printed)
+      return EXIT_SUCCESS;
+  }
+  actor_system sys{cfg};
+  actor_system client_sys{client_cfg};
+  run(sys, client_sys, cfg);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,242 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+// Measures writing and parsing JSON on generated corpora. Each benchmark
+// prints one line per corpus with the average time per document and the
+// throughput. Since the benchmark only uses the public API of `json_writer`
+// and `json_reader`, it also compiles against older versions of CAF for
+// comparing implementations.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/json_reader.hpp"
+#include "caf/json_writer.hpp"
+
+using std::string;
+
+using namespace caf;
+
+namespace {
+
+struct config : public actor_system_config {
+  size_t iterations = 100;
+  config() {
+    opt_group{custom_options_, "global"} //
+      .add(iterations, "iterations,n", "Documents per benchmark");
+  }
+};
+
+// Runs `f()` `n` times and returns the average time per call in nanoseconds.
+template <class F>
+double run(size_t n, F f) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  auto ns = std::chrono::duration<double, std::nano>{t1 - t0}.count();
+  return ns / static_cast<double>(n);
+}
+
+void print(const char* name, const string& variant, size_t bytes, double ns) {
+  printf("%-10s %-24s %9zu bytes %12.0f ns/doc %8.1f MB/s\n", name,
+         variant.c_str(), bytes, ns, static_cast<double>(bytes) * 1e3 / ns);
+}
+
+// Aborts the benchmark if writing or parsing failed, since the numbers would
+// be meaningless.
+void check(bool ok, const char* what) {
+  if (!ok) {
+    fprintf(stderr, "%s failed\n", what);
+    abort();
+  }
+}
+
+// -- corpus -------------------------------------------------------------------
+
+struct record {
+  int64_t id = 0;
+  int32_t count = 0;
+  double value = 0.;
+  string name;
+  string text;
+  std::vector<int64_t> samples;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, record& x) {
+  return f.object(x).fields(f.field("id", x.id), f.field("count", x.count),
+                            f.field("value", x.value),
+                            f.field("name", x.name), f.field("text", x.text),
+                            f.field("samples", x.samples));
+}
+
+enum class corpus_kind {
+  plain_strings,
+  escaped_strings,
+  integers,
+  mixed,
+};
+
+const char* corpus_name(corpus_kind kind) {
+  switch (kind) {
+    case corpus_kind::plain_strings:
+      return "plain strings";
+    case corpus_kind::escaped_strings:
+      return "escaped strings";
+    case corpus_kind::integers:
+      return "integers";
+    default:
+      return "mixed";
+  }
+}
+
+// Returns `size` characters of text. Escaped text contains a quote, a
+// backslash, a newline or a tab after about every third word.
+string make_text(std::minstd_rand& rng, size_t size, bool escaped) {
+  static constexpr const char* words[] = {"actor ",   "message ", "system ",
+                                          "mailbox ", "node ",    "stream "};
+  static constexpr char specials[] = {'"', '\\', '\n', '\t'};
+  string result;
+  while (result.size() < size) {
+    result += words[rng() % std::size(words)];
+    if (escaped && rng() % 3 == 0)
+      result += specials[rng() % std::size(specials)];
+  }
+  result.resize(size);
+  return result;
+}
+
+std::vector<record> make_corpus(corpus_kind kind, size_t size) {
+  std::minstd_rand rng{42};
+  auto wide = [&rng] {
+    return static_cast<int64_t>((uint64_t{rng()} << 32) | rng());
+  };
+  std::vector<record> result(size);
+  for (auto& x : result) {
+    x.id = wide();
+    x.count = static_cast<int32_t>(rng() % 1000);
+    x.value = static_cast<double>(rng() % 100000) / 8.;
+    x.name = "record-" + std::to_string(rng() % 10000);
+    switch (kind) {
+      case corpus_kind::plain_strings:
+        x.text = make_text(rng, 256, false);
+        break;
+      case corpus_kind::escaped_strings:
+        x.text = make_text(rng, 256, true);
+        break;
+      case corpus_kind::integers:
+        for (size_t i = 0; i < 32; ++i)
+          x.samples.emplace_back(i % 2 == 0 ? wide() : wide() % 1000);
+        break;
+      default:
+        x.text = make_text(rng, 64, rng() % 2 == 0);
+        for (size_t i = 0; i < 8; ++i)
+          x.samples.emplace_back(i % 2 == 0 ? wide() : wide() % 1000);
+    }
+  }
+  return result;
+}
+
+constexpr corpus_kind all_corpora[] = {
+  corpus_kind::plain_strings,
+  corpus_kind::escaped_strings,
+  corpus_kind::integers,
+  corpus_kind::mixed,
+};
+
+// Returns the JSON output for `xs`.
+string to_json(const std::vector<record>& xs, size_t indentation = 0) {
+  json_writer writer;
+  writer.indentation(indentation);
+  check(writer.apply(xs), "write");
+  auto str = writer.str();
+  return string{str.begin(), str.end()};
+}
+
+// -- json_writer --------------------------------------------------------------
+
+// Measures writing 1000 records per document. The writer keeps its buffer
+// between documents.
+void bench_writer(const config& cfg) {
+  for (auto kind : all_corpora) {
+    auto xs = make_corpus(kind, 1000);
+    json_writer writer;
+    auto ns = run(cfg.iterations, [&] {
+      writer.reset();
+      check(writer.apply(xs), "write");
+    });
+    print("write", corpus_name(kind), writer.str().size(), ns);
+  }
+}
+
+// -- json_reader --------------------------------------------------------------
+
+// Returns a configuration in the style of `caf-application.conf` with
+// `num_sections` sections, printed with indentation.
+string make_config(size_t num_sections) {
+  std::minstd_rand rng{42};
+  string result = "{\n";
+  for (size_t i = 0; i < num_sections; ++i) {
+    if (i > 0)
+      result += ",\n";
+    result += "  \"section-" + std::to_string(i) + "\": {\n";
+    result += "    \"enabled\": " + string{rng() % 2 == 0 ? "true" : "false"};
+    result += ",\n    \"max-threads\": " + std::to_string(rng() % 64);
+    result += ",\n    \"timeout\": " + std::to_string(rng() % 1000) + ".5";
+    result += ",\n    \"host\": \"node-" + std::to_string(rng() % 100)
+              + ".example.com\"";
+    result += ",\n    \"ports\": [";
+    for (size_t j = 0; j < 4; ++j)
+      result += (j > 0 ? ", " : "") + std::to_string(1024 + rng() % 60000);
+    result += "],\n    \"labels\": {\"role\": \"worker\", \"zone\": \"eu-"
+              + std::to_string(rng() % 4) + "\"}\n  }";
+  }
+  result += "\n}\n";
+  return result;
+}
+
+// Measures parsing configurations and message dumps. Also measures inputs
+// with an error at the very end, which forces the parser to read everything
+// before failing, and inputs with an error at the start.
+void bench_reader(const config& cfg) {
+  std::vector<std::pair<string, string>> docs;
+  docs.emplace_back("config", make_config(2000));
+  for (auto kind : all_corpora)
+    docs.emplace_back(corpus_name(kind), to_json(make_corpus(kind, 1000)));
+  docs.emplace_back("mixed (indented)",
+                    to_json(make_corpus(corpus_kind::mixed, 1000), 2));
+  json_reader reader;
+  for (auto& [name, doc] : docs) {
+    auto ns = run(cfg.iterations, [&] { check(reader.load(doc), "load"); });
+    print("load", name, doc.size(), ns);
+  }
+  for (auto& [name, doc] : docs) {
+    // Replaces the last closing bracket with a character that is invalid in
+    // this position.
+    auto late = doc;
+    late[late.find_last_of("]}")] = '?';
+    auto ns = run(cfg.iterations, [&] { check(!reader.load(late), "fail"); });
+    print("fail end", name, late.size(), ns);
+    auto early = doc;
+    early[early.find_first_of(",")] = '?';
+    ns = run(cfg.iterations, [&] { check(!reader.load(early), "fail"); });
+    print("fail start", name, early.size(), ns);
+  }
+}
+
+void caf_main(actor_system&, const config& cfg) {
+  bench_writer(cfg);
+  bench_reader(cfg);
+}
+
+} // namespace
+
+CAF_MAIN()
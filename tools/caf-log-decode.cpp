@@ -0,0 +1,60 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "caf/all.hpp"
+#include "caf/detail/binary_log.hpp"
+
+using std::string;
+
+using namespace caf;
+
+namespace {
+
+struct config : public actor_system_config {
+  string input_file;
+  string output_file;
+  string format = to_string(defaults::logger::file::format);
+  config() {
+    opt_group{custom_options_, "global"}
+      .add(input_file, "input-file,i", "Path to a binary log file")
+      .add(output_file, "output-file,o", "Path for the output file (or stdout)")
+      .add(format, "format,f", "Format string for rendering each event");
+  }
+};
+
+// Renders binary log files (see caf.logger.file.binary) as text.
+void caf_main(actor_system&, const config& cfg) {
+  using std::cerr;
+  using std::endl;
+  if (cfg.input_file.empty()) {
+    cerr << "*** no input file specified" << endl;
+    return;
+  }
+  std::ifstream in{cfg.input_file, std::ios::binary};
+  if (!in) {
+    cerr << "*** unable to open input file: " << cfg.input_file << endl;
+    return;
+  }
+  std::ofstream out_file;
+  if (!cfg.output_file.empty()) {
+    out_file.open(cfg.output_file);
+    if (!out_file) {
+      cerr << "*** unable to open output file: " << cfg.output_file << endl;
+      return;
+    }
+  }
+  auto& out = cfg.output_file.empty() ? std::cout : out_file;
+  auto lf = logger::parse_format(cfg.format);
+  if (!detail::render_binary_log(in, out, lf))
+    cerr << "*** input is not a binary log or contains malformed records"
+         << endl;
+}
+
+} // namespace
+
+CAF_MAIN()
@@ -0,0 +1,367 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+// Measures the binary serializer and deserializer: bulk paths for vectors of
+// arithmetic types, pre-sizing the output for messages, compact integers and
+// the fixed-size codec. Each benchmark prints one line per configuration with
+// the average time per element, message or object and, for compact integers,
+// the average message size.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/fixed_size_codec.hpp"
+
+namespace bench {
+
+struct point {
+  int32_t x;
+  int32_t y;
+  int32_t z;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, point& x) {
+  return f.object(x).fields(f.field("x", x.x), f.field("y", x.y),
+                            f.field("z", x.z));
+}
+
+struct segment {
+  point from;
+  point to;
+  double weight;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, segment& x) {
+  return f.object(x).fields(f.field("from", x.from), f.field("to", x.to),
+                            f.field("weight", x.weight));
+}
+
+struct reading {
+  uint32_t sensor;
+  int64_t timestamp;
+  std::vector<int32_t> samples;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, reading& x) {
+  return f.object(x).fields(f.field("sensor", x.sensor),
+                            f.field("timestamp", x.timestamp),
+                            f.field("samples", x.samples));
+}
+
+struct order {
+  uint64_t id;
+  std::string symbol;
+  int32_t quantity;
+  double price;
+};
+
+template <class Inspector>
+bool inspect(Inspector& f, order& x) {
+  return f.object(x).fields(f.field("id", x.id), f.field("symbol", x.symbol),
+                            f.field("quantity", x.quantity),
+                            f.field("price", x.price));
+}
+
+} // namespace bench
+
+CAF_BEGIN_TYPE_ID_BLOCK(caf_serialization_bench, first_custom_type_id)
+
+  CAF_ADD_TYPE_ID(caf_serialization_bench, (bench::point))
+  CAF_ADD_TYPE_ID(caf_serialization_bench, (bench::segment))
+  CAF_ADD_TYPE_ID(caf_serialization_bench, (std::vector<bench::segment>) )
+  CAF_ADD_TYPE_ID(caf_serialization_bench, (bench::reading))
+  CAF_ADD_TYPE_ID(caf_serialization_bench, (bench::order))
+
+CAF_END_TYPE_ID_BLOCK(caf_serialization_bench)
+
+using std::string;
+
+using namespace caf;
+using namespace bench;
+
+namespace {
+
+struct config : public actor_system_config {
+  size_t elements = 10'000'000;
+  size_t iterations = 100'000;
+  config() {
+    opt_group{custom_options_, "global"}
+      .add(elements, "elements,e", "Vector elements per benchmark")
+      .add(iterations, "iterations,n", "Messages or objects per benchmark");
+  }
+};
+
+// Runs `f(i)` for each i in [0, n) and returns the average time per call in
+// nanoseconds.
+template <class F>
+double run(size_t n, F f) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i)
+    f(i);
+  auto t1 = std::chrono::steady_clock::now();
+  auto ns = std::chrono::duration<double, std::nano>{t1 - t0}.count();
+  return ns / static_cast<double>(n);
+}
+
+void print(const char* name, const string& variant, double ns,
+           const char* unit) {
+  printf("%-10s %-36s %10.2f ns/%s\n", name, variant.c_str(), ns, unit);
+}
+
+// Aborts the benchmark if serialization failed, since the numbers would be
+// meaningless.
+void check(bool ok, const char* what) {
+  if (!ok) {
+    fprintf(stderr, "%s failed\n", what);
+    abort();
+  }
+}
+
+// -- bulk paths for vectors ---------------------------------------------------
+
+// Compares writing and reading one value at a time to the bulk `value(span)`
+// overloads for vectors of arithmetic types.
+template <class T>
+void bench_vector(const config& cfg, const char* type_name, size_t size) {
+  std::minstd_rand rng{42};
+  std::vector<T> xs(size);
+  for (auto& x : xs)
+    x = static_cast<T>(rng());
+  auto reps = std::max(cfg.elements / size, size_t{1});
+  auto variant = [&](const char* name) {
+    return string{type_name} + " size=" + std::to_string(size) + " " + name;
+  };
+  auto per_elem = [](double ns, size_t n) { return ns / n; };
+  byte_buffer buf;
+  auto ns = run(reps, [&](size_t) {
+    buf.clear();
+    binary_serializer sink{nullptr, buf};
+    auto ok = sink.begin_sequence(xs.size());
+    for (auto x : xs)
+      ok = ok && sink.value(x);
+    check(ok && sink.end_sequence(), "save");
+  });
+  print("save", variant("per-element"), per_elem(ns, size), "elem");
+  ns = run(reps, [&](size_t) {
+    buf.clear();
+    binary_serializer sink{nullptr, buf};
+    check(sink.begin_sequence(xs.size()) && sink.value(make_span(xs))
+            && sink.end_sequence(),
+          "save");
+  });
+  print("save", variant("bulk"), per_elem(ns, size), "elem");
+  std::vector<T> ys(size);
+  ns = run(reps, [&](size_t) {
+    binary_deserializer source{nullptr, buf};
+    size_t n = 0;
+    auto ok = source.begin_sequence(n) && n == ys.size();
+    for (auto& y : ys)
+      ok = ok && source.value(y);
+    check(ok && source.end_sequence(), "load");
+  });
+  print("load", variant("per-element"), per_elem(ns, size), "elem");
+  ns = run(reps, [&](size_t) {
+    binary_deserializer source{nullptr, buf};
+    size_t n = 0;
+    check(source.begin_sequence(n) && n == ys.size()
+            && source.value(make_span(ys)) && source.end_sequence(),
+          "load");
+  });
+  print("load", variant("bulk"), per_elem(ns, size), "elem");
+}
+
+void bench_vectors(const config& cfg) {
+  for (size_t size : {1'000, 10'000, 100'000, 1'000'000}) {
+    bench_vector<int32_t>(cfg, "int32_t", size);
+    bench_vector<double>(cfg, "double", size);
+  }
+}
+
+// -- pre-sizing messages ------------------------------------------------------
+
+segment make_segment(int32_t i) {
+  return segment{point{i, i + 1, i + 2}, point{-i, -i - 1, -i - 2}, i * 0.5};
+}
+
+// Compares saving messages with and without pre-sizing the output. A fresh
+// buffer per message shows the cost of growing the buffer. A reused buffer
+// shows the overhead of the extra size pass when the capacity already fits.
+void bench_presize(const config& cfg) {
+  std::vector<segment> segments;
+  for (int32_t i = 0; i < 1000; ++i)
+    segments.emplace_back(make_segment(i));
+  std::vector<std::pair<string, message>> msgs;
+  msgs.emplace_back("segment", make_message(make_segment(1)));
+  msgs.emplace_back("1000 segments", make_message(segments));
+  msgs.emplace_back("string 1KiB", make_message(string(1024, 'x')));
+  msgs.emplace_back("string 64KiB", make_message(string(64 * 1024, 'x')));
+  msgs.emplace_back("string 1MiB", make_message(string(1024 * 1024, 'x')));
+  msgs.emplace_back("segment + 64KiB string",
+                    make_message(make_segment(1), string(64 * 1024, 'x')));
+  for (auto& [name, msg] : msgs) {
+    // Scale down the iterations for large messages.
+    byte_buffer tmp;
+    binary_serializer size_sink{nullptr, tmp};
+    check(msg.save(size_sink), "save");
+    auto reps = std::max(cfg.iterations * 64 / (tmp.size() + 64), size_t{100});
+    for (auto presize : {false, true}) {
+      auto variant = name + (presize ? " presize=on" : " presize=off");
+      auto ns = run(reps, [&](size_t) {
+        byte_buffer buf;
+        binary_serializer sink{nullptr, buf};
+        sink.presize(presize);
+        check(msg.save(sink), "save");
+      });
+      print("fresh", variant, ns, "msg");
+      byte_buffer buf;
+      ns = run(reps, [&](size_t) {
+        buf.clear();
+        binary_serializer sink{nullptr, buf};
+        sink.presize(presize);
+        check(msg.save(sink), "save");
+      });
+      print("reused", variant, ns, "msg");
+    }
+  }
+}
+
+// -- compact integers ---------------------------------------------------------
+
+// Returns messages in the style of typical actor traffic. The small mix has
+// sequence numbers, counters and sensor IDs that fit into one or two bytes.
+// The large mix uses timestamps in nanoseconds and random 64-bit IDs.
+std::vector<message> message_mix(size_t n, bool small) {
+  std::minstd_rand rng{42};
+  auto id = [&]() -> uint64_t {
+    if (small)
+      return rng() % 1000;
+    return (uint64_t{rng()} << 32) | rng();
+  };
+  std::vector<message> result;
+  for (size_t i = 0; i < n; ++i) {
+    switch (i % 4) {
+      case 0:
+        result.emplace_back(make_message(static_cast<uint64_t>(i)));
+        break;
+      case 1: {
+        reading x;
+        x.sensor = static_cast<uint32_t>(rng() % 64);
+        x.timestamp = small ? static_cast<int64_t>(i)
+                            : 1'600'000'000'000'000'000 + id() % 1'000'000;
+        for (int32_t j = 0; j < 16; ++j)
+          x.samples.emplace_back(static_cast<int32_t>(rng() % 200) - 100);
+        result.emplace_back(make_message(std::move(x)));
+        break;
+      }
+      case 2:
+        result.emplace_back(make_message(
+          order{id(), "ACME", static_cast<int32_t>(rng() % 500), 12.5}));
+        break;
+      default: {
+        auto x = static_cast<int32_t>(rng() % (small ? 100 : 1'000'000));
+        result.emplace_back(make_message(make_segment(x)));
+      }
+    }
+  }
+  return result;
+}
+
+// Compares the size and speed of fixed-size and compact integers.
+void bench_compact_integers(const config& cfg) {
+  for (auto small : {true, false}) {
+    auto msgs = message_mix(1024, small);
+    for (auto compact : {false, true}) {
+      auto variant = string{small ? "small ints" : "large ints"}
+                     + (compact ? " compact=on" : " compact=off");
+      byte_buffer buf;
+      std::vector<size_t> offsets;
+      for (auto& msg : msgs) {
+        offsets.emplace_back(buf.size());
+        binary_serializer sink{nullptr, buf};
+        sink.compact_integers(compact);
+        check(msg.save(sink), "save");
+      }
+      offsets.emplace_back(buf.size());
+      printf("%-10s %-36s %10.2f bytes/msg\n", "size", variant.c_str(),
+             static_cast<double>(buf.size()) / msgs.size());
+      byte_buffer out;
+      auto ns = run(cfg.iterations, [&](size_t i) {
+        out.clear();
+        binary_serializer sink{nullptr, out};
+        sink.compact_integers(compact);
+        check(msgs[i % msgs.size()].save(sink), "save");
+      });
+      print("save", variant, ns, "msg");
+      message tmp;
+      ns = run(cfg.iterations, [&](size_t i) {
+        auto j = i % msgs.size();
+        binary_deserializer source{nullptr, buf.data() + offsets[j],
+                                   offsets[j + 1] - offsets[j]};
+        source.compact_integers(compact);
+        check(tmp.load(source), "load");
+      });
+      print("load", variant, ns, "msg");
+    }
+  }
+}
+
+// -- fixed-size codec ---------------------------------------------------------
+
+// Compares the generic `apply` of the binary (de)serializer to the fixed-size
+// codec that meta objects use for types with a fixed binary size.
+template <class T>
+void bench_codec(const config& cfg, const char* type_name, const T& x) {
+  byte_buffer buf;
+  auto ns = run(cfg.iterations, [&](size_t) {
+    buf.clear();
+    binary_serializer sink{nullptr, buf};
+    check(sink.apply(x), "save");
+  });
+  print("save", string{type_name} + " apply", ns, "obj");
+  ns = run(cfg.iterations, [&](size_t) {
+    buf.clear();
+    binary_serializer sink{nullptr, buf};
+    check(fixed_size_codec<T>::save(sink, x), "save");
+  });
+  print("save", string{type_name} + " codec", ns, "obj");
+  T y;
+  ns = run(cfg.iterations, [&](size_t) {
+    binary_deserializer source{nullptr, buf};
+    check(source.apply(y), "load");
+  });
+  print("load", string{type_name} + " apply", ns, "obj");
+  ns = run(cfg.iterations, [&](size_t) {
+    binary_deserializer source{nullptr, buf};
+    check(fixed_size_codec<T>::load(source, y), "load");
+  });
+  print("load", string{type_name} + " codec", ns, "obj");
+}
+
+void bench_codecs(const config& cfg) {
+  bench_codec(cfg, "int32_t", int32_t{42});
+  bench_codec(cfg, "point", point{1, 2, 3});
+  bench_codec(cfg, "segment", make_segment(1));
+}
+
+void caf_main(actor_system&, const config& cfg) {
+  bench_vectors(cfg);
+  bench_presize(cfg);
+  bench_compact_integers(cfg);
+  bench_codecs(cfg);
+}
+
+} // namespace
+
+CAF_MAIN(id_block::caf_serialization_bench)
@@ -0,0 +1,201 @@
+// This file is part of CAF, the C++ Actor Framework. See the file LICENSE in
+// the main distribution directory for license terms and copyright or visit
+// https://github.com/actor-framework/actor-framework/blob/master/LICENSE.
+
+// Measures the cost of updating and looking up metrics, with and without
+// sharding, for 1 to max-threads threads (doubling the number of threads in
+// each step). Each benchmark prints one line per configuration with the
+// average time per operation.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/telemetry/metric_registry.hpp"
+
+using std::string;
+
+using namespace caf;
+
+namespace {
+
+struct config : public actor_system_config {
+  size_t max_threads = 64;
+  size_t iterations = 1'000'000;
+  config() {
+    opt_group{custom_options_, "global"}
+      .add(max_threads, "max-threads,t", "Maximum number of threads")
+      .add(iterations, "iterations,n", "Operations per thread and benchmark");
+  }
+};
+
+// Runs `f(thread_index, i)` for each i in [0, n) on `num_threads` threads and
+// returns the average time per call in nanoseconds.
+template <class F>
+double run(size_t num_threads, size_t n, F f) {
+  std::atomic<size_t> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t)
+    threads.emplace_back([&, t] {
+      ++ready;
+      while (!go)
+        std::this_thread::yield();
+      for (size_t i = 0; i < n; ++i)
+        f(t, i);
+    });
+  while (ready != num_threads)
+    std::this_thread::yield();
+  auto t0 = std::chrono::steady_clock::now();
+  go = true;
+  for (auto& t : threads)
+    t.join();
+  auto t1 = std::chrono::steady_clock::now();
+  auto ns = std::chrono::duration<double, std::nano>{t1 - t0}.count();
+  return ns / static_cast<double>(num_threads * n);
+}
+
+void print(const char* name, const string& variant, size_t num_threads,
+           double ns_per_op) {
+  printf("%-14s %-24s threads=%-3zu %10.2f ns/op\n", name, variant.c_str(),
+         num_threads, ns_per_op);
+}
+
+// Returns 1, 2, 4, ..., max_threads.
+std::vector<size_t> thread_counts(size_t max_threads) {
+  std::vector<size_t> result;
+  for (size_t n = 1; n <= std::max(max_threads, size_t{1}); n *= 2)
+    result.emplace_back(n);
+  return result;
+}
+
+// Returns the shard settings for `n` threads: none and one shard per thread.
+std::vector<size_t> shard_counts(size_t n) {
+  if (n == 1)
+    return {1};
+  return {1, n};
+}
+
+// Returns random values between 0 and `max` (inclusive).
+std::vector<double> random_values(double max) {
+  std::minstd_rand rng{42};
+  std::uniform_real_distribution<double> dist{0., max};
+  std::vector<double> result(4096);
+  for (auto& x : result)
+    x = dist(rng);
+  return result;
+}
+
+// Compares shared and sharded counters under contention.
+void bench_counters(const config& cfg) {
+  for (auto n : thread_counts(cfg.max_threads)) {
+    for (auto shards : shard_counts(n)) {
+      telemetry::metric_registry reg;
+      reg.shards(shards);
+      auto x = reg.counter_instance("bench", "counter", {}, "");
+      auto ns = run(n, cfg.iterations, [x](size_t, size_t) { x->inc(); });
+      print("counter", "shards=" + std::to_string(shards), n, ns);
+    }
+  }
+}
+
+// Compares the bucket lookup of histograms to a binary search over the upper
+// bounds for various numbers of buckets.
+void bench_bucket_lookup(const config& cfg) {
+  for (size_t num_buckets : {4, 8, 16, 32, 64}) {
+    std::vector<double> bounds;
+    for (size_t i = 1; i <= num_buckets; ++i)
+      bounds.emplace_back(static_cast<double>(i));
+    auto values = random_values(static_cast<double>(num_buckets));
+    telemetry::metric_registry reg;
+    auto x = reg.histogram_family<double>("bench", "histogram", {}, bounds, "")
+               ->get_or_add({});
+    auto variant = "buckets=" + std::to_string(num_buckets);
+    auto ns = run(1, cfg.iterations, [x, &values](size_t, size_t i) {
+      x->observe(values[i % values.size()]);
+    });
+    print("observe", variant, 1, ns);
+    // Computing only the index separates the lookup from the atomic updates.
+    std::atomic<size_t> sink{0};
+    ns = run(1, cfg.iterations, [x, &values, &sink](size_t, size_t i) {
+      sink.fetch_add(x->bucket_index(values[i % values.size()]),
+                     std::memory_order_relaxed);
+    });
+    print("bucket_index", variant, 1, ns);
+    ns = run(1, cfg.iterations, [&bounds, &values, &sink](size_t, size_t i) {
+      auto pos = std::lower_bound(bounds.begin(), bounds.end(),
+                                  values[i % values.size()]);
+      sink.fetch_add(static_cast<size_t>(pos - bounds.begin()),
+                     std::memory_order_relaxed);
+    });
+    print("lower_bound", variant, 1, ns);
+  }
+}
+
+// Compares shared and sharded histograms under contention.
+void bench_histograms(const config& cfg) {
+  std::vector<double> bounds;
+  for (size_t i = 1; i <= 16; ++i)
+    bounds.emplace_back(static_cast<double>(i));
+  auto values = random_values(16.);
+  telemetry::hdr_layout layout{1., 16.};
+  for (auto n : thread_counts(cfg.max_threads)) {
+    for (auto shards : shard_counts(n)) {
+      telemetry::metric_registry reg;
+      reg.shards(shards);
+      auto variant = "shards=" + std::to_string(shards);
+      auto x = reg.histogram_family<double>("bench", "histogram", {}, bounds,
+                                            "")
+                 ->get_or_add({});
+      auto ns = run(n, cfg.iterations, [x, &values](size_t t, size_t i) {
+        x->observe(values[(t * 7 + i) % values.size()]);
+      });
+      print("histogram", variant, n, ns);
+      auto y = reg.hdr_histogram_instance<double>("bench", "hdr-histogram",
+                                                  {}, layout, "");
+      ns = run(n, cfg.iterations, [y, &values](size_t t, size_t i) {
+        y->observe(values[(t * 7 + i) % values.size()]);
+      });
+      print("hdr_histogram", variant, n, ns);
+    }
+  }
+}
+
+// Measures looking up existing metrics by their labels.
+void bench_get_or_add(const config& cfg) {
+  std::vector<string> peers;
+  for (size_t i = 0; i < 64; ++i)
+    peers.emplace_back("peer-" + std::to_string(i));
+  for (auto n : thread_counts(cfg.max_threads)) {
+    telemetry::metric_registry reg;
+    auto fam = reg.counter_family("bench", "messages", {"peer"}, "");
+    for (auto& peer : peers)
+      fam->get_or_add({{"peer", peer}});
+    auto ns = run(n, cfg.iterations, [fam, &peers](size_t t, size_t i) {
+      auto& peer = peers[(t * 7 + i) % peers.size()];
+      fam->get_or_add({{"peer", peer}})->inc();
+    });
+    print("get_or_add", "labels=64", n, ns);
+    ns = run(n, cfg.iterations, [&reg](size_t, size_t) {
+      reg.counter_family("bench", "messages", {"peer"}, "");
+    });
+    print("family lookup", "families=1", n, ns);
+  }
+}
+
+void caf_main(actor_system&, const config& cfg) {
+  bench_counters(cfg);
+  bench_bucket_lookup(cfg);
+  bench_histograms(cfg);
+  bench_get_or_add(cfg);
+}
+
+} // namespace
+
+CAF_MAIN()